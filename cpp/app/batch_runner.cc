@@ -0,0 +1,218 @@
+
+#include "app/batch_runner.h"
+
+#include <omp.h>
+
+#include <fstream>
+#include <map>
+#include <sstream>
+
+#include "utils/config.h"
+#include "utils/exception.h"
+#include "utils/json.h"
+#include "utils/log.h"
+#include "utils/operating_system.h"
+#include "utils/structure.h"
+
+namespace app
+{
+namespace
+{
+// Whether the parameters in `parameter_file` enable or disable features
+// (true if they cannot be read, such that the job fails on its own).
+bool sets_features(const std::string& parameter_file)
+{
+  try
+  {
+    auto config = utils::json_from_file(parameter_file);
+    if (!config.IsObject() || !config.HasMember(utils::kParams)) return false;
+    const auto& params = config[utils::kParams];
+    return params.IsObject() && (params.HasMember(utils::kEnabledFeatures) ||
+                                 params.HasMember(utils::kDisabledFeatures));
+  }
+  catch (const std::exception&)
+  {
+    return true;
+  }
+}
+}  // namespace
+
+BatchRunner::BatchRunner()
+    : merge_duplicate_terms_(false),
+      output_benchmark_(true),
+      small_job_bytes_(kDefaultSmallJobBytes)
+{
+}
+
+void BatchRunner::add_job(const std::string& input_file,
+                          const std::string& parameter_file)
+{
+  jobs_.push_back(
+      {input_file, parameter_file.empty() ? parameter_file_ : parameter_file});
+}
+
+void BatchRunner::add_jobs(const std::string& path)
+{
+  if (utils::isFolder(path))
+  {
+    for (const auto& input_file : utils::list_files(path)) add_job(input_file);
+    return;
+  }
+
+  std::ifstream in(path);
+  if (!in)
+  {
+    THROW(utils::FileReadException, "Unable to read job file ", path, ".");
+  }
+  std::string line;
+  size_t line_number = 0;
+  while (std::getline(in, line))
+  {
+    line_number++;
+    std::istringstream fields(line);
+    std::string input_file, parameter_file, extra;
+    if (!(fields >> input_file) || input_file[0] == '#') continue;
+    fields >> parameter_file;
+    if (fields >> extra)
+    {
+      THROW(utils::ParsingException, "Unexpected '", extra, "' in line ",
+            line_number, " of job file ", path,
+            " (expected an input file and an optional parameter file).");
+    }
+    add_job(input_file, parameter_file);
+  }
+}
+
+BatchRunner::JobStatus BatchRunner::run_job(size_t index, bool concurrent,
+                                            std::ostream& line)
+{
+  const BatchJob& job = jobs_[index];
+  utils::Structure record;
+  record["job"] = (uint64_t)index;
+  record["input_file"] = job.input_file;
+  Runner runner;
+  bool success = true;
+  try
+  {
+    if (job.parameter_file.empty())
+    {
+      THROW(utils::MissingInputException, "No parameter file for ",
+            job.input_file, ".");
+    }
+    runner.set_output_benchmark(output_benchmark_);
+    runner.set_input_file(job.input_file);
+    runner.set_parameter_file(job.parameter_file);
+    if (!target_.empty()) runner.set_solver(target_);
+    if (!cache_dir_.empty()) runner.set_cache_dir(cache_dir_);
+    runner.set_merge_duplicate_terms(merge_duplicate_terms_);
+    runner.set_allow_memory_saving_retry(!concurrent);
+    runner.configure();
+    utils::Structure response = runner.get_run_output();
+    // Unlike `Runner::get_response()`, this does not print metrics to the
+    // console (which may be the output).
+    record["response"] = output_benchmark_ ? response : response["solutions"];
+  }
+  catch (const utils::MemoryLimitedException& e)
+  {
+    if (concurrent)
+    {
+      LOG(INFO, "Job ", index, " (", job.input_file,
+          ") exceeds the memory limit, retrying it on its own.");
+      return kDeferred;
+    }
+    LOG(ERROR, "Job ", index, " (", job.input_file, ") failed: ", e.what());
+    record["error"] = e.what();
+    success = false;
+  }
+  catch (const std::exception& e)
+  {
+    LOG(ERROR, "Job ", index, " (", job.input_file, ") failed: ", e.what());
+    record["error"] = e.what();
+    success = false;
+  }
+  runner.write_response(record, &line, false);
+  line << '\n';
+  return success ? kSucceeded : kFailed;
+}
+
+size_t BatchRunner::run(std::ostream& out)
+{
+  // Small jobs are solved concurrently, the others (and those which change
+  // features) one after the other.
+  std::vector<size_t> concurrent_jobs, sequential_jobs;
+  std::map<std::string, bool> parameters_set_features;
+  for (size_t i = 0; i < jobs_.size(); i++)
+  {
+    const std::string& parameter_file = jobs_[i].parameter_file;
+    auto known = parameters_set_features.find(parameter_file);
+    if (known == parameters_set_features.end())
+    {
+      known = parameters_set_features
+                  .emplace(parameter_file, sets_features(parameter_file))
+                  .first;
+    }
+    bool found = false;
+    size_t size = utils::get_file_size(jobs_[i].input_file, found);
+    if (found && !utils::isFolder(jobs_[i].input_file) &&
+        size <= small_job_bytes_ && !known->second)
+    {
+      concurrent_jobs.push_back(i);
+    }
+    else
+    {
+      sequential_jobs.push_back(i);
+    }
+  }
+  LOG(INFO, "Solving ", concurrent_jobs.size(), " jobs concurrently and ",
+      sequential_jobs.size(), " jobs sequentially.");
+
+  size_t failed = 0;
+  std::vector<size_t> deferred_jobs;
+  int max_threads = omp_get_max_threads();
+  #pragma omp parallel
+  {
+    // Solvers of concurrent jobs use a single thread each (this only
+    // affects the calling thread).
+    omp_set_num_threads(1);
+    // Reused for the json line of each job of this thread.
+    std::stringstream line;
+    #pragma omp for schedule(dynamic, 1)
+    for (int i = 0; i < (int)concurrent_jobs.size(); i++)
+    {
+      line.str("");
+      line.clear();
+      JobStatus status = run_job(concurrent_jobs[(size_t)i], true, line);
+      #pragma omp critical(batch_output)
+      {
+        if (status == kDeferred)
+        {
+          deferred_jobs.push_back(concurrent_jobs[(size_t)i]);
+        }
+        else
+        {
+          out << line.str() << std::flush;
+          if (status == kFailed) failed++;
+        }
+      }
+    }
+  }
+  sequential_jobs.insert(sequential_jobs.begin(), deferred_jobs.begin(),
+                         deferred_jobs.end());
+
+  std::stringstream line;
+  for (size_t index : sequential_jobs)
+  {
+    // A job's `threads` parameter and features must not apply to the next
+    // job.
+    omp_set_num_threads(max_threads);
+    utils::ScopedFeatures features;
+    line.str("");
+    line.clear();
+    if (run_job(index, false, line) == kFailed) failed++;
+    out << line.str() << std::flush;
+  }
+  omp_set_num_threads(max_threads);
+  return failed;
+}
+
+}  // namespace app
@@ -0,0 +1,99 @@
+
+#pragma once
+
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "app/runner.h"
+
+namespace app
+{
+/// One problem of a batch: an input file and the parameter file to solve it
+/// with.
+struct BatchJob
+{
+  std::string input_file;
+  std::string parameter_file;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// Batch runner
+///
+/// Solves many problems in one process, avoiding the per-process startup
+/// cost for large numbers of small problems. Each job is solved by its own
+/// `Runner`; jobs whose input is at most `small_job_bytes` are solved
+/// concurrently (each on a single thread), larger jobs one after the other
+/// using all threads.
+///
+/// Features are process-wide, so jobs which change them run one after the
+/// other (with the features restored after each job): those whose
+/// parameters enable or disable features and those which exceed the memory
+/// limit when solved concurrently (which are retried on their own, with the
+/// memory saving model if needed).
+///
+/// The responses are written as json lines in the order in which the jobs
+/// complete:
+///
+///   {"input_file": "...", "job": 0, "response": {...}}
+///   {"error": "...", "input_file": "...", "job": 1}
+///
+class BatchRunner
+{
+ public:
+  /// Inputs up to this size are solved concurrently by default.
+  static constexpr size_t kDefaultSmallJobBytes = 1 << 20;
+
+  BatchRunner();
+
+  /// Parameter file for jobs which do not specify one.
+  void set_parameter_file(const std::string& file_path)
+  {
+    parameter_file_ = file_path;
+  }
+  /// Solver for all jobs (overriding the `target` in the parameter files).
+  void set_solver(const std::string& target) { target_ = target; }
+  void set_cache_dir(const std::string& cache_dir) { cache_dir_ = cache_dir; }
+  void set_merge_duplicate_terms(bool value) { merge_duplicate_terms_ = value; }
+  void set_output_benchmark(bool value) { output_benchmark_ = value; }
+  void set_small_job_bytes(size_t value) { small_job_bytes_ = value; }
+
+  /// Add a job (using the default parameter file if `parameter_file` is
+  /// empty).
+  void add_job(const std::string& input_file,
+               const std::string& parameter_file = "");
+
+  /// Add the jobs in `path`, which is either a folder (each file of which
+  /// is an input) or a job file listing one job per line: the input file,
+  /// optionally followed by the parameter file. Empty lines and lines
+  /// starting with `#` are ignored.
+  void add_jobs(const std::string& path);
+
+  const std::vector<BatchJob>& get_jobs() const { return jobs_; }
+
+  /// Solve all jobs, writing one json line per job to `out`; returns the
+  /// number of jobs which failed.
+  size_t run(std::ostream& out);
+
+ private:
+  enum JobStatus
+  {
+    kSucceeded,
+    kFailed,
+    // exceeded the memory limit while solved concurrently (nothing written)
+    kDeferred
+  };
+
+  /// Solve job `index`, writing its json line to `line`.
+  JobStatus run_job(size_t index, bool concurrent, std::ostream& line);
+
+  std::vector<BatchJob> jobs_;
+  std::string parameter_file_;
+  std::string target_;
+  std::string cache_dir_;
+  bool merge_duplicate_terms_;
+  bool output_benchmark_;
+  size_t small_job_bytes_;
+};
+
+}  // namespace app
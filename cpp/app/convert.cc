@@ -0,0 +1,125 @@
+
+#include <string>
+#include <vector>
+
+#include "utils/arguments.h"
+#include "utils/exception.h"
+#include "utils/log.h"
+#include "utils/operating_system.h"
+#include "utils/proto_reader.h"
+#include "utils/stream_handler_json.h"
+#include "model/binary_problem.h"
+#include "model/graph_model.h"
+
+/// Converter from JSON / protobuf problems to the binary problem format.
+///
+///   qiotoolkit-convert -i problem.json -o problem.qiob
+///
+/// The output can be passed to `qiotoolkit` as the input file; it is
+/// memory-mapped instead of being parsed and normalized.
+
+const char kProgramDocumentation[] = "qiotoolkit Converter";
+const char kArgumentDocumentation[] =
+    "Convert a JSON or protobuf problem to the binary problem format";
+
+using utils::Logger;
+using utils::MissingInputException;
+
+static struct argp_option kOptions[] = {
+    {"log_level", 'l', "STRING", 0,
+     "Set explicit log level (INFO, WARN, ERROR, FATAL)", 0},
+    {"input", 'i', "FILE", 0, "Input json file or protobuf folder to read", 0},
+    {"output", 'o', "FILE", 0, "Binary problem file to write", 0},
+    {"merge-terms", 't', 0, 0,
+     "Merge terms with the same variables (summing their coefficients)", 0},
+    {nullptr, 0, nullptr, 0, nullptr, 0},
+};
+
+struct Config
+{
+  std::string log_level;
+  std::string input_file;
+  std::string output_file;
+  bool merge_terms = false;
+  std::vector<std::string> positional;
+};
+
+static error_t ParseOption(int key, char* value, struct argp_state* state)
+{
+  Config* config = static_cast<Config*>(state->input);
+  switch (key)
+  {
+    case 'l':
+      config->log_level = value;
+      break;
+    case 'i':
+      config->input_file = value;
+      break;
+    case 'o':
+      config->output_file = value;
+      break;
+    case 't':
+      config->merge_terms = true;
+      break;
+    case ARGP_KEY_ARG:
+      config->positional.push_back(value);
+      break;
+    case ARGP_KEY_END:
+      break;
+    default:
+      return ARGP_ERR_UNKNOWN;
+  };
+  return 0;
+}
+
+static struct argp argument_parser = {kOptions,
+                                      ParseOption,
+                                      kArgumentDocumentation,
+                                      kProgramDocumentation,
+                                      nullptr,
+                                      nullptr,
+                                      nullptr};
+
+int main(int argc, char** argv)
+{
+  Config config;
+  try
+  {
+    argp_parse(&argument_parser, argc, argv, 0, 0, &config);
+
+    if (config.log_level != "") Logger::set_level(config.log_level);
+    if (config.input_file == "")
+    {
+      throw MissingInputException("No input file specified (-i)");
+    }
+    if (config.output_file == "")
+    {
+      throw MissingInputException("No output file specified (-o)");
+    }
+    model::GraphModelConfiguration input;
+    model::GraphModelConfiguration::Get_MergeDuplicateTerms::get(input) =
+        config.merge_terms;
+    utils::memory_check_using_file_size(config.input_file, 1.0);
+    if (utils::isFolder(config.input_file))
+    {
+      LOG(INFO, "Parsing ", config.input_file, " as protobuf");
+      utils::configure_graph_from_proto_folder(config.input_file, input);
+    }
+    else
+    {
+      LOG(INFO, "Parsing ", config.input_file, " as json");
+      utils::configure_graph_from_json_file(config.input_file, input);
+    }
+    model::BinaryProblem::write(config.output_file, input);
+    return EX_OK;
+  }
+  catch (const utils::ConfigurationException& e)
+  {
+    LOG(FATAL, e.get_error_message());
+  }
+  catch (const utils::RuntimeException& e)
+  {
+    LOG(FATAL, e.what());
+  }
+  return 16;
+}
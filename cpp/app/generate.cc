@@ -0,0 +1,243 @@
+#include <stdio.h>
+
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "utils/arguments.h"
+#include "utils/config.h"
+#include "utils/exception.h"
+#include "utils/log.h"
+#include "utils/stream_handler_json.h"
+#include "app/generator.h"
+#include "model/binary_problem.h"
+#include "model/graph_model.h"
+
+/// Generator of synthetic problems for scaling studies.
+///
+///   qiotoolkit-generate -f planted -n 100000 -s 7 -o planted.json
+///       --solution planted.solution.json
+///
+/// The same options (and seed) always generate the same problem.
+
+const char kProgramDocumentation[] = "qiotoolkit Problem Generator";
+const char kArgumentDocumentation[] =
+    "Generate a reproducible synthetic problem (pubo, ea2d, ea3d, planted, "
+    "wcnf, tsp or grouped)";
+
+using utils::Logger;
+using utils::MissingInputException;
+
+enum LongOptions
+{
+  kCommunities = 1000,
+  kLoopLength,
+  kGroups,
+  kFormat,
+  kSolution,
+};
+
+static struct argp_option kOptions[] = {
+    {"log_level", 'l', "STRING", 0,
+     "Set explicit log level (INFO, WARN, ERROR, FATAL)", 0},
+    {"family", 'f', "STRING", 0,
+     "Problem family: pubo (default), ea2d, ea3d, planted, wcnf, tsp, grouped",
+     0},
+    {"variables", 'n', "NUMBER", 0,
+     "Number of variables (lattice side length for ea2d/ea3d, cities for "
+     "tsp); default 1000",
+     0},
+    {"terms", 'm', "NUMBER", 0,
+     "Number of terms / clauses / loop edges (default: 4 per variable)", 0},
+    {"locality", 'k', "NUMBER", 0, "Variables per term (default 3)", 0},
+    {"exponent", 'a', "NUMBER", 0,
+     "Power-law exponent of the variable degrees (default 0: uniform)", 0},
+    {"communities", kCommunities, "NUMBER", 0,
+     "Number of clause communities (wcnf; default 1)", 0},
+    {"loop-length", kLoopLength, "NUMBER", 0,
+     "Length of the frustrated loops (planted; default 8)", 0},
+    {"groups", kGroups, "NUMBER", 0,
+     "Number of squared linear combinations (grouped; default: one per 100 "
+     "variables)",
+     0},
+    {"seed", 's', "NUMBER", 0, "Random seed (default 0)", 0},
+    {"format", kFormat, "STRING", 0,
+     "Output format: json (default), proto (folder), wcnf (DIMACS), binary",
+     0},
+    {"output", 'o', "FILE", 0, "Output file or folder (default: stdout)", 0},
+    {"solution", kSolution, "FILE", 0,
+     "Write the known optimum (planted) to FILE", 0},
+    {nullptr, 0, nullptr, 0, nullptr, 0},
+};
+
+struct Config
+{
+  std::string log_level;
+  app::GeneratorConfig generator;
+  std::string format = "json";
+  std::string output_file;
+  std::string solution_file;
+};
+
+static error_t ParseOption(int key, char* value, struct argp_state* state)
+{
+  Config* config = static_cast<Config*>(state->input);
+  switch (key)
+  {
+    case 'l':
+      config->log_level = value;
+      break;
+    case 'f':
+      config->generator.family = value;
+      break;
+    case 'n':
+      config->generator.variables = std::stoull(value);
+      break;
+    case 'm':
+      config->generator.terms = std::stoull(value);
+      break;
+    case 'k':
+      config->generator.locality = (uint32_t)std::stoul(value);
+      break;
+    case 'a':
+      config->generator.exponent = std::stod(value);
+      break;
+    case kCommunities:
+      config->generator.communities = (uint32_t)std::stoul(value);
+      break;
+    case kLoopLength:
+      config->generator.loop_length = (uint32_t)std::stoul(value);
+      break;
+    case kGroups:
+      config->generator.groups = std::stoull(value);
+      break;
+    case 's':
+      config->generator.seed = (uint32_t)std::stoul(value);
+      break;
+    case kFormat:
+      config->format = value;
+      break;
+    case 'o':
+      config->output_file = value;
+      break;
+    case kSolution:
+      config->solution_file = value;
+      break;
+    case ARGP_KEY_ARG:
+      argp_usage(state);
+      break;
+    case ARGP_KEY_END:
+      break;
+    default:
+      return ARGP_ERR_UNKNOWN;
+  };
+  return 0;
+}
+
+static struct argp argument_parser = {kOptions,
+                                      ParseOption,
+                                      kArgumentDocumentation,
+                                      kProgramDocumentation,
+                                      nullptr,
+                                      nullptr,
+                                      nullptr};
+
+static void write_file(const app::ProblemGenerator& generator,
+                       const std::string& file_name,
+                       app::ProblemGenerator::Format format)
+{
+  std::ofstream out(file_name);
+  if (!out)
+  {
+    THROW(utils::FileWriteException, "Unable to write ", file_name, ".");
+  }
+  generator.write(out, format);
+}
+
+int main(int argc, char** argv)
+{
+  Config config;
+  try
+  {
+    argp_parse(&argument_parser, argc, argv, 0, 0, &config);
+
+    if (config.log_level != "") Logger::set_level(config.log_level);
+    app::ProblemGenerator generator(config.generator);
+    LOG(INFO, "Generating ", config.generator.family, " problem (",
+        generator.type(), ") with ", generator.variable_count(),
+        " variables and ", generator.term_count(), " terms.");
+
+    if (config.format == "json" || config.format == "wcnf")
+    {
+      auto format = config.format == "json" ? app::ProblemGenerator::JSON
+                                            : app::ProblemGenerator::WCNF;
+      if (config.output_file.empty())
+      {
+        generator.write(std::cout, format);
+      }
+      else
+      {
+        write_file(generator, config.output_file, format);
+      }
+    }
+    else if (config.format == "proto")
+    {
+      if (config.output_file.empty())
+      {
+        throw MissingInputException("No output folder specified (-o)");
+      }
+      generator.write_proto(config.output_file);
+    }
+    else if (config.format == "binary")
+    {
+      if (config.output_file.empty())
+      {
+        throw MissingInputException("No output file specified (-o)");
+      }
+      if (generator.type() != "pubo" && generator.type() != "ising")
+      {
+        THROW(utils::ValueException, generator.type(),
+              " problems cannot be written in the binary format.");
+      }
+      // The binary format is written from a parsed (and normalized) graph,
+      // so the problem is generated as JSON first.
+      std::string json_file = config.output_file + ".json.tmp";
+      write_file(generator, json_file, app::ProblemGenerator::JSON);
+      model::GraphModelConfiguration input;
+      utils::configure_graph_from_json_file(json_file, input);
+      remove(json_file.c_str());
+      model::BinaryProblem::write(config.output_file, input);
+    }
+    else
+    {
+      THROW(utils::ValueException, "Unknown output format '", config.format,
+            "' (expected json, proto, wcnf or binary).");
+    }
+
+    if (!config.solution_file.empty())
+    {
+      std::ofstream out(config.solution_file);
+      if (!out)
+      {
+        THROW(utils::FileWriteException, "Unable to write ",
+              config.solution_file, ".");
+      }
+      generator.write_solution(out);
+    }
+    return EX_OK;
+  }
+  catch (const utils::ConfigurationException& e)
+  {
+    LOG(FATAL, e.get_error_message());
+  }
+  catch (const utils::RuntimeException& e)
+  {
+    LOG(FATAL, e.what());
+  }
+  catch (const std::exception& e)
+  {
+    LOG(FATAL, e.what());
+  }
+  return 16;
+}
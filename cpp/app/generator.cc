@@ -0,0 +1,592 @@
+
+#include "app/generator.h"
+
+#include <errno.h>
+#include <math.h>
+#include <omp.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+
+#include <algorithm>
+#include <fstream>
+#include <vector>
+
+#include "utils/exception.h"
+#include "utils/log.h"
+#include "utils/random_generator.h"
+#include "problem.pb.h"
+
+namespace app
+{
+namespace
+{
+// Independent random streams derived from the seed.
+enum Stream
+{
+  TERM_STREAM = 1,
+  SPIN_STREAM = 2,
+  LOOP_STREAM = 3,
+  CITY_STREAM = 4,
+  GROUP_STREAM = 5
+};
+
+// Seed for item `index` of `stream` (splitmix64 finalizer).
+uint32_t derive_seed(uint32_t seed, Stream stream, uint64_t index)
+{
+  uint64_t x = ((uint64_t)seed << 32 | (uint64_t)stream << 24) ^
+               (index * 0x9E3779B97F4A7C15ull);
+  x ^= x >> 30;
+  x *= 0xBF58476D1CE4E5B9ull;
+  x ^= x >> 27;
+  x *= 0x94D049BB133111EBull;
+  x ^= x >> 31;
+  return (uint32_t)x;
+}
+
+// Enough digits to parse back to the same double.
+void append_number(std::string& buffer, double value)
+{
+  char text[32];
+  snprintf(text, sizeof(text), "%.17g", value);
+  buffer += text;
+}
+
+void append_number(std::string& buffer, int64_t value)
+{
+  buffer += std::to_string(value);
+}
+
+bool contains(const std::vector<int64_t>& ids, size_t first, int64_t id)
+{
+  return std::find(ids.begin() + first, ids.end(), id) != ids.end();
+}
+
+// Shard file name expected by `utils::ProtoReader` (which cannot be included
+// here as it defines globals).
+std::string shard_file_name(const std::string& folder, size_t index)
+{
+  size_t separator = folder.find_last_of("/\\");
+  std::string name =
+      separator == std::string::npos ? folder : folder.substr(separator + 1);
+  return folder + "/" + name + "_" + std::to_string(index) + ".pb";
+}
+}  // namespace
+
+ProblemGenerator::ProblemGenerator(const GeneratorConfig& config)
+    : config_(config),
+      family_(PUBO),
+      type_("pubo"),
+      dimension_(0),
+      variable_count_(config.variables),
+      term_count_(config.terms > 0 ? config.terms : 4 * config.variables)
+{
+  if (config_.family == "pubo")
+  {
+    family_ = PUBO;
+  }
+  else if (config_.family == "ea2d" || config_.family == "ea3d")
+  {
+    family_ = EA;
+    type_ = "ising";
+    dimension_ = config_.family == "ea2d" ? 2 : 3;
+    if (config_.variables < 3)
+    {
+      THROW(utils::ValueException,
+            "The side length (variables) of ea lattices must be at least 3, "
+            "found: ",
+            config_.variables);
+    }
+    variable_count_ = 1;
+    for (uint32_t d = 0; d < dimension_; d++) variable_count_ *= config_.variables;
+    term_count_ = dimension_ * variable_count_;
+  }
+  else if (config_.family == "planted")
+  {
+    family_ = PLANTED;
+    type_ = "ising";
+    if (config_.loop_length < 3 || config_.loop_length > config_.variables)
+    {
+      THROW(utils::ValueException,
+            "loop_length must be in [3, variables], found: ",
+            config_.loop_length);
+    }
+    uint64_t loops = std::max<uint64_t>(1, term_count_ / config_.loop_length);
+    term_count_ = loops * config_.loop_length;
+  }
+  else if (config_.family == "wcnf")
+  {
+    family_ = WCNF_FAMILY;
+    type_ = "maxsat";
+    if (config_.communities == 0 || config_.communities > config_.variables)
+    {
+      THROW(utils::ValueException,
+            "communities must be in [1, variables], found: ",
+            config_.communities);
+    }
+    if (config_.locality > config_.variables / config_.communities)
+    {
+      THROW(utils::ValueException,
+            "locality must not exceed the size of a community, found: ",
+            config_.locality);
+    }
+  }
+  else if (config_.family == "tsp")
+  {
+    family_ = TSP;
+    type_ = "tsp";
+    term_count_ = config_.variables;
+  }
+  else if (config_.family == "grouped")
+  {
+    family_ = GROUPED;
+    type_ = "pubo_grouped";
+    if (config_.groups == 0)
+    {
+      config_.groups = std::max<uint64_t>(1, config_.variables / 100);
+    }
+    if (config_.groups > config_.variables)
+    {
+      THROW(utils::ValueException, "groups must not exceed variables, found: ",
+            config_.groups);
+    }
+  }
+  else
+  {
+    THROW(utils::ValueException, "Unknown problem family '", config_.family,
+          "' (expected pubo, ea2d, ea3d, planted, wcnf, tsp or grouped).");
+  }
+
+  if (config_.variables < 2)
+  {
+    THROW(utils::ValueException, "variables must be at least 2, found: ",
+          config_.variables);
+  }
+  if ((family_ == PUBO || family_ == GROUPED || family_ == WCNF_FAMILY) &&
+      (config_.locality == 0 || config_.locality > config_.variables))
+  {
+    THROW(utils::ValueException, "locality must be in [1, variables], found: ",
+          config_.locality);
+  }
+  if (config_.exponent < 0)
+  {
+    THROW(utils::ValueException, "exponent must be non-negative, found: ",
+          config_.exponent);
+  }
+}
+
+template <class RNG>
+int64_t ProblemGenerator::random_variable(RNG& rng, uint64_t first,
+                                          uint64_t count) const
+{
+  // Inverse of the (continuous) cumulative distribution of x^-exponent on
+  // [1, count + 1); variable `i` is chosen for x in [i + 1, i + 2).
+  double a = config_.exponent;
+  double u = rng.uniform();
+  double x;
+  if (a == 0)
+  {
+    x = 1 + u * (double)count;
+  }
+  else if (fabs(a - 1) < 1e-9)
+  {
+    x = pow((double)count + 1, u);
+  }
+  else
+  {
+    double b = 1 - a;
+    x = pow(u * (pow((double)count + 1, b) - 1) + 1, 1 / b);
+  }
+  uint64_t offset = std::min<uint64_t>(count - 1, (uint64_t)x - 1);
+  return (int64_t)(first + offset);
+}
+
+int ProblemGenerator::planted_spin(uint64_t id) const
+{
+  return derive_seed(config_.seed, SPIN_STREAM, id) & 1 ? 1 : -1;
+}
+
+void ProblemGenerator::generate(uint64_t begin, uint64_t end,
+                                TermBlock& block) const
+{
+  if (family_ == TSP)
+  {
+    THROW(utils::ValueException, "tsp problems have no terms.");
+  }
+  block.clear();
+  end = std::min(end, term_count_);
+  if (begin >= end) return;
+
+  if (family_ == PLANTED)
+  {
+    // Each loop has its own generator such that blocks may split loops.
+    uint64_t length = config_.loop_length;
+    std::vector<int64_t> vertices;
+    for (uint64_t loop = begin / length; loop * length < end; loop++)
+    {
+      utils::PCG rng(derive_seed(config_.seed, LOOP_STREAM, loop));
+      vertices.clear();
+      while (vertices.size() < length)
+      {
+        int64_t v = random_variable(rng, 0, variable_count_);
+        if (!contains(vertices, 0, v)) vertices.push_back(v);
+      }
+      // All edges are satisfied by the planted configuration except one,
+      // which cannot be satisfied together with the others.
+      uint64_t frustrated = rng.uint32() % length;
+      for (uint64_t k = 0; k < length; k++)
+      {
+        uint64_t term = loop * length + k;
+        if (term < begin || term >= end) continue;
+        int64_t a = vertices[k];
+        int64_t b = vertices[(k + 1) % length];
+        int coupling = -planted_spin(a) * planted_spin(b);
+        block.add_term(k == frustrated ? -coupling : coupling);
+        block.add_id(a);
+        block.add_id(b);
+      }
+    }
+    return;
+  }
+
+  utils::PCG rng(derive_seed(config_.seed, TERM_STREAM, begin / kBlockSize));
+  for (uint64_t term = begin; term < end; term++)
+  {
+    if (family_ == EA)
+    {
+      // Edge from site `term / dimension` in direction `term % dimension`.
+      uint64_t site = term / dimension_;
+      uint64_t direction = term % dimension_;
+      uint64_t stride = 1;
+      for (uint64_t d = 0; d < direction; d++) stride *= config_.variables;
+      uint64_t coordinate = (site / stride) % config_.variables;
+      uint64_t neighbor = coordinate + 1 == config_.variables
+                              ? site - coordinate * stride
+                              : site + stride;
+      block.add_term(rng.uint32() & 1 ? 1 : -1);
+      block.add_id((int64_t)site);
+      block.add_id((int64_t)neighbor);
+      continue;
+    }
+
+    size_t first = block.ids.size();
+    if (family_ == WCNF_FAMILY)
+    {
+      // Integer weights in [1, 10]; most literals from one community.
+      block.add_term(1 + rng.uint32() % 10);
+      uint64_t community = rng.uint32() % config_.communities;
+      uint64_t community_first =
+          community * variable_count_ / config_.communities;
+      uint64_t community_size =
+          (community + 1) * variable_count_ / config_.communities -
+          community_first;
+      while (block.ids.size() - first < config_.locality)
+      {
+        int64_t v = config_.communities > 1 && rng.uniform() < 0.9
+                        ? random_variable(rng, community_first, community_size)
+                        : random_variable(rng, 0, variable_count_);
+        if (contains(block.ids, first, v + 1) ||
+            contains(block.ids, first, -(v + 1)))
+        {
+          continue;
+        }
+        block.add_id(rng.uint32() & 1 ? -(v + 1) : v + 1);
+      }
+      continue;
+    }
+
+    // pubo, grouped
+    block.add_term(2 * rng.uniform() - 1);
+    while (block.ids.size() - first < config_.locality)
+    {
+      int64_t v = random_variable(rng, 0, variable_count_);
+      if (!contains(block.ids, first, v)) block.add_id(v);
+    }
+  }
+}
+
+void ProblemGenerator::write_blocks(
+    std::ostream& out, uint64_t count,
+    const std::function<void(uint64_t, uint64_t, std::string&)>& format)
+{
+  uint64_t blocks = (count + kBlockSize - 1) / kBlockSize;
+  // Formatted blocks held in memory (two per thread to balance the load).
+  size_t batch = 2 * (size_t)omp_get_max_threads();
+  std::vector<std::string> buffers(batch);
+  for (uint64_t first = 0; first < blocks; first += batch)
+  {
+    int size = (int)std::min<uint64_t>(batch, blocks - first);
+    utils::OmpCatch omp_catch;
+    #pragma omp parallel for schedule(dynamic, 1)
+    for (int i = 0; i < size; i++)
+    {
+      omp_catch.run([&]() {
+        uint64_t begin = (first + i) * kBlockSize;
+        buffers[i].clear();
+        format(begin, std::min(count, begin + kBlockSize), buffers[i]);
+      });
+    }
+    omp_catch.rethrow();
+    for (int i = 0; i < size; i++) out << buffers[i];
+  }
+}
+
+void ProblemGenerator::write(std::ostream& out, Format format) const
+{
+  if (format == PROTO)
+  {
+    THROW(utils::ValueException,
+          "protobuf problems are written to a folder (see write_proto).");
+  }
+  if (format == WCNF)
+  {
+    if (family_ != WCNF_FAMILY)
+    {
+      THROW(utils::ValueException,
+            "Only wcnf problems can be written in the DIMACS format.");
+    }
+    uint64_t used;
+    std::vector<int64_t> names = dimacs_names(used);
+    out << "p wcnf " << used << " " << term_count_ << "\n";
+    write_blocks(out, term_count_,
+                 [&](uint64_t begin, uint64_t end, std::string& buffer) {
+                   TermBlock block;
+                   generate(begin, end, block);
+                   for (size_t t = 0; t < block.size(); t++)
+                   {
+                     append_number(buffer, (int64_t)block.costs[t]);
+                     for (size_t k = block.offsets[t]; k < block.offsets[t + 1];
+                          k++)
+                     {
+                       int64_t id = block.ids[k];
+                       buffer += ' ';
+                       append_number(buffer, id > 0 ? names[id - 1]
+                                                    : -names[-id - 1]);
+                     }
+                     buffer += " 0\n";
+                   }
+                 });
+    return;
+  }
+
+  out << "{\"cost_function\":{\"type\":\"" << type_
+      << "\",\"version\":\"1.0\",";
+  if (family_ == TSP)
+  {
+    write_tsp(out);
+  }
+  else
+  {
+    out << "\"terms\":[";
+    write_blocks(out, term_count_,
+                 [this](uint64_t begin, uint64_t end, std::string& buffer) {
+                   TermBlock block;
+                   generate(begin, end, block);
+                   for (size_t t = 0; t < block.size(); t++)
+                   {
+                     if (begin + t > 0) buffer += ',';
+                     buffer += "{\"c\":";
+                     append_number(buffer, block.costs[t]);
+                     buffer += ",\"ids\":[";
+                     for (size_t k = block.offsets[t]; k < block.offsets[t + 1];
+                          k++)
+                     {
+                       if (k > block.offsets[t]) buffer += ',';
+                       append_number(buffer, block.ids[k]);
+                     }
+                     buffer += "]}";
+                   }
+                 });
+    out << "]";
+    if (family_ == GROUPED) write_groups(out);
+  }
+  out << "}}\n";
+}
+
+std::vector<int64_t> ProblemGenerator::dimacs_names(uint64_t& used) const
+{
+  // Clauses are generated twice (here and when writing) rather than held in
+  // memory; blocks are generated on all threads and marked in order.
+  std::vector<int64_t> names(variable_count_, 0);
+  uint64_t blocks = (term_count_ + kBlockSize - 1) / kBlockSize;
+  size_t batch = (size_t)omp_get_max_threads();
+  std::vector<TermBlock> terms(batch);
+  for (uint64_t first = 0; first < blocks; first += batch)
+  {
+    int size = (int)std::min<uint64_t>(batch, blocks - first);
+    utils::OmpCatch omp_catch;
+    #pragma omp parallel for schedule(dynamic, 1)
+    for (int i = 0; i < size; i++)
+    {
+      omp_catch.run([&]() {
+        uint64_t begin = (first + i) * kBlockSize;
+        generate(begin, begin + kBlockSize, terms[i]);
+      });
+    }
+    omp_catch.rethrow();
+    for (int i = 0; i < size; i++)
+    {
+      for (int64_t id : terms[i].ids) names[std::abs(id) - 1] = 1;
+    }
+  }
+  used = 0;
+  for (auto& name : names)
+  {
+    if (name != 0) name = (int64_t)++used;
+  }
+  return names;
+}
+
+void ProblemGenerator::write_tsp(std::ostream& out) const
+{
+  // Each city is placed from its own generator such that rows can be
+  // formatted independently.
+  uint64_t n = variable_count_;
+  auto city = [this](uint64_t i, double& x, double& y) {
+    utils::PCG rng(derive_seed(config_.seed, CITY_STREAM, i));
+    x = rng.uniform();
+    y = rng.uniform();
+  };
+  std::vector<double> xs(n), ys(n);
+  for (uint64_t i = 0; i < n; i++) city(i, xs[i], ys[i]);
+
+  out << "\"disks\":[";
+  write_blocks(out, n,
+               [&](uint64_t begin, uint64_t end, std::string& buffer) {
+                 for (uint64_t i = begin; i < end; i++)
+                 {
+                   buffer += i > 0 ? ",[" : "[";
+                   for (uint64_t j = 0; j < n; j++)
+                   {
+                     if (j > 0) buffer += ',';
+                     append_number(buffer, hypot(xs[i] - xs[j], ys[i] - ys[j]));
+                   }
+                   buffer += ']';
+                 }
+               });
+  out << "]";
+}
+
+void ProblemGenerator::write_groups(std::ostream& out) const
+{
+  // Each group penalizes (sum_i x_i - size / 2)^2 for `size` random variables
+  // with a random positive weight.
+  uint64_t size =
+      std::max<uint64_t>(2, variable_count_ / config_.groups);
+  size = std::min(size, variable_count_);
+  out << ",\"terms_slc\":[";
+  write_blocks(
+      out, config_.groups,
+      [&](uint64_t begin, uint64_t end, std::string& buffer) {
+        std::vector<int64_t> ids;
+        for (uint64_t g = begin; g < end; g++)
+        {
+          utils::PCG rng(derive_seed(config_.seed, GROUP_STREAM, g));
+          ids.clear();
+          while (ids.size() < size)
+          {
+            int64_t v = random_variable(rng, 0, variable_count_);
+            if (!contains(ids, 0, v)) ids.push_back(v);
+          }
+          buffer += g > 0 ? ",{\"c\":" : "{\"c\":";
+          append_number(buffer, 0.5 + rng.uniform());
+          buffer += ",\"terms\":[";
+          for (int64_t id : ids)
+          {
+            buffer += "{\"c\":1,\"ids\":[";
+            append_number(buffer, id);
+            buffer += "]},";
+          }
+          buffer += "{\"c\":";
+          append_number(buffer, -(int64_t)(size / 2));
+          buffer += ",\"ids\":[]}]}";
+        }
+      });
+  out << "]";
+}
+
+void ProblemGenerator::write_proto(const std::string& folder) const
+{
+  QuantumUtil::Problem_ProblemType type;
+  if (type_ == "pubo")
+  {
+    type = QuantumUtil::Problem_ProblemType_PUBO;
+  }
+  else if (type_ == "ising")
+  {
+    type = QuantumUtil::Problem_ProblemType_ISING;
+  }
+  else if (type_ == "maxsat")
+  {
+    type = QuantumUtil::Problem_ProblemType_MAXSAT;
+  }
+  else
+  {
+    THROW(utils::ValueException, type_,
+          " problems cannot be written as protobuf.");
+  }
+
+  if (mkdir(folder.c_str(), 0755) != 0 && errno != EEXIST)
+  {
+    THROW(utils::FileWriteException, "Unable to create folder ", folder, ".");
+  }
+  // One shard per block.
+  int shards = (int)((term_count_ + kBlockSize - 1) / kBlockSize);
+  utils::OmpCatch omp_catch;
+  #pragma omp parallel for schedule(dynamic, 1)
+  for (int shard = 0; shard < shards; shard++)
+  {
+    omp_catch.run([&]() {
+      TermBlock block;
+      uint64_t begin = (uint64_t)shard * kBlockSize;
+      generate(begin, begin + kBlockSize, block);
+      QuantumUtil::Problem problem;
+      auto* cost_function = problem.mutable_cost_function();
+      cost_function->set_type(type);
+      cost_function->set_version("1.0");
+      for (size_t t = 0; t < block.size(); t++)
+      {
+        auto* term = cost_function->add_terms();
+        term->set_c(block.costs[t]);
+        for (size_t k = block.offsets[t]; k < block.offsets[t + 1]; k++)
+        {
+          term->add_ids(block.ids[k]);
+        }
+      }
+      std::string file_name = shard_file_name(folder, (size_t)shard);
+      std::ofstream out(file_name, std::ios::binary);
+      if (!out || !problem.SerializeToOstream(&out))
+      {
+        THROW(utils::FileWriteException, "Unable to write ", file_name, ".");
+      }
+    });
+  }
+  omp_catch.rethrow();
+  LOG(INFO, "Wrote ", shards, " protobuf shards to ", folder, ".");
+}
+
+void ProblemGenerator::write_solution(std::ostream& out) const
+{
+  if (!has_solution())
+  {
+    THROW(utils::ValueException, "The optimum of ", config_.family,
+          " problems is unknown.");
+  }
+  // Each frustrated loop has exactly one unsatisfied edge in the planted
+  // configuration, which is the least possible.
+  int64_t length = config_.loop_length;
+  int64_t loops = (int64_t)term_count_ / length;
+  out << "{\"cost\":" << loops * (2 - length) << ",\"configuration\":{";
+  write_blocks(out, variable_count_,
+               [this](uint64_t begin, uint64_t end, std::string& buffer) {
+                 for (uint64_t i = begin; i < end; i++)
+                 {
+                   buffer += i > 0 ? ",\"" : "\"";
+                   buffer += std::to_string(i);
+                   buffer += planted_spin(i) > 0 ? "\":1" : "\":-1";
+                 }
+               });
+  out << "}}\n";
+}
+
+}  // namespace app
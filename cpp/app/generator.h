@@ -0,0 +1,183 @@
+
+#pragma once
+
+#include <stdint.h>
+
+#include <functional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace app
+{
+/// Parameters of a synthetic problem (see `ProblemGenerator`).
+struct GeneratorConfig
+{
+  GeneratorConfig()
+      : family("pubo"),
+        variables(1000),
+        terms(0),
+        locality(3),
+        exponent(0),
+        communities(1),
+        loop_length(8),
+        groups(0),
+        seed(0)
+  {
+  }
+
+  /// One of pubo, ea2d, ea3d, planted, wcnf, tsp or grouped.
+  std::string family;
+  /// Number of variables (the side length of the lattice for ea2d/ea3d and
+  /// the number of cities for tsp).
+  uint64_t variables;
+  /// Number of terms (0 for 4 terms per variable); the number of clauses
+  /// for wcnf and the number of loop edges for planted.
+  uint64_t terms;
+  /// Number of variables per term (or literals per clause).
+  uint32_t locality;
+  /// Variables are selected with probability proportional to
+  /// (index + 1)^-exponent, i.e., uniformly for 0 and with a power-law
+  /// degree distribution for larger values.
+  double exponent;
+  /// Number of communities most clauses are drawn from (wcnf); more than one
+  /// gives "industrial-like" instances with community structure.
+  uint32_t communities;
+  /// Length of the frustrated loops of planted instances.
+  uint32_t loop_length;
+  /// Number of squared linear combination groups (grouped; 0 for one per
+  /// 100 variables).
+  uint64_t groups;
+  uint32_t seed;
+};
+
+/// Terms [begin, end) of a problem, stored flat: the variables of term `i`
+/// are ids[offsets[i] .. offsets[i + 1]).
+struct TermBlock
+{
+  void clear()
+  {
+    costs.clear();
+    ids.clear();
+    offsets.assign(1, 0);
+  }
+  void add_term(double cost)
+  {
+    costs.push_back(cost);
+    offsets.push_back(offsets.back());
+  }
+  void add_id(int64_t id)
+  {
+    ids.push_back(id);
+    offsets.back()++;
+  }
+  size_t size() const { return costs.size(); }
+
+  std::vector<double> costs;
+  std::vector<size_t> offsets;
+  std::vector<int64_t> ids;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// Problem generator
+///
+/// Writes reproducible synthetic problems for scaling studies: the same
+/// configuration (including the seed) always yields the same problem,
+/// independently of the number of threads.
+///
+/// Terms are generated in fixed-size blocks (each with its own random
+/// generator seeded from the seed and block index) on all threads and
+/// written in order, such that only a few blocks per thread are held in
+/// memory at any time.
+///
+///   * pubo: random k-local terms with uniform coefficients in [-1, 1).
+///   * ea2d, ea3d: Edwards-Anderson spin glasses with +-1 couplings on a
+///     periodic square (cubic) lattice.
+///   * planted: ising problem of frustrated loops whose ground state (a
+///     random planted configuration) and its cost are known.
+///   * wcnf: weighted random k-SAT clauses (with community structure if
+///     `communities` > 1).
+///   * tsp: euclidean distances between random cities in the unit square.
+///   * grouped: pubo_grouped problem with random k-local terms and squared
+///     linear combinations of the variables.
+///
+class ProblemGenerator
+{
+ public:
+  /// Number of terms per block.
+  static constexpr size_t kBlockSize = 1 << 16;
+
+  enum Format
+  {
+    JSON,
+    PROTO,  // folder of protobuf shards (one per block)
+    WCNF,   // DIMACS (wcnf only; unused variables are dropped)
+  };
+
+  /// Throws a ValueException if the configuration is invalid.
+  explicit ProblemGenerator(const GeneratorConfig& config);
+
+  /// The model type of the generated problem.
+  const std::string& type() const { return type_; }
+  uint64_t variable_count() const { return variable_count_; }
+  uint64_t term_count() const { return term_count_; }
+
+  /// Generate terms [begin, end) (which must be aligned to kBlockSize except
+  /// for the end).
+  void generate(uint64_t begin, uint64_t end, TermBlock& block) const;
+
+  /// Write the problem in `format` to `out` (JSON, WCNF).
+  void write(std::ostream& out, Format format) const;
+
+  /// Write the problem as protobuf shards to `folder`.
+  void write_proto(const std::string& folder) const;
+
+  /// Whether the optimum of the problem is known (planted).
+  bool has_solution() const { return family_ == PLANTED; }
+
+  /// Write the known optimum: {"cost": ..., "configuration": {...}}.
+  void write_solution(std::ostream& out) const;
+
+ private:
+  enum Family
+  {
+    PUBO,
+    EA,
+    PLANTED,
+    WCNF_FAMILY,
+    TSP,
+    GROUPED
+  };
+
+  // Write `count` items in blocks of kBlockSize on all threads; `format`
+  // appends items [begin, end) to a buffer and `out` receives the buffers in
+  // order.
+  static void write_blocks(
+      std::ostream& out, uint64_t count,
+      const std::function<void(uint64_t, uint64_t, std::string&)>& format);
+
+  void write_tsp(std::ostream& out) const;
+  void write_groups(std::ostream& out) const;
+
+  // DIMACS name of each variable (0 for variables which appear in no clause):
+  // the used variables are numbered consecutively from 1 such that readers
+  // find as many variables as the problem line declares.
+  std::vector<int64_t> dimacs_names(uint64_t& used) const;
+
+  // Random variable (see `GeneratorConfig::exponent`) in [first, first +
+  // count).
+  template <class RNG>
+  int64_t random_variable(RNG& rng, uint64_t first, uint64_t count) const;
+
+  // Spin of variable `id` in the planted configuration.
+  int planted_spin(uint64_t id) const;
+
+  GeneratorConfig config_;
+  Family family_;
+  std::string type_;
+  uint32_t dimension_;
+  uint64_t variable_count_;
+  uint64_t term_count_;
+};
+
+}  // namespace app
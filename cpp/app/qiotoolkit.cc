@@ -12,6 +12,7 @@
 #include "utils/file.h"
 #include "utils/log.h"
 #include "utils/metadata.h"
+#include "app/batch_runner.h"
 #include "app/runner.h"
 
 /// Executable for running qiotoolkit simulations locally.
@@ -36,6 +37,18 @@ static struct argp_option kOptions[] = {
     {"user", 'u', 0, 0,
      "Render user-readable output (as opposed to service-formatted)", 0},
     {"memory-saving", 'm', 0, 0, "Force to run in memory-saving model", 0},
+    {"cache-dir", 'c', "DIR", 0,
+     "Cache normalized graph problems in this directory", 0},
+    {"merge-terms", 't', 0, 0,
+     "Merge terms with the same variables (summing their coefficients)", 0},
+    {"binary-output", 'b', 0, 0,
+     "Write solutions in the compact binary format (.qios)", 0},
+    {"perf-counters", 'P', 0, 0,
+     "Record hardware counters for each phase in the benchmark (Linux)", 0},
+    {"jobs", 'j', "FILE", 0,
+     "Solve each input listed in FILE (an input file and optional parameter "
+     "file per line) or directory, writing one json line per job",
+     0},
     {nullptr, 0, nullptr, 0, nullptr, 0},
 };
 
@@ -45,6 +58,11 @@ struct Config
   bool user_friendly_mode;
   bool no_benchmark_output;
   bool memory_saving;
+  bool merge_terms;
+  bool binary_output;
+  bool perf_counters;
+  std::string cache_dir;
+  std::string jobs;
   std::string log_level;
   std::string input_file;
   std::string output_file;
@@ -85,6 +103,21 @@ static error_t ParseOption(int key, char* value, struct argp_state* state)
     case 'm':
       config->memory_saving = true;
       break;
+    case 'c':
+      config->cache_dir = value;
+      break;
+    case 't':
+      config->merge_terms = true;
+      break;
+    case 'b':
+      config->binary_output = true;
+      break;
+    case 'P':
+      config->perf_counters = true;
+      break;
+    case 'j':
+      config->jobs = value;
+      break;
     case ARGP_KEY_ARG:
       config->positional.push_back(value);
       break;
@@ -125,6 +158,48 @@ void print_version()
                        << std::flush;
 }
 
+// Solve the jobs in `config.jobs` in this process.
+static int run_batch(const Config& config)
+{
+  if (config.binary_output)
+  {
+    throw utils::ValueException("Batches are written as json lines; "
+                                "--binary-output is not supported.");
+  }
+  app::BatchRunner batch;
+  batch.set_output_benchmark(!config.no_benchmark_output);
+  batch.set_parameter_file(config.parameter_file);
+  if (config.solver != "") batch.set_solver(config.solver);
+  if (config.cache_dir != "") batch.set_cache_dir(config.cache_dir);
+  batch.set_merge_duplicate_terms(config.merge_terms);
+  batch.add_jobs(config.jobs);
+  LOG(INFO, "Running ", batch.get_jobs().size(), " jobs from ", config.jobs);
+
+  size_t failed;
+  if (config.output_file != "")
+  {
+    LOG(INFO, "Writing ", config.output_file);
+    std::ofstream out(config.output_file, std::ios::binary);
+    failed = batch.run(out);
+    out.close();
+    if (!out)
+    {
+      THROW(utils::FileWriteException, "Unable to write file ",
+            config.output_file, ".");
+    }
+  }
+  else
+  {
+    failed = batch.run(std::cout);
+  }
+  if (failed > 0)
+  {
+    LOG(WARN, failed, " of ", batch.get_jobs().size(), " jobs failed.");
+    return 16;
+  }
+  return EX_OK;
+}
+
 int main(int argc, char** argv)
 {
   Config config;
@@ -137,6 +212,11 @@ int main(int argc, char** argv)
   config.user_friendly_mode = false;
   config.no_benchmark_output = false;
   config.memory_saving = false;
+  config.merge_terms = false;
+  config.binary_output = false;
+  config.perf_counters = false;
+  config.cache_dir = "";
+  config.jobs = "";
 
   try
   {
@@ -164,7 +244,7 @@ int main(int argc, char** argv)
     // throw MissingInputException("No input file specified (-i)");
     // throw MissingInputException("No solver specified (-s)");
 
-    if (config.parameter_file == "")
+    if (config.parameter_file == "" && config.jobs == "")
     {
       throw MissingInputException("No parameter file specified (-p)");
     }
@@ -177,29 +257,56 @@ int main(int argc, char** argv)
       utils::set_enabled_feature({utils::Features::FEATURE_USE_MEMORY_SAVING});
     }
 
+    if (config.merge_terms)
+    {
+      LOG(INFO, "Merging terms with the same variables.");
+    }
+
+    if (config.perf_counters)
+    {
+      LOG(INFO, "Recording hardware counters.");
+      utils::set_enabled_feature({utils::Features::FEATURE_PERF_COUNTERS});
+    }
+
+    if (config.jobs != "")
+    {
+      return run_batch(config);
+    }
+
     std::unique_ptr<app::Runner> runner_ptr(get_runner());
     auto& runner = *runner_ptr.get();
     runner.set_output_benchmark(!config.no_benchmark_output);
+    runner.set_binary_output(config.binary_output);
     runner.set_parameter_file(config.parameter_file);
     if (config.input_file != "") runner.set_input_file(config.input_file);
     if (config.solver != "") runner.set_solver(config.solver);
+    if (config.cache_dir != "") runner.set_cache_dir(config.cache_dir);
+    runner.set_merge_duplicate_terms(config.merge_terms);
 
     LOG_MEMORY_USAGE("start of configure");
     runner.configure();
 
     LOG_MEMORY_USAGE("start of running solver");
     LOG(INFO, "Running solver ", runner.get_solver()->get_identifier());
-    std::string result = runner.run();
+    utils::Structure response = runner.get_response();
 
     if (config.output_file != "")
     {
       LOG(INFO, "Writing ", config.output_file);
-      utils::write_file(config.output_file, result);
+      std::ofstream out(config.output_file, std::ios::binary);
+      runner.write_response(response, &out);
+      out.close();
+      if (!out)
+      {
+        THROW(utils::FileWriteException, "Unable to write file ",
+              config.output_file, ".");
+      }
     }
     else
     {
       LOG(INFO, "Writing Response to stdout");
-      std::cout << result << std::endl;
+      runner.write_response(response, &std::cout);
+      if (!config.binary_output) std::cout << std::endl;
     }
 
     return EX_OK;
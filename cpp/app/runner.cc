@@ -1,10 +1,15 @@
 
 #include "runner.h"
 
+#include <math.h>
+
 #include <cstring>
+#include <sstream>
 
+#include "../utils/binary_solution.h"
 #include "../utils/exception.h"
 #include "../utils/file.h"
+#include "../utils/instrumentation.h"
 #include "../utils/json.h"
 #include "../utils/log.h"
 #include "../utils/metadata.h"
@@ -12,9 +17,12 @@
 #include "../utils/proto_reader.h"
 #include "../utils/stream_handler.h"
 #include "../utils/stream_handler_json.h"
+#include "../utils/structure_writer.h"
 #include "../utils/timing.h"
 #include "../graph/properties.h"
 #include "../model/all_models.h"
+#include "../model/binary_problem.h"
+#include "../model/problem_cache.h"
 #include "../model/terms.h"
 #include "../solver/all_solvers.h"
 #include "rapidjson/document.h"
@@ -32,10 +40,54 @@ using graph::get_graph_attributes;
 using graph::get_graph_node_count;
 using graph::GraphAttributes;
 
+namespace
+{
+// Number of variables of the graph problem in `input`.
+size_t get_node_count(model::GraphModelConfiguration& input)
+{
+  const auto* normalized =
+      model::GraphModelConfiguration::Get_Normalized::get(input);
+  if (normalized != nullptr) return normalized->node_count;
+  return get_graph_node_count(
+      model::GraphModelConfiguration::Get_Edges::get(input));
+}
+
+// Largest number of variables in a term of the graph problem in `input`.
+size_t get_max_nodes_in_term(model::GraphModelConfiguration& input)
+{
+  const auto* normalized =
+      model::GraphModelConfiguration::Get_Normalized::get(input);
+  if (normalized != nullptr) return normalized->properties.max_locality_;
+  return get_graph_attributes(
+             model::GraphModelConfiguration::Get_Edges::get(input))
+      .max_nodes_in_term;
+}
+
+// Value of a rendered (integer) configuration entry.
+int get_int(const utils::Structure& value)
+{
+  switch (value.get_type())
+  {
+    case utils::Structure::INT32:
+      return value.get<int32_t>();
+    case utils::Structure::UINT32:
+      return (int)value.get<uint32_t>();
+    case utils::Structure::INT64:
+      return (int)value.get<int64_t>();
+    case utils::Structure::UINT64:
+      return (int)value.get<uint64_t>();
+    default:
+      THROW(InvalidTypesException, "Expected an integer configuration value, ",
+            "found '", value.to_string(false), "'.");
+  }
+}
+}  // namespace
+
 void Runner::configure()
 {
   double start_time = get_wall_time();
   double start_cputime = get_cpu_time();
+  utils::reset_phases();
   if (parameter_file_.empty())
     throw MissingInputException("No parameter_file specified");
   LOG(INFO, "Reading file: ", parameter_file_);
@@ -84,8 +136,11 @@ void Runner::configure()
         utils::ends_with(input_file_, ".wcnf"))
     {
       LOG(INFO, "Parsing ", input_file_, " as DIMACS CNF.");
-      utils::Dimacs dimacs;
-      dimacs.read_file(input_file_);
+      utils::DimacsReader dimacs;
+      {
+        utils::ScopedPhase phase("parse");
+        dimacs.read_file(input_file_);
+      }
       configure(dimacs, params, target_);
     }
     else
@@ -105,6 +160,7 @@ void Runner::configure(const std::string& json)
 {
   double start_time = get_wall_time();
   double start_cputime = get_cpu_time();
+  utils::reset_phases();
 
   auto config = utils::json_from_string(json);
   std::string target;
@@ -119,7 +175,20 @@ void Runner::configure(const std::string& json)
         .description("uri to read input data from")
         .required();
     LOG(INFO, "Reading ", input_data_uri);
-    configure(input_data_uri, config, target);
+    if (utils::ends_with(input_data_uri, ".cnf") ||
+        utils::ends_with(input_data_uri, ".wcnf"))
+    {
+      utils::DimacsReader dimacs;
+      {
+        utils::ScopedPhase phase("parse");
+        dimacs.read_file(input_data_uri);
+      }
+      configure(dimacs, config, target);
+    }
+    else
+    {
+      configure(input_data_uri, config, target);
+    }
   }
   else
   {
@@ -202,12 +271,18 @@ solver::ModelSolver<::model::Poly>* create_model_solver(const std::string&)
   {                                                            \
     selected_model = model_type;                               \
     std::unique_ptr<Model_T> model_ptr(new Model_T);           \
-    model_ptr->configure(input);                               \
-    model_ptr->init();                                         \
+    {                                                          \
+      utils::ScopedPhase phase("model_init");                  \
+      model_ptr->configure(input);                             \
+      model_ptr->init();                                       \
+    }                                                          \
     auto* model_solver = create_model_solver<Model_T>(target); \
     model_solver->set_model(model_ptr.get());                  \
     model_ = std::move(model_ptr);                             \
-    model_solver->configure(params);                           \
+    {                                                          \
+      utils::ScopedPhase phase("solver_configure");            \
+      model_solver->configure(params);                         \
+    }                                                          \
     solver_.reset(model_solver);                               \
   }
 
@@ -218,39 +293,79 @@ void Runner::configure(const std::string& input_file, const utils::Json& params,
   std::string selected_model = "";
 
   model::BaseModelPreviewConfiguration input_preview;
+  // Binary problem files are mapped rather than parsed; they only exist for
+  // (already normalized) graph models.
+  model::BinaryProblem binary_problem;
+  bool is_binary = false;
 
   // The protobuf message folder ends with .pb
   // This is constructed internally and we control it's naming
   if (utils::isFolder(input_file))
   {
     LOG(INFO, "Parsing the problem data ", input_file, "in protobuf");
+    utils::ScopedPhase phase("parse");
     utils::configure_from_proto_folder(input_file, input_preview);
+    model_type_ =
+        model::BaseModelPreviewConfiguration::Get_Type::get(input_preview);
+  }
+  else if (model::BinaryProblem::is_binary_problem(input_file))
+  {
+    LOG(INFO, "Mapping the binary problem ", input_file);
+    binary_problem.open(input_file);
+    is_binary = true;
+    model_type_ = binary_problem.type();
   }
   else
   {
+    utils::ScopedPhase phase("parse");
     utils::configure_from_json_file(input_file, input_preview);
+    model_type_ =
+        model::BaseModelPreviewConfiguration::Get_Type::get(input_preview);
   }
 
-  model_type_ =
-      model::BaseModelPreviewConfiguration::Get_Type::get(input_preview);
   const std::string& model_type = model_type_;
+  bool is_graph_model = model_type == "blume-capel" || model_type == "ising" ||
+                        model_type == "pubo";
+
+  // With a cache directory, graph model inputs are looked up in (and added
+  // to) the cache of binary problems; other models cannot be cached.
+  model::ProblemCache cache(cache_dir_, merge_duplicate_terms_);
+  std::string cache_key;
+  if (!cache_dir_.empty() && !is_binary && is_graph_model)
+  {
+    cache_key = cache.key(input_file);
+    is_binary = cache.lookup(cache_key, binary_problem);
+  }
 
-  if (model_type == "blume-capel" || model_type == "ising" ||
-      model_type == "pubo")
+  if (is_graph_model)
   {
     model::GraphModelConfiguration input;
+    model::GraphModelConfiguration::Get_MergeDuplicateTerms::get(input) =
+        merge_duplicate_terms_;
 
-    utils::memory_check_using_file_size(input_file, 1.0);
-    if (utils::isFolder(input_file))
+    if (is_binary)
     {
+      binary_problem.configure(input);
+    }
+    else if (utils::isFolder(input_file))
+    {
+      utils::memory_check_using_file_size(input_file, 1.0);
       LOG(INFO, "Parsing problem terms", input_file, "in protobuf");
-      utils::configure_from_proto_folder<model::GraphModelConfiguration>(
+      utils::ScopedPhase phase("parse");
+      utils::configure_graph_from_proto_folder<model::GraphModelConfiguration>(
           input_file, input);
     }
     else
     {
-      utils::configure_from_json_file<model::GraphModelConfiguration>(input_file,
-                                                                     input);
+      utils::memory_check_using_file_size(input_file, 1.0);
+      utils::ScopedPhase phase("parse");
+      utils::configure_graph_from_json_file<model::GraphModelConfiguration>(
+          input_file, input);
+    }
+    if (!is_binary && !cache_key.empty() &&
+        cache.store(cache_key, input, binary_problem))
+    {
+      binary_problem.configure(input);
     }
 
     // Try instantiating each model (this checks the model identifier
@@ -263,8 +378,7 @@ void Runner::configure(const std::string& input_file, const utils::Json& params,
     {
       if (memory_saving_enabled())
       {
-        size_t nodes_count = get_graph_node_count(
-            model::GraphModelConfiguration::Get_Edges::get(input));
+        size_t nodes_count = get_node_count(input);
         if (nodes_count <= UINT8_MAX - 2)
         {
           LOG(INFO,
@@ -300,8 +414,7 @@ void Runner::configure(const std::string& input_file, const utils::Json& params,
     {
       if (memory_saving_enabled())
       {
-        size_t nodes_count = get_graph_node_count(
-            model::GraphModelConfiguration::Get_Edges::get(input));
+        size_t nodes_count = get_node_count(input);
         if (nodes_count <= UINT8_MAX - 2)
         {
           LOG(INFO,
@@ -327,26 +440,21 @@ void Runner::configure(const std::string& input_file, const utils::Json& params,
       }
       else
       {
-        GraphAttributes graph_attributes = get_graph_attributes(
-            model::GraphModelConfiguration::Get_Edges::get(input));
+        size_t max_nodes_in_term = get_max_nodes_in_term(input);
 
-        if (graph_attributes.max_nodes_in_term <=
-            std::numeric_limits<uint8_t>::max())
+        if (max_nodes_in_term <= std::numeric_limits<uint8_t>::max())
         {
           SELECT_MODEL("pubo", ::model::PuboWithCounter<uint8_t>);
         }
-        else if (graph_attributes.max_nodes_in_term <=
-                 std::numeric_limits<uint16_t>::max())
+        else if (max_nodes_in_term <= std::numeric_limits<uint16_t>::max())
         {
           SELECT_MODEL("pubo", ::model::PuboWithCounter<uint16_t>);
         }
-        else if (graph_attributes.max_nodes_in_term <=
-                 std::numeric_limits<uint32_t>::max())
+        else if (max_nodes_in_term <= std::numeric_limits<uint32_t>::max())
         {
           SELECT_MODEL("pubo", ::model::PuboWithCounter<uint32_t>);
         }
-        else if (graph_attributes.max_nodes_in_term <=
-                 std::numeric_limits<uint64_t>::max())
+        else if (max_nodes_in_term <= std::numeric_limits<uint64_t>::max())
         {
           SELECT_MODEL("pubo", ::model::PuboWithCounter<uint64_t>);
         }
@@ -363,7 +471,10 @@ void Runner::configure(const std::string& input_file, const utils::Json& params,
     model::FacedGraphModelConfiguration input;
 
     utils::memory_check_using_file_size(input_file, 1.0);
-    utils::configure_from_json_file(input_file, input);
+    {
+      utils::ScopedPhase phase("parse");
+      utils::configure_from_json_file(input_file, input);
+    }
 
     SELECT_MODEL("ising_grouped", ::model::IsingGrouped);
 
@@ -398,21 +509,30 @@ void Runner::configure(const std::string& input_file, const utils::Json& params,
   {
     model::ClockConfiguration input;
     utils::memory_check_using_file_size(input_file, 1.0);
-    utils::configure_from_json_file(input_file, input);
+    {
+      utils::ScopedPhase phase("parse");
+      utils::configure_from_json_file(input_file, input);
+    }
     SELECT_MODEL("clock", ::model::Clock);
   }
   else if (model_type == "tsp")
   {
     model::TspConfiguration input;
     utils::memory_check_using_file_size(input_file, 1.0);
-    utils::configure_from_json_file(input_file, input);
+    {
+      utils::ScopedPhase phase("parse");
+      utils::configure_from_json_file(input_file, input);
+    }
     SELECT_MODEL("tsp", ::model::Tsp);
   }
   else if (model_type == "poly")
   {
     model::PolyConfiguration input;
     utils::memory_check_using_file_size(input_file, 1.0);
-    utils::configure_from_json_file(input_file, input);
+    {
+      utils::ScopedPhase phase("parse");
+      utils::configure_from_json_file(input_file, input);
+    }
     SELECT_MODEL("poly", ::model::Poly);
   }
   else if (model_type == "maxsat")
@@ -420,7 +540,10 @@ void Runner::configure(const std::string& input_file, const utils::Json& params,
     std::unique_ptr<::model::MaxSat32> maxsat(new ::model::MaxSat32());
     utils::memory_check_using_file_size(input_file, 1.0);
     model::MaxSatConfiguration input;
-    utils::configure_from_json_file(input_file, input);
+    {
+      utils::ScopedPhase phase("parse");
+      utils::configure_from_json_file(input_file, input);
+    }
     maxsat->configure(input);
     select_max_sat_implementation(maxsat.get(), params, target);
   }
@@ -429,7 +552,8 @@ void Runner::configure(const std::string& input_file, const utils::Json& params,
 }
 
 /// Handling of parsed dimacs
-void Runner::configure(const utils::Dimacs& dimacs, const utils::Json& params,
+void Runner::configure(const utils::DimacsReader& dimacs,
+                       const utils::Json& params,
                        const std::string& solver_name)
 {
   std::unique_ptr<::model::MaxSat32> maxsat(new ::model::MaxSat32());
@@ -517,16 +641,18 @@ utils::Structure Runner::get_run_output()
   double start_cputime = get_cpu_time();
   try
   {
+    utils::ScopedPhase phase("solver_init");
     solver_->init();
   }
   catch (const utils::MemoryLimitedException& e)
   {
-    if (memory_saving_retry())
+    if (allow_memory_saving_retry_ && memory_saving_retry())
     {
       LOG(INFO, "Retry to use memory saving model");
       reset_for_memory_saving();
       utils::set_enabled_feature({utils::Features::FEATURE_USE_MEMORY_SAVING});
       configure();
+      utils::ScopedPhase phase("solver_init");
       solver_->init();
     }
     else
@@ -540,6 +666,7 @@ utils::Structure Runner::get_run_output()
   utils::Structure init_soln;
   if (output_benchmark_) 
   {
+    utils::ScopedPhase phase("render");
     init_soln = solver_->get_result(); 
   }
 
@@ -549,7 +676,14 @@ utils::Structure Runner::get_run_output()
   double solver_end_time = get_wall_time();
   double execution_time_ms = 1000 * (solver_end_time - solver_start_time);
   solver_->finalize();
-  auto response = solver_->get_result();
+  // Configurations are written directly from the solver's states (see
+  // `write_response`).
+  solver_->set_defer_configurations(true);
+  utils::Structure response;
+  {
+    utils::ScopedPhase phase("render");
+    response = solver_->get_result();
+  }
 
   double execution_cputime_ms = 1000 * (get_cpu_time() - start_cputime);
 
@@ -568,7 +702,6 @@ utils::Structure Runner::get_run_output()
   {
     response[utils::kBenchmark]["solver"] = solver_->get_solver_properties();
   }
-  solver_.reset();
 
   response[utils::kBenchmark][utils::kDiskIOReadBytes] = input_size_bytes_;
 
@@ -611,17 +744,29 @@ utils::Structure Runner::get_run_output()
     response["solutions"]["solutions"].prepend(std::vector<utils::Structure> {init_soln["solutions"]});
   }
 
+  // Breakdown of the phases so far (the serialization of the response is
+  // included in postprocessing_time_ms).
+  response[utils::kBenchmark][utils::kPhases] = utils::render_phases();
+
   // Calculate the size of the output and denote both input & output sizes
-  // as the io_{read,write} bytes in the benchmark stats.
-  int output_size_bytes = (int)(response.to_string().size() +
-                                strlen("    \"disk_io_write_bytes\": ,\n"));
-  int output_size_digits = (int)floor(log10(output_size_bytes));
-  if (output_size_digits < floor(log10(output_size_bytes + output_size_digits)))
-  {
-    output_size_digits++;
+  // as the io_{read,write} bytes in the benchmark stats. The counting writer
+  // only adds up the sizes of the configurations (without formatting them);
+  // the binary output sets its size when written (see
+  // `write_binary_response`).
+  if (!binary_output_)
+  {
+    int output_size_bytes =
+        (int)(write_response(response, nullptr) +
+              strlen("    \"disk_io_write_bytes\": ,\n"));
+    int output_size_digits = (int)floor(log10(output_size_bytes));
+    if (output_size_digits <
+        floor(log10(output_size_bytes + output_size_digits)))
+    {
+      output_size_digits++;
+    }
+    output_size_bytes += output_size_digits + 1;
+    response[utils::kBenchmark][utils::kDiskIOWriteBytes] = output_size_bytes;
   }
-  output_size_bytes += output_size_digits + 1;
-  response[utils::kBenchmark][utils::kDiskIOWriteBytes] = output_size_bytes;
 
   double postprocess_ms = 1000 * (get_wall_time() - solver_end_time);
   response[utils::kBenchmark][utils::kPreprocessingMs] = preprocess_ms;
@@ -631,17 +776,127 @@ utils::Structure Runner::get_run_output()
 }
 
 std::string Runner::run()
+{
+  utils::Structure response = get_response();
+  std::stringstream out;
+  write_response(response, &out);
+  return out.str();
+}
+
+utils::Structure Runner::get_response()
 {
   utils::Structure response = get_run_output();
 
   if (!output_benchmark_)
   {
     metric_to_console(response[utils::kBenchmark]);
-    return response["solutions"].to_string();
+    return response["solutions"];
   }
 
   // end2end_time_ms also doesn't include serialization of the response.
-  return response.to_string();
+  return response;
+}
+
+size_t Runner::write_response(const utils::Structure& response,
+                              std::ostream* out, bool pretty)
+{
+  if (binary_output_) return write_binary_response(response, out);
+  utils::StructureWriter writer(out, pretty);
+  writer.set_deferred_handler(
+      [this](size_t index, utils::StructureWriter& configuration_writer) {
+        solver_->write_configuration(index, configuration_writer);
+      });
+  writer.write(response);
+  return writer.bytes_written();
+}
+
+size_t Runner::write_binary_response(const utils::Structure& response,
+                                     std::ostream* out)
+{
+  std::vector<int> names;
+  utils::SolutionEncoding encoding;
+  if (!solver_->get_binary_variables(names, encoding))
+  {
+    THROW(utils::ValueException, "Binary output is not supported for the '",
+          model_type_, "' model with solver '", target_, "'.");
+  }
+
+  // Take the configurations out of the response, which becomes the
+  // metadata.
+  utils::Structure metadata = response;
+  utils::Structure& solutions = metadata.has_key(utils::kBenchmark)
+                                    ? metadata["solutions"]
+                                    : metadata;
+  std::vector<double> costs;
+  std::vector<utils::Structure> configurations;
+  auto take = [&](utils::Structure& solution) {
+    if (!solution.has_key("configuration")) return;
+    costs.push_back(solution["cost"].get<double>());
+    configurations.push_back(solution["configuration"]);
+    solution.remove("configuration");
+  };
+  double cost = NAN;
+  if (solutions.has_key("cost")) cost = solutions["cost"].get<double>();
+  if (solutions.has_key("solutions"))
+  {
+    for (size_t i = 0; i < solutions["solutions"].get_array_size(); i++)
+    {
+      take(solutions["solutions"][i]);
+    }
+    if (solutions.has_key("configuration")) solutions.remove("configuration");
+  }
+  else
+  {
+    take(solutions);
+  }
+
+  std::string rendered_metadata = metadata.to_string(false);
+  if (metadata.has_key(utils::kBenchmark))
+  {
+    // The size of the file only depends on that of the metadata (which
+    // reports it), not on the values of the configurations.
+    size_t size = 0;
+    while (true)
+    {
+      size_t file_size = utils::BinarySolutionWriter::file_size(
+          rendered_metadata.size(), names.size(), encoding,
+          configurations.size());
+      if (file_size == size) break;
+      size = file_size;
+      metadata[utils::kBenchmark][utils::kDiskIOWriteBytes] = (int)size;
+      rendered_metadata = metadata.to_string(false);
+    }
+  }
+
+  utils::BinarySolutionWriter writer(out);
+  writer.write_header(rendered_metadata, cost, names, encoding,
+                      configurations.size());
+  std::vector<int> values;
+  for (size_t i = 0; i < configurations.size(); i++)
+  {
+    const utils::Structure& configuration = configurations[i];
+    size_t index;
+    if (utils::StructureWriter::is_deferred(configuration, index))
+    {
+      solver_->get_binary_values(index, values);
+    }
+    else
+    {
+      // A rendered configuration (e.g., of the initial state): an array
+      // indexed like `names` or an object keyed by the names.
+      values.resize(names.size());
+      for (size_t j = 0; j < names.size(); j++)
+      {
+        const utils::Structure& value =
+            configuration.get_type() == utils::Structure::ARRAY
+                ? configuration[j]
+                : configuration[std::to_string(names[j])];
+        values[j] = get_int(value);
+      }
+    }
+    writer.write_solution(costs[i], values);
+  }
+  return writer.bytes_written();
 }
 
 void Runner::copy_if_present(const std::string& key, const utils::Structure& src,
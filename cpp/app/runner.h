@@ -2,9 +2,10 @@
 #pragma once
 
 #include <memory>
+#include <ostream>
 #include <string>
 
-#include "utils/dimacs.h"
+#include "utils/dimacs_reader.h"
 #include "utils/json.h"
 #include "markov/model.h"
 #include "model/max_sat.h"
@@ -36,6 +37,9 @@ class Runner
  public:
   Runner()
       : output_benchmark_(true),
+        binary_output_(false),
+        allow_memory_saving_retry_(true),
+        merge_duplicate_terms_(false),
         input_size_bytes_(0),
         configure_time_ms_(0.0),
         configure_cputime_ms_(0.0)
@@ -46,12 +50,32 @@ class Runner
   virtual ~Runner() {}
 
   void set_output_benchmark(bool value) { output_benchmark_ = value; }
+
+  /// Write the response in the binary solution format (see
+  /// `utils::BinarySolutionWriter`) instead of json.
+  void set_binary_output(bool value) { binary_output_ = value; }
   void set_input_file(std::string file_path) { input_file_ = file_path; }
   void set_parameter_file(std::string file_path)
   {
     parameter_file_ = file_path;
   }
   virtual void set_solver(std::string target) { target_ = target; }
+
+  /// Whether a run exceeding the memory limit is retried with the memory
+  /// saving model. The retry enables `FEATURE_USE_MEMORY_SAVING`, which is
+  /// process-wide; concurrent runs must disable it (and the
+  /// `MemoryLimitedException` is thrown instead).
+  void set_allow_memory_saving_retry(bool value)
+  {
+    allow_memory_saving_retry_ = value;
+  }
+
+  /// Directory in which normalized graph problems are cached between runs
+  /// (disabled if empty).
+  void set_cache_dir(std::string cache_dir) { cache_dir_ = cache_dir; }
+
+  /// Whether graph models merge the terms with the same set of variables.
+  void set_merge_duplicate_terms(bool value) { merge_duplicate_terms_ = value; }
   std::string get_target() { return this->target_; }
 
   void configure();
@@ -75,11 +99,30 @@ class Runner
   /// This calls `Solver::init()` followed by `Solver::run()`.
   ///
   /// NOTE: `Response.benchmark.execution_time_ms` will reflect the time spent
-  /// in this method (excluding `Structure::to_string()` converting the
-  /// response to string, because that happens after the time measurement is
-  /// written into the response)
+  /// in this method (excluding `write_response()` converting the response to
+  /// string, because that happens after the time measurement is written into
+  /// the response)
   virtual std::string run();
 
+  /// Run the simulation and return the response to output.
+  ///
+  /// The configurations in the response are placeholders, which
+  /// `write_response()` renders from the solver's states.
+  utils::Structure get_response();
+
+  /// Write `response` (from `get_response()` or `get_run_output()`) to `out`
+  /// and return the number of bytes written (or, if `out` is nullptr, the
+  /// number of bytes which would be written).
+  ///
+  /// With `pretty` false, json output is written on a single line.
+  size_t write_response(const utils::Structure& response, std::ostream* out,
+                        bool pretty = true);
+
+  /// Write `response` in the binary solution format: the configurations
+  /// are written as values, the rest of the response as json metadata.
+  size_t write_binary_response(const utils::Structure& response,
+                               std::ostream* out);
+
   virtual utils::Structure get_run_output();
 
   ::solver::Solver* get_solver() const { return solver_.get(); }
@@ -106,14 +149,15 @@ class Runner
 
   std::unique_ptr<::solver::Solver> solver_;
   bool output_benchmark_;
+  bool binary_output_;
 
  private:
   virtual void configure(const std::string& input, const utils::Json& parameters,
                          const std::string& solver_name);
 
   /// Handle dimacs input for max-sat.
-  void configure(const utils::Dimacs& dimacs, const utils::Json& parameters,
-                 const std::string& solver_name);
+  void configure(const utils::DimacsReader& dimacs,
+                 const utils::Json& parameters, const std::string& solver_name);
 
   /// Select a suitable implementation (i.e., Counter_T size) for
   /// the max sat model.
@@ -155,6 +199,9 @@ class Runner
   std::string parameter_file_;
   std::string target_;
   std::string model_type_;
+  std::string cache_dir_;
+  bool allow_memory_saving_retry_;
+  bool merge_duplicate_terms_;
 
   /// Private (owned) pointer to the solver instantiated
   /// (e.g. an `solver::ParallelTempering<model::Ising>`)
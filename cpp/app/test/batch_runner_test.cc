@@ -0,0 +1,109 @@
+
+#include "app/batch_runner.h"
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#include "utils/config.h"
+#include "utils/exception.h"
+#include "utils/file.h"
+#include "utils/json.h"
+#include "gtest/gtest.h"
+
+using app::BatchRunner;
+
+namespace
+{
+const char kJobFile[] = "batch_runner_test.jobs";
+
+void write_job_file(const std::string& content)
+{
+  std::ofstream out(kJobFile);
+  out << content;
+}
+}  // namespace
+
+TEST(BatchRunner, JobFile)
+{
+  write_job_file(
+      "# input parameters\n"
+      "a.json  params.json\n"
+      "\n"
+      "   b.json\n");
+  BatchRunner batch;
+  batch.set_parameter_file("default.json");
+  batch.add_jobs(kJobFile);
+  const auto& jobs = batch.get_jobs();
+  ASSERT_EQ(jobs.size(), 2u);
+  EXPECT_EQ(jobs[0].input_file, "a.json");
+  EXPECT_EQ(jobs[0].parameter_file, "params.json");
+  EXPECT_EQ(jobs[1].input_file, "b.json");
+  EXPECT_EQ(jobs[1].parameter_file, "default.json");
+
+  write_job_file("a.json params.json extra\n");
+  EXPECT_THROW(batch.add_jobs(kJobFile), utils::ParsingException);
+  EXPECT_THROW(batch.add_jobs("missing.jobs"), utils::FileReadException);
+  std::remove(kJobFile);
+}
+
+TEST(BatchRunner, Run)
+{
+  BatchRunner batch;
+  batch.set_parameter_file(utils::data_path("params1.json"));
+  batch.set_solver("simulatedannealing.qiotoolkit");
+  batch.add_job(utils::data_path("ising1.json"));
+  batch.add_job(utils::data_path("missing.json"));
+  batch.add_job(utils::data_path("ising1.json"));
+
+  std::stringstream out;
+  EXPECT_EQ(batch.run(out), 1u);
+
+  // One line per job, in the order of completion.
+  std::vector<bool> seen(3, false);
+  std::string line;
+  size_t lines = 0;
+  while (std::getline(out, line))
+  {
+    lines++;
+    auto record = utils::json_from_string(line);
+    size_t job = record["job"].GetUint64();
+    ASSERT_LT(job, 3u);
+    seen[job] = true;
+    if (job == 1)
+    {
+      EXPECT_TRUE(record.HasMember("error"));
+      EXPECT_FALSE(record.HasMember("response"));
+    }
+    else
+    {
+      EXPECT_FALSE(record.HasMember("error"));
+      EXPECT_TRUE(record["response"]["solutions"].HasMember("configuration"));
+      // Each job has its own phases (even when solved concurrently).
+      const auto& phases = record["response"]["benchmark"]["phases"];
+      EXPECT_EQ(phases["model_init"]["count"].GetUint64(), 1u);
+      EXPECT_TRUE(phases.HasMember("steps"));
+    }
+  }
+  EXPECT_EQ(lines, 3u);
+  EXPECT_EQ(seen, std::vector<bool>(3, true));
+}
+
+TEST(BatchRunner, FeaturesDoNotLeak)
+{
+  // Jobs enabling features run on their own, which is not seen by later
+  // jobs (nor after the batch).
+  utils::initialize_features();
+  BatchRunner batch;
+  batch.set_parameter_file(utils::data_path("params1.json"));
+  batch.set_solver("simulatedannealing.qiotoolkit");
+  batch.add_job(utils::data_path("ising1.json"),
+                utils::data_path("batch_features.json"));
+  batch.add_job(utils::data_path("ising1.json"));
+
+  std::stringstream out;
+  EXPECT_EQ(batch.run(out), 0u);
+  EXPECT_FALSE(
+      utils::feature_enabled(utils::Features::FEATURE_PA_EXP_REPOPULATION));
+}
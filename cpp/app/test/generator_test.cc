@@ -0,0 +1,155 @@
+
+#include "app/generator.h"
+
+#include <omp.h>
+
+#include <set>
+#include <sstream>
+#include <string>
+
+#include "utils/dimacs_reader.h"
+#include "utils/exception.h"
+#include "utils/stream_handler_json.h"
+#include "model/ising.h"
+#include "gtest/gtest.h"
+
+using app::GeneratorConfig;
+using app::ProblemGenerator;
+using app::TermBlock;
+
+namespace
+{
+std::string generate_json(const GeneratorConfig& config)
+{
+  std::stringstream out;
+  ProblemGenerator(config).write(out, ProblemGenerator::JSON);
+  return out.str();
+}
+}  // namespace
+
+TEST(Generator, Reproducible)
+{
+  GeneratorConfig config;
+  config.family = "planted";
+  config.variables = 1000;
+  // Loops of length 7 span the blocks.
+  config.loop_length = 7;
+  config.terms = 2 * ProblemGenerator::kBlockSize + 100;
+  config.seed = 3;
+
+  int max_threads = omp_get_max_threads();
+  omp_set_num_threads(1);
+  std::string single = generate_json(config);
+  omp_set_num_threads(3);
+  std::string multiple = generate_json(config);
+  omp_set_num_threads(max_threads);
+  EXPECT_EQ(single, multiple);
+
+  config.seed = 4;
+  EXPECT_NE(generate_json(config), single);
+}
+
+TEST(Generator, TermCounts)
+{
+  GeneratorConfig config;
+  config.variables = 100;
+  config.locality = 4;
+  ProblemGenerator pubo(config);
+  EXPECT_EQ(pubo.type(), "pubo");
+  EXPECT_EQ(pubo.term_count(), 400u);
+  TermBlock block;
+  pubo.generate(0, ProblemGenerator::kBlockSize, block);
+  ASSERT_EQ(block.size(), 400u);
+  for (size_t t = 0; t < block.size(); t++)
+  {
+    std::set<int64_t> ids(block.ids.begin() + block.offsets[t],
+                          block.ids.begin() + block.offsets[t + 1]);
+    EXPECT_EQ(ids.size(), 4u);
+    EXPECT_GE(*ids.begin(), 0);
+    EXPECT_LT(*ids.rbegin(), 100);
+    EXPECT_GE(block.costs[t], -1);
+    EXPECT_LT(block.costs[t], 1);
+  }
+
+  config.family = "ea3d";
+  config.variables = 4;
+  ProblemGenerator ea(config);
+  EXPECT_EQ(ea.type(), "ising");
+  EXPECT_EQ(ea.variable_count(), 64u);
+  EXPECT_EQ(ea.term_count(), 192u);
+  // Site 3 = (3, 0, 0) wraps around to (0, 0, 0) in the first direction.
+  ea.generate(0, ProblemGenerator::kBlockSize, block);
+  EXPECT_EQ(block.ids[2 * 9], 3);
+  EXPECT_EQ(block.ids[2 * 9 + 1], 0);
+
+  config.family = "unknown";
+  EXPECT_THROW(ProblemGenerator{config}, std::exception);
+  config.family = "pubo";
+  config.locality = 51;
+  EXPECT_THROW(ProblemGenerator{config}, std::exception);
+}
+
+TEST(Generator, PlantedOptimum)
+{
+  // Each of the 16 variables is part of many loops.
+  GeneratorConfig config;
+  config.family = "planted";
+  config.variables = 16;
+  config.terms = 800;
+  config.seed = 11;
+  ProblemGenerator generator(config);
+  ASSERT_TRUE(generator.has_solution());
+  std::stringstream problem, solution;
+  generator.write(problem, ProblemGenerator::JSON);
+  generator.write_solution(solution);
+
+  // Solve the problem with the planted configuration as the initial one.
+  std::string text = solution.str();
+  size_t configuration = text.find("\"configuration\":");
+  ASSERT_NE(configuration, std::string::npos);
+  double cost = std::stod(text.substr(8, configuration - 9));
+  EXPECT_EQ(cost, 100 * (2 - 8));
+  std::string input = problem.str();
+  input = input.substr(0, input.rfind("}}")) + ",\"initial_configuration\":" +
+          text.substr(configuration + 16, text.rfind('}') - configuration - 16) +
+          "}}";
+
+  model::Ising ising;
+  utils::configure_with_configuration_from_json_string(input, ising);
+  EXPECT_EQ(ising.calculate_cost(ising.get_initial_configuration_state()),
+            cost);
+}
+
+TEST(Generator, WcnfRoundTrip)
+{
+  // Few clauses with power-law degrees leave most variables unused, which
+  // are dropped from the output.
+  GeneratorConfig config;
+  config.family = "wcnf";
+  config.variables = 50;
+  config.terms = 10;
+  config.communities = 5;
+  config.exponent = 1.5;
+  ProblemGenerator wcnf(config);
+  std::stringstream dimacs;
+  wcnf.write(dimacs, ProblemGenerator::WCNF);
+  std::string text = dimacs.str();
+
+  utils::DimacsReader reader;
+  reader.read(text.data(), text.size());
+  EXPECT_EQ(reader.get_type(), "wcnf");
+  EXPECT_EQ(reader.get_ncl(), 10u);
+  EXPECT_LT(reader.get_nvar(), 50u);
+  // The variables used are numbered consecutively.
+  const auto& variables = reader.get_variables();
+  for (size_t i = 0; i < variables.size(); i++)
+  {
+    EXPECT_EQ(variables[i], (int)i + 1);
+  }
+  TermBlock block;
+  wcnf.generate(0, ProblemGenerator::kBlockSize, block);
+  for (size_t t = 0; t < block.size(); t++)
+  {
+    EXPECT_EQ(reader.get_weights()[t], block.costs[t]);
+  }
+}
@@ -0,0 +1,139 @@
+
+#include "app/tts_runner.h"
+
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "utils/exception.h"
+#include "utils/file.h"
+#include "utils/json.h"
+#include "gtest/gtest.h"
+
+using app::TtsRun;
+using app::TtsRunner;
+
+TEST(TtsRunner, TimeToSolution)
+{
+  EXPECT_NEAR(app::time_to_solution(10, 0.5), 10 * log(0.01) / log(0.5),
+              1e-9);
+  EXPECT_EQ(app::time_to_solution(10, 0.995), 10);
+  EXPECT_EQ(app::time_to_solution(10, 1), 10);
+  EXPECT_TRUE(std::isinf(app::time_to_solution(10, 0)));
+}
+
+TEST(TtsRunner, Summary)
+{
+  std::vector<TtsRun> runs(4);
+  for (size_t i = 0; i < runs.size(); i++)
+  {
+    runs[i].time_ms = 10;
+    runs[i].evaluations = 100;
+    runs[i].success = i < 2;
+    runs[i].time_to_target_ms = (double)i + 1;
+    runs[i].evaluations_to_target = 10 * (i + 1);
+  }
+  runs[3].error = "failed";
+  utils::Structure summary = app::summarize_runs(runs);
+  EXPECT_EQ(summary["runs"].get<uint64_t>(), 3u);
+  EXPECT_EQ(summary["successes"].get<uint64_t>(), 2u);
+  EXPECT_EQ(summary["errors"].get<uint64_t>(), 1u);
+  EXPECT_DOUBLE_EQ(summary["success_probability"].get<double>(), 2. / 3);
+  EXPECT_DOUBLE_EQ(summary["tts99_ms"].get<double>(),
+                   10 * log(0.01) / log(1. / 3));
+  EXPECT_DOUBLE_EQ(summary["ets99"].get<double>(),
+                   100 * log(0.01) / log(1. / 3));
+  EXPECT_DOUBLE_EQ(summary["median_time_to_target_ms"].get<double>(), 1.5);
+  EXPECT_DOUBLE_EQ(summary["median_evaluations_to_target"].get<double>(), 15);
+
+  // Without successes, there is no time to solution.
+  runs[0].success = runs[1].success = false;
+  summary = app::summarize_runs(runs);
+  EXPECT_DOUBLE_EQ(summary["success_probability"].get<double>(), 0);
+  EXPECT_FALSE(summary.has_key("tts99_ms"));
+}
+
+TEST(TtsRunner, ProblemFile)
+{
+  const char kProblemFile[] = "tts_runner_test.problems";
+  const char kSolutionFile[] = "tts_runner_test.solution.json";
+  {
+    std::ofstream solution(kSolutionFile);
+    solution << "{\"cost\": -42, \"configuration\": {}}";
+    std::ofstream problems(kProblemFile);
+    problems << "# input target\n"
+             << "a.json -10.5\n"
+             << "\n"
+             << "b.json " << kSolutionFile << "\n";
+  }
+  TtsRunner tts;
+  tts.add_problems(kProblemFile);
+  const auto& problems = tts.get_problems();
+  ASSERT_EQ(problems.size(), 2u);
+  EXPECT_EQ(problems[0].input_file, "a.json");
+  EXPECT_EQ(problems[0].target_cost, -10.5);
+  EXPECT_EQ(problems[1].input_file, "b.json");
+  EXPECT_EQ(problems[1].target_cost, -42);
+
+  {
+    std::ofstream problems(kProblemFile);
+    problems << "a.json\n";
+  }
+  EXPECT_THROW(tts.add_problems(kProblemFile), utils::ParsingException);
+  std::remove(kProblemFile);
+  std::remove(kSolutionFile);
+}
+
+TEST(TtsRunner, Run)
+{
+  // The optimum of ising1.json is -10.
+  TtsRunner tts;
+  tts.add_problem(utils::data_path("ising1.json"), -10);
+  tts.add_solver("simulatedannealing.qiotoolkit",
+                 utils::data_path("params1.json"));
+  tts.add_solver("simulatedannealing.qiotoolkit",
+                 utils::data_path("missing.json"));
+  tts.set_seeds(3);
+
+  EXPECT_THROW(
+      {
+        std::stringstream out;
+        tts.run(out);
+      },
+      utils::FileReadException);
+
+  TtsRunner valid;
+  valid.add_problem(utils::data_path("ising1.json"), -10);
+  valid.add_problem(utils::data_path("missing.json"), 0);
+  valid.add_solver("simulatedannealing.qiotoolkit",
+                   utils::data_path("params1.json"));
+  valid.set_seeds(3);
+  std::stringstream out;
+  EXPECT_EQ(valid.run(out), 3u);
+
+  auto report = utils::json_from_string(out.str());
+  EXPECT_EQ(report["seeds"].GetUint(), 3u);
+  const auto& solved = report["problems"][0]["solvers"][0];
+  EXPECT_EQ(std::string(solved["target"].GetString()),
+            "simulatedannealing.qiotoolkit");
+  EXPECT_EQ(solved["runs"].GetUint64(), 3u);
+  EXPECT_EQ(solved["successes"].GetUint64(), 3u);
+  EXPECT_EQ(solved["success_probability"].GetDouble(), 1);
+  EXPECT_TRUE(solved.HasMember("tts99_ms"));
+  for (int i = 0; i < 3; i++)
+  {
+    const auto& run = solved["seeds"][i];
+    EXPECT_EQ(run["seed"].GetUint(), (unsigned)(i + 1));
+    EXPECT_EQ(run["cost"].GetDouble(), -10);
+    EXPECT_LE(run["time_to_target_ms"].GetDouble(),
+              run["time_ms"].GetDouble() + 1e-9);
+    EXPECT_LE(run["evaluations_to_target"].GetUint64(),
+              run["evaluations"].GetUint64());
+  }
+  const auto& failed = report["problems"][1]["solvers"][0];
+  EXPECT_EQ(failed["errors"].GetUint64(), 3u);
+  EXPECT_TRUE(failed["seeds"][0].HasMember("error"));
+}
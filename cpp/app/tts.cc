@@ -0,0 +1,236 @@
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "utils/arguments.h"
+#include "utils/config.h"
+#include "utils/exception.h"
+#include "utils/log.h"
+#include "app/tts_runner.h"
+
+/// Time-to-solution benchmark of solvers on problems with known optima.
+///
+///   qiotoolkit-tts --problems problems.txt --seeds 100
+///       --solver simulatedannealing.qiotoolkit=sa.json
+///       --solver paralleltempering.qiotoolkit=pt.json -o report.json
+///
+/// Each solver runs on each problem with the given number of seeds, stopping
+/// at the target cost; the report lists the success probability, TTS99 and
+/// evaluation counts per solver and problem (see `app::TtsRunner`).
+
+const char kProgramDocumentation[] = "qiotoolkit Time-to-Solution Benchmark";
+const char kArgumentDocumentation[] =
+    "Compare the time to solution of solvers on problems with known optima";
+
+using utils::Logger;
+using utils::MissingInputException;
+
+enum LongOptions
+{
+  kFirstSeed = 1000,
+  kTolerance,
+  kTargetCost,
+  kConcurrentRuns,
+};
+
+static struct argp_option kOptions[] = {
+    {"log_level", 'l', "STRING", 0,
+     "Set explicit log level (INFO, WARN, ERROR, FATAL)", 0},
+    {"problems", 'j', "FILE", 0,
+     "Problems to solve: an input file and the target cost (or a solution "
+     "file with the target `cost`) per line",
+     0},
+    {"input", 'i', "FILE", 0, "Single problem to solve (with --target-cost)",
+     0},
+    {"target-cost", kTargetCost, "NUMBER", 0, "Target cost of --input", 0},
+    {"solver", 's', "TARGET[=FILE]", 0,
+     "Solver to benchmark (repeatable), optionally with its parameter file",
+     0},
+    {"parameters", 'p', "FILE", 0,
+     "Parameter file of solvers which do not specify one", 0},
+    {"seeds", 'n', "NUMBER", 0, "Number of runs (seeds) per solver and problem "
+     "(default 100)", 0},
+    {"first-seed", kFirstSeed, "NUMBER", 0, "Seed of the first run (default 1)",
+     0},
+    {"concurrent-runs", kConcurrentRuns, "NUMBER", 0,
+     "Number of runs solved at once, each on a share of the threads "
+     "(default: one per thread)",
+     0},
+    {"tolerance", kTolerance, "NUMBER", 0,
+     "Absolute tolerance when comparing costs to the target (default 1e-6)", 0},
+    {"cache-dir", 'c', "DIR", 0,
+     "Cache normalized graph problems in this directory", 0},
+    {"output", 'o', "FILE", 0, "Report file to write (default: stdout)", 0},
+    {nullptr, 0, nullptr, 0, nullptr, 0},
+};
+
+struct Config
+{
+  std::string log_level;
+  std::string problems;
+  std::string input_file;
+  std::string target_cost;
+  std::vector<std::string> solvers;
+  std::string parameter_file;
+  std::string seeds;
+  std::string first_seed;
+  std::string concurrent_runs;
+  std::string tolerance;
+  std::string cache_dir;
+  std::string output_file;
+};
+
+static error_t ParseOption(int key, char* value, struct argp_state* state)
+{
+  Config* config = static_cast<Config*>(state->input);
+  switch (key)
+  {
+    case 'l':
+      config->log_level = value;
+      break;
+    case 'j':
+      config->problems = value;
+      break;
+    case 'i':
+      config->input_file = value;
+      break;
+    case kTargetCost:
+      config->target_cost = value;
+      break;
+    case 's':
+      config->solvers.push_back(value);
+      break;
+    case 'p':
+      config->parameter_file = value;
+      break;
+    case 'n':
+      config->seeds = value;
+      break;
+    case kFirstSeed:
+      config->first_seed = value;
+      break;
+    case kConcurrentRuns:
+      config->concurrent_runs = value;
+      break;
+    case kTolerance:
+      config->tolerance = value;
+      break;
+    case 'c':
+      config->cache_dir = value;
+      break;
+    case 'o':
+      config->output_file = value;
+      break;
+    case ARGP_KEY_ARG:
+      argp_usage(state);
+      break;
+    case ARGP_KEY_END:
+      break;
+    default:
+      return ARGP_ERR_UNKNOWN;
+  };
+  return 0;
+}
+
+static struct argp argument_parser = {kOptions,
+                                      ParseOption,
+                                      kArgumentDocumentation,
+                                      kProgramDocumentation,
+                                      nullptr,
+                                      nullptr,
+                                      nullptr};
+
+int main(int argc, char** argv)
+{
+  Config config;
+  try
+  {
+    argp_parse(&argument_parser, argc, argv, 0, 0, &config);
+
+    if (config.log_level != "") Logger::set_level(config.log_level);
+    utils::initialize_features();
+
+    app::TtsRunner tts;
+    if (config.problems != "") tts.add_problems(config.problems);
+    if (config.input_file != "")
+    {
+      if (config.target_cost == "")
+      {
+        throw MissingInputException("No target cost specified (--target-cost)");
+      }
+      tts.add_problem(config.input_file, std::stod(config.target_cost));
+    }
+    if (tts.get_problems().empty())
+    {
+      throw MissingInputException("No problems specified (-j or -i)");
+    }
+
+    for (const auto& solver : config.solvers)
+    {
+      size_t separator = solver.find('=');
+      std::string parameter_file = separator == std::string::npos
+                                       ? config.parameter_file
+                                       : solver.substr(separator + 1);
+      if (parameter_file == "")
+      {
+        throw MissingInputException("No parameter file for " + solver +
+                                    " (-p or TARGET=FILE)");
+      }
+      tts.add_solver(solver.substr(0, separator), parameter_file);
+    }
+    if (tts.get_solvers().empty())
+    {
+      throw MissingInputException("No solver specified (-s)");
+    }
+
+    if (config.seeds != "") tts.set_seeds((uint32_t)std::stoul(config.seeds));
+    if (config.first_seed != "")
+    {
+      tts.set_first_seed((uint32_t)std::stoul(config.first_seed));
+    }
+    if (config.concurrent_runs != "")
+    {
+      tts.set_concurrent_runs((uint32_t)std::stoul(config.concurrent_runs));
+    }
+    if (config.tolerance != "") tts.set_tolerance(std::stod(config.tolerance));
+    if (config.cache_dir != "") tts.set_cache_dir(config.cache_dir);
+
+    size_t failed;
+    if (config.output_file != "")
+    {
+      LOG(INFO, "Writing ", config.output_file);
+      std::ofstream out(config.output_file);
+      failed = tts.run(out);
+      out.close();
+      if (!out)
+      {
+        THROW(utils::FileWriteException, "Unable to write file ",
+              config.output_file, ".");
+      }
+    }
+    else
+    {
+      failed = tts.run(std::cout);
+    }
+    if (failed > 0)
+    {
+      LOG(WARN, failed, " runs failed.");
+      return 16;
+    }
+    return EX_OK;
+  }
+  catch (const utils::ConfigurationException& e)
+  {
+    LOG(FATAL, e.get_error_message());
+  }
+  catch (const utils::RuntimeException& e)
+  {
+    LOG(FATAL, e.what());
+  }
+  catch (const std::exception& e)
+  {
+    LOG(FATAL, e.what());
+  }
+  return 16;
+}
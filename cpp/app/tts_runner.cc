@@ -0,0 +1,420 @@
+
+#include "app/tts_runner.h"
+
+#include <math.h>
+#include <omp.h>
+
+#include <algorithm>
+#include <fstream>
+#include <limits>
+#include <sstream>
+
+#include "utils/config.h"
+#include "utils/exception.h"
+#include "utils/json.h"
+#include "utils/log.h"
+#include "utils/metadata.h"
+#include "app/runner.h"
+
+namespace app
+{
+namespace
+{
+// Value of a rendered number.
+double get_number(const utils::Structure& value)
+{
+  switch (value.get_type())
+  {
+    case utils::Structure::INT32:
+      return value.get<int32_t>();
+    case utils::Structure::UINT32:
+      return value.get<uint32_t>();
+    case utils::Structure::INT64:
+      return (double)value.get<int64_t>();
+    case utils::Structure::UINT64:
+      return (double)value.get<uint64_t>();
+    case utils::Structure::DOUBLE:
+      return value.get<double>();
+    default:
+      THROW(utils::InvalidTypesException, "Expected a number, found '",
+            value.to_string(false), "'.");
+  }
+}
+
+// Set `object[key]` to `value` (adding the member if needed).
+void set_member(utils::Json& object, const char* key, utils::Json& value,
+                utils::JsonDocument::AllocatorType& allocator)
+{
+  if (object.HasMember(key))
+  {
+    object[key] = value;
+  }
+  else
+  {
+    utils::Json name(key, allocator);
+    object.AddMember(name, value, allocator);
+  }
+}
+
+std::string read_parameters(const std::string& parameter_file)
+{
+  std::ifstream in(parameter_file);
+  if (!in)
+  {
+    THROW(utils::FileReadException, "Unable to read parameter file ",
+          parameter_file, ".");
+  }
+  std::stringstream content;
+  content << in.rdbuf();
+  return content.str();
+}
+
+// Whether `parameters` enable or disable features (true if they cannot be
+// parsed, such that the runs fail on their own).
+bool sets_features(const std::string& parameters)
+{
+  try
+  {
+    auto config = utils::json_from_string(parameters);
+    if (!config.IsObject() || !config.HasMember(utils::kParams)) return false;
+    const auto& params = config[utils::kParams];
+    return params.IsObject() && (params.HasMember(utils::kEnabledFeatures) ||
+                                 params.HasMember(utils::kDisabledFeatures));
+  }
+  catch (const std::exception&)
+  {
+    return true;
+  }
+}
+
+double median(std::vector<double> values)
+{
+  size_t middle = values.size() / 2;
+  std::nth_element(values.begin(), values.begin() + middle, values.end());
+  if (values.size() % 2 == 1) return values[middle];
+  double upper = values[middle];
+  return (upper + *std::max_element(values.begin(), values.begin() + middle)) /
+         2;
+}
+}  // namespace
+
+double time_to_solution(double time_per_run, double p,
+                        double target_probability)
+{
+  if (p >= target_probability) return time_per_run;
+  if (p <= 0) return std::numeric_limits<double>::infinity();
+  return time_per_run * log(1 - target_probability) / log(1 - p);
+}
+
+utils::Structure summarize_runs(const std::vector<TtsRun>& runs)
+{
+  uint64_t count = 0, successes = 0, errors = 0;
+  double total_time = 0, total_evaluations = 0;
+  std::vector<double> times_to_target, evaluations_to_target;
+  for (const auto& run : runs)
+  {
+    if (!run.error.empty())
+    {
+      errors++;
+      continue;
+    }
+    count++;
+    total_time += run.time_ms;
+    total_evaluations += (double)run.evaluations;
+    if (run.success)
+    {
+      successes++;
+      times_to_target.push_back(run.time_to_target_ms);
+      evaluations_to_target.push_back((double)run.evaluations_to_target);
+    }
+  }
+
+  utils::Structure s;
+  s["runs"] = count;
+  s["successes"] = successes;
+  s["errors"] = errors;
+  if (count == 0) return s;
+  double p = (double)successes / (double)count;
+  double mean_time = total_time / (double)count;
+  double mean_evaluations = total_evaluations / (double)count;
+  s["success_probability"] = p;
+  s["mean_time_ms"] = mean_time;
+  s["mean_evaluations"] = mean_evaluations;
+  if (successes > 0)
+  {
+    s["tts99_ms"] = time_to_solution(mean_time, p);
+    s["ets99"] = time_to_solution(mean_evaluations, p);
+    s["median_time_to_target_ms"] = median(times_to_target);
+    s["median_evaluations_to_target"] = median(evaluations_to_target);
+  }
+  return s;
+}
+
+TtsRunner::TtsRunner()
+    : seeds_(100), first_seed_(1), concurrent_runs_(0), tolerance_(1e-6)
+{
+}
+
+void TtsRunner::add_problem(const std::string& input_file, double target_cost)
+{
+  problems_.push_back({input_file, target_cost});
+}
+
+void TtsRunner::add_problems(const std::string& path)
+{
+  std::ifstream in(path);
+  if (!in)
+  {
+    THROW(utils::FileReadException, "Unable to read problem file ", path, ".");
+  }
+  std::string line;
+  size_t line_number = 0;
+  while (std::getline(in, line))
+  {
+    line_number++;
+    std::istringstream fields(line);
+    std::string input_file, target, extra;
+    if (!(fields >> input_file) || input_file[0] == '#') continue;
+    if (!(fields >> target) || (fields >> extra))
+    {
+      THROW(utils::ParsingException, "Expected an input file and a target ",
+            "cost (or solution file) in line ", line_number,
+            " of problem file ", path, ".");
+    }
+    size_t parsed = 0;
+    double target_cost = 0;
+    try
+    {
+      target_cost = std::stod(target, &parsed);
+    }
+    catch (const std::exception&)
+    {
+      parsed = 0;
+    }
+    if (parsed != target.size())
+    {
+      // A solution file with the target `cost`.
+      auto solution = utils::json_from_file(target);
+      if (!solution.IsObject() || !solution.HasMember("cost") ||
+          !solution["cost"].IsNumber())
+      {
+        THROW(utils::ParsingException, "Solution file ", target,
+              " does not specify a `cost`.");
+      }
+      target_cost = solution["cost"].GetDouble();
+    }
+    add_problem(input_file, target_cost);
+  }
+}
+
+void TtsRunner::add_solver(const std::string& target,
+                           const std::string& parameter_file)
+{
+  solvers_.push_back({target, parameter_file});
+}
+
+TtsRun TtsRunner::run_one(const TtsProblem& problem, const TtsSolver& solver,
+                          const std::string& parameters, uint32_t seed) const
+{
+  TtsRun run;
+  run.seed = seed;
+  try
+  {
+    utils::JsonDocument config = utils::json_from_string(parameters);
+    if (!config.IsObject() || !config.HasMember(utils::kParams) ||
+        !config[utils::kParams].IsObject())
+    {
+      THROW(utils::MissingInputException, "Parameter file ",
+            solver.parameter_file, " does not specify `", utils::kParams,
+            "`.");
+    }
+    auto& allocator = config.GetAllocator();
+    utils::Json target(solver.target.c_str(), allocator);
+    set_member(config, "target", target, allocator);
+    utils::Json input(problem.input_file.c_str(), allocator);
+    set_member(config, "input_data_uri", input, allocator);
+    utils::Json seed_value(seed);
+    set_member(config[utils::kParams], "seed", seed_value, allocator);
+    utils::Json cost_limit(problem.target_cost + tolerance_);
+    set_member(config[utils::kParams], "cost_limit", cost_limit, allocator);
+
+    Runner runner;
+    runner.set_output_benchmark(false);
+    if (!cache_dir_.empty()) runner.set_cache_dir(cache_dir_);
+    runner.configure(utils::json_to_string(config));
+    utils::Structure response = runner.get_run_output();
+
+    const utils::Structure& benchmark = response[utils::kBenchmark];
+    const utils::Structure& solutions = response["solutions"];
+    run.cost = get_number(solutions["cost"]);
+    run.time_ms = get_number(benchmark[utils::kExecutionTimeMs]);
+    run.evaluations =
+        benchmark["cost_function_evaluation_count"].get<uint64_t>() +
+        benchmark["cost_difference_evaluation_count"].get<uint64_t>();
+    run.success = run.cost <= problem.target_cost + tolerance_;
+    if (!run.success) return run;
+
+    // The first improvement reaching the target (the traced costs exclude
+    // constant terms, which the final cost includes).
+    run.time_to_target_ms = run.time_ms;
+    run.evaluations_to_target = run.evaluations;
+    const utils::Structure& events = benchmark["cost_trace"]["events"];
+    size_t size = events.get_array_size();
+    if (size == 0) return run;
+    double offset = run.cost - get_number(events[size - 1]["cost"]);
+    for (size_t i = 0; i < size; i++)
+    {
+      const utils::Structure& event = events[i];
+      if (get_number(event["cost"]) + offset <=
+          problem.target_cost + tolerance_)
+      {
+        run.time_to_target_ms = get_number(event["time_ms"]);
+        run.evaluations_to_target = event["evaluations"].get<uint64_t>();
+        break;
+      }
+    }
+  }
+  catch (const std::exception& e)
+  {
+    LOG(ERROR, solver.target, " failed on ", problem.input_file, " (seed ",
+        seed, "): ", e.what());
+    run.error = e.what();
+  }
+  return run;
+}
+
+size_t TtsRunner::run(std::ostream& out)
+{
+  if (problems_.empty() || solvers_.empty() || seeds_ == 0)
+  {
+    THROW(utils::MissingInputException,
+          "The benchmark requires at least one problem, solver and seed.");
+  }
+  std::vector<std::string> parameters;
+  for (const auto& solver : solvers_)
+  {
+    parameters.push_back(read_parameters(solver.parameter_file));
+  }
+
+  // Runs are ordered by problem, solver and seed.
+  size_t runs_per_problem = solvers_.size() * seeds_;
+  size_t total = problems_.size() * runs_per_problem;
+  std::vector<TtsRun> runs(total);
+  LOG(INFO, "Running ", solvers_.size(), " solvers on ", problems_.size(),
+      " problems with ", seeds_, " seeds each (", total, " runs).");
+  // Runs of solvers whose parameters change features (which are
+  // process-wide) are solved one after the other, the others concurrently.
+  std::vector<size_t> concurrent_runs, sequential_runs;
+  std::vector<bool> solver_sets_features;
+  for (const auto& solver_parameters : parameters)
+  {
+    solver_sets_features.push_back(sets_features(solver_parameters));
+  }
+  for (size_t index = 0; index < total; index++)
+  {
+    size_t solver = index % runs_per_problem / seeds_;
+    if (solver_sets_features[solver])
+    {
+      sequential_runs.push_back(index);
+    }
+    else
+    {
+      concurrent_runs.push_back(index);
+    }
+  }
+
+  int max_threads = omp_get_max_threads();
+  int concurrency = concurrent_runs_ > 0
+                        ? std::min((int)concurrent_runs_, max_threads)
+                        : max_threads;
+  int threads_per_run = std::max(1, max_threads / concurrency);
+  int max_active_levels = omp_get_max_active_levels();
+  // Each run parallelizes on its own share of the threads.
+  omp_set_max_active_levels(std::max(max_active_levels, 2));
+  #pragma omp parallel num_threads(concurrency)
+  {
+    // This only affects the calling thread.
+    omp_set_num_threads(threads_per_run);
+    #pragma omp for schedule(dynamic, 1)
+    for (int i = 0; i < (int)concurrent_runs.size(); i++)
+    {
+      size_t index = concurrent_runs[(size_t)i];
+      size_t problem = index / runs_per_problem;
+      size_t solver = index % runs_per_problem / seeds_;
+      uint32_t seed = first_seed_ + (uint32_t)(index % seeds_);
+      runs[index] = run_one(problems_[problem], solvers_[solver],
+                            parameters[solver], seed);
+    }
+  }
+  omp_set_max_active_levels(max_active_levels);
+
+  for (size_t index : sequential_runs)
+  {
+    // A run's `threads` parameter and features must not apply to the next
+    // run.
+    omp_set_num_threads(max_threads);
+    utils::ScopedFeatures features;
+    size_t problem = index / runs_per_problem;
+    size_t solver = index % runs_per_problem / seeds_;
+    uint32_t seed = first_seed_ + (uint32_t)(index % seeds_);
+    runs[index] = run_one(problems_[problem], solvers_[solver],
+                          parameters[solver], seed);
+  }
+  omp_set_num_threads(max_threads);
+
+  size_t failed = 0;
+  utils::Structure report;
+  report["build"] = utils::get_build_properties();
+  report["seeds"] = seeds_;
+  report["first_seed"] = first_seed_;
+  report["tolerance"] = tolerance_;
+  utils::Structure problems(utils::Structure::ARRAY);
+  for (size_t p = 0; p < problems_.size(); p++)
+  {
+    utils::Structure entry;
+    entry["input_file"] = problems_[p].input_file;
+    entry["target_cost"] = problems_[p].target_cost;
+    utils::Structure solvers(utils::Structure::ARRAY);
+    for (size_t s = 0; s < solvers_.size(); s++)
+    {
+      auto first = runs.begin() + (long)(p * runs_per_problem + s * seeds_);
+      std::vector<TtsRun> solver_runs(first, first + seeds_);
+      utils::Structure summary = summarize_runs(solver_runs);
+      summary["target"] = solvers_[s].target;
+      summary["parameter_file"] = solvers_[s].parameter_file;
+      utils::Structure seeds(utils::Structure::ARRAY);
+      for (const auto& run : solver_runs)
+      {
+        utils::Structure rendered;
+        rendered["seed"] = run.seed;
+        if (!run.error.empty())
+        {
+          rendered["error"] = run.error;
+          failed++;
+        }
+        else
+        {
+          rendered["success"] = run.success;
+          rendered["cost"] = run.cost;
+          rendered["time_ms"] = run.time_ms;
+          rendered["evaluations"] = run.evaluations;
+          if (run.success)
+          {
+            rendered["time_to_target_ms"] = run.time_to_target_ms;
+            rendered["evaluations_to_target"] = run.evaluations_to_target;
+          }
+        }
+        seeds.push_back(rendered);
+      }
+      summary["seeds"] = seeds;
+      solvers.push_back(summary);
+    }
+    entry["solvers"] = solvers;
+    problems.push_back(entry);
+  }
+  report["problems"] = problems;
+  out << report.to_string() << "\n";
+  return failed;
+}
+
+}  // namespace app
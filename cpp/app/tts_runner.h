@@ -0,0 +1,158 @@
+
+#pragma once
+
+#include <stdint.h>
+
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "utils/structure.h"
+
+namespace app
+{
+/// A problem with a known (or planted) optimum.
+struct TtsProblem
+{
+  std::string input_file;
+  double target_cost;
+};
+
+/// A solver target and the parameter file to run it with.
+struct TtsSolver
+{
+  std::string target;
+  std::string parameter_file;
+};
+
+/// Outcome of one run (one seed of one solver on one problem).
+struct TtsRun
+{
+  TtsRun()
+      : seed(0),
+        success(false),
+        cost(0),
+        time_ms(0),
+        time_to_target_ms(0),
+        evaluations(0),
+        evaluations_to_target(0)
+  {
+  }
+
+  uint32_t seed;
+  /// Whether the run reached the target cost.
+  bool success;
+  /// Lowest cost found.
+  double cost;
+  /// Solver time of the run (which stops at the target).
+  double time_ms;
+  /// Solver time and cost function evaluations until the target was reached
+  /// (only for successful runs).
+  double time_to_target_ms;
+  uint64_t evaluations;
+  uint64_t evaluations_to_target;
+  /// Error message of a failed run (which is not counted).
+  std::string error;
+};
+
+/// Expected time (or number of evaluations) to find the target with
+/// probability `target_probability` by repeating independent runs which
+/// each take `time_per_run` and succeed with probability `p`:
+///
+///   time_per_run * log(1 - target_probability) / log(1 - p)
+///
+/// This is `time_per_run` if p >= target_probability and infinite if p == 0.
+double time_to_solution(double time_per_run, double p,
+                        double target_probability = 0.99);
+
+/// Summarize the runs of one solver on one problem: the number of `runs`
+/// and `successes`, the `success_probability`, the mean solver time and
+/// evaluations per run, the `tts99_ms` and `ets99` (evaluations to solution)
+/// derived from them (omitted if no run succeeded) and the median time and
+/// evaluations to target of the successful runs.
+utils::Structure summarize_runs(const std::vector<TtsRun>& runs);
+
+////////////////////////////////////////////////////////////////////////////////
+/// Time-to-solution benchmark
+///
+/// Runs each solver on each problem with `seeds` different seeds, each run
+/// stopping at the problem's target cost (via `cost_limit`). Runs are
+/// solved concurrently, each on an equal share of the threads (a single
+/// thread each unless `concurrent_runs` is set). Runs of solvers whose
+/// parameters change features are solved one after the other with all
+/// threads, and the features are reset after each. The report compares the
+/// solvers per problem:
+///
+///   {
+///     "build": {...},
+///     "seeds": 100,
+///     "problems": [
+///       {"input_file": "...", "target_cost": -600,
+///        "solvers": [
+///          {"target": "simulatedannealing.qiotoolkit",
+///           "parameter_file": "...",
+///           "runs": 100, "successes": 97, "success_probability": 0.97,
+///           "mean_time_ms": 12.5, "tts99_ms": 18.2, "ets99": 1.2e6, ...,
+///           "seeds": [{"seed": 1, "success": true, "cost": -600,
+///                      "time_ms": 11.8, "time_to_target_ms": 11.7,
+///                      "evaluations": 81234,
+///                      "evaluations_to_target": 80112}, ...]},
+///          ...]},
+///       ...
+///     ]
+///   }
+///
+/// The time and evaluations to target are read from the solver's
+/// `cost_trace` (whose costs exclude the problem's constant terms, which are
+/// accounted for using the final cost).
+///
+class TtsRunner
+{
+ public:
+  TtsRunner();
+
+  void add_problem(const std::string& input_file, double target_cost);
+
+  /// Add the problems listed in `path`, one per line: the input file
+  /// followed by the target cost or a json file with the target `cost` (such
+  /// as the solution written by `qiotoolkit-generate --solution`). Empty
+  /// lines and lines starting with `#` are ignored.
+  void add_problems(const std::string& path);
+
+  /// Add a solver; `parameter_file` contains its `params` (of which `seed`
+  /// and `cost_limit` are set for each run).
+  void add_solver(const std::string& target, const std::string& parameter_file);
+
+  void set_seeds(uint32_t seeds) { seeds_ = seeds; }
+  /// Seed of the first run (the others use the following seeds).
+  void set_first_seed(uint32_t seed) { first_seed_ = seed; }
+  /// Number of runs solved at once (0, the default, for one per thread);
+  /// 1 solves them one after the other such that the measured times do not
+  /// depend on competing runs.
+  void set_concurrent_runs(uint32_t runs) { concurrent_runs_ = runs; }
+  /// Absolute tolerance when comparing costs to the target.
+  void set_tolerance(double tolerance) { tolerance_ = tolerance; }
+  void set_cache_dir(const std::string& cache_dir) { cache_dir_ = cache_dir; }
+
+  const std::vector<TtsProblem>& get_problems() const { return problems_; }
+  const std::vector<TtsSolver>& get_solvers() const { return solvers_; }
+
+  /// Run all seeds of all solvers on all problems and write the report to
+  /// `out`; returns the number of runs which failed with an error.
+  size_t run(std::ostream& out);
+
+ private:
+  /// Run `solver` on `problem` with `seed`.
+  TtsRun run_one(const TtsProblem& problem, const TtsSolver& solver,
+                 const std::string& parameters, uint32_t seed) const;
+
+  std::vector<TtsProblem> problems_;
+  std::vector<TtsSolver> solvers_;
+  uint32_t seeds_;
+  uint32_t first_seed_;
+  uint32_t concurrent_runs_;
+  double tolerance_;
+  std::string cache_dir_;
+};
+
+}  // namespace app
@@ -0,0 +1,295 @@
+
+#include <functional>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "utils/json.h"
+#include "utils/random_generator.h"
+#include "benchmark/benchmark.h"
+#include "benchmarks/synthetic.h"
+#include "markov/metropolis.h"
+#include "model/all_models.h"
+
+/// Microbenchmarks of the model kernels: the time per
+/// `calculate_cost_difference`, per `apply_transition` and per
+/// `Walker::make_sweep` for each model on synthetic problems of a given
+/// number of variables, degree and locality (the benchmark arguments).
+///
+/// Run with `--benchmark_filter=<regex>` to select models or kernels, e.g.
+///
+///   qiotoolkit_bench --benchmark_filter='IsingTermCached/cost_difference'
+
+using benchmark_utils::Shape;
+
+namespace
+{
+using Generator = std::function<std::string(const Shape&)>;
+
+// Number of precomputed transitions cycled through in `cost_difference`.
+constexpr size_t kTransitions = 1024;
+constexpr uint32_t kSeed = 42;
+
+template <class Model>
+using IsFaced = std::is_base_of<
+    model::FacedGraphModel<typename Model::State_T,
+                           typename Model::Transition_T>,
+    Model>;
+
+// Faced models communicate cached calculations through the cost (see
+// `markov::Walker::attempt_transition`).
+template <class Model>
+typename std::enable_if<IsFaced<Model>::value, typename Model::Cost_T>::type
+cost_difference(const Model& model, const typename Model::State_T& state,
+                const typename Model::Transition_T& transition,
+                typename Model::Cost_T& cost)
+{
+  return model.calculate_cost_difference(state, transition, &cost);
+}
+
+template <class Model>
+typename std::enable_if<!IsFaced<Model>::value, typename Model::Cost_T>::type
+cost_difference(const Model& model, const typename Model::State_T& state,
+                const typename Model::Transition_T& transition,
+                typename Model::Cost_T&)
+{
+  return model.calculate_cost_difference(state, transition);
+}
+
+template <class Model>
+typename std::enable_if<IsFaced<Model>::value>::type apply_transition(
+    const Model& model, const typename Model::Transition_T& transition,
+    typename Model::State_T& state, typename Model::Cost_T& cost)
+{
+  model.apply_transition(transition, state, &cost);
+}
+
+template <class Model>
+typename std::enable_if<!IsFaced<Model>::value>::type apply_transition(
+    const Model& model, const typename Model::Transition_T& transition,
+    typename Model::State_T& state, typename Model::Cost_T&)
+{
+  model.apply_transition(transition, state);
+}
+
+Shape get_shape(const benchmark::State& state)
+{
+  return {(size_t)state.range(0), (size_t)state.range(1),
+          (size_t)state.range(2)};
+}
+
+// Configure `model` with the generated problem; returns false (skipping the
+// benchmark) if a grouped problem came without groups.
+template <class Model>
+bool configure(Model& model, const Generator& generate,
+               benchmark::State& state)
+{
+  auto json = utils::json_from_string(generate(get_shape(state)));
+  if (IsFaced<Model>::value)
+  {
+    const auto& cost_function = json["cost_function"];
+    if (!cost_function.HasMember("terms_slc") ||
+        !cost_function["terms_slc"].IsArray() ||
+        cost_function["terms_slc"].Empty())
+    {
+      state.SkipWithError("The grouped problem has no terms_slc groups.");
+      return false;
+    }
+  }
+  model.configure(json);
+  model.init();
+  return true;
+}
+
+// Time per `calculate_cost_difference` (of precomputed random transitions).
+template <class Model>
+void cost_difference_benchmark(benchmark::State& state,
+                               const Generator& generate)
+{
+  Model model;
+  if (!configure(model, generate, state)) return;
+  utils::Twister rng;
+  rng.seed(kSeed);
+  auto model_state = model.get_random_state(rng);
+  auto cost = model.calculate_cost(model_state);
+  std::vector<typename Model::Transition_T> transitions;
+  for (size_t i = 0; i < kTransitions; i++)
+  {
+    transitions.push_back(model.get_random_transition(model_state, rng));
+  }
+  size_t i = 0;
+  for (auto _ : state)
+  {
+    benchmark::DoNotOptimize(
+        cost_difference(model, model_state, transitions[i], cost));
+    i = (i + 1) % kTransitions;
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+// Time per `apply_transition` (including drawing the random transition,
+// which depends on the current state).
+template <class Model>
+void apply_transition_benchmark(benchmark::State& state,
+                                const Generator& generate)
+{
+  Model model;
+  if (!configure(model, generate, state)) return;
+  utils::Twister rng;
+  rng.seed(kSeed);
+  auto model_state = model.get_random_state(rng);
+  auto cost = model.calculate_cost(model_state);
+  for (auto _ : state)
+  {
+    auto transition = model.get_random_transition(model_state, rng);
+    apply_transition(model, transition, model_state, cost);
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+// Time per `make_sweep` of a Metropolis walker at beta = 1.
+template <class Model>
+void sweep_benchmark(benchmark::State& state, const Generator& generate)
+{
+  Model model;
+  if (!configure(model, generate, state)) return;
+  utils::Twister rng;
+  rng.seed(kSeed);
+  markov::Metropolis<Model> walker;
+  walker.set_model(&model);
+  walker.set_rng(&rng);
+  walker.set_beta(1.0);
+  walker.init();
+  for (auto _ : state)
+  {
+    walker.make_sweep();
+    benchmark::DoNotOptimize(walker.cost());
+  }
+  // Items are the attempted transitions (one per variable for most models).
+  state.SetItemsProcessed(state.iterations() *
+                          (int64_t)model.get_sweep_size());
+}
+
+// Register the three kernels of `Model` for each of `shapes`.
+template <class Model>
+void register_model(const std::string& name, Generator generate,
+                    const std::vector<Shape>& shapes)
+{
+  auto add = [&](const std::string& kernel,
+                 void (*function)(benchmark::State&, const Generator&)) {
+    auto* b = benchmark::RegisterBenchmark(
+        (name + "/" + kernel).c_str(),
+        [function, generate](benchmark::State& state) {
+          function(state, generate);
+        });
+    b->ArgNames({"variables", "degree", "locality"});
+    for (const auto& shape : shapes)
+    {
+      b->Args({(int64_t)shape.variables, (int64_t)shape.degree,
+               (int64_t)shape.locality});
+    }
+  };
+  add("cost_difference", &cost_difference_benchmark<Model>);
+  add("apply_transition", &apply_transition_benchmark<Model>);
+  add("sweep", &sweep_benchmark<Model>);
+}
+
+Generator graph(const std::string& type, const std::string& extra = "")
+{
+  return [type, extra](const Shape& shape) {
+    return benchmark_utils::graph_problem(type, shape, kSeed, extra);
+  };
+}
+
+Generator grouped(const std::string& type)
+{
+  return [type](const Shape& shape) {
+    return benchmark_utils::grouped_problem(type, shape, kSeed);
+  };
+}
+
+void register_models()
+{
+  using namespace model;
+  // Small (cache resident) and large problems of low and high degree.
+  const std::vector<Shape> quadratic = {
+      {1000, 4, 2}, {1000, 16, 2}, {100000, 4, 2}, {100000, 16, 2}};
+  const std::vector<Shape> local = {
+      {1000, 4, 3}, {1000, 16, 3}, {100000, 4, 3}, {100000, 16, 6}};
+  // Compact models with 8 (16) bit ids are limited to 253 (65533)
+  // variables.
+  const std::vector<Shape> tiny = {{250, 4, 2}, {250, 16, 2}};
+  const std::vector<Shape> tiny_local = {{250, 4, 3}, {250, 16, 3}};
+  const std::vector<Shape> medium = {
+      {1000, 4, 2}, {1000, 16, 2}, {60000, 4, 2}, {60000, 16, 2}};
+  const std::vector<Shape> medium_local = {
+      {1000, 4, 3}, {1000, 16, 3}, {60000, 4, 3}, {60000, 16, 6}};
+  // Dense models (the tsp size is the number of cities).
+  const std::vector<Shape> cities = {{100, 0, 0}, {1000, 0, 0}};
+
+  register_model<Ising>("Ising", graph("ising"), quadratic);
+  register_model<IsingTermCached>("IsingTermCached", graph("ising"),
+                                  quadratic);
+  register_model<IsingCompact<uint8_t>>("IsingCompact8", graph("ising"), tiny);
+  register_model<IsingCompact<uint16_t>>("IsingCompact16", graph("ising"),
+                                         medium);
+  register_model<IsingCompact<uint32_t>>("IsingCompact32", graph("ising"),
+                                         quadratic);
+  register_model<IsingGrouped>("IsingGrouped", grouped("ising_grouped"),
+                               quadratic);
+  register_model<BlumeCapel>("BlumeCapel", graph("blume-capel"), quadratic);
+
+  register_model<Pubo>("Pubo", graph("pubo"), local);
+  register_model<PuboWithCounter<uint8_t>>("PuboWithCounter8", graph("pubo"),
+                                           local);
+  register_model<PuboWithCounter<uint16_t>>("PuboWithCounter16",
+                                            graph("pubo"), local);
+  register_model<PuboWithCounter<uint32_t>>("PuboWithCounter32",
+                                            graph("pubo"), local);
+  register_model<PuboCompact<uint8_t>>("PuboCompact8", graph("pubo"),
+                                       tiny_local);
+  register_model<PuboCompact<uint16_t>>("PuboCompact16", graph("pubo"),
+                                        medium_local);
+  register_model<PuboCompact<uint32_t>>("PuboCompact32", graph("pubo"),
+                                        local);
+  register_model<PuboAdaptive<uint32_t>>("PuboAdaptive", graph("pubo"),
+                                         local);
+  register_model<PuboGrouped<uint8_t>>("PuboGrouped", grouped("pubo_grouped"),
+                                       local);
+
+  register_model<MaxSat8>(
+      "MaxSat8",
+      [](const Shape& s) { return benchmark_utils::maxsat_problem(s, kSeed); },
+      local);
+  register_model<MaxSat16>(
+      "MaxSat16",
+      [](const Shape& s) { return benchmark_utils::maxsat_problem(s, kSeed); },
+      local);
+  register_model<MaxSat32>(
+      "MaxSat32",
+      [](const Shape& s) { return benchmark_utils::maxsat_problem(s, kSeed); },
+      local);
+
+  register_model<Clock>("Clock", graph("clock", "\"q\":4,"), quadratic);
+  register_model<Potts>("Potts", graph("potts"), quadratic);
+  register_model<Poly>(
+      "Poly",
+      [](const Shape& s) { return benchmark_utils::poly_problem(s, kSeed); },
+      local);
+  register_model<Tsp>(
+      "Tsp",
+      [](const Shape& s) { return benchmark_utils::tsp_problem(s, kSeed); },
+      cities);
+}
+}  // namespace
+
+int main(int argc, char** argv)
+{
+  register_models();
+  benchmark::Initialize(&argc, argv);
+  if (benchmark::ReportUnrecognizedArguments(argc, argv)) return 1;
+  benchmark::RunSpecifiedBenchmarks();
+  benchmark::Shutdown();
+  return 0;
+}
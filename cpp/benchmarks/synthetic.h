@@ -0,0 +1,177 @@
+
+#pragma once
+
+#include <cmath>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "utils/random_generator.h"
+
+namespace benchmark_utils
+{
+/// Size of a synthetic problem: the number of variables, the average number
+/// of terms each variable appears in and the number of variables per term.
+struct Shape
+{
+  size_t variables;
+  size_t degree;
+  size_t locality;
+};
+
+/// Random distinct variables for one term (as 0-based ids).
+inline std::vector<int> random_ids(utils::RandomGenerator& rng,
+                                   const Shape& shape)
+{
+  std::set<int> ids;
+  size_t locality = std::min(shape.locality, shape.variables);
+  while (ids.size() < locality)
+  {
+    ids.insert((int)(rng.uniform() * (double)shape.variables));
+  }
+  return std::vector<int>(ids.begin(), ids.end());
+}
+
+/// Number of terms such that each variable appears in `degree` terms on
+/// average.
+inline size_t term_count(const Shape& shape)
+{
+  return std::max<size_t>(
+      1, shape.variables * shape.degree / std::max<size_t>(1, shape.locality));
+}
+
+/// Write `count` random terms `{"c": ..., "ids": [...]}` with coefficients
+/// in [-1, 1) (or, if `positive`, integer weights in [1, 10]). With
+/// `signed_literals`, ids are 1-based and randomly negated (as in maxsat).
+inline void write_terms(std::ostream& out, utils::RandomGenerator& rng,
+                        const Shape& shape, size_t count,
+                        const char* coefficient_key = "c",
+                        bool positive = false, bool signed_literals = false)
+{
+  out << "[";
+  for (size_t t = 0; t < count; t++)
+  {
+    if (t > 0) out << ",";
+    double c = positive ? std::floor(1 + 10 * rng.uniform())
+                        : 2 * rng.uniform() - 1;
+    out << "{\"" << coefficient_key << "\":" << c << ",\"ids\":[";
+    std::vector<int> ids = random_ids(rng, shape);
+    for (size_t i = 0; i < ids.size(); i++)
+    {
+      int id = ids[i];
+      if (signed_literals) id = rng.uniform() < 0.5 ? -(id + 1) : id + 1;
+      out << (i > 0 ? "," : "") << id;
+    }
+    out << "]}";
+  }
+  out << "]";
+}
+
+/// Graph problem (ising, pubo, clock, potts and their variants) of `type`
+/// with random terms; `extra` members are added to the cost function.
+inline std::string graph_problem(const std::string& type, const Shape& shape,
+                                 uint32_t seed, const std::string& extra = "",
+                                 const std::string& version = "1.0")
+{
+  utils::Twister rng;
+  rng.seed(seed);
+  std::ostringstream out;
+  out << "{\"cost_function\":{\"type\":\"" << type << "\",\"version\":\""
+      << version << "\"," << extra << "\"terms\":";
+  write_terms(out, rng, shape, term_count(shape));
+  out << "}";
+  if (type == "potts") out << ",\"q\":4";
+  out << "}";
+  return out.str();
+}
+
+/// Grouped graph problem (ising_grouped or pubo_grouped): half of the terms
+/// as plain `terms` and the other half as `terms_slc` groups, each the square
+/// of a linear combination of `locality` distinct variables.
+inline std::string grouped_problem(const std::string& type, const Shape& shape,
+                                   uint32_t seed)
+{
+  utils::Twister rng;
+  rng.seed(seed);
+  size_t count = term_count(shape);
+  std::ostringstream out;
+  out << "{\"cost_function\":{\"type\":\"" << type
+      << "\",\"version\":\"1.0\",\"terms_slc\":[";
+  for (size_t g = 0; g < count / 2 + 1; g++)
+  {
+    out << (g > 0 ? "," : "") << "{\"c\":" << 2 * rng.uniform() - 1
+        << ",\"terms\":[";
+    std::vector<int> ids = random_ids(rng, shape);
+    for (size_t i = 0; i < ids.size(); i++)
+    {
+      out << (i > 0 ? "," : "") << "{\"c\":" << 2 * rng.uniform() - 1
+          << ",\"ids\":[" << ids[i] << "]}";
+    }
+    out << "]}";
+  }
+  out << "],\"terms\":";
+  write_terms(out, rng, shape, count - count / 2);
+  out << "}}";
+  return out.str();
+}
+
+/// Weighted maxsat problem with random clauses of `locality` literals.
+inline std::string maxsat_problem(const Shape& shape, uint32_t seed)
+{
+  utils::Twister rng;
+  rng.seed(seed);
+  std::ostringstream out;
+  out << "{\"cost_function\":{\"type\":\"maxsat\",\"version\":\"1.0\","
+         "\"terms\":";
+  write_terms(out, rng, shape, term_count(shape), "c", true, true);
+  out << "}}";
+  return out.str();
+}
+
+/// Poly problem: a squared group of half the terms and the other half as
+/// plain monomials.
+inline std::string poly_problem(const Shape& shape, uint32_t seed)
+{
+  utils::Twister rng;
+  rng.seed(seed);
+  size_t count = term_count(shape);
+  std::ostringstream out;
+  out << "{\"cost_function\":{\"type\":\"poly\",\"version\":\"0.1\","
+         "\"terms\":[{\"parameter\":\"x\",\"constant\":1,\"exponent\":2,"
+         "\"terms\":";
+  write_terms(out, rng, shape, count / 2 + 1, "constant");
+  out << "},{\"constant\":1,\"terms\":";
+  write_terms(out, rng, shape, count - count / 2, "constant");
+  out << "}]}}";
+  return out.str();
+}
+
+/// Tsp problem with `variables` random cities in the unit square.
+inline std::string tsp_problem(const Shape& shape, uint32_t seed)
+{
+  utils::Twister rng;
+  rng.seed(seed);
+  std::vector<double> x(shape.variables), y(shape.variables);
+  for (size_t i = 0; i < shape.variables; i++)
+  {
+    x[i] = rng.uniform();
+    y[i] = rng.uniform();
+  }
+  std::ostringstream out;
+  out << "{\"cost_function\":{\"type\":\"tsp\",\"version\":\"1.0\"},"
+         "\"dist\":[";
+  for (size_t i = 0; i < shape.variables; i++)
+  {
+    out << (i > 0 ? ",[" : "[");
+    for (size_t j = 0; j < shape.variables; j++)
+    {
+      out << (j > 0 ? "," : "") << std::hypot(x[i] - x[j], y[i] - y[j]);
+    }
+    out << "]";
+  }
+  out << "]}";
+  return out.str();
+}
+
+}  // namespace benchmark_utils
@@ -0,0 +1,17 @@
+include(FetchContent)
+
+set(BENCHMARK_ENABLE_TESTING OFF CACHE BOOL "" FORCE)
+set(BENCHMARK_ENABLE_GTEST_TESTS OFF CACHE BOOL "" FORCE)
+set(BENCHMARK_ENABLE_INSTALL OFF CACHE BOOL "" FORCE)
+
+FetchContent_Declare(
+  googlebenchmark
+  GIT_REPOSITORY https://github.com/google/benchmark.git
+  GIT_TAG        v1.8.3
+)
+FetchContent_MakeAvailable(googlebenchmark)
+
+function(add_benchmark name source)
+  add_executable(${name} ${source})
+  target_link_libraries(${name} benchmark::benchmark)
+endfunction()
@@ -147,6 +147,34 @@ int ComputeCholeskyFactorL(int size_m, double * restrict chol) noexcept {
   return 0;
 }
 
+/*!\rst
+  Appends rows to the cholesky factor of the leading block (Cholesky-Banachiewicz, row by row):
+  ``L_{ij} = (A_{ij} - \sum_{p<j} L_{ip}*L_{jp})/L_{jj}`` for ``j < i`` and
+  ``L_{ii} = \sqrt(A_{ii} - \sum_{p<i} L_{ip}^2)``, which only reads rows of ``L`` computed before.
+\endrst*/
+int UpdateCholeskyFactorL(int size_m, int size_old, double * restrict chol) noexcept {
+#define OL_CHOL(i, j) chol[((j)*size_m + (i))]
+  for (int i = size_old; i < size_m; ++i) {  // over new rows
+    for (int j = 0; j <= i; ++j) {  // over columns
+      double L_ij = OL_CHOL(i, j);
+      for (int p = 0; p < j; ++p) {
+        L_ij -= OL_CHOL(i, p) * OL_CHOL(j, p);
+      }
+      if (j < i) {
+        OL_CHOL(i, j) = L_ij / OL_CHOL(j, j);
+      } else if (likely(L_ij > 1.0e-16)) {
+        OL_CHOL(i, i) = std::sqrt(L_ij);
+      } else {
+        // same singularity condition as ComputeCholeskyFactorL()
+        OL_ERROR_PRINTF("cholesky matrix singular %.18E ", L_ij);
+        return i + 1;
+      }
+    }
+  }
+#undef OL_CHOL
+  return 0;
+}
+
 /*!\rst
   Solve ``A*x = b`` or ``A^T*x = b`` when ``A`` is lower triangular IN-PLACE.
   Uses the standard "backsolve" technique, instead of forming ``A^-1`` which is
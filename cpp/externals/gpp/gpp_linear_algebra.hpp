@@ -156,6 +156,27 @@ inline OL_PURE_FUNCTION OL_NONNULL_POINTERS OL_WARN_UNUSED_RESULT double DotProd
 \endrst*/
 int ComputeCholeskyFactorL(int size_m, double * restrict chol) noexcept OL_NONNULL_POINTERS OL_WARN_UNUSED_RESULT;
 
+/*!\rst
+  Extends the cholesky factor of the leading ``size_old`` x ``size_old`` block of ``A`` to the cholesky factor of
+  ``A``, i.e., appends the rows of ``L`` corresponding to the last ``size_m - size_old`` rows of ``A``.
+
+  This is equivalent to ComputeCholeskyFactorL() but only costs ``O((size_m - size_old)*size_m^2)`` instead of
+  ``O(size_m^3)``; each appended row is a rank-one update of the factorization.
+
+  \param
+    :size_m: dimension of matrix
+    :size_old: dimension of the leading block which is already factored
+    :chol[size_m][size_m]: the leading ``size_old`` x ``size_old`` block holds its cholesky factor (as output by
+                           ComputeCholeskyFactorL()), the remaining rows of the lower triangle hold ``A`` (on entry)
+  \output
+    :chol[size_m][size_m]: cholesky factor of ``A`` (``L``).  ``L`` is stored in the lower triangle
+                           of ``A``.  Do not acccess the upper triangle of ``L``. (on exit)
+  \return
+    0 if successful. Otherwise the matrix is NOT positive definite and this returns ``i``, the
+    index of the ``i``-th leading minor that is not positive definite.
+\endrst*/
+int UpdateCholeskyFactorL(int size_m, int size_old, double * restrict chol) noexcept OL_NONNULL_POINTERS OL_WARN_UNUSED_RESULT;
+
 /*!\rst
   Solves the system ``A*x = b`` or ``A^T * x = b`` when ``A`` is lower triangular. ``A`` must be nonsingular.
   Before calling, ``x`` holds the RHS, ``b``.  After return, ``x`` will be OVERWRITTEN with
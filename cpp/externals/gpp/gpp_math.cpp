@@ -422,6 +422,7 @@ void BuildCovarianceMatrix(const CovarianceInterface& covariance,
 
   \param
     :noise_variance[num_sampled]: i-th entry is amt of noise variance to add to i-th diagonal entry; i.e., noise measuring i-th point
+    :first_new_point: only the rows of the points from this index on are filled (the others are left unchanged)
 \endrst*/
 OL_NONNULL_POINTERS void BuildCovarianceMatrixWithNoiseVariance(const CovarianceInterface& covariance,
                                                                 double const * restrict noise_variance,
@@ -429,11 +430,12 @@ OL_NONNULL_POINTERS void BuildCovarianceMatrixWithNoiseVariance(const Covariance
                                                                 int dim, int num_sampled,
                                                                 int const * restrict derivatives,
                                                                 int num_derivatives,
-                                                                double * restrict cov_matrix) noexcept {
+                                                                double * restrict cov_matrix,
+                                                                int first_new_point = 0) noexcept {
   // we only work with lower triangular parts of symmetric matrices, so only fill half of it
   double * cov_temp = new double[Square(num_derivatives+1)]();
   for (int i = 0; i < num_sampled; ++i) { // col
-    for (int j = i; j < num_sampled; ++j) { //row
+    for (int j = std::max(i, first_new_point); j < num_sampled; ++j) { //row
       covariance.Covariance(points_sampled + j*dim, derivatives, num_derivatives,
                             points_sampled + i*dim, derivatives, num_derivatives,
                             cov_temp);
@@ -456,11 +458,11 @@ OL_NONNULL_POINTERS void BuildCovarianceMatrixWithNoiseVariance(const Covariance
 
 }  // end unnamed namespace
 
-void GaussianProcess::BuildCovarianceMatrixWithNoiseVariance() noexcept {
+void GaussianProcess::BuildCovarianceMatrixWithNoiseVariance(int first_new_point) noexcept {
   optimal_learning::BuildCovarianceMatrixWithNoiseVariance(*covariance_ptr_, noise_variance_.data(),
                                                            points_sampled_.data(), dim_, num_sampled_,
                                                            derivatives_.data(), num_derivatives_,
-                                                           K_chol_.data());
+                                                           K_chol_.data(), first_new_point);
 }
 
 /*!\rst
@@ -550,6 +552,32 @@ void GaussianProcess::RecomputeMeanVariables(bool mean_change /* = true*/) {
   CholeskyFactorLMatrixVectorSolve(K_chol_.data(), num_sampled_*(num_derivatives_+1), K_inv_y_.data());
 }
 
+void GaussianProcess::ExtendDerivedVariables(int num_new_points, bool mean_change /* = true*/) {
+  const int num_old = num_sampled_ - num_new_points;
+  const int size_old = num_old*(num_derivatives_+1);
+  const int size_new = num_sampled_*(num_derivatives_+1);
+
+  // move the cholesky factor of the old points to the leading block of the larger matrix
+  std::vector<double> K_chol_new(Square(size_new));
+  for (int col = 0; col < size_old; ++col) {
+    std::copy(K_chol_.begin() + col*size_old, K_chol_.begin() + (col+1)*size_old,
+              K_chol_new.begin() + col*size_new);
+  }
+  K_chol_.swap(K_chol_new);
+
+  // covariance rows of the new points, then their rows of the cholesky factor
+  BuildCovarianceMatrixWithNoiseVariance(num_old);
+  int leading_minor_index = UpdateCholeskyFactorL(size_new, size_old, K_chol_.data());
+  if (unlikely(leading_minor_index != 0)) {
+    OL_THROW_EXCEPTION(SingularMatrixException,
+                       "Covariance matrix (K) singular. Check for duplicate points_sampled "
+                       "(with 0 noise) and/or extreme hyperparameter values.",
+                       K_chol_.data(), size_new, leading_minor_index);
+  }
+
+  RecomputeMeanVariables(mean_change);
+}
+
 GaussianProcess::GaussianProcess(const CovarianceInterface& covariance_in,
                                  double const * restrict points_sampled_in,
                                  double const * restrict points_sampled_value_in,
@@ -1712,10 +1740,9 @@ void GaussianProcess::AddPointsToGP(double const * restrict new_points,
   points_sampled_value_.resize(num_sampled_*(num_derivatives_+1));
   std::copy_backward(new_points_value, new_points_value + num_new_points*(num_derivatives_+1), points_sampled_value_.end());
 
-  // recompute derived quantities
-  // TODO(GH-192): Insert the new covariance (and cholesky covariance) rows into the current matrix  (O(N^2))
+  // insert the new covariance (and cholesky covariance) rows into the current matrix  (O(N^2))
   // instead of recomputing everything (O(N^3)).
-  RecomputeDerivedVariables(mean_change);
+  ExtendDerivedVariables(num_new_points, mean_change);
 }
 
 void GaussianProcess::AddSampledPointsToGP(double const * restrict new_points,
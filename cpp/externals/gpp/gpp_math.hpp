@@ -384,7 +384,8 @@ class GaussianProcess final {
   /*!\rst
     Add the specified (point, fcn value, noise variance) historical data to this GP.
 
-    Forces recomputation of all derived quantities for GP to remain consistent.
+    Updates all derived quantities for GP to remain consistent; the cholesky factor of the covariance is
+    extended by the new rows (``O(N^2)`` per row) rather than recomputed (``O(N^3)``).
 
     \param
       :new_points[dim][num_new_points]: coordinates of each new point to add
@@ -713,7 +714,7 @@ class GaussianProcess final {
   std::unique_ptr<CovarianceInterface> covariance_ptr_;
 
  private:
-  void BuildCovarianceMatrixWithNoiseVariance() noexcept;
+  void BuildCovarianceMatrixWithNoiseVariance(int first_new_point = 0) noexcept;
 
   /*!\rst
     :cov_matrix[num_sampled][num_to_sample]: computed "mix" covariance matrix
@@ -837,6 +838,12 @@ class GaussianProcess final {
 
   void RecomputeMeanVariables(bool mean_change = true);
 
+  /*!\rst
+    Extends the cholesky factor of the covariance by the last ``num_new_points`` points (which must have been
+    appended to the state variables already) and recomputes the mean quantities.
+  \endrst*/
+  void ExtendDerivedVariables(int num_new_points, bool mean_change = true);
+
   // size information
   //! spatial dimension (e.g., entries per point of ``points_sampled``)
   int dim_;
@@ -1629,6 +1636,53 @@ void RestartedGradientDescentEIOptimization(const ExpectedImprovementEvaluator&
   ei_state.GetCurrentPoint(next_point);
 }
 
+/*!\rst
+  Evaluates the Expected Improvement at each of the ``num_multistarts`` starting points of multistarted gradient
+  descent. The points are independent, so they are evaluated in parallel (one state per thread). A static schedule
+  keeps the (monte-carlo) EI of each point repeatable for a given number of threads.
+
+  \param
+    :ei_evaluator: evaluator object specifying how to compute EI
+    :thread_schedule: number of threads to use (schedule is ignored)
+    :start_point_set[problem_size][num_multistarts]: points at which to evaluate EI
+    :problem_size: number of coordinates of each point in ``start_point_set``
+    :num_multistarts: number of points in ``start_point_set``
+    :state_vector[thread_schedule.max_num_threads]: one state per thread (e.g., from SetupExpectedImprovementState())
+  \output
+    :state_vector[thread_schedule.max_num_threads]: states with the last point evaluated by each thread
+    :ei_values[num_multistarts]: EI at each point of ``start_point_set``
+  \raise
+    the first exception thrown while evaluating EI (after all threads finished)
+\endrst*/
+template <typename ExpectedImprovementEvaluator>
+OL_NONNULL_POINTERS void ComputeExpectedImprovementOfStartingPoints(
+    const ExpectedImprovementEvaluator& ei_evaluator,
+    const ThreadSchedule& thread_schedule,
+    double const * restrict start_point_set,
+    int problem_size,
+    int num_multistarts,
+    typename ExpectedImprovementEvaluator::StateType * state_vector,
+    double * restrict ei_values) {
+  // exceptions must not leave the OpenMP block; capture the first one (see MultistartOptimizer::MultistartOptimize())
+  std::once_flag exception_capture_flag;
+  std::exception_ptr captured_exception;
+#pragma omp parallel for num_threads(thread_schedule.max_num_threads) schedule(static)
+  for (int i = 0; i < num_multistarts; ++i) {
+    int thread_id = omp_get_thread_num();
+    try {
+      state_vector[thread_id].SetCurrentPoint(ei_evaluator, start_point_set + i*problem_size);
+      ei_values[i] = ei_evaluator.ComputeExpectedImprovement(state_vector + thread_id);
+    } catch (const std::exception& except) {
+      std::call_once(exception_capture_flag, [&captured_exception]() noexcept {
+          captured_exception = std::current_exception();
+        });
+    }
+  }
+  if (unlikely(captured_exception != nullptr)) {
+    std::rethrow_exception(captured_exception);
+  }
+}
+
 /*!\rst
   Perform multistart gradient descent (MGD) to solve the q,p-EI problem (see ComputeOptimalPointsToSample and/or
   header docs).  Starts a GD run from each point in ``start_point_set``.  The point corresponding to the
@@ -1710,10 +1764,9 @@ OL_NONNULL_POINTERS void ComputeOptimalPointsToSampleViaMultistartGradientDescen
                                   configure_for_gradients, &ei_state_vector);
 
     std::vector<double> EI_starting(num_multistarts);
-    for (int i=0; i<num_multistarts; ++i){
-      ei_state_vector[0].SetCurrentPoint(ei_evaluator, start_point_set + i*num_to_sample*gaussian_process.dim());
-      EI_starting[i] = ei_evaluator.ComputeExpectedImprovement(&ei_state_vector[0]);
-    }
+    ComputeExpectedImprovementOfStartingPoints(ei_evaluator, thread_schedule, start_point_set,
+                                               num_to_sample*gaussian_process.dim(), num_multistarts,
+                                               ei_state_vector.data(), EI_starting.data());
 
     std::priority_queue<std::pair<double, int>> q;
     int k = 20; // number of indices we need
@@ -1757,10 +1810,9 @@ OL_NONNULL_POINTERS void ComputeOptimalPointsToSampleViaMultistartGradientDescen
                                   configure_for_gradients, normal_rng, &ei_state_vector);
 
     std::vector<double> EI_starting(num_multistarts);
-    for (int i=0; i<num_multistarts; ++i){
-      ei_state_vector[0].SetCurrentPoint(ei_evaluator, start_point_set + i*num_to_sample*gaussian_process.dim());
-      EI_starting[i] = ei_evaluator.ComputeExpectedImprovement(&ei_state_vector[0]);
-    }
+    ComputeExpectedImprovementOfStartingPoints(ei_evaluator, thread_schedule, start_point_set,
+                                               num_to_sample*gaussian_process.dim(), num_multistarts,
+                                               ei_state_vector.data(), EI_starting.data());
 
     std::priority_queue<std::pair<double, int>> q;
     int k = 20; // number of indices we need
@@ -2,8 +2,10 @@
 #pragma once
 
 #include <float.h>
+#include <omp.h>
 
 #include <algorithm>
+#include <atomic>
 #include <climits>
 #include <cmath>
 #include <map>
@@ -13,6 +15,7 @@
 #include "utils/component.h"
 #include "utils/config.h"
 #include "utils/exception.h"
+#include "utils/instrumentation.h"
 #include "utils/log.h"
 #include "utils/operating_system.h"
 #include "utils/stream_handler.h"
@@ -20,6 +23,8 @@
 #include "graph/face.h"
 #include "graph/graph_properties.h"
 #include "graph/node.h"
+#include "graph/node_name_index.h"
+#include "graph/normalized_graph.h"
 
 namespace graph
 {
@@ -57,6 +62,26 @@ class GraphConfiguration
     static std::string get_key() { return graph::kNodesInputIdentifier; }
   };
 
+  /// Already normalized graph to configure from instead of the edges (set
+  /// when loading a binary problem file; nullptr otherwise).
+  struct Get_Normalized
+  {
+    static const NormalizedGraph*& get(GraphConfiguration& graph_config)
+    {
+      return graph_config.normalized_;
+    }
+  };
+
+  /// Whether terms with the same set of nodes are merged when normalizing
+  /// the edges (set by the caller, e.g. for `--merge-terms`).
+  struct Get_MergeDuplicateTerms
+  {
+    static bool& get(GraphConfiguration& graph_config)
+    {
+      return graph_config.merge_duplicate_terms_;
+    }
+  };
+
   using MembersStreamHandler = utils::ObjectMemberStreamHandler<
       utils::VectorObjectStreamHandler<typename EdgeType::StreamHandler>,
       GraphConfiguration, Get_Edges, true,
@@ -69,8 +94,141 @@ class GraphConfiguration
  private:
   std::vector<EdgeType> edges_;
   std::vector<NodeType> nodes_;
+  const NormalizedGraph* normalized_ = nullptr;
+  bool merge_duplicate_terms_ = false;
 };
 
+////////////////////////////////////////////////////////////////////////////////
+/// Merge edges with the same (sorted) set of node ids into the first of them
+/// by summing their costs; the others are marked in `removed`. Merged edges
+/// whose costs sum to zero are removed as well. Constant edges (without
+/// nodes) are left to the caller.
+///
+/// Edges are bucketed by the hash of their node ids in a single pass; each
+/// bucket is sorted and grouped on its own thread (costs are summed in input
+/// order).
+///
+template <typename Edge>
+void merge_duplicate_edges(std::vector<Edge>& edges, std::vector<char>& removed,
+                           GraphProperties& properties)
+{
+  removed.assign(edges.size(), 0);
+  std::vector<uint64_t> hashes(edges.size());
+  #pragma omp parallel for schedule(static)
+  for (size_t edge_id = 0; edge_id < edges.size(); edge_id++)
+  {
+    uint64_t hash = 0x9e3779b97f4a7c15ULL;
+    for (int id : edges[edge_id].node_ids())
+    {
+      hash = (hash ^ (uint64_t)(uint32_t)id) * 0xbf58476d1ce4e5b9ULL;
+      hash ^= hash >> 31;
+    }
+    hashes[edge_id] = hash;
+  }
+
+  // Bucket the (hash, edge id) pairs by partition: count the edges of each
+  // partition, then scatter them into its range of `buckets`.
+  size_t n_partitions = std::max(1, omp_get_max_threads());
+  std::vector<size_t> offsets(n_partitions + 1, 0);
+  for (size_t edge_id = 0; edge_id < edges.size(); edge_id++)
+  {
+    if (edges[edge_id].nodes_count() > 0)
+    {
+      offsets[hashes[edge_id] % n_partitions + 1]++;
+    }
+  }
+  for (size_t partition = 0; partition < n_partitions; partition++)
+  {
+    offsets[partition + 1] += offsets[partition];
+  }
+  std::vector<std::pair<uint64_t, size_t>> buckets(offsets[n_partitions]);
+  {
+    std::vector<size_t> next(offsets.begin(), offsets.end() - 1);
+    for (size_t edge_id = 0; edge_id < edges.size(); edge_id++)
+    {
+      if (edges[edge_id].nodes_count() > 0)
+      {
+        buckets[next[hashes[edge_id] % n_partitions]++] = {hashes[edge_id],
+                                                           edge_id};
+      }
+    }
+  }
+
+  uint64_t merged_terms = 0;
+  uint64_t cancelled_terms = 0;
+  #pragma omp parallel for schedule(dynamic, 1) \
+      reduction(+ : merged_terms, cancelled_terms)
+  for (size_t partition = 0; partition < n_partitions; partition++)
+  {
+    // Edge ids of the partition, sorted by hash (and by id within a hash).
+    std::pair<uint64_t, size_t>* members = buckets.data() + offsets[partition];
+    size_t members_count = offsets[partition + 1] - offsets[partition];
+    std::sort(members, members + members_count);
+
+    std::vector<size_t> representatives;
+    std::vector<size_t> merged_representatives;
+    for (size_t begin = 0, end = 0; begin < members_count; begin = end)
+    {
+      end = begin + 1;
+      while (end < members_count && members[end].first == members[begin].first)
+      {
+        end++;
+      }
+      if (end == begin + 1) continue;
+      // Within a run of equal hashes, compare against the distinct node sets
+      // seen so far (usually just one).
+      representatives.clear();
+      merged_representatives.clear();
+      for (size_t i = begin; i < end; i++)
+      {
+        size_t edge_id = members[i].second;
+        bool merged = false;
+        for (size_t representative : representatives)
+        {
+          Edge& target = edges[representative];
+          if (target.node_ids() == edges[edge_id].node_ids())
+          {
+            target.set_cost(target.cost() + edges[edge_id].cost());
+            removed[edge_id] = 1;
+            merged_terms++;
+            if (merged_representatives.empty() ||
+                merged_representatives.back() != representative)
+            {
+              merged_representatives.push_back(representative);
+            }
+            merged = true;
+            break;
+          }
+        }
+        if (!merged) representatives.push_back(edge_id);
+      }
+      std::sort(merged_representatives.begin(), merged_representatives.end());
+      merged_representatives.erase(std::unique(merged_representatives.begin(),
+                                               merged_representatives.end()),
+                                   merged_representatives.end());
+      for (size_t representative : merged_representatives)
+      {
+        if (edges[representative].cost() == 0)
+        {
+          removed[representative] = 1;
+          cancelled_terms++;
+        }
+      }
+    }
+  }
+  properties.merged_terms_ += merged_terms;
+  properties.cancelled_terms_ += cancelled_terms;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Normalize the input edges: map node names to dense node ids (in order of
+/// first appearance), sort (and, with `allow_dup_merge_`, deduplicate) the
+/// node ids of each edge, merge edges with the same nodes (with
+/// `merge_duplicate_terms_`), move constant terms into `const_cost_`, collect
+/// the locality properties and build the edge list of each node.
+///
+/// All phases but the final assembly of the name maps run on all threads.
+///
 template <typename Edge>
 void normalize_edges(std::vector<Edge>& edges,
                      std::vector<std::vector<size_t>>& local_nodes,
@@ -78,100 +236,221 @@ void normalize_edges(std::vector<Edge>& edges,
                      std::map<int, int>& node_name_to_id,
                      std::map<int, int>& node_id_to_name)
 {
-  std::vector<Edge> temp_edges = std::move(edges);
-
+  utils::ScopedPhase phase("normalize_edges");
   node_name_to_id.clear();
   node_id_to_name.clear();
-  edges.clear();
+  local_nodes.clear();
 
-  if (temp_edges.size() == 0)
+  if (edges.size() == 0)
   {
     THROW(utils::ValueException, "parameter `", kEdgesInputIdentifier,
           +"`: size must be greater than 0, found 0");
   }
 
-  edges.reserve(temp_edges.size());
-
-  int node_order = 0;
+  // Collect the names found in contiguous chunks of edges (in order of first
+  // appearance within the chunk), then assign dense ids by merging the chunks
+  // in order. This reproduces the ids of a sequential scan.
+  size_t n_chunks = std::min<size_t>(
+      std::max(1, omp_get_max_threads()), (edges.size() + 1023) / 1024);
+  std::vector<std::vector<int>> chunk_names(n_chunks);
+  #pragma omp parallel for schedule(static, 1)
+  for (size_t k = 0; k < n_chunks; k++)
+  {
+    NodeNameIndex seen;
+    size_t begin = edges.size() * k / n_chunks;
+    size_t end = edges.size() * (k + 1) / n_chunks;
+    for (size_t edge_id = begin; edge_id < end; edge_id++)
+    {
+      for (int name : edges[edge_id].node_ids())
+      {
+        int order = (int)chunk_names[k].size();
+        if (seen.insert(name, order) == order)
+        {
+          chunk_names[k].push_back(name);
+        }
+      }
+    }
+  }
+  NodeNameIndex name_index;
+  std::vector<int> id_to_name;
+  name_index.reserve(chunk_names[0].size());
+  for (auto& names : chunk_names)
+  {
+    for (int name : names)
+    {
+      if (name_index.insert(name, (int)id_to_name.size()) ==
+          (int)id_to_name.size())
+      {
+        id_to_name.push_back(name);
+      }
+    }
+    std::vector<int>().swap(names);
+  }
+  size_t node_count = id_to_name.size();
 
-  for (size_t edge_id = 0; edge_id < temp_edges.size(); edge_id++)
+  // Rewrite each edge in terms of sorted node ids.
+  bool duplicates = false;
+  #pragma omp parallel
   {
-    Edge new_edge;
-    std::set<int> new_edge_ids;
-    const Edge& old_edge = temp_edges[edge_id];
-    new_edge.set_cost(old_edge.cost());
+    bool thread_duplicates = false;
+    std::vector<int> ids;
 
-    for (int input_id : old_edge.node_ids())
+    #pragma omp for schedule(static)
+    for (size_t edge_id = 0; edge_id < edges.size(); edge_id++)
     {
-      auto search = node_name_to_id.find(input_id);
-      if (search == node_name_to_id.end())
+      Edge& edge = edges[edge_id];
+      ids.clear();
+      for (int name : edge.node_ids())
       {
-        // this is a new node id found
-        node_name_to_id.insert({input_id, node_order});
-        node_id_to_name.insert({node_order, input_id});
-        local_nodes.push_back(std::vector<size_t>());
-        node_order++;
-        assert((size_t)node_order == local_nodes.size());
+        ids.push_back(name_index.find(name));
       }
-      int internal_id = node_name_to_id[input_id];
-      assert(internal_id < node_order);
-
-      if (new_edge_ids.find(internal_id) == new_edge_ids.end())
+      std::sort(ids.begin(), ids.end());
+      auto last = std::unique(ids.begin(), ids.end());
+      if (last != ids.end())
       {
-        new_edge_ids.insert(internal_id);
-        new_edge.add_node_id(internal_id);
-        local_nodes[internal_id].push_back(edges.size());
+        thread_duplicates = true;
+        ids.erase(last, ids.end());
       }
-      else
+      edge.clear_node_ids();
+      for (int id : ids)
       {
-        if (!properties.allow_dup_merge_)
-        {
-          throw utils::DuplicatedVariableException(
-              "Duplicated ids detected in term!");
-        }
+        edge.add_node_id(id);
       }
     }
-    new_edge.sort_node_ids();
-    size_t locality = new_edge.node_ids().size();
-    if (locality > properties.max_locality_)
+
+    #pragma omp critical
+    duplicates = duplicates || thread_duplicates;
+  }
+  if (duplicates && !properties.allow_dup_merge_)
+  {
+    throw utils::DuplicatedVariableException(
+        "Duplicated ids detected in term!");
+  }
+
+  std::vector<char> removed;
+  if (properties.merge_duplicate_terms_)
+  {
+    merge_duplicate_edges(edges, removed, properties);
+  }
+
+  // Collect the locality properties (per thread, merged below).
+  #pragma omp parallel
+  {
+    uint32_t max_locality = properties.max_locality_;
+    uint32_t min_locality = properties.min_locality_;
+    uint64_t accumulated_dependent_vars = 0;
+    uint64_t accumulated_dependent_terms = 0;
+    double max_coupling_magnitude = properties.max_coupling_magnitude_;
+    double min_coupling_magnitude = properties.min_coupling_magnitude_;
+    uint64_t total_locality = 0;
+
+    #pragma omp for schedule(static)
+    for (size_t edge_id = 0; edge_id < edges.size(); edge_id++)
     {
-      properties.max_locality_ = locality;
+      if (!removed.empty() && removed[edge_id]) continue;
+      const Edge& edge = edges[edge_id];
+      uint32_t locality = (uint32_t)edge.nodes_count();
+      max_locality = std::max(max_locality, locality);
+      min_locality = std::min(min_locality, locality);
+      if (locality > 0)
+      {
+        accumulated_dependent_vars += (uint64_t)locality * (locality - 1);
+        accumulated_dependent_terms += locality;
+        double abs_cost = fabs(edge.cost());
+        max_coupling_magnitude = std::max(max_coupling_magnitude, abs_cost);
+        min_coupling_magnitude = std::min(min_coupling_magnitude, abs_cost);
+      }
+      total_locality += locality;
     }
-    if (properties.min_locality_ > locality)
+
+    #pragma omp critical
     {
-      properties.min_locality_ = locality;
+      properties.max_locality_ =
+          std::max(properties.max_locality_, max_locality);
+      properties.min_locality_ =
+          std::min(properties.min_locality_, min_locality);
+      properties.accumulated_dependent_vars_ += accumulated_dependent_vars;
+      properties.accumulated_dependent_terms_ += accumulated_dependent_terms;
+      properties.max_coupling_magnitude_ =
+          std::max(properties.max_coupling_magnitude_, max_coupling_magnitude);
+      properties.min_coupling_magnitude_ =
+          std::min(properties.min_coupling_magnitude_, min_coupling_magnitude);
+      properties.total_locality_ += total_locality;
     }
-    if (locality > 0)
+  }
+
+  // Constant terms (without nodes) are accumulated in const_cost_ (in input
+  // order) and removed from the edges, as are merged terms.
+  size_t edge_count = 0;
+  for (size_t edge_id = 0; edge_id < edges.size(); edge_id++)
+  {
+    if (!removed.empty() && removed[edge_id]) continue;
+    if (edges[edge_id].nodes_count() == 0)
     {
-      properties.accumulated_dependent_vars_ += locality * (locality - 1);
-      properties.accumulated_dependent_terms_ += locality;
+      properties.const_cost_ += edges[edge_id].cost();
     }
-    if (locality > 0)
+    else
     {
-      double abs_cost = fabs(new_edge.cost());
-      if (abs_cost > properties.max_coupling_magnitude_)
+      if (edge_count != edge_id)
       {
-        properties.max_coupling_magnitude_ = abs_cost;
-      }
-      if (abs_cost < properties.min_coupling_magnitude_)
-      {
-        properties.min_coupling_magnitude_ = abs_cost;
+        edges[edge_count] = std::move(edges[edge_id]);
       }
+      edge_count++;
     }
-    properties.total_locality_ += locality;
+  }
+  edges.resize(edge_count);
 
-    if (new_edge.nodes_count() > 0)
+  // Build the edge lists of the nodes: count, allocate, fill and sort (the
+  // fill order depends on the thread schedule).
+  std::vector<std::atomic<size_t>> cursor(node_count);
+  #pragma omp parallel for schedule(static)
+  for (size_t edge_id = 0; edge_id < edges.size(); edge_id++)
+  {
+    for (int id : edges[edge_id].node_ids())
     {
-      edges.push_back(new_edge);
+      cursor[id].fetch_add(1, std::memory_order_relaxed);
     }
-    else
+  }
+  local_nodes.resize(node_count);
+  #pragma omp parallel for schedule(static)
+  for (size_t id = 0; id < node_count; id++)
+  {
+    local_nodes[id].resize(cursor[id].load(std::memory_order_relaxed));
+    cursor[id].store(0, std::memory_order_relaxed);
+  }
+  #pragma omp parallel for schedule(static)
+  for (size_t edge_id = 0; edge_id < edges.size(); edge_id++)
+  {
+    for (int id : edges[edge_id].node_ids())
     {
-      // in case this is const term (there is no node), add the cost to
-      // properties_.const_cost_
-      properties.const_cost_ += new_edge.cost();
+      size_t position = cursor[id].fetch_add(1, std::memory_order_relaxed);
+      local_nodes[id][position] = edge_id;
     }
   }
-  assert(local_nodes.size() == (size_t)node_order);
+  #pragma omp parallel for schedule(dynamic, 1024)
+  for (size_t id = 0; id < node_count; id++)
+  {
+    std::sort(local_nodes[id].begin(), local_nodes[id].end());
+  }
+
+  // Sorted (hinted) insertion into the maps is linear.
+  for (size_t id = 0; id < node_count; id++)
+  {
+    node_id_to_name.emplace_hint(node_id_to_name.end(), (int)id,
+                                 id_to_name[id]);
+  }
+  std::vector<std::pair<int, int>> name_to_id(node_count);
+  #pragma omp parallel for schedule(static)
+  for (size_t id = 0; id < node_count; id++)
+  {
+    name_to_id[id] = {id_to_name[id], (int)id};
+  }
+  std::sort(name_to_id.begin(), name_to_id.end());
+  for (const auto& entry : name_to_id)
+  {
+    node_name_to_id.emplace_hint(node_name_to_id.end(), entry);
+  }
+
   properties.avg_locality_ =
       (double)(properties.total_locality_) / edges.size();
 }
@@ -211,6 +490,11 @@ class Graph : public utils::Component
 
   void set_allow_dup_merge(bool value) { properties_.allow_dup_merge_ = value; }
 
+  void set_merge_duplicate_terms(bool value)
+  {
+    properties_.merge_duplicate_terms_ = value;
+  }
+
   double get_const_cost() const { return properties_.const_cost_; }
 
   bool is_empty() const
@@ -390,12 +674,71 @@ class Graph : public utils::Component
 
   void configure(Configuration_T& config)
   {
+    const NormalizedGraph* normalized =
+        Configuration_T::Get_Normalized::get(config);
+    if (normalized != nullptr)
+    {
+      configure(*normalized);
+      return;
+    }
     LOG_MEMORY_USAGE("begin of graph configure");
+    if (Configuration_T::Get_MergeDuplicateTerms::get(config))
+    {
+      properties_.merge_duplicate_terms_ = true;
+    }
     edges_ = std::move(Configuration_T::Get_Edges::get(config));
     LOG_MEMORY_USAGE("end of graph configure");
     init();
   }
 
+  /// Configure the graph from an already normalized graph.
+  ///
+  /// This builds the edges and nodes directly, skipping the name mapping and
+  /// duplicate detection of `populate_node_edge_ids()`.
+  void configure(const NormalizedGraph& normalized)
+  {
+    LOG_MEMORY_USAGE("begin of graph configure");
+    normalized_memory_check(normalized);
+    // The properties (including how duplicates were treated) are those the
+    // graph was normalized with.
+    properties_ = normalized.properties;
+
+    edges_.clear();
+    edges_.resize(normalized.edge_count);
+    #pragma omp parallel for
+    for (size_t edge_id = 0; edge_id < normalized.edge_count; edge_id++)
+    {
+      Edge& edge = edges_[edge_id];
+      edge.set_cost(normalized.edge_costs[edge_id]);
+      for (uint64_t k = normalized.edge_offsets[edge_id];
+           k < normalized.edge_offsets[edge_id + 1]; k++)
+      {
+        edge.add_node_id(normalized.edge_node_ids[k]);
+      }
+    }
+
+    nodes_.clear();
+    nodes_.resize(normalized.node_count);
+    #pragma omp parallel for
+    for (size_t node_id = 0; node_id < normalized.node_count; node_id++)
+    {
+      nodes_[node_id] = Node(std::vector<size_t>(
+          normalized.node_edge_ids + normalized.node_offsets[node_id],
+          normalized.node_edge_ids + normalized.node_offsets[node_id + 1]));
+    }
+
+    node_name_to_id_.clear();
+    node_id_to_name_.clear();
+    for (size_t node_id = 0; node_id < normalized.node_count; node_id++)
+    {
+      int name = normalized.node_names[node_id];
+      node_name_to_id_.emplace(name, (int)node_id);
+      node_id_to_name_.emplace_hint(node_id_to_name_.end(), (int)node_id, name);
+    }
+    assert(validate());
+    LOG_MEMORY_USAGE("end of graph configure");
+  }
+
   utils::Structure render() const override
   {
     utils::Structure s;
@@ -598,6 +941,21 @@ class Graph : public utils::Component
           "Expected to exceed machine's current available memory.");
   }
 
+  void normalized_memory_check(const NormalizedGraph& normalized)
+  {
+    size_t n_connections = normalized.connection_count();
+    size_t memory_estimation =
+        normalized.edge_count * Edge::memory_estimate(0) +
+        utils::vector_values_memory_estimate<int>(n_connections) +
+        normalized.node_count * Node::memory_estimate(0) +
+        utils::vector_values_memory_estimate<size_t>(n_connections);
+    if (utils::get_available_memory() < memory_estimation)
+      throw utils::MemoryLimitedException(
+          "Input problem is too large (too many "
+          "terms and/or variables). "
+          "Expected to exceed machine's current available memory.");
+  }
+
   void init()
   {
     init_memory_check();
@@ -30,7 +30,8 @@ class CompactGraph : public utils::Component
         num_edges_(0),
         node_end_value_(0),
         edge_end_value_(0),
-        properties_()
+        properties_(),
+        normalized_(false)
   {
     static_assert(sizeof(ELEMTYPE) < 8,
                   "Can not be larger than or equal to 8 bytes");
@@ -42,14 +43,92 @@ class CompactGraph : public utils::Component
 
   void set_allow_dup_merge(bool value) { properties_.allow_dup_merge_ = value; }
 
+  void set_merge_duplicate_terms(bool value)
+  {
+    properties_.merge_duplicate_terms_ = value;
+  }
+
   double get_const_cost() const { return properties_.const_cost_; }
 
   bool is_empty() const { return num_nodes_ == 0; }
 
   void configure(Configuration_T& config)
   {
+    const NormalizedGraph* normalized =
+        Configuration_T::Get_Normalized::get(config);
+    if (normalized != nullptr)
+    {
+      configure(*normalized);
+      return;
+    }
     LOG_MEMORY_USAGE("begin of graph configure");
+    if (Configuration_T::Get_MergeDuplicateTerms::get(config))
+    {
+      properties_.merge_duplicate_terms_ = true;
+    }
     edges_ = std::move(Configuration_T::Get_Edges::get(config));
+    normalized_ = false;
+    LOG_MEMORY_USAGE("end of graph configure");
+  }
+
+  /// Configure from an already normalized graph (`init()` will then not
+  /// need to normalize the edges).
+  void configure(const NormalizedGraph& normalized)
+  {
+    LOG_MEMORY_USAGE("begin of graph configure");
+    // The properties (including how duplicates were treated) are those the
+    // graph was normalized with.
+    properties_ = normalized.properties;
+    num_nodes_ = normalized.node_count;
+    num_edges_ = normalized.edge_count;
+
+    edges_.clear();
+    edges_.resize(num_edges_);
+    #pragma omp parallel for
+    for (size_t edge_id = 0; edge_id < num_edges_; edge_id++)
+    {
+      Edge_T& edge = edges_[edge_id];
+      edge.set_cost(normalized.edge_costs[edge_id]);
+      for (uint64_t k = normalized.edge_offsets[edge_id];
+           k < normalized.edge_offsets[edge_id + 1]; k++)
+      {
+        edge.add_node_id(normalized.edge_node_ids[k]);
+      }
+    }
+
+    coefficients_.clear();
+    node_edges_associates_.clear();
+    coefficients_.reserve(properties_.accumulated_dependent_terms_);
+    node_edges_associates_.reserve(properties_.accumulated_dependent_vars_ +
+                                   properties_.accumulated_dependent_terms_);
+    node_name_to_id_.clear();
+    node_id_to_name_.clear();
+    for (size_t node_id = 0; node_id < num_nodes_; node_id++)
+    {
+      uint64_t begin = normalized.node_offsets[node_id];
+      uint64_t end = normalized.node_offsets[node_id + 1];
+      assert(end > begin);
+      for (uint64_t k = begin; k < end; k++)
+      {
+        uint64_t edge_id = normalized.node_edge_ids[k];
+        coefficients_.push_back(normalized.edge_costs[edge_id]);
+        for (uint64_t l = normalized.edge_offsets[edge_id];
+             l < normalized.edge_offsets[edge_id + 1]; l++)
+        {
+          if ((size_t)normalized.edge_node_ids[l] != node_id)
+          {
+            node_edges_associates_.push_back(
+                (ELEMTYPE)normalized.edge_node_ids[l]);
+          }
+        }
+        node_edges_associates_.push_back(k + 1 == end ? node_end_value_
+                                                      : edge_end_value_);
+      }
+      int name = normalized.node_names[node_id];
+      node_name_to_id_.emplace(name, (int)node_id);
+      node_id_to_name_.emplace_hint(node_id_to_name_.end(), (int)node_id, name);
+    }
+    normalized_ = true;
     LOG_MEMORY_USAGE("end of graph configure");
   }
 
@@ -61,6 +140,7 @@ class CompactGraph : public utils::Component
 
   void init()
   {
+    if (normalized_) return;
     std::vector<std::vector<size_t>> local_nodes;
     normalize_edges<Edge_T>(edges_, local_nodes, properties_, node_name_to_id_,
                             node_id_to_name_);
@@ -175,6 +255,8 @@ class CompactGraph : public utils::Component
     return properties_.total_locality_;
   }
 
+  const GraphProperties& get_properties() const { return properties_; }
+
   double estimate_max_cost_diff() const
   {
     double max_diff = 0;
@@ -233,5 +315,8 @@ class CompactGraph : public utils::Component
 
   // Graph properties.
   GraphProperties properties_;
+
+  // Whether the graph was configured from an already normalized graph.
+  bool normalized_;
 };
 }  // namespace graph
\ No newline at end of file
@@ -7,6 +7,7 @@ struct GraphProperties
 {
   GraphProperties()
       : allow_dup_merge_(false),
+        merge_duplicate_terms_(false),
         max_locality_(0),
         min_locality_(UINT_MAX),
         avg_locality_(0),
@@ -16,6 +17,8 @@ struct GraphProperties
         min_coupling_magnitude_(DBL_MAX),
         total_locality_(0),
         const_cost_(0),
+        merged_terms_(0),
+        cancelled_terms_(0),
         scale_factor_(1.0),
         is_rescaled_(false)
   {
@@ -40,6 +43,9 @@ struct GraphProperties
   }
 
   bool allow_dup_merge_;
+  // Whether terms with the same set of nodes are merged into one (by summing
+  // their costs), as requested by the graph's configuration.
+  bool merge_duplicate_terms_;
 
   uint32_t max_locality_;
   uint32_t min_locality_;
@@ -50,6 +56,10 @@ struct GraphProperties
   double min_coupling_magnitude_;
   uint64_t total_locality_;
   double const_cost_;
+  // Number of input terms merged into an earlier term with the same nodes.
+  uint64_t merged_terms_;
+  // Number of merged terms dropped because their costs summed to zero.
+  uint64_t cancelled_terms_;
 
   double scale_factor_;
   bool is_rescaled_;
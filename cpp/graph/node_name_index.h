@@ -0,0 +1,103 @@
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <algorithm>
+#include <vector>
+
+namespace graph
+{
+////////////////////////////////////////////////////////////////////////////////
+/// NodeNameIndex
+///
+/// Open-addressing hash map from node names (as found in the input) to dense
+/// node ids, used while normalizing edges. Lookups (`find`) are safe to run
+/// concurrently as long as no thread is inserting.
+///
+class NodeNameIndex
+{
+ public:
+  NodeNameIndex() : size_(0), mask_(0) {}
+
+  /// Prepare the index for `n` names (avoids rehashing while inserting).
+  void reserve(size_t n)
+  {
+    size_t capacity = 16;
+    while (capacity < 2 * n) capacity *= 2;
+    if (capacity > names_.size()) rehash(capacity);
+  }
+
+  /// Insert `name` with `id` unless it is present already; returns the id
+  /// associated with `name` (`id` if it was inserted).
+  int insert(int name, int id)
+  {
+    if (2 * (size_ + 1) > names_.size())
+    {
+      rehash(std::max<size_t>(16, 2 * names_.size()));
+    }
+    size_t slot = hash(name) & mask_;
+    while (ids_[slot] != kEmpty)
+    {
+      if (names_[slot] == name) return ids_[slot];
+      slot = (slot + 1) & mask_;
+    }
+    names_[slot] = name;
+    ids_[slot] = id;
+    size_++;
+    return id;
+  }
+
+  /// Return the id associated with `name` or -1 if it is not present.
+  int find(int name) const
+  {
+    if (size_ == 0) return kEmpty;
+    size_t slot = hash(name) & mask_;
+    while (ids_[slot] != kEmpty)
+    {
+      if (names_[slot] == name) return ids_[slot];
+      slot = (slot + 1) & mask_;
+    }
+    return kEmpty;
+  }
+
+  /// Number of names in the index.
+  size_t size() const { return size_; }
+
+ private:
+  static constexpr int kEmpty = -1;
+
+  static size_t hash(int name)
+  {
+    uint64_t x = (uint64_t)(uint32_t)name;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return (size_t)(x ^ (x >> 31));
+  }
+
+  void rehash(size_t capacity)
+  {
+    std::vector<int> names(capacity);
+    std::vector<int> ids(capacity, int(kEmpty));
+    size_t mask = capacity - 1;
+    for (size_t i = 0; i < names_.size(); i++)
+    {
+      if (ids_[i] == kEmpty) continue;
+      size_t slot = hash(names_[i]) & mask;
+      while (ids[slot] != kEmpty) slot = (slot + 1) & mask;
+      names[slot] = names_[i];
+      ids[slot] = ids_[i];
+    }
+    names_.swap(names);
+    ids_.swap(ids);
+    mask_ = mask;
+  }
+
+  std::vector<int> names_;
+  std::vector<int> ids_;
+  size_t size_;
+  size_t mask_;
+};
+
+}  // namespace graph
@@ -0,0 +1,59 @@
+
+#pragma once
+
+#include <float.h>
+
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+
+#include "utils/exception.h"
+#include "graph/graph_properties.h"
+
+namespace graph
+{
+////////////////////////////////////////////////////////////////////////////////
+/// Read-only view of a graph which has already been normalized.
+///
+/// This is the result of `normalize_edges()` in compressed sparse row (CSR)
+/// form: nodes carry their internal ids `0..(N-1)`, the node ids within each
+/// edge are sorted and unique, and constant terms have been folded into
+/// `properties.const_cost_`. The arrays are not owned by this struct; they
+/// typically point into a memory-mapped problem file.
+///
+///   * The node ids of edge `e` are
+///     `edge_node_ids[edge_offsets[e] .. edge_offsets[e + 1])`.
+///   * The edge ids of node `n` are
+///     `node_edge_ids[node_offsets[n] .. node_offsets[n + 1])`.
+///   * `node_names[n]` is the input name of node `n`.
+///
+struct NormalizedGraph
+{
+  NormalizedGraph()
+      : node_count(0),
+        edge_count(0),
+        edge_offsets(nullptr),
+        edge_node_ids(nullptr),
+        edge_costs(nullptr),
+        node_offsets(nullptr),
+        node_edge_ids(nullptr),
+        node_names(nullptr)
+  {
+  }
+
+  /// Number of node ids across all edges (== number of edge ids across all
+  /// nodes).
+  uint64_t connection_count() const { return edge_offsets[edge_count]; }
+
+  size_t node_count;
+  size_t edge_count;
+  const uint64_t* edge_offsets;
+  const int32_t* edge_node_ids;
+  const double* edge_costs;
+  const uint64_t* node_offsets;
+  const uint64_t* node_edge_ids;
+  const int32_t* node_names;
+  GraphProperties properties;
+};
+
+}  // namespace graph
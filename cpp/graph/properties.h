@@ -64,6 +64,8 @@ class Size : public Property<Graph>
     s[utils::kAccumDependentVars] = g.get_accumulated_dependent_vars();
     s[utils::kMaxCouplingMagnitude] = g.get_max_coupling_magnitude();
     s[utils::kMinCouplingMagnitude] = g.get_min_coupling_magnitude();
+    s[utils::kMergedTerms] = g.get_properties().merged_terms_;
+    s[utils::kCancelledTerms] = g.get_properties().cancelled_terms_;
     return s;
   }
 };
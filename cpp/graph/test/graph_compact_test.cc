@@ -64,6 +64,29 @@ TEST(CompactGraphTest, DuplicatedNodes)
   EXPECT_EQ(6, graph.get_sum_coefficient_degrees_total());
 }
 
+TEST(CompactGraphTest, MergesDuplicateTerms)
+{
+  CompactGraph graph;
+  std::string json_str(
+      R"({"terms":[{"ids":[0,1], "c":1}, {"ids":[1,0], "c":2}, {"ids":[2,1], "c":-1}, {"ids":[1,2], "c":1}, {"ids":[2], "c":5}, {"ids":[2,2], "c":1}, {"ids":[], "c":3}]})");
+  utils::configure_with_configuration_from_json_string(json_str, graph);
+  graph.set_allow_dup_merge(true);
+  graph.set_merge_duplicate_terms(true);
+  graph.init();
+  EXPECT_EQ(2, graph.edges_size());
+  EXPECT_EQ(3, graph.nodes_size());
+  EXPECT_EQ(3, graph.get_const_cost());
+  EXPECT_EQ(3, graph.get_properties().merged_terms_);
+  EXPECT_EQ(1, graph.get_properties().cancelled_terms_);
+  EXPECT_EQ(6, graph.estimate_max_cost_diff());
+  EXPECT_EQ(2, graph.get_locality());
+  EXPECT_EQ(0, graph.get_min_locality());
+  EXPECT_EQ(1.5, graph.get_avg_locality());
+  EXPECT_EQ(6., graph.get_max_coupling_magnitude());
+  EXPECT_EQ(3., graph.get_min_coupling_magnitude());
+  EXPECT_EQ(3, graph.get_sum_coefficient_degrees_total());
+}
+
 TEST(CompactGraphTest, DuplicatedNodesException)
 {
   CompactGraph graph;
@@ -359,6 +359,24 @@ TEST_F(GraphTest, MaxCostDiff)
   EXPECT_EQ(8, max_cost);
 }
 
+TEST_F(GraphTest, MergesDuplicateTerms)
+{
+  Graph graph;
+  graph.set_merge_duplicate_terms(true);
+  std::string json_str(
+      R"({"terms":[{"ids":[0,1], "c":1}, {"ids":[2,1], "c":-1}, {"ids":[1,0], "c":2}, {"ids":[1,2], "c":1}, {"ids":[2], "c":5}]})");
+  utils::configure_with_configuration_from_json_string(json_str, graph);
+  ASSERT_EQ(graph.edges().size(), 2);
+  EXPECT_EQ(graph.nodes().size(), 3);
+  EXPECT_EQ(graph.edge(0).node_ids(), std::vector<int>({0, 1}));
+  EXPECT_EQ(graph.edge(0).cost(), 3);
+  EXPECT_EQ(graph.edge(1).node_ids(), std::vector<int>({2}));
+  EXPECT_EQ(graph.node(1).edge_ids(), std::vector<size_t>({0}));
+  EXPECT_EQ(graph.node(2).edge_ids(), std::vector<size_t>({1}));
+  EXPECT_EQ(graph.get_properties().merged_terms_, 2);
+  EXPECT_EQ(graph.get_properties().cancelled_terms_, 1);
+}
+
 TEST_F(GraphTest, Serializes_Proto)
 {
   EXPECT_EQ(square_proto.edges().size(), 4);
@@ -0,0 +1,50 @@
+
+#include "../node_name_index.h"
+
+#include <climits>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+using ::graph::NodeNameIndex;
+
+TEST(NodeNameIndex, InitializesEmpty)
+{
+  NodeNameIndex index;
+  EXPECT_EQ(index.size(), 0u);
+  EXPECT_EQ(index.find(0), -1);
+}
+
+TEST(NodeNameIndex, InsertsAndFinds)
+{
+  NodeNameIndex index;
+  std::vector<int> names;
+  for (int i = 0; i < 10000; i++)
+  {
+    names.push_back((i % 2 ? -1 : 1) * i * 7919);
+  }
+  for (size_t i = 0; i < names.size(); i++)
+  {
+    EXPECT_EQ(index.insert(names[i], i), (int)i);
+  }
+  EXPECT_EQ(index.size(), names.size());
+  for (size_t i = 0; i < names.size(); i++)
+  {
+    // Present names keep their id.
+    EXPECT_EQ(index.insert(names[i], -5), (int)i);
+    EXPECT_EQ(index.find(names[i]), (int)i);
+  }
+  EXPECT_EQ(index.size(), names.size());
+  EXPECT_EQ(index.find(1), -1);
+  EXPECT_EQ(index.find(INT_MIN), -1);
+}
+
+TEST(NodeNameIndex, Reserves)
+{
+  NodeNameIndex index;
+  index.reserve(100);
+  index.insert(42, 0);
+  index.reserve(1000);
+  EXPECT_EQ(index.find(42), 0);
+  EXPECT_EQ(index.size(), 1u);
+}
@@ -6,10 +6,12 @@
 #include <memory>
 #include <vector>
 
+#include "utils/binary_solution.h"
 #include "utils/component.h"
 #include "utils/config.h"
 #include "utils/exception.h"
 #include "utils/random_generator.h"
+#include "utils/structure_writer.h"
 #include "markov/state.h"
 #include "markov/transition.h"
 #include "model/base_model.h"
@@ -161,6 +163,33 @@ class Model : public ::model::BaseModel
     return rendered;
   }
 
+  /// Write a state of this model (as `render_state` renders it) with `writer`
+  ///
+  /// Models with large states override this to write the rendering directly
+  /// instead of building a `utils::Structure` first.
+  virtual void write_state(const State_T& state,
+                           utils::StructureWriter& writer) const
+  {
+    writer.write(render_state(state));
+  }
+
+  /// Describe the variables of this model for binary solution output
+  /// (`utils::BinarySolutionWriter`): their input names and how their values
+  /// are encoded. Returns false if the model does not support it.
+  virtual bool get_binary_variables(std::vector<int>&,
+                                    utils::SolutionEncoding&) const
+  {
+    return false;
+  }
+
+  /// Get the value of each variable in `state` (in the order of the names
+  /// returned by `get_binary_variables`).
+  virtual void get_binary_values(const State_T&, std::vector<int>&) const
+  {
+    THROW(utils::NotImplementedException, this->get_identifier(),
+          " does not support binary solution output.");
+  }
+
   /// Return the number of (attempted) transition to consider `one sweep`.
   ///
   /// This number is expected to scale roughly with the number of variables
@@ -0,0 +1,398 @@
+
+#include "model/binary_problem.h"
+
+#include <cstdio>
+#include <cstring>
+#include <map>
+
+#include "utils/exception.h"
+#include "utils/log.h"
+#include "graph/graph.h"
+
+namespace model
+{
+namespace
+{
+constexpr char kMagic[8] = {'Q', 'I', 'O', 'P', 'R', 'O', 'B', '\n'};
+constexpr uint32_t kByteOrderMark = 0x01020304;
+
+struct Header
+{
+  char magic[8];
+  uint32_t format_version;
+  uint32_t byte_order;
+  char type[32];
+  char version[16];
+
+  uint64_t node_count;
+  uint64_t edge_count;
+  uint64_t connection_count;
+  uint64_t initial_configuration_count;
+
+  // graph::GraphProperties of the normalized graph.
+  uint32_t allow_dup_merge;
+  uint32_t merge_duplicate_terms;
+  uint32_t max_locality;
+  uint32_t min_locality;
+  uint64_t accumulated_dependent_vars;
+  uint64_t accumulated_dependent_terms;
+  uint64_t total_locality;
+  double avg_locality;
+  double max_coupling_magnitude;
+  double min_coupling_magnitude;
+  double const_cost;
+  uint64_t merged_terms;
+  uint64_t cancelled_terms;
+
+  // Byte offsets of the sections from the beginning of the file.
+  uint64_t edge_offsets;
+  uint64_t edge_node_ids;
+  uint64_t edge_costs;
+  uint64_t node_offsets;
+  uint64_t node_edge_ids;
+  uint64_t node_names;
+  uint64_t initial_configuration;
+};
+
+static_assert(sizeof(Header) % 8 == 0, "header must keep sections aligned");
+
+bool is_graph_model_type(const std::string& type)
+{
+  return type == "ising" || type == "pubo" || type == "blume-capel";
+}
+
+// Copy a fixed-size, possibly unterminated string field.
+std::string read_string(const char* field, size_t size)
+{
+  return std::string(field, strnlen(field, size));
+}
+
+// Writes the sections of the file, keeping track of their offsets.
+class SectionWriter
+{
+ public:
+  SectionWriter(const std::string& file_name)
+      : file_name_(file_name), fp_(std::fopen(file_name.c_str(), "wb")), pos_(0)
+  {
+    if (fp_ == nullptr)
+    {
+      throw utils::FileWriteException("Unable to write file " + file_name +
+                                      ".");
+    }
+  }
+
+  ~SectionWriter()
+  {
+    if (fp_ != nullptr) std::fclose(fp_);
+  }
+
+  uint64_t position() const { return pos_; }
+
+  void write(const void* data, size_t bytes)
+  {
+    if (bytes > 0 && std::fwrite(data, 1, bytes, fp_) != bytes)
+    {
+      throw utils::FileWriteException("Unable to write file " + file_name_ +
+                                      ".");
+    }
+    pos_ += bytes;
+  }
+
+  // Write `values` padded to 8 bytes and return the offset they start at.
+  template <class T>
+  uint64_t write_section(const std::vector<T>& values)
+  {
+    static const char kPadding[8] = {0};
+    uint64_t offset = pos_;
+    write(values.data(), values.size() * sizeof(T));
+    write(kPadding, (8 - pos_ % 8) % 8);
+    return offset;
+  }
+
+  void rewrite_header(const Header& header)
+  {
+    if (std::fseek(fp_, 0, SEEK_SET) != 0 ||
+        std::fwrite(&header, sizeof(Header), 1, fp_) != 1 ||
+        std::fclose(fp_) != 0)
+    {
+      fp_ = nullptr;
+      throw utils::FileWriteException("Unable to write file " + file_name_ +
+                                      ".");
+    }
+    fp_ = nullptr;
+  }
+
+ private:
+  std::string file_name_;
+  std::FILE* fp_;
+  uint64_t pos_;
+};
+
+}  // namespace
+
+bool BinaryProblem::is_binary_problem(const std::string& file_name)
+{
+  char magic[sizeof(kMagic)];
+  std::FILE* fp = std::fopen(file_name.c_str(), "rb");
+  if (fp == nullptr) return false;
+  bool matches = std::fread(magic, 1, sizeof(magic), fp) == sizeof(magic) &&
+                 std::memcmp(magic, kMagic, sizeof(kMagic)) == 0;
+  std::fclose(fp);
+  return matches;
+}
+
+void BinaryProblem::open(const std::string& file_name)
+{
+  file_.open(file_name);
+  const char* data = file_.data();
+  size_t size = file_.size();
+  if (size < sizeof(Header) ||
+      std::memcmp(data, kMagic, sizeof(kMagic)) != 0)
+  {
+    THROW(utils::ParsingException, "File ", file_name,
+          " is not a binary problem file.");
+  }
+  Header header;
+  std::memcpy(&header, data, sizeof(Header));
+  if (header.format_version != kBinaryProblemFormatVersion)
+  {
+    THROW(utils::ParsingException, "Unsupported binary problem format version ",
+          header.format_version, " in ", file_name, " (expected ",
+          kBinaryProblemFormatVersion, ").");
+  }
+  if (header.byte_order != kByteOrderMark)
+  {
+    THROW(utils::ParsingException, "Binary problem file ", file_name,
+          " was written with a different byte order.");
+  }
+  type_ = read_string(header.type, sizeof(header.type));
+  version_ = read_string(header.version, sizeof(header.version));
+  if (!is_graph_model_type(type_))
+  {
+    THROW(utils::ParsingException, "Unsupported model type '", type_,
+          "' in binary problem file ", file_name, ".");
+  }
+
+  // Locate a section of `count` elements of type T and check its bounds.
+  auto section = [&](uint64_t offset, uint64_t count, size_t element_size) {
+    if (offset % 8 != 0 || offset < sizeof(Header) || offset > size ||
+        count > (size - offset) / element_size)
+    {
+      THROW(utils::ParsingException, "Binary problem file ", file_name,
+            " is truncated or corrupt.");
+    }
+    return data + offset;
+  };
+  graph_ = graph::NormalizedGraph();
+  graph_.node_count = header.node_count;
+  graph_.edge_count = header.edge_count;
+  graph_.edge_offsets = reinterpret_cast<const uint64_t*>(
+      section(header.edge_offsets, header.edge_count + 1, sizeof(uint64_t)));
+  graph_.edge_node_ids = reinterpret_cast<const int32_t*>(section(
+      header.edge_node_ids, header.connection_count, sizeof(int32_t)));
+  graph_.edge_costs = reinterpret_cast<const double*>(
+      section(header.edge_costs, header.edge_count, sizeof(double)));
+  graph_.node_offsets = reinterpret_cast<const uint64_t*>(
+      section(header.node_offsets, header.node_count + 1, sizeof(uint64_t)));
+  graph_.node_edge_ids = reinterpret_cast<const uint64_t*>(section(
+      header.node_edge_ids, header.connection_count, sizeof(uint64_t)));
+  graph_.node_names = reinterpret_cast<const int32_t*>(
+      section(header.node_names, header.node_count, sizeof(int32_t)));
+  const int32_t* initial_configuration =
+      reinterpret_cast<const int32_t*>(section(
+          header.initial_configuration,
+          2 * header.initial_configuration_count, sizeof(int32_t)));
+
+  // Validate the references such that models can trust them.
+  size_t invalid = 0;
+  if (graph_.edge_offsets[0] != 0 || graph_.node_offsets[0] != 0 ||
+      graph_.edge_offsets[graph_.edge_count] != header.connection_count ||
+      graph_.node_offsets[graph_.node_count] != header.connection_count)
+  {
+    invalid++;
+  }
+  #pragma omp parallel for reduction(+ : invalid)
+  for (size_t edge_id = 0; edge_id < graph_.edge_count; edge_id++)
+  {
+    uint64_t begin = graph_.edge_offsets[edge_id];
+    uint64_t end = graph_.edge_offsets[edge_id + 1];
+    if (begin >= end || end > header.connection_count)
+    {
+      invalid++;
+      continue;
+    }
+    for (uint64_t k = begin; k < end; k++)
+    {
+      int32_t node_id = graph_.edge_node_ids[k];
+      if (node_id < 0 || (uint64_t)node_id >= graph_.node_count ||
+          (k > begin && graph_.edge_node_ids[k - 1] >= node_id))
+      {
+        invalid++;
+      }
+    }
+  }
+  #pragma omp parallel for reduction(+ : invalid)
+  for (size_t node_id = 0; node_id < graph_.node_count; node_id++)
+  {
+    uint64_t begin = graph_.node_offsets[node_id];
+    uint64_t end = graph_.node_offsets[node_id + 1];
+    if (begin >= end || end > header.connection_count)
+    {
+      invalid++;
+      continue;
+    }
+    for (uint64_t k = begin; k < end; k++)
+    {
+      if (graph_.node_edge_ids[k] >= graph_.edge_count) invalid++;
+    }
+  }
+  if (invalid > 0)
+  {
+    THROW(utils::ParsingException, "Binary problem file ", file_name,
+          " contains invalid graph references.");
+  }
+
+  auto& properties = graph_.properties;
+  properties.allow_dup_merge_ = header.allow_dup_merge != 0;
+  properties.merge_duplicate_terms_ = header.merge_duplicate_terms != 0;
+  properties.max_locality_ = header.max_locality;
+  properties.min_locality_ = header.min_locality;
+  properties.avg_locality_ = header.avg_locality;
+  properties.accumulated_dependent_vars_ = header.accumulated_dependent_vars;
+  properties.accumulated_dependent_terms_ = header.accumulated_dependent_terms;
+  properties.max_coupling_magnitude_ = header.max_coupling_magnitude;
+  properties.min_coupling_magnitude_ = header.min_coupling_magnitude;
+  properties.total_locality_ = header.total_locality;
+  properties.const_cost_ = header.const_cost;
+  properties.merged_terms_ = header.merged_terms;
+  properties.cancelled_terms_ = header.cancelled_terms;
+
+  initial_configuration_.resize(header.initial_configuration_count);
+  for (size_t i = 0; i < initial_configuration_.size(); i++)
+  {
+    initial_configuration_[i] = {initial_configuration[2 * i],
+                                 initial_configuration[2 * i + 1]};
+  }
+  LOG(INFO, "Mapped binary problem ", file_name, " (", type_, ", ",
+      graph_.node_count, " variables, ", graph_.edge_count, " terms).");
+}
+
+void BinaryProblem::configure(GraphModelConfiguration& configuration) const
+{
+  BaseModelConfiguration::Get_Type::get(configuration) = type_;
+  BaseModelConfiguration::Get_Version::get(configuration) = version_;
+  GraphModelConfiguration::Get_Initial_Configuration::get(configuration) =
+      initial_configuration_;
+  GraphModelConfiguration::Get_Edges::get(configuration).clear();
+  GraphModelConfiguration::Get_Normalized::get(configuration) = &graph_;
+}
+
+void BinaryProblem::write(const std::string& file_name,
+                          GraphModelConfiguration& configuration)
+{
+  const std::string& type = BaseModelConfiguration::Get_Type::get(configuration);
+  const std::string& version =
+      BaseModelConfiguration::Get_Version::get(configuration);
+  if (!is_graph_model_type(type))
+  {
+    THROW(utils::ValueException, "Model type '", type,
+          "' cannot be written as a binary problem.");
+  }
+  if (type.size() >= sizeof(Header::type) ||
+      version.size() >= sizeof(Header::version))
+  {
+    THROW(utils::ValueException, "Model type or version too long: '", type,
+          "', '", version, "'.");
+  }
+
+  // Create the file before touching `configuration`, such that a failure to
+  // do so leaves it intact.
+  SectionWriter writer(file_name);
+
+  // Normalize the edges the same way the models do (only pubo allows
+  // repeated variables in a term, see `AbstractPubo`). The properties used
+  // are stored with the graph, which the models then adopt.
+  auto& edges = GraphModelConfiguration::Get_Edges::get(configuration);
+  std::vector<std::vector<size_t>> local_nodes;
+  graph::GraphProperties properties;
+  properties.allow_dup_merge_ = (type == "pubo");
+  properties.merge_duplicate_terms_ =
+      GraphModelConfiguration::Get_MergeDuplicateTerms::get(configuration);
+  std::map<int, int> node_name_to_id;
+  std::map<int, int> node_id_to_name;
+  graph::normalize_edges(edges, local_nodes, properties, node_name_to_id,
+                         node_id_to_name);
+
+  std::vector<uint64_t> edge_offsets(edges.size() + 1, 0);
+  std::vector<double> edge_costs(edges.size());
+  for (size_t edge_id = 0; edge_id < edges.size(); edge_id++)
+  {
+    edge_offsets[edge_id + 1] =
+        edge_offsets[edge_id] + edges[edge_id].node_ids().size();
+    edge_costs[edge_id] = edges[edge_id].cost();
+  }
+  std::vector<int32_t> edge_node_ids;
+  edge_node_ids.reserve(edge_offsets.back());
+  for (const auto& edge : edges)
+  {
+    edge_node_ids.insert(edge_node_ids.end(), edge.node_ids().begin(),
+                         edge.node_ids().end());
+  }
+  std::vector<uint64_t> node_offsets(local_nodes.size() + 1, 0);
+  std::vector<uint64_t> node_edge_ids;
+  node_edge_ids.reserve(edge_offsets.back());
+  std::vector<int32_t> node_names(local_nodes.size());
+  for (size_t node_id = 0; node_id < local_nodes.size(); node_id++)
+  {
+    node_edge_ids.insert(node_edge_ids.end(), local_nodes[node_id].begin(),
+                         local_nodes[node_id].end());
+    node_offsets[node_id + 1] = node_edge_ids.size();
+    node_names[node_id] = node_id_to_name.at((int)node_id);
+  }
+  std::vector<int32_t> initial_configuration;
+  for (const auto& name_value :
+       GraphModelConfiguration::Get_Initial_Configuration::get(configuration))
+  {
+    initial_configuration.push_back(name_value.first);
+    initial_configuration.push_back(name_value.second);
+  }
+
+  Header header;
+  std::memset(&header, 0, sizeof(Header));
+  std::memcpy(header.magic, kMagic, sizeof(kMagic));
+  header.format_version = kBinaryProblemFormatVersion;
+  header.byte_order = kByteOrderMark;
+  std::memcpy(header.type, type.data(), type.size());
+  std::memcpy(header.version, version.data(), version.size());
+  header.node_count = local_nodes.size();
+  header.edge_count = edges.size();
+  header.connection_count = edge_offsets.back();
+  header.initial_configuration_count = initial_configuration.size() / 2;
+  header.allow_dup_merge = properties.allow_dup_merge_ ? 1 : 0;
+  header.merge_duplicate_terms = properties.merge_duplicate_terms_ ? 1 : 0;
+  header.max_locality = properties.max_locality_;
+  header.min_locality = properties.min_locality_;
+  header.accumulated_dependent_vars = properties.accumulated_dependent_vars_;
+  header.accumulated_dependent_terms = properties.accumulated_dependent_terms_;
+  header.total_locality = properties.total_locality_;
+  header.avg_locality = properties.avg_locality_;
+  header.max_coupling_magnitude = properties.max_coupling_magnitude_;
+  header.min_coupling_magnitude = properties.min_coupling_magnitude_;
+  header.const_cost = properties.const_cost_;
+  header.merged_terms = properties.merged_terms_;
+  header.cancelled_terms = properties.cancelled_terms_;
+
+  writer.write(&header, sizeof(Header));
+  header.edge_offsets = writer.write_section(edge_offsets);
+  header.edge_node_ids = writer.write_section(edge_node_ids);
+  header.edge_costs = writer.write_section(edge_costs);
+  header.node_offsets = writer.write_section(node_offsets);
+  header.node_edge_ids = writer.write_section(node_edge_ids);
+  header.node_names = writer.write_section(node_names);
+  header.initial_configuration = writer.write_section(initial_configuration);
+  writer.rewrite_header(header);
+  LOG(INFO, "Wrote binary problem ", file_name, " (", type, ", ",
+      header.node_count, " variables, ", header.edge_count, " terms).");
+}
+
+}  // namespace model
@@ -0,0 +1,89 @@
+
+#pragma once
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "utils/mapped_file.h"
+#include "graph/normalized_graph.h"
+#include "model/graph_model.h"
+
+namespace model
+{
+/// File extension conventionally used for binary problem files.
+constexpr char kBinaryProblemExtension[] = ".qiob";
+
+/// Current version of the binary problem format.
+constexpr uint32_t kBinaryProblemFormatVersion = 3;
+
+////////////////////////////////////////////////////////////////////////////////
+/// Binary problem file
+///
+/// A versioned binary format for graph models (`ising`, `pubo` and
+/// `blume-capel`) which stores the problem after `normalize_edges()`:
+///
+///   * a fixed-size header with the model type and version, the element
+///     counts, the `GraphProperties` and the byte offset of each section,
+///   * the edges in CSR form (offsets, internal node ids and costs),
+///   * the nodes in CSR form (offsets and edge ids),
+///   * the input name of each node and
+///   * the initial configuration (if any) as (name, value) pairs.
+///
+/// All values are stored in native (little-endian) byte order and every
+/// section is 8-byte aligned, such that the file can be memory-mapped and its
+/// arrays used in place. Loading a model from it therefore involves no
+/// parsing and no normalization:
+///
+///   BinaryProblem problem;
+///   problem.open("problem.qiob");
+///   GraphModelConfiguration configuration;
+///   problem.configure(configuration);
+///   ising.configure(configuration);
+///
+/// `BinaryProblem::write()` converts a (JSON or protobuf) configuration to
+/// this format; see `qiotoolkit-convert`.
+///
+class BinaryProblem
+{
+ public:
+  /// Whether `file_name` is a binary problem file (judged by its header).
+  static bool is_binary_problem(const std::string& file_name);
+
+  /// Map and validate `file_name`.
+  ///
+  /// Throws a ParsingException if the file is not a valid binary problem.
+  void open(const std::string& file_name);
+
+  /// Model type of the problem (e.g., "ising").
+  const std::string& type() const { return type_; }
+
+  /// Version of the input format the problem was converted from.
+  const std::string& version() const { return version_; }
+
+  /// The normalized graph (pointing into the mapped file).
+  const graph::NormalizedGraph& graph() const { return graph_; }
+
+  /// Prepare `configuration` for configuring a graph model.
+  ///
+  /// The configuration refers to the mapped file, so this BinaryProblem
+  /// must outlive the call configuring the model from it.
+  void configure(GraphModelConfiguration& configuration) const;
+
+  /// Normalize the graph in `configuration` and write it to `file_name`.
+  ///
+  /// NOTE: This moves the edges out of `configuration` (unless the file
+  /// cannot be created, in which case a FileWriteException is thrown before
+  /// modifying it).
+  static void write(const std::string& file_name,
+                    GraphModelConfiguration& configuration);
+
+ private:
+  utils::MappedFile file_;
+  std::string type_;
+  std::string version_;
+  graph::NormalizedGraph graph_;
+  std::vector<std::pair<int, int>> initial_configuration_;
+};
+
+}  // namespace model
@@ -142,6 +142,17 @@ class GraphModel : public ::markov::Model<State_T, Transition_T, Cost_T>
   /// Return a specific edge by EdgeId.
   inline const Edge& edge(size_t id) const { return graph_.edges()[id]; }
 
+  /// Return the input name of each node (indexed by NodeId).
+  std::vector<int> get_node_names() const
+  {
+    std::vector<int> names(nodes().size());
+    for (const auto& it : graph_.output_map())
+    {
+      if ((size_t)it.first < names.size()) names[it.first] = it.second;
+    }
+    return names;
+  }
+
   /// Configure the graph from JSON document
   void configure(const utils::Json& json) override
   {
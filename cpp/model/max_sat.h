@@ -3,9 +3,12 @@
 
 #include <assert.h>
 
+#include <algorithm>
+#include <atomic>
 #include <set>
 
 #include "utils/dimacs.h"
+#include "utils/dimacs_reader.h"
 #include "utils/operating_system.h"
 #include "utils/utils.h"
 #include "markov/model.h"
@@ -287,6 +290,86 @@ class MaxSat : public markov::Model<MaxSatState<Counter_T>, size_t>
     configure(dimacs.get_clauses());
   }
 
+  /// Read a max-sat problem from the flat arrays of a `utils::DimacsReader`.
+  ///
+  /// Dimacs input never contains clauses which are always true (a variable
+  /// appearing both positive and negative is rejected when parsing), so
+  /// the adj-list can be built directly, without the sets used above.
+  void configure(const utils::DimacsReader& dimacs)
+  {
+    const auto& weights = dimacs.get_weights();
+    const auto& offsets = dimacs.get_clause_offsets();
+    const auto& literals = dimacs.get_literals();
+    free_variables_.clear();
+    variable_names_ = dimacs.get_variables();
+    weights_.clear();
+    affected_.clear();
+    if (variable_names_.empty() || weights.empty()) return;
+
+    // Translate each (positive) variable name to its variable_id; names are
+    // sorted, so this is a lookup table if they are dense enough and a
+    // binary search otherwise.
+    int max_name = variable_names_.back();
+    bool dense = (size_t)max_name <= 2 * literals.size() + 1024;
+    std::vector<int> name_to_id(dense ? max_name + 1 : 0, -1);
+    for (size_t id = 0; dense && id < variable_names_.size(); id++)
+    {
+      name_to_id[variable_names_[id]] = (int)id;
+    }
+    auto lookup = [&](int name) -> int {
+      if (dense) return name_to_id[name];
+      return (int)(std::lower_bound(variable_names_.begin(),
+                                    variable_names_.end(), name) -
+                   variable_names_.begin());
+    };
+
+    // Clauses (and their weights) use 1-based indexing.
+    size_t n_clauses = weights.size();
+    weights_.resize(n_clauses + 1);
+    max_weight_ = std::numeric_limits<Cost_T>::min();
+    max_vars_in_clause_ = 0;
+    for (size_t i = 0; i < n_clauses; i++)
+    {
+      weights_[i + 1] = weights[i];
+      max_weight_ = std::max(max_weight_, weights[i]);
+      max_vars_in_clause_ = std::max<size_t>(max_vars_in_clause_,
+                                             offsets[i + 1] - offsets[i]);
+    }
+
+    // Count the clauses of each variable, then fill the (pre-sized) lists
+    // in parallel and restore the increasing clause order.
+    std::vector<int> ids(literals.size());
+    std::vector<std::atomic<size_t>> counts(variable_names_.size());
+    #pragma omp parallel for schedule(static)
+    for (size_t i = 0; i < literals.size(); i++)
+    {
+      ids[i] = lookup(std::abs(literals[i]));
+      counts[ids[i]].fetch_add(1, std::memory_order_relaxed);
+    }
+    affected_.resize(variable_names_.size());
+    for (size_t id = 0; id < affected_.size(); id++)
+    {
+      affected_[id].resize(counts[id].load(std::memory_order_relaxed));
+      counts[id].store(0, std::memory_order_relaxed);
+    }
+    #pragma omp parallel for schedule(dynamic, 1024)
+    for (size_t i = 0; i < n_clauses; i++)
+    {
+      int clause_id = (int)i + 1;
+      for (uint64_t j = offsets[i]; j < offsets[i + 1]; j++)
+      {
+        size_t slot = counts[ids[j]].fetch_add(1, std::memory_order_relaxed);
+        affected_[ids[j]][slot] = literals[j] < 0 ? -clause_id : clause_id;
+      }
+    }
+    #pragma omp parallel for schedule(dynamic, 64)
+    for (size_t id = 0; id < affected_.size(); id++)
+    {
+      std::sort(affected_[id].begin(), affected_[id].end(),
+                [](int a, int b) { return std::abs(a) < std::abs(b); });
+    }
+  }
+
   /// Turn a list of clauses into adj-list representation for simulation.
   ///
   /// This uses the position in variables as the variable_id and makes
@@ -133,6 +133,23 @@ class Potts : public GraphModel<PottsState, PottsTransition>
     return State_T::memory_estimate(nodes().size());
   }
 
+  /// Potts spins (0..q-1) are written as the smallest integers holding q
+  /// values, named by their node.
+  bool get_binary_variables(std::vector<int>& names,
+                            utils::SolutionEncoding& encoding) const override
+  {
+    names = get_node_names();
+    encoding.type =
+        utils::SolutionEncoding::smallest_int(0, (int64_t)q_ - 1);
+    return true;
+  }
+
+  void get_binary_values(const State_T& state,
+                         std::vector<int>& values) const override
+  {
+    values.assign(state.spins.begin(), state.spins.end());
+  }
+
  private:
   double calculate_term(const PottsState& state, size_t edge_id) const;
   double calculate_term(const PottsState& state, size_t edge_id,
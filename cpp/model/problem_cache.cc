@@ -0,0 +1,141 @@
+
+#include "model/problem_cache.h"
+
+#include <chrono>
+#include <cstdio>
+#include <iomanip>
+#include <sstream>
+#include <vector>
+
+#include "utils/exception.h"
+#include "utils/log.h"
+#include "utils/mapped_file.h"
+#include "utils/operating_system.h"
+#include "utils/utils.h"
+
+namespace model
+{
+namespace
+{
+bool file_exists(const std::string& file_name)
+{
+  std::FILE* fp = std::fopen(file_name.c_str(), "rb");
+  if (fp == nullptr) return false;
+  std::fclose(fp);
+  return true;
+}
+
+// Files holding the content of `input`: the file itself or, for protobuf
+// folders, the `<folder>_<i>.pb` messages (see utils::ProtoReader).
+std::vector<std::string> input_files(const std::string& input)
+{
+  if (!utils::isFolder(input)) return {input};
+  std::string folder = input;
+  while (!folder.empty() && (folder.back() == '/' || folder.back() == '\\'))
+  {
+    folder.pop_back();
+  }
+  std::string folder_name = folder.substr(folder.find_last_of("/\\") + 1);
+  std::vector<std::string> files;
+  for (size_t i = 0;; i++)
+  {
+    std::string file_name =
+        folder + "/" + folder_name + "_" + std::to_string(i) + ".pb";
+    if (!file_exists(file_name)) break;
+    files.push_back(file_name);
+  }
+  return files;
+}
+}  // namespace
+
+ProblemCache::ProblemCache(const std::string& directory,
+                           bool merge_duplicate_terms)
+    : directory_(directory), merge_duplicate_terms_(merge_duplicate_terms)
+{
+  while (!directory_.empty() &&
+         (directory_.back() == '/' || directory_.back() == '\\'))
+  {
+    directory_.pop_back();
+  }
+}
+
+std::string ProblemCache::key(const std::string& input) const
+{
+  // Entries are only valid for the format version they were written in (and
+  // depend on whether duplicate terms are merged).
+  uint64_t hash = kBinaryProblemFormatVersion;
+  if (merge_duplicate_terms_)
+  {
+    hash = hash * 0x100000001b3ULL ^ 1;
+  }
+  for (const auto& file_name : input_files(input))
+  {
+    utils::MappedFile file(file_name);
+    size_t file_hash = utils::hash_bytes(file.data(), file.size());
+    utils::hash_combine(file_hash, file.size());
+    hash = hash * 0x100000001b3ULL ^ file_hash;
+  }
+  std::ostringstream key;
+  key << std::hex << std::setw(16) << std::setfill('0') << hash;
+  return key.str();
+}
+
+std::string ProblemCache::entry_path(const std::string& key) const
+{
+  return directory_ + "/" + key + kBinaryProblemExtension;
+}
+
+bool ProblemCache::lookup(const std::string& key, BinaryProblem& problem) const
+{
+  std::string path = entry_path(key);
+  if (!BinaryProblem::is_binary_problem(path)) return false;
+  try
+  {
+    problem.open(path);
+  }
+  catch (const utils::ConfigurationException& e)
+  {
+    LOG(WARN, "Ignoring invalid cache entry ", path, ": ",
+        e.get_error_message());
+    return false;
+  }
+  LOG(INFO, "Using cached problem ", path);
+  return true;
+}
+
+bool ProblemCache::store(const std::string& key,
+                         GraphModelConfiguration& configuration,
+                         BinaryProblem& problem) const
+{
+  std::string path = entry_path(key);
+  // Write to a unique temporary file first, such that concurrent runs never
+  // see a partially written entry.
+  std::string temp_path =
+      path + ".tmp" +
+      std::to_string(
+          std::chrono::steady_clock::now().time_since_epoch().count());
+  try
+  {
+    BinaryProblem::write(temp_path, configuration);
+  }
+  catch (...)
+  {
+    std::remove(temp_path.c_str());
+    if (!GraphModelConfiguration::Get_Edges::get(configuration).empty())
+    {
+      // The file could not be created; configuration is still intact.
+      LOG(WARN, "Unable to write cache entry ", path);
+      return false;
+    }
+    throw;
+  }
+  if (std::rename(temp_path.c_str(), path.c_str()) != 0)
+  {
+    // Another run may have stored the same entry in the meantime.
+    std::remove(temp_path.c_str());
+  }
+  problem.open(path);
+  return true;
+}
+
+}  // namespace model
@@ -0,0 +1,66 @@
+
+#pragma once
+
+#include <string>
+
+#include "model/binary_problem.h"
+#include "model/graph_model.h"
+
+namespace model
+{
+////////////////////////////////////////////////////////////////////////////////
+/// Disk cache of normalized graph problems.
+///
+/// Entries are binary problem files (see `BinaryProblem`) named after a hash
+/// of the input's content, such that repeated runs on the same input (with
+/// different solver parameters) can skip parsing and normalization:
+///
+///   ProblemCache cache(cache_dir);
+///   std::string key = cache.key(input_file);
+///   BinaryProblem problem;
+///   if (!cache.lookup(key, problem))
+///   {
+///     GraphModelConfiguration configuration;
+///     ... parse input_file into configuration ...
+///     cache.store(key, configuration, problem);
+///   }
+///   problem.configure(configuration);
+///
+/// The directory must exist; entries are never evicted.
+///
+class ProblemCache
+{
+ public:
+  /// Cache in `directory` for problems normalized with (or without)
+  /// `merge_duplicate_terms`.
+  explicit ProblemCache(const std::string& directory,
+                        bool merge_duplicate_terms = false);
+
+  /// Cache key for an input file (or protobuf folder).
+  ///
+  /// This hashes the entire content of the input.
+  std::string key(const std::string& input) const;
+
+  /// Path of the cache entry for `key`.
+  std::string entry_path(const std::string& key) const;
+
+  /// Map the cache entry for `key` into `problem` if it exists.
+  ///
+  /// Unreadable entries are treated as missing.
+  bool lookup(const std::string& key, BinaryProblem& problem) const;
+
+  /// Write `configuration` as the cache entry for `key` and map it into
+  /// `problem`.
+  ///
+  /// Returns false (leaving `configuration` intact) if the entry cannot be
+  /// created. Otherwise, the edges are moved out of `configuration` and
+  /// `problem` must be used to configure the model.
+  bool store(const std::string& key, GraphModelConfiguration& configuration,
+             BinaryProblem& problem) const;
+
+ private:
+  std::string directory_;
+  bool merge_duplicate_terms_;
+};
+
+}  // namespace model
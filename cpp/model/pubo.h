@@ -114,6 +114,37 @@ class AbstractPubo : public GraphModel<State_T, size_t, Cost_T>
     return state.render(this->graph_.output_map());
   }
 
+  void write_state(const State_T& state,
+                   utils::StructureWriter& writer) const override
+  {
+    std::vector<int> values(state.spins.size());
+    for (size_t i = 0; i < values.size(); i++)
+    {
+      values[i] = state.spins[i] ? 0 : 1;
+    }
+    writer.write_int_object(this->get_node_names(), values);
+  }
+
+  bool get_binary_variables(std::vector<int>& names,
+                            utils::SolutionEncoding& encoding) const override
+  {
+    names = this->get_node_names();
+    encoding.type = utils::SolutionEncoding::BITS;
+    encoding.bit_values[0] = 0;
+    encoding.bit_values[1] = 1;
+    return true;
+  }
+
+  void get_binary_values(const State_T& state,
+                         std::vector<int>& values) const override
+  {
+    values.resize(state.spins.size());
+    for (size_t i = 0; i < values.size(); i++)
+    {
+      values[i] = state.spins[i] ? 0 : 1;
+    }
+  }
+
   size_t state_memory_estimate() const override
   {
     return State_T::memory_estimate(nodes().size(), edges().size());
@@ -0,0 +1,192 @@
+
+#include "../binary_problem.h"
+
+#include <cstdio>
+#include <string>
+
+#include "../../utils/exception.h"
+#include "../../utils/file.h"
+#include "../../utils/random_generator.h"
+#include "../../utils/stream_handler_json.h"
+#include "../ising.h"
+#include "../pubo.h"
+#include "gtest/gtest.h"
+
+using ::model::BinaryProblem;
+using ::model::GraphModelConfiguration;
+using ::model::Ising;
+using ::utils::Twister;
+using PuboCompact = ::model::PuboCompact<uint8_t>;
+
+namespace
+{
+// Convert `input_str` to a binary problem file `file_name`.
+void write_binary_problem(const std::string& input_str,
+                          const std::string& file_name)
+{
+  GraphModelConfiguration configuration;
+  utils::configure_from_json_string(input_str, configuration);
+  BinaryProblem::write(file_name, configuration);
+}
+
+template <class Model>
+void configure_from_binary_problem(const std::string& file_name, Model& model)
+{
+  BinaryProblem problem;
+  problem.open(file_name);
+  GraphModelConfiguration configuration;
+  problem.configure(configuration);
+  model.configure(configuration);
+  model.init();
+}
+}  // namespace
+
+TEST(BinaryProblem, IsingRoundTrip)
+{
+  std::string input_str(R"({
+    "cost_function": {
+      "type": "ising",
+      "version": "1.0",
+      "terms": [
+        {"c": 1, "ids": [10, 3]},
+        {"c": -2, "ids": [3, 7]},
+        {"c": 0.5, "ids": [7, 10, 42]},
+        {"c": 3, "ids": []},
+        {"c": -1, "ids": [42]}
+      ],
+      "initial_configuration": {"3": -1, "7": 1, "10": 1, "42": -1}
+    }
+  })");
+  std::string file_name = "binary_problem_test_ising.qiob";
+  write_binary_problem(input_str, file_name);
+  EXPECT_TRUE(BinaryProblem::is_binary_problem(file_name));
+  {
+    BinaryProblem problem;
+    problem.open(file_name);
+    EXPECT_FALSE(problem.graph().properties.allow_dup_merge_);
+  }
+
+  Ising expected;
+  utils::configure_with_configuration_from_json_string(input_str, expected);
+  expected.init();
+  Ising ising;
+  configure_from_binary_problem(file_name, ising);
+  std::remove(file_name.c_str());
+
+  EXPECT_EQ(ising.node_count(), expected.node_count());
+  EXPECT_EQ(ising.edge_count(), expected.edge_count());
+  EXPECT_EQ(ising.get_const_cost(), expected.get_const_cost());
+  EXPECT_EQ(ising.get_initial_configuration(),
+            expected.get_initial_configuration());
+  EXPECT_EQ(ising.get_initial_configuration_state().spins,
+            expected.get_initial_configuration_state().spins);
+  for (size_t i = 0; i < ising.node_count(); i++)
+  {
+    EXPECT_EQ(ising.node(i).edge_ids(), expected.node(i).edge_ids());
+  }
+  EXPECT_EQ(ising.get_benchmark_properties().to_string(),
+            expected.get_benchmark_properties().to_string());
+
+  Twister rng;
+  rng.seed(188);
+  for (int i = 0; i < 16; i++)
+  {
+    auto state = ising.get_random_state(rng);
+    EXPECT_EQ(ising.calculate_cost(state), expected.calculate_cost(state));
+    EXPECT_EQ(ising.render_state(state).to_string(),
+              expected.render_state(state).to_string());
+  }
+}
+
+TEST(BinaryProblem, PuboCompactRoundTrip)
+{
+  std::string input_str(R"({
+    "cost_function": {
+      "type": "pubo",
+      "version": "1.1",
+      "terms": [
+        {"c": 1, "ids": [-1, -1]},
+        {"c": 9, "ids": [2, 100]},
+        {"c": 10, "ids": [3, 3, 2]},
+        {"c": -4, "ids": [100, -1, 3]}
+      ]
+    }
+  })");
+  std::string file_name = "binary_problem_test_pubo.qiob";
+  write_binary_problem(input_str, file_name);
+  {
+    // The file records how the graph was normalized.
+    BinaryProblem problem;
+    problem.open(file_name);
+    EXPECT_TRUE(problem.graph().properties.allow_dup_merge_);
+    EXPECT_FALSE(problem.graph().properties.merge_duplicate_terms_);
+  }
+
+  PuboCompact expected;
+  utils::configure_with_configuration_from_json_string(input_str, expected);
+  expected.init();
+  PuboCompact pubo;
+  configure_from_binary_problem(file_name, pubo);
+  std::remove(file_name.c_str());
+
+  EXPECT_EQ(pubo.node_count(), expected.node_count());
+  EXPECT_EQ(pubo.edge_count(), expected.edge_count());
+  EXPECT_EQ(pubo.estimate_max_cost_diff(), expected.estimate_max_cost_diff());
+  Twister rng;
+  rng.seed(188);
+  for (int i = 0; i < 16; i++)
+  {
+    auto state = pubo.get_random_state(rng);
+    EXPECT_EQ(pubo.calculate_cost(state), expected.calculate_cost(state));
+    for (size_t spin = 0; spin < pubo.node_count(); spin++)
+    {
+      EXPECT_EQ(pubo.calculate_cost_difference(state, spin),
+                expected.calculate_cost_difference(state, spin));
+    }
+  }
+}
+
+TEST(BinaryProblem, IsingRejectsDuplicatedIds)
+{
+  std::string input_str(R"({
+    "cost_function": {
+      "type": "ising",
+      "version": "1.0",
+      "terms": [{"c": 1, "ids": [0, 0]}]
+    }
+  })");
+  EXPECT_THROW(
+      write_binary_problem(input_str, "binary_problem_test_duplicated.qiob"),
+      utils::DuplicatedVariableException);
+  std::remove("binary_problem_test_duplicated.qiob");
+}
+
+TEST(BinaryProblem, RejectsInvalidFiles)
+{
+  std::string json_file = "binary_problem_test.json";
+  utils::write_file(json_file, R"({"cost_function": {}})");
+  EXPECT_FALSE(BinaryProblem::is_binary_problem(json_file));
+  BinaryProblem problem;
+  EXPECT_THROW(problem.open(json_file), utils::ParsingException);
+  std::remove(json_file.c_str());
+  EXPECT_FALSE(BinaryProblem::is_binary_problem("binary_problem_missing"));
+
+  std::string file_name = "binary_problem_test_truncated.qiob";
+  write_binary_problem(R"({
+    "cost_function": {
+      "type": "ising",
+      "version": "1.0",
+      "terms": [{"c": 1, "ids": [0, 1]}, {"c": 1, "ids": [1, 2]}]
+    }
+  })",
+                       file_name);
+  std::string content = utils::read_file(file_name);
+  utils::write_file(file_name, content.substr(0, content.size() - 16));
+  EXPECT_THROW(problem.open(file_name), utils::ParsingException);
+
+  // Bump the format version (which follows the 8 byte magic).
+  content[8] = 2;
+  utils::write_file(file_name, content);
+  EXPECT_THROW(problem.open(file_name), utils::ParsingException);
+  std::remove(file_name.c_str());
+}
@@ -76,6 +76,38 @@ TEST_F(IsingTest, InitialConfiguration)
   EXPECT_EQ(state.spins, expected_spins);
 }
 
+TEST_F(IsingTest, WriteState)
+{
+  auto state = ising.get_initial_configuration_state();
+  for (bool pretty : {true, false})
+  {
+    std::stringstream out;
+    utils::StructureWriter writer(&out, pretty);
+    ising.write_state(state, writer);
+    EXPECT_EQ(out.str(), ising.render_state(state).to_string(pretty));
+  }
+}
+
+TEST_F(IsingTest, BinaryValues)
+{
+  std::vector<int> names;
+  utils::SolutionEncoding encoding;
+  ASSERT_TRUE(ising.get_binary_variables(names, encoding));
+  EXPECT_EQ(encoding.type, utils::SolutionEncoding::BITS);
+  EXPECT_EQ(encoding.bit_values[0], -1);
+  EXPECT_EQ(encoding.bit_values[1], 1);
+
+  auto state = ising.get_initial_configuration_state();
+  std::vector<int> values;
+  ising.get_binary_values(state, values);
+  ASSERT_EQ(values.size(), names.size());
+  utils::Structure rendered = ising.render_state(state);
+  for (size_t i = 0; i < names.size(); i++)
+  {
+    EXPECT_EQ(values[i], rendered[std::to_string(names[i])].get<int>());
+  }
+}
+
 TEST(Ising, InitialConfigurationWrongValue)
 {
   std::string input_str = R"({
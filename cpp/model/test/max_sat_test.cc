@@ -37,8 +37,7 @@ class MaxSatTest : public testing::Test
     utils::configure_with_configuration_from_json_string(json, maxsat1);
     maxsat1.init();
 
-    Dimacs dimacs;
-    dimacs.read(R"(c
+    std::string wcnf(R"(c
 c
 c Weighted Max-SAT
 c
@@ -47,17 +46,25 @@ p wcnf 2 3
 4 1 2 0
 2 -2 0
 )");
+    Dimacs dimacs;
+    dimacs.read(wcnf);
     maxsat2.configure(dimacs);
     maxsat2.init();
+
+    utils::DimacsReader reader;
+    reader.read(wcnf.data(), wcnf.size());
+    maxsat3.configure(reader);
+    maxsat3.init();
   }
 
   MaxSat32 maxsat1;
   MaxSat32 maxsat2;
+  MaxSat32 maxsat3;
 };
 
 TEST_F(MaxSatTest, CalculateCost)
 {
-  for (MaxSat32* maxsat : {&maxsat1, &maxsat2})
+  for (MaxSat32* maxsat : {&maxsat1, &maxsat2, &maxsat3})
   {
     auto state = maxsat->create_state({0, 0});
     EXPECT_EQ(maxsat->calculate_cost(state), 4);
@@ -72,7 +79,7 @@ TEST_F(MaxSatTest, CalculateCost)
 
 TEST_F(MaxSatTest, CalculateCostDifference)
 {
-  for (MaxSat32* maxsat : {&maxsat1, &maxsat2})
+  for (MaxSat32* maxsat : {&maxsat1, &maxsat2, &maxsat3})
   {
     auto state = maxsat->create_state({0, 0});
     EXPECT_EQ(maxsat->calculate_cost_difference(state, 0), 1 - 4);
@@ -94,7 +101,7 @@ TEST_F(MaxSatTest, CalculateCostDifference)
 
 TEST_F(MaxSatTest, ApplyTransition)
 {
-  for (MaxSat32* maxsat : {&maxsat1, &maxsat2})
+  for (MaxSat32* maxsat : {&maxsat1, &maxsat2, &maxsat3})
   {
     auto state = maxsat->create_state({0, 0});
     EXPECT_EQ(state.variables, std::vector<bool>({0, 0}));
@@ -0,0 +1,83 @@
+
+#include "../problem_cache.h"
+
+#include <cstdio>
+#include <string>
+
+#include "../../utils/file.h"
+#include "../../utils/stream_handler_json.h"
+#include "../ising.h"
+#include "gtest/gtest.h"
+
+using ::model::BinaryProblem;
+using ::model::GraphModelConfiguration;
+using ::model::Ising;
+using ::model::ProblemCache;
+
+namespace
+{
+const char kIsingInput[] = R"({
+  "cost_function": {
+    "type": "ising",
+    "version": "1.0",
+    "terms": [{"c": 1, "ids": [4, 2]}, {"c": -1, "ids": [2, 8]}]
+  }
+})";
+}  // namespace
+
+TEST(ProblemCache, KeyDependsOnContent)
+{
+  ProblemCache cache(".");
+  utils::write_file("problem_cache_test_a.json", kIsingInput);
+  utils::write_file("problem_cache_test_b.json", kIsingInput);
+  std::string key = cache.key("problem_cache_test_a.json");
+  EXPECT_EQ(key.size(), 16);
+  EXPECT_EQ(key, cache.key("problem_cache_test_b.json"));
+  utils::write_file("problem_cache_test_b.json", std::string(kIsingInput) + " ");
+  EXPECT_NE(key, cache.key("problem_cache_test_b.json"));
+  // Problems normalized with merged terms are cached separately.
+  ProblemCache merging_cache(".", true);
+  EXPECT_NE(key, merging_cache.key("problem_cache_test_a.json"));
+  std::remove("problem_cache_test_a.json");
+  std::remove("problem_cache_test_b.json");
+}
+
+TEST(ProblemCache, StoresAndLooksUpEntries)
+{
+  ProblemCache cache("./");
+  std::string key = "0123456789abcdef";
+  EXPECT_EQ(cache.entry_path(key), "./0123456789abcdef.qiob");
+  std::remove(cache.entry_path(key).c_str());
+
+  BinaryProblem problem;
+  EXPECT_FALSE(cache.lookup(key, problem));
+
+  GraphModelConfiguration configuration;
+  utils::configure_from_json_string(kIsingInput, configuration);
+  EXPECT_TRUE(cache.store(key, configuration, problem));
+  EXPECT_EQ(problem.type(), "ising");
+  EXPECT_EQ(problem.graph().node_count, 3);
+
+  BinaryProblem cached;
+  EXPECT_TRUE(cache.lookup(key, cached));
+  GraphModelConfiguration cached_configuration;
+  cached.configure(cached_configuration);
+  Ising ising;
+  ising.configure(cached_configuration);
+  EXPECT_EQ(ising.node_count(), 3);
+  EXPECT_EQ(ising.edge_count(), 2);
+  auto rendered = ising.render_state(::model::IsingState(3, 0));
+  EXPECT_EQ(1, rendered["4"].get<int32_t>());
+  EXPECT_EQ(1, rendered["8"].get<int32_t>());
+  std::remove(cache.entry_path(key).c_str());
+}
+
+TEST(ProblemCache, IgnoresUnwritableDirectory)
+{
+  ProblemCache cache("problem_cache_test_missing_dir");
+  GraphModelConfiguration configuration;
+  utils::configure_from_json_string(kIsingInput, configuration);
+  BinaryProblem problem;
+  EXPECT_FALSE(cache.store("0123456789abcdef", configuration, problem));
+  EXPECT_EQ(GraphModelConfiguration::Get_Edges::get(configuration).size(), 2);
+}
@@ -78,6 +78,38 @@ TEST_F(PuboTest, InitialConfiguration)
   EXPECT_EQ(state.spins, expected_spins);
 }
 
+TEST_F(PuboTest, WriteState)
+{
+  auto state = pubo.get_initial_configuration_state();
+  for (bool pretty : {true, false})
+  {
+    std::stringstream out;
+    utils::StructureWriter writer(&out, pretty);
+    pubo.write_state(state, writer);
+    EXPECT_EQ(out.str(), pubo.render_state(state).to_string(pretty));
+  }
+}
+
+TEST_F(PuboTest, BinaryValues)
+{
+  std::vector<int> names;
+  utils::SolutionEncoding encoding;
+  ASSERT_TRUE(pubo.get_binary_variables(names, encoding));
+  EXPECT_EQ(encoding.type, utils::SolutionEncoding::BITS);
+  EXPECT_EQ(encoding.bit_values[0], 0);
+  EXPECT_EQ(encoding.bit_values[1], 1);
+
+  auto state = pubo.get_initial_configuration_state();
+  std::vector<int> values;
+  pubo.get_binary_values(state, values);
+  ASSERT_EQ(values.size(), names.size());
+  utils::Structure rendered = pubo.render_state(state);
+  for (size_t i = 0; i < names.size(); i++)
+  {
+    EXPECT_EQ(values[i], rendered[std::to_string(names[i])].get<int>());
+  }
+}
+
 TEST(Pubo, InitialConfigurationWrongValue)
 {
   std::string input_str = R"({
@@ -0,0 +1,42 @@
+
+#include "observe/cost_trace.h"
+
+#include <algorithm>
+
+#include "utils/exception.h"
+#include "utils/timing.h"
+
+namespace observe
+{
+CostTrace::CostTrace(size_t capacity)
+    : events_(capacity), recorded_(0), start_time_(utils::get_wall_time())
+{
+  if (capacity == 0)
+  {
+    THROW(utils::ValueException, "The cost trace capacity must be positive.");
+  }
+}
+
+utils::Structure CostTrace::render() const
+{
+  utils::Structure s(utils::Structure::OBJECT);
+  utils::Structure events(utils::Structure::ARRAY);
+  size_t first = recorded_ - size();
+  for (size_t i = first; i < recorded_; i++)
+  {
+    const Event& event = events_[i % events_.size()];
+    utils::Structure rendered;
+    // Improvements found before the start (e.g., during initialization) are
+    // reported at time 0.
+    rendered["time_ms"] = 1000 * std::max(0.0, event.wall_time - start_time_);
+    rendered["step"] = event.step;
+    rendered["evaluations"] = event.evaluations;
+    rendered["cost"] = event.cost;
+    events.push_back(rendered);
+  }
+  s["events"] = events;
+  s["dropped"] = (uint64_t)dropped();
+  return s;
+}
+
+}  // namespace observe
@@ -0,0 +1,72 @@
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <vector>
+
+#include "utils/component.h"
+
+namespace observe
+{
+/// Time-to-target trace
+///
+/// Records an event (wall time, step, number of cost function evaluations
+/// and cost) whenever a new lowest cost is found. Events are kept in a ring
+/// buffer allocated upfront, such that recording never allocates; if more
+/// than `capacity` events are recorded, the oldest ones are dropped.
+///
+/// Unlike the `Milestone` observable, the trace is recorded in all builds.
+class CostTrace : public utils::Component
+{
+ public:
+  static constexpr size_t kDefaultCapacity = 1024;
+
+  explicit CostTrace(size_t capacity = kDefaultCapacity);
+
+  /// Set the wall time relative to which event times are rendered.
+  void start(double start_time) { start_time_ = start_time; }
+
+  void record(double wall_time, uint64_t step, uint64_t evaluations,
+              double cost)
+  {
+    Event& event = events_[recorded_ % events_.size()];
+    event.wall_time = wall_time;
+    event.step = step;
+    event.evaluations = evaluations;
+    event.cost = cost;
+    recorded_++;
+  }
+
+  /// Drop all events.
+  void reset() { recorded_ = 0; }
+
+  /// Number of events currently held.
+  size_t size() const
+  {
+    return recorded_ < events_.size() ? recorded_ : events_.size();
+  }
+
+  /// Number of events dropped because the buffer was full.
+  size_t dropped() const { return recorded_ - size(); }
+
+  /// Render the events (in the order they were recorded) with their time in
+  /// milliseconds since `start()`.
+  utils::Structure render() const override;
+
+ private:
+  struct Event
+  {
+    double wall_time;
+    uint64_t step;
+    uint64_t evaluations;
+    double cost;
+  };
+
+  std::vector<Event> events_;
+  size_t recorded_;
+  double start_time_;
+};
+
+}  // namespace observe
@@ -1,12 +1,15 @@
 
 #include "observe/observer.h"
 
+#include <omp.h>
+
 #include "utils/config.h"
 
 namespace observe
 {
 void Observer::clear_observable_label(const std::string& identifier)
 {
+  labels_changed();
   auto found = labels_.find(identifier);
   if (found == labels_.end())
   {
@@ -28,27 +31,105 @@ bool Observer::is_watching(const std::string& name) const
 void Observer::observe(const std::string& identifier, double value,
                        double weight)
 {
-  if (!is_watching(identifier)) return;
-  for (const auto& protocol : protocols_)
+  observe(get_handle(identifier), value, weight);
+}
+
+Observer::Handle Observer::get_handle(const std::string& identifier) const
+{
+  // All watched observables are resolved when configuring, such that this
+  // is a read-only lookup (which may be called from any thread).
+  auto found = handles_.find(identifier);
+  if (found == handles_.end()) return Handle();
+  return Handle(found->second);
+}
+
+void Observer::record(int index, double value, double weight)
+{
+  if (omp_in_parallel())
   {
-    if (protocol.is_watching(identifier))
+    size_t thread = (size_t)omp_get_thread_num();
+    if (thread < pending_.size())
     {
-      Group* group =
-          protocol.select_group(observables_, restart_step_, labels_);
-      if (!group->has_observable(identifier))
-      {
-        group->add_observable(identifier,
-                              protocol.create_observable(identifier));
-      }
-      group->select_observable(identifier).record(value, weight);
+      pending_[thread].push_back({index, value, weight, labels_snapshot()});
+      return;
+    }
+    // More threads than at configuration time.
+    #pragma omp critical(observer_record)
+    record(interned_[(size_t)index], value, weight, restart_step_, labels_);
+    return;
+  }
+  // Values of the last parallel region precede this one.
+  if (!snapshots_.empty()) merge_pending();
+  record(interned_[(size_t)index], value, weight, restart_step_, labels_);
+}
+
+size_t Observer::labels_snapshot()
+{
+  int snapshot = snapshot_.load(std::memory_order_acquire);
+  if (snapshot >= 0) return (size_t)snapshot;
+  #pragma omp critical(observer_snapshot)
+  {
+    snapshot = snapshot_.load(std::memory_order_relaxed);
+    if (snapshot < 0)
+    {
+      snapshots_.push_back({restart_step_, labels_});
+      snapshot = (int)snapshots_.size() - 1;
+      snapshot_.store(snapshot, std::memory_order_release);
     }
   }
+  return (size_t)snapshot;
 }
 
-utils::Structure Observer::render() const { return observables_.render(); }
+void Observer::labels_changed()
+{
+  if (!snapshots_.empty()) merge_pending();
+}
+
+void Observer::record(const Interned& interned, double value, double weight,
+                      size_t restart_step, const Labels& labels) const
+{
+  for (size_t i : interned.protocols)
+  {
+    const Protocol& protocol = protocols_[i];
+    Group* group = protocol.select_group(observables_, restart_step, labels);
+    if (!group->has_observable(interned.identifier))
+    {
+      group->add_observable(interned.identifier,
+                            protocol.create_observable(interned.identifier));
+    }
+    group->select_observable(interned.identifier).record(value, weight);
+  }
+}
+
+void Observer::merge_pending() const
+{
+  for (auto& thread_pending : pending_)
+  {
+    for (const Pending& pending : thread_pending)
+    {
+      const Snapshot& snapshot = snapshots_[pending.snapshot];
+      record(interned_[(size_t)pending.index], pending.value, pending.weight,
+             snapshot.restart_step, snapshot.labels);
+    }
+    thread_pending.clear();
+  }
+  snapshots_.clear();
+  snapshot_.store(-1, std::memory_order_relaxed);
+}
+
+utils::Structure Observer::render() const
+{
+  merge_pending();
+  return observables_.render();
+}
 
 void Observer::configure(const utils::Json& json)
 {
+  handles_.clear();
+  interned_.clear();
+  pending_.assign((size_t)omp_get_max_threads(), {});
+  snapshots_.clear();
+  snapshot_.store(-1, std::memory_order_relaxed);
   if (!json.IsObject() || !json.HasMember("observer")) return;
   if (!json["observer"].IsArray())
   {
@@ -63,6 +144,21 @@ void Observer::configure(const utils::Json& json)
         .description("configuration of the measurement protocols")
         .required();
   }
+
+  // Resolve the watched observables (and the protocols watching them).
+  for (size_t i = 0; i < protocols_.size(); i++)
+  {
+    for (const std::string& name : protocols_[i].watched())
+    {
+      auto found = handles_.find(name);
+      if (found == handles_.end())
+      {
+        found = handles_.emplace(name, (int)interned_.size()).first;
+        interned_.push_back({name, {}});
+      }
+      interned_[(size_t)found->second].protocols.push_back(i);
+    }
+  }
 }
 
 Observer::Group* Observer::Group::select_subgroup(
@@ -152,15 +248,21 @@ bool Observer::Protocol::is_watching(const std::string& name) const
   return observables_.find(name) != observables_.end();
 }
 
+std::vector<std::string> Observer::Protocol::watched() const
+{
+  std::vector<std::string> names;
+  for (const auto& observable : observables_) names.push_back(observable.first);
+  return names;
+}
+
 Observer::Group* Observer::Protocol::select_group(
-    Group& groups, size_t restart_step,
-    std::map<std::string, utils::Structure> labels_) const
+    Group& groups, size_t restart_step, const Labels& labels) const
 {
   Group* group = &groups;
   for (const auto& average : average_over_)
   {
-    auto label = labels_.find(average.first);
-    if (label == labels_.end())
+    auto label = labels.find(average.first);
+    if (label == labels.end())
     {
       LOG(ERROR, "observable not grouped by ", average.first);
       continue;
@@ -172,8 +274,8 @@ Observer::Group* Observer::Protocol::select_group(
   }
   for (const auto& grouping : group_by_)
   {
-    auto label = labels_.find(grouping);
-    if (label == labels_.end())
+    auto label = labels.find(grouping);
+    if (label == labels.end())
     {
       LOG(ERROR, "observable not grouped by ", grouping);
       continue;
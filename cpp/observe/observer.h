@@ -1,9 +1,11 @@
 
 #pragma once
 
+#include <atomic>
 #include <map>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "utils/component.h"
 #include "utils/structure.h"
@@ -14,15 +16,20 @@ namespace observe
 class Observer : public utils::ComponentWithOutput
 {
  public:
-  Observer() : restart_step_(0) {}
+  Observer() : restart_step_(0), snapshot_(-1) {}
 
-  void restart(size_t step) { restart_step_ = step; }
+  void restart(size_t step)
+  {
+    labels_changed();
+    restart_step_ = step;
+  }
 
   bool is_watching(const std::string& identifier) const;
 
   template <class T>
   void set_observable_label(const std::string& identifier, const T& value)
   {
+    labels_changed();
     labels_[identifier] = value;
   }
   void clear_observable_label(const std::string& identifier);
@@ -37,7 +44,10 @@ class Observer : public utils::ComponentWithOutput
     ScopedLabel(const ScopedLabel&) = default;
     ScopedLabel& operator=(const ScopedLabel& copy) = default;
 
-    virtual ~ScopedLabel() { observer_->clear_observable_label(label_); }
+    virtual ~ScopedLabel()
+    {
+      if (observer_ != nullptr) observer_->clear_observable_label(label_);
+    }
 
    private:
     Observer* observer_;  // not owned
@@ -47,6 +57,8 @@ class Observer : public utils::ComponentWithOutput
   template <class T>
   ScopedLabel scoped_observable_label(const std::string& label, T value)
   {
+    // Labels only group observations: skip them if nothing is watched.
+    if (protocols_.empty()) return ScopedLabel(nullptr, label);
     set_observable_label(label, value);
     return ScopedLabel(this, label);
   }
@@ -54,11 +66,79 @@ class Observer : public utils::ComponentWithOutput
   void observe(const std::string& identifier, double value,
                double weight = 1.0);
 
+  /// Precompiled reference to an observable (see `get_handle()`).
+  class Handle
+  {
+   public:
+    Handle() : index_(-1) {}
+    /// Whether the observable is watched by any protocol.
+    explicit operator bool() const { return index_ >= 0; }
+
+   private:
+    friend class Observer;
+    explicit Handle(int index) : index_(index) {}
+    int index_;
+  };
+
+  /// Resolve `identifier` to a handle for use in hot loops.
+  ///
+  /// Handles are invalidated by `configure()`; resolve them afterwards. The
+  /// handle of an observable which is not watched is empty.
+  Handle get_handle(const std::string& identifier) const;
+
+  /// Record `value` for the observable referred to by `handle` (a no-op for
+  /// an empty handle).
+  ///
+  /// Within a parallel region, values are accumulated per thread (referring
+  /// to a copy of the current labels, which must not change within the
+  /// region) and merged into the observables by the next label change,
+  /// observation outside of a parallel region or rendering.
+  void observe(const Handle& handle, double value, double weight = 1.0)
+  {
+    if (!handle) return;
+    record(handle.index_, value, weight);
+  }
+
   void configure(const utils::Json& json) override;
 
   utils::Structure render() const override;
 
  private:
+  using Labels = std::map<std::string, utils::Structure>;
+
+  // A value recorded within a parallel region.
+  struct Pending
+  {
+    int index;
+    double value;
+    double weight;
+    // Index in snapshots_.
+    size_t snapshot;
+  };
+
+  // Labels (and restart step) of values recorded within a parallel region.
+  struct Snapshot
+  {
+    size_t restart_step;
+    Labels labels;
+  };
+
+  // An observable resolved by `get_handle()` and the protocols watching it.
+  struct Interned
+  {
+    std::string identifier;
+    std::vector<size_t> protocols;
+  };
+
+  void record(int index, double value, double weight);
+  void record(const Interned& interned, double value, double weight,
+              size_t restart_step, const Labels& labels) const;
+  // Index of the snapshot of the current labels (taken by the first
+  // observation within a parallel region after the labels changed).
+  size_t labels_snapshot();
+  // Merge pending values before the labels change.
+  void labels_changed();
+  void merge_pending() const;
   class Group : public utils::Component
   {
    public:
@@ -110,8 +190,10 @@ class Observer : public utils::ComponentWithOutput
    public:
     void configure(const utils::Json& json) override;
     bool is_watching(const std::string& name) const;
+    // Names of the observables watched.
+    std::vector<std::string> watched() const;
     Group* select_group(Group& groups, size_t restart_step,
-                        std::map<std::string, utils::Structure> labels_) const;
+                        const Labels& labels) const;
     std::unique_ptr<Observable> create_observable(
         const std::string& name) const;
 
@@ -123,9 +205,18 @@ class Observer : public utils::ComponentWithOutput
 
   size_t restart_step_;
   utils::Structure config_;
-  std::map<std::string, utils::Structure> labels_;
-  Group observables_;
+  Labels labels_;
+  // Mutable for merging pending values when rendering.
+  mutable Group observables_;
   std::vector<Protocol> protocols_;
+  // Watched observables (resolved when configuring).
+  std::map<std::string, int> handles_;
+  std::vector<Interned> interned_;
+  // Values recorded within parallel regions, by thread.
+  mutable std::vector<std::vector<Pending>> pending_;
+  mutable std::vector<Snapshot> snapshots_;
+  // Snapshot of the current labels (-1 if not taken yet).
+  mutable std::atomic<int> snapshot_;
 };
 
 }  // namespace observe
@@ -0,0 +1,46 @@
+
+#include "observe/cost_trace.h"
+
+#include "utils/exception.h"
+#include "gtest/gtest.h"
+
+using ::observe::CostTrace;
+
+TEST(CostTrace, Render)
+{
+  CostTrace trace(3);
+  trace.start(100.0);
+  trace.record(99.0, 0, 10, 5.0);
+  trace.record(100.5, 1, 20, 4.0);
+  EXPECT_EQ(trace.size(), 2u);
+  EXPECT_EQ(trace.dropped(), 0u);
+  EXPECT_EQ(trace.render().to_string(false),
+            R"({"dropped": 0, "events": [{"cost": 5.000000, "evaluations": 10, )"
+            R"("step": 0, "time_ms": 0.000000},{"cost": 4.000000, )"
+            R"("evaluations": 20, "step": 1, "time_ms": 500.000000}]})");
+}
+
+TEST(CostTrace, Wraps)
+{
+  CostTrace trace(3);
+  trace.start(0.0);
+  for (uint64_t i = 0; i < 5; i++)
+  {
+    trace.record((double)i, i, 10 * i, -(double)i);
+  }
+  EXPECT_EQ(trace.size(), 3u);
+  EXPECT_EQ(trace.dropped(), 2u);
+  utils::Structure rendered = trace.render();
+  EXPECT_EQ(rendered["dropped"].get<uint64_t>(), 2u);
+  ASSERT_EQ(rendered["events"].get_array_size(), 3u);
+  // The most recent events are kept, oldest first.
+  for (size_t i = 0; i < 3; i++)
+  {
+    EXPECT_EQ(rendered["events"][i]["step"].get<uint64_t>(), i + 2);
+    EXPECT_EQ(rendered["events"][i]["cost"].get<double>(), -(double)(i + 2));
+  }
+
+  trace.reset();
+  EXPECT_EQ(trace.size(), 0u);
+  EXPECT_THROW(CostTrace(0), utils::ValueException);
+}
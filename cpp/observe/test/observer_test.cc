@@ -0,0 +1,87 @@
+
+#include "observe/observer.h"
+
+#include <string>
+
+#include "utils/json.h"
+#include "gtest/gtest.h"
+
+using ::observe::Observer;
+
+TEST(Observer, Handles)
+{
+  Observer observer;
+  observer.configure(utils::json_from_string(R"({
+    "observer": {
+      "group_by": ["replica"],
+      "constant": ["T"],
+      "average": ["cost"]
+    }
+  })"));
+  Observer::Handle cost = observer.get_handle("cost");
+  EXPECT_TRUE(cost);
+  EXPECT_TRUE(observer.get_handle("T"));
+  EXPECT_FALSE(observer.get_handle("energy"));
+  EXPECT_FALSE(Observer::Handle());
+
+  for (int replica = 0; replica < 2; replica++)
+  {
+    auto label = observer.scoped_observable_label("replica", replica);
+    observer.observe("T", replica + 1);
+    // Values recorded within a parallel region are merged when rendering.
+    #pragma omp parallel for
+    for (int i = 0; i < 100; i++)
+    {
+      observer.observe(cost, (double)(100 * replica + i));
+      observer.observe(Observer::Handle(), 1.0);
+    }
+  }
+  utils::Structure rendered = observer.render();
+  EXPECT_EQ(rendered["replica"][0]["T"].get<double>(), 1.0);
+  EXPECT_EQ(rendered["replica"][0]["cost"].get<double>(), 49.5);
+  EXPECT_EQ(rendered["replica"][1]["T"].get<double>(), 2.0);
+  EXPECT_EQ(rendered["replica"][1]["cost"].get<double>(), 149.5);
+  EXPECT_FALSE(rendered.has_key("energy"));
+}
+
+TEST(Observer, Unconfigured)
+{
+  Observer observer;
+  Observer::Handle cost = observer.get_handle("cost");
+  EXPECT_FALSE(cost);
+  auto label = observer.scoped_observable_label("replica", 0);
+  observer.observe(cost, 1.0);
+  observer.observe("cost", 1.0);
+  EXPECT_EQ(observer.render().get_type(), utils::Structure::UNKNOWN_TYPE);
+}
+
+TEST(Observer, ParallelRegions)
+{
+  Observer observer;
+  observer.configure(utils::json_from_string(R"({
+    "observer": {
+      "group_by": ["replica"],
+      "average": ["cost"]
+    }
+  })"));
+  for (int replica = 0; replica < 3; replica++)
+  {
+    auto label = observer.scoped_observable_label("replica", replica);
+    // Observables are looked up by name from all threads; each region's
+    // values are recorded with the labels at its start.
+    #pragma omp parallel for
+    for (int i = 0; i < 100; i++)
+    {
+      observer.observe("cost", (double)(replica + i));
+      observer.observe("energy", 1.0);
+    }
+    observer.observe("cost", (double)(replica + 49.5));
+  }
+  utils::Structure rendered = observer.render();
+  for (int replica = 0; replica < 3; replica++)
+  {
+    EXPECT_EQ(rendered["replica"][replica]["cost"].get<double>(),
+              replica + 49.5);
+  }
+  EXPECT_FALSE(rendered.has_key("energy"));
+}
@@ -117,7 +117,11 @@ class ModelSolver : public Solver
     if (lowest_cost_.has_value())
     {
       s["cost"] = *lowest_cost_ + model_cur.get_const_cost();
-      s["configuration"] = model_cur.render_state(lowest_state_);
+      // Large configurations are written directly from the states (with
+      // `write_configuration`) if the caller asked for it.
+      s["configuration"] = defer_configurations_
+                               ? utils::StructureWriter::deferred(0)
+                               : model_cur.render_state(lowest_state_);
 
       // introduce this field even if multiple solutions were not requested. We
       // want to move customers into using this new array format.
@@ -126,7 +130,10 @@ class ModelSolver : public Solver
       {
         utils::Structure sol;
         sol["cost"] = lowest_costs_[i] + model_cur.get_const_cost();
-        sol["configuration"] = model_cur.render_state(*lowest_states_[i]);
+        sol["configuration"] =
+            defer_configurations_
+                ? utils::StructureWriter::deferred(i + 1)
+                : model_cur.render_state(*lowest_states_[i]);
         additional_s.push_back(sol);
       }
 
@@ -149,6 +156,26 @@ class ModelSolver : public Solver
     return s;
   }
 
+  /// Write the configuration of `lowest_state_` (index 0) or
+  /// `lowest_states_[index - 1]`.
+  void write_configuration(size_t index,
+                           utils::StructureWriter& writer) const override
+  {
+    this->get_model().write_state(get_deferred_state(index), writer);
+  }
+
+  bool get_binary_variables(std::vector<int>& names,
+                            utils::SolutionEncoding& encoding) const override
+  {
+    return this->get_model().get_binary_variables(names, encoding);
+  }
+
+  void get_binary_values(size_t index,
+                         std::vector<int>& values) const override
+  {
+    this->get_model().get_binary_values(get_deferred_state(index), values);
+  }
+
   virtual std::string init_memory_check_error_message() const = 0;
 
   virtual size_t target_number_of_states() const = 0;
@@ -195,6 +222,18 @@ class ModelSolver : public Solver
   virtual const Model_T& get_model() const { return *model_; }
 
  protected:
+  /// The state of deferred configuration `index`: `lowest_state_` (0) or
+  /// `lowest_states_[index - 1]`.
+  const State_T& get_deferred_state(size_t index) const
+  {
+    if (index > lowest_states_.size())
+    {
+      THROW(utils::IndexOutOfRangeException, "No configuration ", index,
+            " to write.");
+    }
+    return index == 0 ? lowest_state_ : *lowest_states_[index - 1];
+  }
+
   virtual size_t max_replicas_of_state() const
   {
     const Model_T& model = this->get_model();
@@ -244,12 +283,23 @@ class ModelSolver : public Solver
     return result;
   }
 
+  /// Record a new lowest cost in the time-to-target trace.
+  void trace_lowest_cost(double cost)
+  {
+    this->cost_trace_.record(
+        utils::get_wall_time(), this->get_current_step(),
+        this->evaluation_counter_.get_function_evaluation_count() +
+            this->evaluation_counter_.get_difference_evaluation_count(),
+        cost);
+  }
+
   bool update_lowest_cost(Cost_T cost, const State_T& state)
   {
     if (!lowest_cost_.has_value() || cost < *lowest_cost_)
     {
       lowest_cost_ = cost;
       lowest_state_ = state;
+      trace_lowest_cost(static_cast<double>(cost));
       return true;
     }
     else
@@ -1,9 +1,10 @@
 
 #pragma once
 
-#include <set>
+#include <memory>
 
 #include "utils/operating_system.h"
+#include "utils/packed_state_set.h"
 #include "utils/random_generator.h"
 #include "markov/metropolis.h"
 #include "model/poly.h"
@@ -76,6 +77,9 @@ class Murex : public SteppingSolver<Model_T>
     Weights weights;
     // Metropolis walker at this node (contains a state)
     markov::Metropolis<Model_T> replica;
+    // Random number generator of this node (forked from the solver's, such
+    // that nodes can be updated concurrently and reproducibly).
+    std::unique_ptr<utils::RandomGenerator> rng;
     // Indices of the children to the right and up from this node
     // (-1 if this node doesn't have children in this direction)
     std::vector<int> child_ids;
@@ -85,14 +89,13 @@ class Murex : public SteppingSolver<Model_T>
     double lowest_cost;
     // Keep track of the lowest states found so far
     // (this is cleaned if we find something lower by TOLERANCE)
-    std::set<std::vector<bool>> lowest_states;
+    utils::PackedStateSet lowest_states;
 
-    static size_t memory_estimate(const Model_T& model)
+    static size_t memory_estimate(const Model_T& model,
+                                  size_t max_lowest_states)
     {
       size_t n_dimensions = model.get_parameters().size();
       size_t n_weights = 2;
-      size_t n_states = 1;  // average lowest_states amount value during method
-                            // run, starts with 1 at init
       size_t n_spins = model.get_sweep_size();
       return sizeof(Node) +  // memory consumption of empty class
              markov::Metropolis<Model_T>::memory_estimate(
@@ -101,10 +104,8 @@ class Murex : public SteppingSolver<Model_T>
                  n_dimensions) +  // memory consumption of elements of child_ids
              utils::vector_values_memory_estimate<double>(
                  n_weights) +  // memory consumption of elements of weights
-             utils::vector_values_memory_estimate<std::vector<bool>>(
-                 n_states) +  // memory consumption of
-             n_states * utils::vector_values_memory_estimate<bool>(
-                            n_spins);  // elements of lowest_states
+             utils::PackedStateSet::memory_estimate(
+                 n_spins, max_lowest_states);  // storage of lowest_states
     }
   };
 
@@ -151,7 +152,7 @@ class Murex : public SteppingSolver<Model_T>
     // Fix at 2d grid for now.
     assert(dimensions_ == 2);
     size_t nT = temperatures.size();
-    size_t nodes_size_ = nT * (nT + 1) / 2;
+    nodes_size_ = nT * (nT + 1) / 2;
 
     this->init_memory_check();
     // proceed to memory allocation
@@ -174,7 +175,8 @@ class Murex : public SteppingSolver<Model_T>
         node.j = j;
         node.weights = weights;
         node.replica.set_model(this->model_);
-        node.replica.set_rng(this->rng_.get());
+        node.rng = this->rng_->fork();
+        node.replica.set_rng(node.rng.get());
         node.replica.set_temperature(temperatures[nT - i - 1]);
         node.child_ids = std::vector<int>(dimensions_, -1);
         if (j != i)
@@ -190,21 +192,30 @@ class Murex : public SteppingSolver<Model_T>
         node_id++;
       }
     }
+    #pragma omp parallel for
     for (size_t i = 0; i < nodes_.size(); i++)
     {
-      this->scoped_observable_label("node", i);
       auto& node = nodes_[i];
       assert(node.weights.size() == 2);
       auto& replica = node.replica;
       replica.init();
       node.lowest_cost = replica.cost();
+      node.lowest_states.init(replica.state().spins.size(), max_lowest_states_,
+                              lowest_states_eviction());
       node.lowest_states.insert(replica.state().spins);
       auto transition = this->model_->create_parameter_change(node.weights);
       auto cost_difference =
           this->model_->calculate_cost_difference(replica.state(), transition);
       replica.apply_transition(transition, cost_difference);
-      this->observe("avg_cost", replica.cost());
     }
+    for (size_t i = 0; i < nodes_.size(); i++)
+    {
+      auto node_label = this->scoped_observable_label("node", i);
+      this->observe("avg_cost", nodes_[i].replica.cost());
+    }
+    exchanges_.resize(nodes_.size());
+    spin_overlaps_.resize(nodes_.size());
+    term_overlaps_.resize(nodes_.size());
   }
 
   //////////////////////////////////////////////////////////////////////////////
@@ -218,10 +229,11 @@ class Murex : public SteppingSolver<Model_T>
   ///
   void make_step(uint64_t step) override
   {
-    // Metropolis updates to each replica (idependently)
+    // Metropolis updates to each replica (idependently, using the node's own
+    // random number generator).
+    #pragma omp parallel for
     for (size_t i = 0; i < nodes_.size(); i++)
     {
-      this->scoped_observable_label("node", i);
       auto& node = nodes_[i];
       node.replica.make_step();
       if (node.replica.cost() < node.lowest_cost + 1e-6)
@@ -233,39 +245,48 @@ class Murex : public SteppingSolver<Model_T>
         }
         node.lowest_states.insert(node.replica.state().spins);
       }
+    }
+
+    // Observables and evaluation counts outside multithreading
+    for (size_t i = 0; i < nodes_.size(); i++)
+    {
+      auto node_label = this->scoped_observable_label("node", i);
+      auto& node = nodes_[i];
       this->observe("avg_cost", node.replica.cost());
       auto counter = node.replica.get_evaluation_counter();
       this->observe(
           "acc_rate",
           static_cast<double>(counter.get_accepted_transition_count()) /
               static_cast<double>(counter.get_difference_evaluation_count()));
-    }
-
-    // Find lowest outside multithreading
-    for (auto& node : nodes_)
-    {
-      this->evaluation_counter_ += node.replica.get_evaluation_counter();
+      this->evaluation_counter_ += counter;
       node.replica.reset_evaluation_counter();
     }
 
     // Perform exchange moves
+    //
+    // The pairs exchanging in a step are disjoint (each child is on a diagonal
+    // of the other parity and is the child of at most one node in the chosen
+    // direction), so they can be processed concurrently. Each exchange draws
+    // from the generator of its first node, which keeps the outcome
+    // independent of the number of threads.
     bool odd = step & 1;
     size_t direction = (step / 2) % dimensions_;
+    bool measure_overlap = (step / 4) % 250 == 0;
+    #pragma omp parallel for
     for (size_t i = 0; i < nodes_.size(); i++)
     {
-      this->scoped_observable_label("node", i);
-      this->scoped_observable_label("direction", direction);
+      exchanges_[i] = kNoExchange;
       auto& n1 = nodes_[i];
       if (odd != n1.odd) continue;
       if (n1.child_ids[direction] == -1) continue;
       auto& n2 = nodes_[static_cast<size_t>(n1.child_ids[direction])];
 
-      if ((step / 4) % 250 == 0)
+      if (measure_overlap)
       {
         const auto& s1 = n1.replica.state();
         const auto& s2 = n2.replica.state();
-        this->observe("spin_overlap", this->model_->get_spin_overlap(s1, s2));
-        this->observe("term_overlap", this->model_->get_term_overlap(s1, s2));
+        spin_overlaps_[i] = this->model_->get_spin_overlap(s1, s2);
+        term_overlaps_[i] = this->model_->get_term_overlap(s1, s2);
       }
 
       // NOTE: To satisfy detailed balance, we must consider the change
@@ -293,18 +314,32 @@ class Murex : public SteppingSolver<Model_T>
       auto c2p = c2 + this->model_->calculate_cost_difference(r2.state(), t1);
 
       double z = r1.beta() * (c1 - c2p) + r2.beta() * (c2 - c1p);
-      if (z >= 0 || this->rng_->uniform() < exp(z))
+      if (z >= 0 || n1.rng->uniform() < exp(z))
       {
         r1.apply_transition(t2, c1p - c1);
         r2.apply_transition(t1, c2p - c2);
         r1.swap_state(&r2);
-        this->observe("swap_rate", 1);
+        exchanges_[i] = kAccepted;
       }
       else
       {
-        this->observe("swap_rate", 0);
+        exchanges_[i] = kRejected;
       }
     }
+
+    for (size_t i = 0; i < nodes_.size(); i++)
+    {
+      if (exchanges_[i] == kNoExchange) continue;
+      auto node_label = this->scoped_observable_label("node", i);
+      auto direction_label =
+          this->scoped_observable_label("direction", direction);
+      if (measure_overlap)
+      {
+        this->observe("spin_overlap", spin_overlaps_[i]);
+        this->observe("term_overlap", term_overlaps_[i]);
+      }
+      this->observe("swap_rate", exchanges_[i] == kAccepted ? 1 : 0);
+    }
   }
 
   //////////////////////////////////////////////////////////////////////////////
@@ -328,10 +363,10 @@ class Murex : public SteppingSolver<Model_T>
       s["T"] = node.replica.temperature();
       // s["cost"] = node.avg_cost.render();
       s["min_cost"] = node.lowest_cost;
-      for (const auto& state : node.lowest_states)
+      for (size_t k = 0; k < node.lowest_states.size(); k++)
       {
         std::vector<int> tmp;
-        for (const auto& spin : state)
+        for (const auto& spin : node.lowest_states.get(k))
         {
           tmp.push_back(spin ? -1 : 1);
         }
@@ -344,6 +379,7 @@ class Murex : public SteppingSolver<Model_T>
 
   void configure(const utils::Json& json) override
   {
+    using ::matcher::GreaterThan;
     Base_T::configure(json);
     if (!json.IsObject() || !json.HasMember(utils::kParams))
     {
@@ -354,13 +390,53 @@ class Murex : public SteppingSolver<Model_T>
     this->param(params, "temperature_set", temperature_set_)
         .description("temperatures for the grid's diagonals.")
         .required();
+    this->param(params, "max_lowest_states", max_lowest_states_)
+        .description("maximum number of lowest states kept per node.")
+        .default_value((size_t)1024)
+        .matches(GreaterThan<size_t>(0))
+        .with_output();
+    this->param(params, "lowest_states_eviction", lowest_states_eviction_)
+        .description(
+            "which states to keep once `max_lowest_states` is reached: "
+            "'reject_new' or 'evict_oldest'.")
+        .default_value((std::string) "reject_new")
+        .with_output();
+    if (lowest_states_eviction_ != "reject_new" &&
+        lowest_states_eviction_ != "evict_oldest")
+    {
+      throw utils::InitialConfigException(
+          "`lowest_states_eviction` must be one of ['reject_new', "
+          "'evict_oldest'].");
+    }
   }
 
  private:
+  // Outcome of the exchange attempted from a node in the current step.
+  enum Exchange : uint8_t
+  {
+    kNoExchange,
+    kRejected,
+    kAccepted
+  };
+
+  utils::PackedStateSet::Eviction lowest_states_eviction() const
+  {
+    return lowest_states_eviction_ == "evict_oldest"
+               ? utils::PackedStateSet::kEvictOldest
+               : utils::PackedStateSet::kRejectNew;
+  }
+
   size_t dimensions_;
   ::schedule::Schedule temperature_set_;
+  size_t max_lowest_states_;
+  std::string lowest_states_eviction_;
   std::vector<Node> nodes_;
   size_t nodes_size_;
+  // Per-node results of the exchange moves (recorded concurrently and
+  // observed afterwards).
+  std::vector<Exchange> exchanges_;
+  std::vector<double> spin_overlaps_;
+  std::vector<double> term_overlaps_;
 };
 REGISTER_SOLVER(Murex);
 
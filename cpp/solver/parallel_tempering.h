@@ -6,6 +6,7 @@
 #include <vector>
 
 #include "utils/exception.h"
+#include "utils/instrumentation.h"
 #include "utils/operating_system.h"
 #include "markov/metropolis.h"
 #include "observe/observer.h"
@@ -33,7 +34,10 @@ class ParallelTempering : public SteppingSolver<Model_T>
   using State_T = typename Model_T::State_T;
 
   /// Create an uninitialized Parallel Tempering instance
-  ParallelTempering() : use_inverse_temperatures_(false) {}
+  ParallelTempering()
+      : use_inverse_temperatures_(false), observe_replicas_(false)
+  {
+  }
 
   ParallelTempering(const ParallelTempering&) = delete;
   ParallelTempering& operator=(const ParallelTempering&) = delete;
@@ -142,46 +146,51 @@ class ParallelTempering : public SteppingSolver<Model_T>
     // Record observements
     for (size_t i = 0; i < replicas_.size(); i++)
     {
-      auto label = this->scoped_observable_label("replica", i);
       auto& replica = replicas_[i];
-      if (use_inverse_temperatures_)
-      {
-        this->observe("beta", replica.beta());
-      }
-      else
-      {
-        this->observe("T", replica.temperature());
-      }
       auto counter = replica.get_evaluation_counter();
       this->evaluation_counter_ += counter;
-      this->observe(
-          "acc_rate",
-          static_cast<double>(counter.get_accepted_transition_count()) /
-              static_cast<double>(counter.get_difference_evaluation_count()));
-      this->observe("avg_cost", replica.cost());
+      if (observe_replicas_)
+      {
+        auto label = this->scoped_observable_label("replica", i);
+        if (use_inverse_temperatures_)
+        {
+          this->observe(observed_.beta, replica.beta());
+        }
+        else
+        {
+          this->observe(observed_.T, replica.temperature());
+        }
+        this->observe(
+            observed_.acc_rate,
+            static_cast<double>(counter.get_accepted_transition_count()) /
+                static_cast<double>(
+                    counter.get_difference_evaluation_count()));
+        this->observe(observed_.avg_cost, replica.cost());
+        this->observe(observed_.avg_dir, direction_[i]);
+      }
 
       this->update_lowest_cost(replica.get_lowest_cost(),
                                replica.get_lowest_state());
 
       replica.reset_evaluation_counter();
-      this->observe("avg_dir", direction_[i]);
     }
 
     // Perform replica swaps
+    utils::ScopedPhase exchange_phase("exchange");
     for (size_t i = step & 1; i < replicas_.size() - 1; i += 2)
     {
-      auto label = this->scoped_observable_label("replica", i);
       auto& a = replicas_[i];
       auto& b = replicas_[i + 1];
-      if (accept(a, b))
+      bool accepted = accept(a, b);
+      if (accepted)
       {
         a.swap_state(&b);
         std::swap(direction_[i], direction_[i + 1]);
-        this->observe("swap_rate", 1);
       }
-      else
+      if (observed_.swap_rate)
       {
-        this->observe("swap_rate", 0);
+        auto label = this->scoped_observable_label("replica", i);
+        this->observe(observed_.swap_rate, accepted ? 1 : 0);
       }
     }
     direction_[0] = UP;
@@ -231,6 +240,16 @@ class ParallelTempering : public SteppingSolver<Model_T>
       use_inverse_temperatures_ = true;
       this->set_output_parameter("all_betas", temperatures_);
     }
+
+    observed_.beta = this->get_handle("beta");
+    observed_.T = this->get_handle("T");
+    observed_.acc_rate = this->get_handle("acc_rate");
+    observed_.avg_cost = this->get_handle("avg_cost");
+    observed_.avg_dir = this->get_handle("avg_dir");
+    observed_.swap_rate = this->get_handle("swap_rate");
+    observe_replicas_ = observed_.beta || observed_.T ||
+                        observed_.acc_rate || observed_.avg_cost ||
+                        observed_.avg_dir;
   }
 
   void finalize() override { this->populate_solutions(replicas_); }
@@ -249,6 +268,15 @@ class ParallelTempering : public SteppingSolver<Model_T>
   std::vector<::markov::Metropolis<Model_T>> replicas_;
   std::vector<std::unique_ptr<::utils::RandomGenerator>> rngs_;
   std::vector<Direction> direction_;
+
+  // Observables recorded in each step (resolved in `configure()`).
+  struct Observed
+  {
+    ::observe::Observer::Handle beta, T, acc_rate, avg_cost, avg_dir,
+        swap_rate;
+  };
+  Observed observed_;
+  bool observe_replicas_;
 };
 REGISTER_SOLVER(ParallelTempering);
 
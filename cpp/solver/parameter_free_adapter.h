@@ -40,6 +40,14 @@ class ParameterFreeAdapterInterfaceBase
   // estimate the execution cost (the less the better) of current parameter
   // settings.
   virtual double estimate_execution_cost() const = 0;
+
+  // continue the last run with `parameters` which only raise its step budget
+  // (parameters[0]), keeping its current states; returns false if the solver
+  // can only restart (with `update_parameters`).
+  virtual bool resume_parameters(const std::vector<double>&, double)
+  {
+    return false;
+  }
 };
 
 ////////////////////////////////////////////////////////////////////////////////
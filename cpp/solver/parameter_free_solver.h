@@ -1,8 +1,20 @@
 
 #pragma once
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "utils/exception.h"
+#include "utils/instrumentation.h"
+#include "utils/json.h"
 #include "utils/structure.h"
+#include "omp.h"
 #include "solver/stepping_solver.h"
 #include "strategy/bayesian.h"
+#include "strategy/successive_halving.h"
+#include "strategy/tuning_cache.h"
 
 namespace solver
 {
@@ -12,7 +24,17 @@ class ParameterFreeSolver : public SteppingSolver<Model_T>
 {
  public:
   ParameterFreeSolver()
-      : stable_bests_(0), initial_samples_(4), nonimprovement_limit_(8)
+      : best_worker_(&solver_worker_),
+        stable_bests_(0),
+        initial_samples_(4),
+        nonimprovement_limit_(8),
+        batch_size_(1),
+        batch_samples_(0),
+        successive_halving_(false),
+        worker_count_(0),
+        tuning_cache_neighbors_(3),
+        tuning_cache_skip_distance_(0),
+        tuning_skipped_(false)
   {
   }
 
@@ -32,6 +54,19 @@ class ParameterFreeSolver : public SteppingSolver<Model_T>
   void init() override
   {
     strategy_.init(solver_worker_.parameter_dimensions(), this->seed_);
+    if (successive_halving_)
+    {
+      halving_.init(solver_worker_.parameter_dimensions(), this->seed_);
+    }
+    if (!tuning_cache_file_.empty())
+    {
+      warm_start_from_cache();
+    }
+
+    if (successive_halving_)
+    {
+      this->init_memory_check();
+    }
 
     // to ensure timeout checking as fast as possible
     this->fixed_step_per_tick(1);
@@ -42,6 +77,21 @@ class ParameterFreeSolver : public SteppingSolver<Model_T>
     return solver_worker_.init_memory_check_error_message();
   }
 
+  // Successive halving keeps the workers of up to `halving_configurations`
+  // runs alive (besides `solver_worker_`) to continue them later.
+  void init_memory_check() override
+  {
+    const Model_T& model = this->get_model();
+    size_t memory_per_state = model.state_memory_estimate();
+    size_t memory_per_lower_state = model.state_only_memory_estimate();
+    size_t workers = 1 + halving_.get_configurations();
+    size_t memory_estimation = (memory_per_lower_state + memory_per_state) *
+                               target_number_of_states() * workers;
+    size_t available_memory = utils::get_available_memory();
+    if (available_memory < memory_estimation)
+      throw utils::MemoryLimitedException(init_memory_check_error_message());
+  }
+
   virtual size_t target_number_of_states() const override
   {
     return solver_worker_.target_number_of_states();
@@ -60,13 +110,77 @@ class ParameterFreeSolver : public SteppingSolver<Model_T>
       solver_worker_.set_time_limit(5.);
     }
     training_parameters(json);
+
+    using ::matcher::GreaterThan;
+    auto& params = json[utils::kParams];
+    this->param(params, strategy::kBatchSize, batch_size_)
+        .description(
+            "number of parameter sets evaluated concurrently (each with a "
+            "share of the threads)")
+        .matches(GreaterThan<uint32_t>(0));
+    this->param(params, strategy::kSuccessiveHalving, successive_halving_)
+        .description(
+            "search with successive halving of the parameter sets, which "
+            "continue their runs with growing step budgets");
+    if (successive_halving_)
+    {
+      halving_.configure(params, solver_worker_.get_thread_count());
+      if (batch_size_ > 1)
+      {
+        LOG(WARN, "Successive halving evaluates one parameter set at a time, ",
+            "ignoring ", strategy::kBatchSize);
+        batch_size_ = 1;
+      }
+    }
+    this->param(params, strategy::kTuningCache, tuning_cache_file_)
+        .description(
+            "file caching the tuned parameters of previous runs by problem "
+            "features (empty to disable)");
+    this->param(params, strategy::kTuningCacheNeighbors,
+                tuning_cache_neighbors_)
+        .description(
+            "number of cached parameter sets of the nearest problems which "
+            "are evaluated first");
+    this->param(params, strategy::kTuningCacheSkipDistance,
+                tuning_cache_skip_distance_)
+        .description(
+            "feature distance up to which the parameters of the nearest "
+            "cached problem are used without tuning (negative to always "
+            "tune)");
+    if (batch_size_ > 1 || successive_halving_)
+    {
+      worker_json_.CopyFrom(json, worker_json_.GetAllocator());
+    }
+    if (batch_size_ > 1)
+    {
+      configure_batch_workers();
+    }
   }
 
   void make_step(uint64_t step) override
   {
+    bool cached = tuning_skipped_ || step < warm_start_.size();
+    uint64_t initial_steps =
+        std::max((uint64_t)initial_samples_, (uint64_t)warm_start_.size());
+    if (successive_halving_ && !cached && step >= initial_steps)
+    {
+      make_halving_step();
+      return;
+    }
+    if (batch_size_ > 1 && !cached && step >= initial_steps)
+    {
+      make_batch_step();
+      return;
+    }
     std::vector<double> parameters;
     parameters.reserve(solver_worker_.parameter_dimensions());
-    if (step < initial_samples_)
+    if (cached)
+    {
+      // parameters tuned on the nearest cached problems (only the nearest
+      // one if tuning is skipped)
+      parameters = warm_start_[tuning_skipped_ ? 0 : step];
+    }
+    else if (step < initial_samples_)
     {
       // need to run a few runs first before strategy can make meaningful
       // compuation
@@ -77,27 +191,9 @@ class ParameterFreeSolver : public SteppingSolver<Model_T>
       auto ranges = solver_worker_.parameter_ranges();
       strategy_.set_ranges(ranges);
       bool found = strategy_.recommend_parameter_values(parameters);
-      if (!found)
+      if (!found && !fallback_parameters(parameters))
       {
-        // In case the strategy could not find a group of parameters for search
-        // we fall back to linear by changing the best set of parameters' steps
-        // or replicas
-        if (stable_bests_ < nonimprovement_limit_)
-        {
-          LOG(WARN,
-              "Search strategy failed to update a new set of parameters, doing "
-              "linear update");
-          parameters = parameters_best_;
-          solver_worker_.update_parameters_linearly(parameters);
-        }
-        else
-        {
-          LOG(INFO,
-              "Not witness any gains for mutliple runs, probably get the best "
-              "result, exits");
-          this->set_time_limit(0);
-          return;
-        }
+        return;
       }
     }
     double left_over_time =
@@ -108,53 +204,9 @@ class ParameterFreeSolver : public SteppingSolver<Model_T>
           this->time_limit_.value());
       return;
     }
-    solver_worker_.update_parameters(parameters, left_over_time);
-
-    solver_worker_.init();
-
-    // solver shall own the step limit set up by parameters
-    solver_worker_.fixed_step_per_tick(1);
-    solver_worker_.run();
-
-    // collect useful run time information
-    solver_worker_.update_accumulated_info();
-
-    solver_worker_.finalize();
-
-    double objective = solver_worker_.get_lowest_cost();
-    strategy_.add_new_sample(parameters, objective);
-
-    if (this->lowest_cost_.has_value() &&
-        (std::abs(this->lowest_cost_.value() - objective) < 10E-12))
-    {
-      stable_bests_++;
-
-      // in case that the lowest energy found are the same, we save the
-      // parameters whose estimated execution cost is the least.
-      double cur_execution_cost = solver_worker_.estimate_execution_cost();
-      if (cur_execution_cost < execution_time_best_)
-      {
-        update_best(objective, parameters, cur_execution_cost);
-      }
-    }
-
-    if (stable_bests_ >= nonimprovement_limit_)
-    {
-      LOG(INFO,
-          "Not witness any gains for mutliple runs, probably get the best "
-          "result, exits");
-      this->set_time_limit(0);
-    }
-
-    if (!this->lowest_cost_.has_value() ||
-        this->lowest_cost_.value() - objective >
-            10E-12)  // ignore the possible floating point calculation error
-    {
-      stable_bests_ = 0;
-
-      update_best(objective, parameters,
-                  solver_worker_.estimate_execution_cost());
-    }
+    run_worker(solver_worker_, parameters, left_over_time);
+    add_sample(solver_worker_, parameters, cached);
+    check_nonimprovement();
   }
 
   void finalize() override
@@ -163,7 +215,7 @@ class ParameterFreeSolver : public SteppingSolver<Model_T>
     {
       return;
     }
-    unsigned solutions_to_return = (unsigned)solver_worker_.count_solutions();
+    unsigned solutions_to_return = (unsigned)best_worker_->count_solutions();
 
     this->lowest_costs_.reserve(solutions_to_return);
     this->lowest_states_.reserve(solutions_to_return);
@@ -171,10 +223,15 @@ class ParameterFreeSolver : public SteppingSolver<Model_T>
     this->lowest_states_.push_back(&this->lowest_state_);
 
     solutions_to_return--;
-    solver_worker_.copy_solutions_other(this, solutions_to_return);
+    best_worker_->copy_solutions_other(this, solutions_to_return);
 
     // update with the best parameters found.
     solver_worker_.update_parameters(parameters_best_, 0);
+
+    if (!tuning_cache_file_.empty() && !tuning_skipped_ && !features_.empty())
+    {
+      store_in_cache();
+    }
   }
 
   utils::Structure get_model_properties() const override
@@ -186,7 +243,24 @@ class ParameterFreeSolver : public SteppingSolver<Model_T>
   {
     auto properties = solver_worker_.get_solver_properties();
     utils::Structure training_perf;
-    strategy_.get_perf_metrics(training_perf);
+    if (successive_halving_)
+    {
+      halving_.get_perf_metrics(training_perf);
+      training_perf["brackets"] = halving_.get_bracket();
+    }
+    else
+    {
+      strategy_.get_perf_metrics(training_perf);
+    }
+    if (batch_size_ > 1)
+    {
+      training_perf["batch_samples"] = batch_samples_;
+    }
+    if (!tuning_cache_file_.empty())
+    {
+      training_perf["cached_parameters"] = warm_start_.size();
+      training_perf["tuning_skipped"] = tuning_skipped_;
+    }
     properties["training"] = training_perf;
     return properties;
   }
@@ -205,6 +279,10 @@ class ParameterFreeSolver : public SteppingSolver<Model_T>
   {
     ModelSolver<Model_T>::set_model(model);
     solver_worker_.set_model(model);
+    for (auto& worker : batch_workers_)
+    {
+      worker->set_model(model);
+    }
   }
 
  protected:
@@ -213,7 +291,7 @@ class ParameterFreeSolver : public SteppingSolver<Model_T>
     using ::matcher::GreaterThan;
     auto& params = parameters[utils::kParams];
 
-    strategy_.configure(params, this->get_thread_count());
+    strategy_.configure(params, solver_worker_.get_thread_count());
 
     this->param(params, strategy::kInitialSamples, initial_samples_)
         .description("initial number samples to be provided for model training")
@@ -231,16 +309,346 @@ class ParameterFreeSolver : public SteppingSolver<Model_T>
   }
 #endif
  protected:
-  void update_best(double objective, std::vector<double>& parameters,
+  // In case the strategy could not find a group of parameters for search
+  // we fall back to linear by changing the best set of parameters' steps
+  // or replicas; returns false if the search should stop instead.
+  bool fallback_parameters(std::vector<double>& parameters)
+  {
+    if (stable_bests_ < nonimprovement_limit_)
+    {
+      LOG(WARN,
+          "Search strategy failed to update a new set of parameters, doing "
+          "linear update");
+      parameters = parameters_best_;
+      solver_worker_.update_parameters_linearly(parameters);
+      return true;
+    }
+    LOG(INFO,
+        "Not witness any gains for mutliple runs, probably get the best "
+        "result, exits");
+    this->set_time_limit(0);
+    return false;
+  }
+
+  // Run `worker` to completion with `parameters` (continuing its last run
+  // if `resume` is set and the worker supports it). The worker's phases are
+  // accounted to the steps of this solver (batch workers run in a parallel
+  // region).
+  void run_worker(SolverAdapter& worker, const std::vector<double>& parameters,
+                  double left_over_time, bool resume = false)
+  {
+    utils::ScopedPhasesPaused paused_phases;
+    if (!resume || !worker.resume_parameters(parameters, left_over_time))
+    {
+      worker.update_parameters(parameters, left_over_time);
+
+      worker.init();
+    }
+
+    // solver shall own the step limit set up by parameters
+    worker.fixed_step_per_tick(1);
+    worker.run();
+
+    // collect useful run time information
+    worker.update_accumulated_info();
+
+    worker.finalize();
+  }
+
+  // Feed the result of `worker`'s run with `parameters` back to the strategy
+  // (as a `prior` sample if they were not recommended by it) and keep it if
+  // it is the best so far.
+  void add_sample(SolverAdapter& worker, std::vector<double>& parameters,
+                  bool prior = false)
+  {
+    double objective = worker.get_lowest_cost();
+    if (prior)
+    {
+      strategy_.add_prior_sample(parameters, objective);
+    }
+    else
+    {
+      strategy_.add_new_sample(parameters, objective);
+    }
+    update_result(worker, parameters, objective);
+  }
+
+  void update_result(const SolverAdapter& worker,
+                     std::vector<double>& parameters, double objective)
+  {
+    if (this->lowest_cost_.has_value() &&
+        (std::abs(this->lowest_cost_.value() - objective) < 10E-12))
+    {
+      stable_bests_++;
+
+      // in case that the lowest energy found are the same, we save the
+      // parameters whose estimated execution cost is the least.
+      double cur_execution_cost = worker.estimate_execution_cost();
+      if (cur_execution_cost < execution_time_best_)
+      {
+        update_best(worker, objective, parameters, cur_execution_cost);
+      }
+    }
+
+    if (!this->lowest_cost_.has_value() ||
+        this->lowest_cost_.value() - objective >
+            10E-12)  // ignore the possible floating point calculation error
+    {
+      stable_bests_ = 0;
+
+      this->trace_lowest_cost(objective);
+      update_best(worker, objective, parameters,
+                  worker.estimate_execution_cost());
+    }
+  }
+
+  void check_nonimprovement()
+  {
+    if (stable_bests_ >= nonimprovement_limit_)
+    {
+      LOG(INFO,
+          "Not witness any gains for mutliple runs, probably get the best "
+          "result, exits");
+      this->set_time_limit(0);
+    }
+  }
+
+  // Set `params[key]` of the configuration of additional workers.
+  void set_worker_param(const char* key, utils::Json& value)
+  {
+    auto& allocator = worker_json_.GetAllocator();
+    utils::Json& params = worker_json_[utils::kParams];
+    if (params.HasMember(key))
+    {
+      params[key] = value;
+    }
+    else
+    {
+      utils::Json name(key, allocator);
+      params.AddMember(name, value, allocator);
+    }
+  }
+
+  // Create an additional worker (besides `solver_worker_`) with its own seed.
+  std::unique_ptr<SolverAdapter> create_worker()
+  {
+    utils::Json seed(this->seed_ + ++worker_count_);
+    set_worker_param("seed", seed);
+
+    std::unique_ptr<SolverAdapter> worker(new SolverAdapter());
+    worker->set_model(this->model_);
+    worker->configure(worker_json_);
+    worker->copy_limits(this);
+    // Configuring the worker may have lowered the thread count of this thread.
+    omp_set_num_threads(solver_worker_.get_thread_count());
+    return worker;
+  }
+
+  // Create the workers of batch mode: `batch_size_` copies of the worker
+  // which share the threads of `solver_worker_`.
+  void configure_batch_workers()
+  {
+    int thread_count = solver_worker_.get_thread_count();
+    int worker_threads = std::max(1, thread_count / (int)batch_size_);
+    utils::Json threads(worker_threads);
+    set_worker_param("threads", threads);
+
+    batch_workers_.clear();
+    for (uint32_t i = 0; i < batch_size_; i++)
+    {
+      batch_workers_.push_back(create_worker());
+    }
+    LOG(INFO, "Evaluating ", batch_size_, " parameter sets concurrently with ",
+        worker_threads, " threads each");
+  }
+
+  // Evaluate a batch of parameter sets recommended by the strategy
+  // concurrently (one per batch worker) and feed the results back together.
+  void make_batch_step()
+  {
+    std::vector<std::vector<double>> batch;
+    strategy_.set_ranges(solver_worker_.parameter_ranges());
+    if (!strategy_.recommend_parameter_batch(batch_workers_.size(), batch))
+    {
+      batch.resize(1);
+      if (!fallback_parameters(batch[0]))
+      {
+        return;
+      }
+    }
+    double left_over_time =
+        this->time_limit_.value() - (utils::get_wall_time() - this->start_time_);
+    if (left_over_time <= 0 && this->lowest_cost_.has_value())
+    {
+      LOG(INFO, "Stop parameter searching, becauseof timeout:",
+          this->time_limit_.value());
+      return;
+    }
+
+    int worker_threads = batch_workers_[0]->get_thread_count();
+    int max_active_levels = omp_get_max_active_levels();
+    // Each worker parallelizes on its own share of the threads.
+    omp_set_max_active_levels(std::max(max_active_levels, 2));
+    utils::OmpCatch omp_catch;
+    #pragma omp parallel for num_threads((int)batch.size()) schedule(static, 1)
+    for (int i = 0; i < (int)batch.size(); i++)
+    {
+      omp_catch.run([&] {
+        omp_set_num_threads(worker_threads);
+        run_worker(*batch_workers_[i], batch[i], left_over_time);
+      });
+    }
+    omp_set_max_active_levels(max_active_levels);
+    omp_catch.rethrow();
+
+    for (size_t i = 0; i < batch.size(); i++)
+    {
+      add_sample(*batch_workers_[i], batch[i]);
+    }
+    batch_samples_ += (uint32_t)batch.size();
+    for (auto& worker : batch_workers_)
+    {
+      if (best_worker_ == worker.get())
+      {
+        // keep the best worker's solutions rather than rerunning it
+        best_checkpoint_ = std::move(worker);
+        worker = create_worker();
+      }
+    }
+    check_nonimprovement();
+  }
+
+  // Evaluate the next parameter set of the successive halving schedule. Runs
+  // are checkpointed (their workers kept) while they may be promoted, and
+  // promoted parameter sets continue them rather than restarting.
+  void make_halving_step()
+  {
+    std::vector<double> parameters;
+    halving_.set_ranges(solver_worker_.parameter_ranges());
+    halving_.recommend_parameter_values(parameters);
+    double left_over_time =
+        this->time_limit_.value() - (utils::get_wall_time() - this->start_time_);
+    if (left_over_time <= 0 && this->lowest_cost_.has_value())
+    {
+      LOG(INFO, "Stop parameter searching, becauseof timeout:",
+          this->time_limit_.value());
+      return;
+    }
+
+    std::shared_ptr<SolverAdapter> worker;
+    auto checkpoint = checkpoints_.find(halving_.get_resumed_sample());
+    bool resume = checkpoint != checkpoints_.end();
+    if (resume)
+    {
+      worker = checkpoint->second;
+      checkpoints_.erase(checkpoint);
+    }
+    else
+    {
+      worker = create_worker();
+    }
+    run_worker(*worker, parameters, left_over_time, resume);
+    checkpoints_[halving_.get_sample_count()] = worker;
+
+    double objective = worker->get_lowest_cost();
+    halving_.add_new_sample(parameters, objective);
+    update_result(*worker, parameters, objective);
+    if (best_worker_ == worker.get())
+    {
+      best_checkpoint_ = worker;
+    }
+
+    // release the runs which were not promoted
+    std::vector<int> resumable;
+    halving_.get_resumable_samples(resumable);
+    for (auto it = checkpoints_.begin(); it != checkpoints_.end();)
+    {
+      if (std::find(resumable.begin(), resumable.end(), it->first) ==
+          resumable.end())
+      {
+        it = checkpoints_.erase(it);
+      }
+      else
+      {
+        ++it;
+      }
+    }
+    check_nonimprovement();
+  }
+
+  // Look up the parameters tuned on the problems nearest to this model in the
+  // tuning cache: they are evaluated before the initial samples, or instead
+  // of tuning if the nearest problem is within `tuning_cache_skip_distance_`.
+  void warm_start_from_cache()
+  {
+    warm_start_.clear();
+    tuning_skipped_ = false;
+    features_ = strategy::TuningCache::get_features(get_model_properties());
+    if (features_.empty())
+    {
+      LOG(WARN, "The model provides no features for the tuning cache.");
+      return;
+    }
+    tuning_cache_.load(tuning_cache_file_);
+    auto nearest = tuning_cache_.find_nearest(
+        get_identifier(), features_, solver_worker_.parameter_dimensions(),
+        tuning_cache_neighbors_);
+    if (nearest.empty()) return;
+    for (const auto& neighbor : nearest)
+    {
+      warm_start_.push_back(neighbor.entry->parameters_);
+    }
+    tuning_skipped_ = nearest[0].distance <= tuning_cache_skip_distance_;
+    LOG(INFO, "Starting from ", warm_start_.size(),
+        " cached parameter sets (nearest at distance ", nearest[0].distance,
+        tuning_skipped_ ? ", skipping tuning)" : ")");
+  }
+
+  // Append the best parameters found to the tuning cache.
+  void store_in_cache()
+  {
+    strategy::TuningEntry entry;
+    entry.solver_ = get_identifier();
+    entry.features_ = features_;
+    entry.parameters_ = parameters_best_;
+    entry.execution_cost_ = execution_time_best_;
+    entry.cost_ = this->lowest_cost_.value();
+    try
+    {
+      tuning_cache_.store(tuning_cache_file_, entry);
+    }
+    catch (const utils::FileWriteException& e)
+    {
+      // the result is still valid without caching its parameters
+      LOG(WARN, e.what());
+    }
+  }
+
+  void update_best(const SolverAdapter& worker, double objective,
+                   std::vector<double>& parameters,
                    double estimated_execution_cost)
   {
     this->lowest_cost_ = objective;
-    solver_worker_.copy_lowest_state(this);
+    worker.copy_lowest_state(this);
+    best_worker_ = &worker;
     parameters_best_ = parameters;
     execution_time_best_ = estimated_execution_cost;
   }
   // The actual solver class which will execute solver algorithm
   SolverAdapter solver_worker_;
+  // Workers evaluating a batch of parameter sets concurrently (batch mode)
+  std::vector<std::unique_ptr<SolverAdapter>> batch_workers_;
+  // Worker which found the best result (its solutions are returned)
+  const SolverAdapter* best_worker_;
+  // Configuration of additional workers
+  utils::JsonDocument worker_json_;
+  // Successive halving schedule (instead of `strategy_`)
+  strategy::SuccessiveHalvingOpt halving_;
+  // Workers of the runs which successive halving may continue (by sample)
+  std::map<int, std::shared_ptr<SolverAdapter>> checkpoints_;
+  // Keeps the worker of the best result alive once it is not checkpointed
+  // (or no longer a batch worker)
+  std::shared_ptr<SolverAdapter> best_checkpoint_;
   // Parameter searching strategy class like BayesianOpt
   StrategyType strategy_;
   // Best set of parameters found sor far
@@ -254,5 +662,26 @@ class ParameterFreeSolver : public SteppingSolver<Model_T>
   uint32_t initial_samples_;
   // Max number of non-improved searching result for existing
   uint32_t nonimprovement_limit_;
+  // Number of parameter sets evaluated concurrently
+  uint32_t batch_size_;
+  // Number of parameter sets evaluated in batches
+  uint32_t batch_samples_;
+  // Whether to search with successive halving
+  bool successive_halving_;
+  // Number of additional workers created
+  uint32_t worker_count_;
+  // File of the tuning cache (empty if disabled)
+  std::string tuning_cache_file_;
+  // Number of cached parameter sets evaluated first
+  uint32_t tuning_cache_neighbors_;
+  // Feature distance up to which cached parameters are used without tuning
+  double tuning_cache_skip_distance_;
+  strategy::TuningCache tuning_cache_;
+  // Features of the model (keying the tuning cache)
+  std::vector<double> features_;
+  // Cached parameter sets of the nearest problems (nearest first)
+  std::vector<std::vector<double>> warm_start_;
+  // Whether the parameters of the nearest cached problem are used throughout
+  bool tuning_skipped_;
 };
 }  // namespace solver
\ No newline at end of file
@@ -1,11 +1,15 @@
 
 #pragma once
 
+#include <algorithm>
 #include <map>
 #include <memory>
+#include <new>
+#include <type_traits>
 #include <vector>
 
 #include "utils/component.h"
+#include "utils/scan.h"
 #include "omp.h"
 
 namespace solver
@@ -41,13 +45,24 @@ namespace solver
 ///     std::cout << population[i].content();
 ///   }
 ///
+/// Citizens live in an arena owned by the population (one contiguous block
+/// after `reserve()`); resampling only reorders pointers into it and recycles
+/// the slots of killed citizens for the offspring.
+///
 template <class Content_T>
 class Population : public utils::Component
 {
  public:
   using FamilyId = size_t;
 
-  Population() {}
+  Population() : arena_capacity_(0) {}
+
+  // The population owns the storage of its citizens (and hands out
+  // references to them), so it must not be copied.
+  Population(const Population&) = delete;
+  Population& operator=(const Population&) = delete;
+
+  ~Population() override { release(); }
 
   class Citizen
   {
@@ -60,7 +75,7 @@ class Population : public utils::Component
     Citizen(const Citizen& other) = delete;
 
     // Create a new citizen for the content provided
-    explicit Citizen(Content_T content)
+    explicit Citizen(const Content_T& content)
         : count_(1), family_id_(0), content_(content)
     {
     }
@@ -90,8 +105,7 @@ class Population : public utils::Component
     Content_T* operator->() { return &content_; }
 
     // Comparator for sorting citizens
-    static bool compare(const std::unique_ptr<Citizen>& c1,
-                        const std::unique_ptr<Citizen>& c2)
+    static bool compare(const Citizen* c1, const Citizen* c2)
     {
       return Content_T::compare(**c1, **c2);
     }
@@ -111,14 +125,28 @@ class Population : public utils::Component
     Content_T content_;
   };
 
-  void reserve(size_t size) { citizens_.reserve(size); }
+  /// Reserve storage for `size` citizens.
+  ///
+  /// The first call allocates a single contiguous block for all of them;
+  /// citizens created within the reserved size never cause a reallocation
+  /// during resampling.
+  void reserve(size_t size)
+  {
+    citizens_.reserve(size);
+    resampled_.reserve(size);
+    positions_.reserve(size);
+    spawned_.reserve(size);
+    released_.reserve(size);
+    if (size > arena_capacity_)
+    {
+      add_block(size - arena_capacity_);
+    }
+  }
 
   /// Add `content` to the population (with a count of 1).
-  void insert(Content_T content)
+  void insert(const Content_T& content)
   {
-    std::unique_ptr<Citizen> citizen;
-    create_citizen(citizen, content);
-    citizens_.push_back(std::move(citizen));
+    citizens_.push_back(create_citizen(content));
   }
 
   void resize(size_t new_count)
@@ -128,7 +156,7 @@ class Population : public utils::Component
       LOG(WARN,
           "Population::resize is not intended to grow the population. "
           "It appends nullptrs.");
-      citizens_.resize(new_count);
+      citizens_.resize(new_count, nullptr);
     }
     else
     {
@@ -168,53 +196,119 @@ class Population : public utils::Component
 
   /// Resample the population such that `count_` copies of each citizen in
   /// the current population are present in the resampled one.
+  ///
+  /// Citizens are never moved in memory: survivors stay in their slot of the
+  /// arena, and offspring are copied into slots released by citizens with a
+  /// count of 0 (copy-assignment into a recycled slot re-uses the buffers
+  /// of the released content instead of allocating new ones). Only the
+  /// vector of pointers defining the positional order is rebuilt.
+  ///
+  /// The target positions of each citizen and its offspring (and the slots
+  /// to recycle for them) are found by prefix sums over the counts, such that
+  /// the copies can be made in parallel.
   void resample()
   {
     families_.clear();  // force redoing the census.
-    std::vector<std::unique_ptr<Citizen>> resampled;
-#ifdef _DEBUG
-    size_t vanished = 0;
-#endif
-    // First let us release all the citizens whose count() is 0
-    // this can effective avoid the situation we have more than
-    // target population citizen, since some citizen will be
-    // repopulated more than 1.
-    for (size_t i = 0; i < citizens_.size(); i++)
+    size_t n = citizens_.size();
+
+    // For each citizen, the position of its first copy in the resampled
+    // population, the index of its first offspring and whether it is
+    // released (count 0). They are turned into offsets by the scans.
+    positions_.resize(n);
+    spawned_.resize(n);
+    released_.resize(n);
+    // Vacant slots (appended by `resize()`) are dropped without being
+    // released.
+    #pragma omp parallel for
+    for (size_t i = 0; i < n; i++)
     {
-      if (citizens_[i]->get_count() == 0)
-      {
-        remove_citizen(citizens_[i]);
+      bool vacant = citizens_[i] == nullptr;
+      size_t count = vacant ? 0 : citizens_[i]->get_count();
+      positions_[i] = count;
+      spawned_[i] = count > 1 ? count - 1 : 0;
+      released_[i] = count == 0 && !vacant ? 1 : 0;
+    }
+    size_t resampled_size = utils::exclusive_scan(positions_);
+    size_t spawned_count = utils::exclusive_scan(spawned_);
+    size_t released_count = utils::exclusive_scan(released_);
 #ifdef _DEBUG
-        vanished++;
-        assert(vanished < citizens_.size());
+    assert(n == 0 || released_count < n);
 #endif
-      }
-    }
-    for (size_t i = 0; i < citizens_.size(); i++)
+    // NOTE: From here on, counts are inferred from the offsets rather than
+    // read from the citizens (which are modified concurrently).
+    auto count_of = [&](size_t i) {
+      return (i + 1 < n ? positions_[i + 1] : resampled_size) - positions_[i];
+    };
+
+    // Released citizens provide the slots for the offspring first. Any
+    // excess is moved to the pool, any shortfall is taken from the pool
+    // and, as a last resort, from vacant slots in the arena.
+    donors_.resize(spawned_count);
+    size_t recycled = std::min(spawned_count, released_count);
+    size_t pool_size = citizens_cache_pool_.size();
+    citizens_cache_pool_.resize(pool_size + released_count - recycled);
+    #pragma omp parallel for
+    for (size_t i = 0; i < n; i++)
     {
-      if (citizens_[i].get() == nullptr)
+      if (count_of(i) != 0 || citizens_[i] == nullptr) continue;
+      size_t k = released_[i];
+      if (k < recycled)
       {
-        // the citizen has been released since the count is 0
-        continue;
+        donors_[k] = citizens_[i];
       }
-      const auto& citizen = *citizens_[i];
-      // for each count larger than 1, create copies
-      for (size_t count = 1; count < citizen.get_count(); count++)
+      else
       {
-        std::unique_ptr<Citizen> new_citizen;
-        create_citizen(new_citizen, citizen.content());
-        new_citizen->set_family(citizen.get_family());
-        resampled.push_back(std::move(new_citizen));
+        citizens_cache_pool_[pool_size + k - recycled] = citizens_[i];
       }
-      // if the count is non-zero, move the citizen
-      // (i.e., move the first one, don't copy).
-      if (citizen.get_count() > 0)
+    }
+    size_t constructed = recycled;
+    while (constructed < spawned_count && !citizens_cache_pool_.empty())
+    {
+      donors_[constructed++] = citizens_cache_pool_.back();
+      citizens_cache_pool_.pop_back();
+    }
+    if (constructed + vacant_slots_.size() < spawned_count)
+    {
+      // Grow geometrically if the reserved size is exceeded.
+      add_block(std::max(arena_capacity_, spawned_count - constructed -
+                                              vacant_slots_.size()));
+    }
+    for (size_t k = constructed; k < spawned_count; k++)
+    {
+      donors_[k] = vacant_slots_.back();
+      vacant_slots_.pop_back();
+    }
+
+    // Place the offspring ahead of their parent, keeping the order stable.
+    resampled_.resize(resampled_size);
+    #pragma omp parallel for
+    for (size_t i = 0; i < n; i++)
+    {
+      size_t count = count_of(i);
+      if (count == 0) continue;
+      Citizen* citizen = citizens_[i];
+      size_t position = positions_[i];
+      for (size_t k = 0; k + 1 < count; k++)
       {
-        citizens_[i]->set_count(1);
-        resampled.push_back(std::move(citizens_[i]));
+        size_t donor = spawned_[i] + k;
+        Citizen* new_citizen = donors_[donor];
+        if (donor < constructed)
+        {
+          new_citizen->content() = citizen->content();
+        }
+        else
+        {
+          new (new_citizen) Citizen(citizen->content());
+        }
+        new_citizen->set_family(citizen->get_family());
+        new_citizen->set_count(1);
+        resampled_[position + k] = new_citizen;
       }
+      // the citizen itself stays in place.
+      citizen->set_count(1);
+      resampled_[position + count - 1] = citizen;
     }
-    std::swap(citizens_, resampled);
+    std::swap(citizens_, resampled_);
   }
 
   /// Returns a map describing the sizes of the remaining families.
@@ -241,13 +335,22 @@ class Population : public utils::Component
     assert(citizens_.size() == 0);
   }
 
+  /// Destroy the released citizens kept for recycling. Their slots in the
+  /// arena remain available for future citizens.
   void clear_cache_pool()
   {
-    std::vector<std::unique_ptr<Citizen>> empty;
-    std::swap(citizens_cache_pool_, empty);
+    for (Citizen* citizen : citizens_cache_pool_)
+    {
+      citizen->~Citizen();
+      vacant_slots_.push_back(citizen);
+    }
+    citizens_cache_pool_.clear();
   }
 
  private:
+  using Slot = typename std::aligned_storage<sizeof(Citizen),
+                                             alignof(Citizen)>::type;
+
   void do_census()
   {
     for (const auto& citizen : citizens_)
@@ -267,39 +370,83 @@ class Population : public utils::Component
     }
   }
 
-  // Take a Citizen from the pool (or allocate a new one) and place
-  // it into `citizen` with `content` as its content.
-  void create_citizen(std::unique_ptr<Citizen>& citizen,
-                      const Content_T& content)
+  // Append a block of `size` (unconstructed) slots to the arena.
+  void add_block(size_t size)
   {
-    if (citizen != nullptr)
+    std::unique_ptr<Slot[]> block(new Slot[size]);
+    vacant_slots_.reserve(vacant_slots_.size() + size);
+    // Slots are handed out from the back; push them in reverse order such
+    // that consecutive citizens are placed at consecutive addresses.
+    for (size_t i = size; i > 0; i--)
     {
-      LOG(WARN, "Attempting to create citizen in non-empty pointer");
-      return;
+      vacant_slots_.push_back(reinterpret_cast<Citizen*>(&block[i - 1]));
     }
-    if (citizens_cache_pool_.empty())
+    arena_.push_back(std::move(block));
+    arena_capacity_ += size;
+  }
+
+  // Take a Citizen from the pool (or construct a new one in a vacant slot)
+  // and assign `content` as its content.
+  Citizen* create_citizen(const Content_T& content)
+  {
+    Citizen* citizen;
+    if (!citizens_cache_pool_.empty())
     {
-      citizen.reset(new Citizen(content));
+      citizen = citizens_cache_pool_.back();
+      citizens_cache_pool_.pop_back();
+      citizen->content() = content;
     }
     else
     {
-      std::swap(citizen, citizens_cache_pool_.back());
-      citizens_cache_pool_.pop_back();
-      citizen->content() = content;
+      if (vacant_slots_.empty())
+      {
+        // Grow geometrically if the reserved size is exceeded.
+        add_block(std::max(arena_capacity_, size_t(16)));
+      }
+      citizen = new (vacant_slots_.back()) Citizen(content);
+      vacant_slots_.pop_back();
     }
     citizen->set_count(1);
+    return citizen;
   }
 
   // Remove a citizen from the (active) population by moving the
   // pointer to the inactive citizen pool for later recycling.
-  void remove_citizen(std::unique_ptr<Citizen>& citizen)
+  void remove_citizen(Citizen*& citizen)
+  {
+    if (citizen != nullptr)
+    {
+      citizens_cache_pool_.push_back(citizen);
+      citizen = nullptr;
+    }
+  }
+
+  // Destroy all constructed citizens and free the arena.
+  void release()
   {
-    citizens_cache_pool_.push_back(nullptr);
-    std::swap(citizen, citizens_cache_pool_.back());
+    clear();
+    clear_cache_pool();
+    vacant_slots_.clear();
+    arena_.clear();
+    arena_capacity_ = 0;
   }
 
-  std::vector<std::unique_ptr<Citizen>> citizens_;
-  std::vector<std::unique_ptr<Citizen>> citizens_cache_pool_;
+  // Positional order of the active citizens (pointing into the arena).
+  std::vector<Citizen*> citizens_;
+  // Scratch buffer for the order after resampling (kept to avoid
+  // re-allocating it at every step).
+  std::vector<Citizen*> resampled_;
+  // Scratch buffers for the offsets computed during resampling.
+  std::vector<size_t> positions_;
+  std::vector<size_t> spawned_;
+  std::vector<size_t> released_;
+  std::vector<Citizen*> donors_;
+  // Constructed citizens which are not part of the population.
+  std::vector<Citizen*> citizens_cache_pool_;
+  // Slots in the arena which do not hold a constructed citizen.
+  std::vector<Citizen*> vacant_slots_;
+  std::vector<std::unique_ptr<Slot[]>> arena_;
+  size_t arena_capacity_;
   std::map<FamilyId, size_t> families_;
 };
 
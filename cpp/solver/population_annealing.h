@@ -1,10 +1,15 @@
 
 #pragma once
 
+#include <algorithm>
+#include <limits>
+#include <map>
+#include <memory>
 #include <vector>
 
 #include "utils/config.h"
 #include "utils/exception.h"
+#include "utils/instrumentation.h"
 #include "utils/operating_system.h"
 #include "utils/random_generator.h"
 #include "utils/random_selector.h"
@@ -71,6 +76,25 @@ namespace solver
 ///   }
 ///   ```
 ///
+/// Sharded mode
+///
+/// With `shards` > 1 (and a `linear_schedule` or `geometric_schedule`), the
+/// population is split into independent sub-populations, each of which is
+/// swept and resampled (to a constant size) by one thread with its own
+/// random number generator. Each shard keeps track of the statistical weight
+/// it represents (the product of its partition function ratios), and every
+/// `rebalance_interval` steps all citizens are resampled globally according
+/// to these weights and citizens are migrated to even out the shard sizes.
+///
+///   ```json
+///   {
+///     'target': 'populationannealing.cpu',
+///     'version': '1.0',
+///     'shards': 8,
+///     'rebalance_interval': 10
+///   }
+///   ```
+///
 template <class Model_T>
 class PopulationAnnealing : public SteppingSolver<Model_T>
 {
@@ -78,7 +102,10 @@ class PopulationAnnealing : public SteppingSolver<Model_T>
   using Base_T = SteppingSolver<Model_T>;
   using State_T = typename Model_T::State_T;
 
-  PopulationAnnealing() : target_population_(0), epoch_(0) {}
+  PopulationAnnealing()
+      : target_population_(0), shard_count_(1), rebalance_interval_(1), epoch_(0)
+  {
+  }
 
   PopulationAnnealing(const PopulationAnnealing&) = delete;
   PopulationAnnealing& operator=(const PopulationAnnealing&) = delete;
@@ -105,12 +132,9 @@ class PopulationAnnealing : public SteppingSolver<Model_T>
     this->init_memory_check();
     // proceed to memory allocation
 
-    // Initialize the rngs
-    rngs_.resize(static_cast<size_t>(omp_get_max_threads()));
-    for (size_t t = 0; t < rngs_.size(); t++)
-    {
-      rngs_[t] = this->rng_->fork();
-    }
+    // The random number generators of the chunks of citizens are forked as
+    // needed (see `for_each_citizen`).
+    rngs_.clear();
 
     // Rescale the bonds in the model
     if (!this->model_->is_rescaled())
@@ -118,6 +142,18 @@ class PopulationAnnealing : public SteppingSolver<Model_T>
       const_cast<Model_T*>(this->model_)->rescale();
     }
 
+    // Create the shards (in sharded mode)
+    if (is_sharded())
+    {
+      if (shards_.empty())
+      {
+        cur_beta_ = beta_start_;
+        restart_base_step_ = 0;
+        init_shards();
+      }
+      return;
+    }
+
     // Create the population
     if (population_.empty())
     {
@@ -155,13 +191,10 @@ class PopulationAnnealing : public SteppingSolver<Model_T>
       population_[i].set_family(i);
     }
 
-    #pragma omp parallel for schedule(static, 1)
-    for (size_t i = 0; i < population_.size(); i++)
-    {
-      size_t thread_id = static_cast<size_t>(omp_get_thread_num());
-      population_[i]->set_rng(rngs_[thread_id].get());
+    for_each_citizen([&](size_t i, ::utils::RandomGenerator& rng) {
+      population_[i]->set_rng(&rng);
       population_[i]->init();
-    }
+    });
 
     current_culling_fraction_ = initial_culling_fraction_;
   }
@@ -261,7 +294,13 @@ class PopulationAnnealing : public SteppingSolver<Model_T>
 
   void make_step(uint64_t step) override
   {
-    this->observe("epoch", static_cast<double>(epoch_));
+    this->observe(observed_.epoch, static_cast<double>(epoch_));
+
+    if (is_sharded())
+    {
+      make_sharded_step(step);
+      return;
+    }
 
     if (population_.empty())
     {
@@ -277,13 +316,10 @@ class PopulationAnnealing : public SteppingSolver<Model_T>
     costs_after_.resize(R);
 
     // Perform `input_params.sweeps` Metropolis sweeps per citizen.
-    #pragma omp parallel for schedule(static, 1)
-    for (size_t i = 0; i < R; i++)
-    {
+    for_each_citizen([&](size_t i, ::utils::RandomGenerator& rng) {
       costs_before_[i] = population_[i]->cost();
-      size_t thread_id = static_cast<size_t>(omp_get_thread_num());
       auto& citizen = population_[i];
-      citizen->set_rng(rngs_[thread_id].get());
+      citizen->set_rng(&rng);
 
       // each sweep may take quite some time, and the R may be large for
       // population annealing so we need to double check the time_limit_ to
@@ -296,7 +332,7 @@ class PopulationAnnealing : public SteppingSolver<Model_T>
       }
 
       costs_after_[i] = citizen->cost();
-    }
+    });
 
     for (size_t i = 0; i < population_.size(); i++)
     {
@@ -339,8 +375,8 @@ class PopulationAnnealing : public SteppingSolver<Model_T>
 #endif
     avg_before /= Rd;
     avg_after /= Rd;
-    this->observe("cost", avg_after);
-    this->observe("population", Rd);
+    this->observe(observed_.cost, avg_after);
+    this->observe(observed_.population, Rd);
 
     double var_before = 0;
     double var_after = 0;
@@ -358,7 +394,7 @@ class PopulationAnnealing : public SteppingSolver<Model_T>
     var_after /= Rd;
     gamma /= Rd;
     double sigma = sqrt(var_before * var_after);
-    this->observe("sigma", sigma);
+    this->observe(observed_.sigma, sigma);
     double zeta = 0;
     if (sigma > 0 && gamma != 0)
     {
@@ -368,8 +404,8 @@ class PopulationAnnealing : public SteppingSolver<Model_T>
         // avoid divided by 0 and floating point calculation error
         double tau = static_cast<double>(sweeps_per_replica_) / delta;
         zeta = sigma * tau;
-        this->observe("tau", tau);
-        this->observe("zeta", zeta);
+        this->observe(observed_.tau, tau);
+        this->observe(observed_.zeta, zeta);
       }
     }
 
@@ -426,22 +462,25 @@ class PopulationAnnealing : public SteppingSolver<Model_T>
     if (delta_beta > 0)
     {
       // Resampling according to selected delta_beta
-      this->observe("delta_beta", delta_beta);
-      resample(delta_beta);
+      this->observe(observed_.delta_beta, delta_beta);
+      {
+        utils::ScopedPhase phase("resample");
+        resample(delta_beta);
+      }
 
       // Family observables
       auto& families = population_.get_families();
       double family_count = static_cast<double>(families.size());
-      this->observe("families", family_count);
+      this->observe(observed_.families, family_count);
       rho_t = 0;
       for (const auto& id_and_size : families)
       {
         double family_size = static_cast<double>(id_and_size.second);
         rho_t += family_size * family_size;
-        this->observe("family_size", family_size, 1.);
+        this->observe(observed_.family_size, family_size, 1.);
       }
       rho_t /= Rd;
-      this->observe("rho_t", rho_t);
+      this->observe(observed_.rho_t, rho_t);
     }
 
     // This condition checks for two things:
@@ -487,6 +526,28 @@ class PopulationAnnealing : public SteppingSolver<Model_T>
     utils::disable_overflow_divbyzero_exceptions();
   }
 
+  /// Call `function(i, rng)` for each citizen `i`, in parallel.
+  ///
+  /// The citizens are split into chunks of `kCitizensPerChunk`, each drawing
+  /// from its own random number generator (forked in order), such that the
+  /// results do not depend on the number of threads.
+  template <class Function>
+  void for_each_citizen(Function function)
+  {
+    size_t size = population_.size();
+    size_t chunks = (size + kCitizensPerChunk - 1) / kCitizensPerChunk;
+    while (rngs_.size() < chunks) rngs_.push_back(this->rng_->fork());
+    #pragma omp parallel for schedule(dynamic, 1)
+    for (size_t chunk = 0; chunk < chunks; chunk++)
+    {
+      size_t end = std::min(size, (chunk + 1) * kCitizensPerChunk);
+      for (size_t i = chunk * kCitizensPerChunk; i < end; i++)
+      {
+        function(i, *rngs_[chunk]);
+      }
+    }
+  }
+
   void resample(double delta_beta)
   {
     if (population_.size() == 0)
@@ -555,26 +616,28 @@ class PopulationAnnealing : public SteppingSolver<Model_T>
         residual_weights[i] = residual_weight;
         resampled_size += int_weight;
       }
-      // We use a RandomSelector to fill the population to the desired size.
-      // (this helper class ensures the filling citizens are chosen with
-      // probability proportional to their residual weight). As a result,
-      // each citizen is selected
+      // We use systematic selection over the residual weights to fill the
+      // population to the desired size (this ensures the filling citizens
+      // are chosen with probability proportional to their residual weight
+      // and only requires a parallel prefix sum). As a result, each citizen
+      // is selected
       //
       //   * at least `floor(relative_weight)` times
       //   * at most `ceil(relative_weight)` times
       //   * has a chance to be selected an additional time of
       //     `relative_weight - floor(relative_weight)`
       //     (i.e., the fractional part of `relative_weight`)
-      ::utils::RandomSelector selector;
-      for (size_t i = 0; i < population_.size(); i++)
+      if (resampled_size < population_.size())
       {
-        selector.insert(i, residual_weights[i]);
-      }
-      while (resampled_size < population_.size())
-      {
-        size_t citizen_id = selector.select_and_remove(this->rng_->uniform());
-        population_[citizen_id].spawn(1);
-        resampled_size++;
+        std::vector<size_t> selections;
+        ::utils::systematic_selection(residual_weights,
+                                      population_.size() - resampled_size,
+                                      this->rng_->uniform(), selections);
+        #pragma omp parallel for
+        for (size_t i = 0; i < population_.size(); i++)
+        {
+          if (selections[i] > 0) population_[i].spawn(selections[i]);
+        }
       }
     }
     else
@@ -582,28 +645,21 @@ class PopulationAnnealing : public SteppingSolver<Model_T>
       // Original method (variable population within +-5% of target)
       // Compute the partition function ratio Q(βk, βk−1) * population_.size();
       double Q = total_weight;
-      uint64_t current_population = population_.size();
       double RRQ = static_cast<double>(target_population_) / Q;
-      for (size_t i = 0; i < population_.size(); i++)
-      {
-        auto& citizen = population_[i];
+      for_each_citizen([&](size_t i, ::utils::RandomGenerator& rng) {
         // Resample: make N[(Rβk−1 /R˜ βk)τj (βk, βk−1)] copies of replica j
         // {N(a) is a Poisson random variate with mean a}
         // taking into account Poisson is not defined at 0.
-        size_t new_count =
-            (RRQ * weight[i]) > 0.0
-                ? (size_t)floor(this->rng_->poisson(RRQ * weight[i]))
-                : size_t(0);
-        if (new_count == 0)
-        {
-          current_population -= citizen.get_count();
-          citizen.kill();
-        }
-        else if (new_count > 1)
-        {
-          current_population += new_count - 1;
-          citizen.spawn(new_count - 1);
-        }
+        size_t new_count = (RRQ * weight[i]) > 0.0
+                               ? (size_t)floor(rng.poisson(RRQ * weight[i]))
+                               : size_t(0);
+        population_[i].set_count(new_count);
+      });
+      size_t current_population = 0;
+      #pragma omp parallel for reduction(+ : current_population)
+      for (size_t i = 0; i < population_.size(); i++)
+      {
+        current_population += population_[i].get_count();
       }
       // Keep population alive feature
       if (current_population == 0)
@@ -776,10 +832,49 @@ class PopulationAnnealing : public SteppingSolver<Model_T>
         .default_value((size_t)1)
         .matches(GreaterThan<size_t>(0))
         .with_output();
+
+    this->param(params, "shards", shard_count_)
+        .description(
+            "number of sub-populations which are resampled independently "
+            "between global rebalances.")
+        .default_value((size_t)1)
+        .matches(GreaterThan<size_t>(0))
+        .with_output();
+    if (is_sharded())
+    {
+      this->param(params, "rebalance_interval", rebalance_interval_)
+          .description("number of steps between global rebalances of shards.")
+          .default_value((size_t)10)
+          .matches(GreaterThan<size_t>(0))
+          .with_output();
+      if (!is_linear_schedule() && !is_geometric_schedule())
+      {
+        throw utils::InitialConfigException(
+            "`shards` > 1 requires a `resampling_strategy` of "
+            "'linear_schedule' or 'geometric_schedule'.");
+      }
+      if (target_population_ < shard_count_)
+      {
+        THROW(utils::ValueException, "the population (", target_population_,
+              ") must be at least the number of shards (", shard_count_, ").");
+      }
+    }
+
+    observed_.epoch = this->get_handle("epoch");
+    observed_.cost = this->get_handle("cost");
+    observed_.population = this->get_handle("population");
+    observed_.sigma = this->get_handle("sigma");
+    observed_.tau = this->get_handle("tau");
+    observed_.zeta = this->get_handle("zeta");
+    observed_.delta_beta = this->get_handle("delta_beta");
+    observed_.families = this->get_handle("families");
+    observed_.family_size = this->get_handle("family_size");
+    observed_.rho_t = this->get_handle("rho_t");
   }
 
   void finalize() override
   {
+    if (is_sharded()) gather_shards();
     // adjust population and current lowest solution with scale factor before
     // persisting.
     this->populate_solutions(population_);
@@ -812,21 +907,420 @@ class PopulationAnnealing : public SteppingSolver<Model_T>
       population_[i].set_family(i);
     }
 
-    #pragma omp parallel for schedule(static, 1)
-    for (size_t i = 0; i < population_.size(); i++)
-    {
+    for_each_citizen([&](size_t i, ::utils::RandomGenerator& rng) {
       if (i >= index_start)
       {
-        size_t thread_id = static_cast<size_t>(omp_get_thread_num());
-        population_[i]->set_rng(rngs_[thread_id].get());
+        population_[i]->set_rng(&rng);
         population_[i]->init();
       }
-    }
+    });
 
     current_culling_fraction_ = initial_culling_fraction_;
     this->update_lowest_cost(population_[0]->cost(), population_[0]->state());
   }
 
+  /////////////////////////////////////////////////////////////////////////////
+  /// A sub-population in sharded mode.
+  ///
+  /// Each shard is processed by a single thread at a time (and allocated by
+  /// the thread which processes it, such that its citizens reside on that
+  /// thread's memory node).
+  struct Shard
+  {
+    Population<::markov::Metropolis<Model_T>> population;
+    std::unique_ptr<::utils::RandomGenerator> rng;
+    // Logarithm of the (unnormalized) statistical weight represented by this
+    // shard since the last rebalance (in units where each citizen had a
+    // weight of 1 at that point).
+    double log_weight;
+    std::vector<double> costs;
+    std::vector<double> weights;
+    std::vector<size_t> selections;
+  };
+
+  bool is_sharded() const { return shard_count_ > 1; }
+
+  /// Size of shard `s` after a rebalance.
+  size_t shard_target_size(size_t s) const
+  {
+    return target_population_ / shard_count_ +
+           (s < target_population_ % shard_count_ ? 1 : 0);
+  }
+
+  /// (Re-)initialize all shards with random states.
+  void init_shards()
+  {
+    if (shards_.size() != shard_count_)
+    {
+      shards_.clear();
+      for (size_t s = 0; s < shard_count_; s++)
+      {
+        shards_.emplace_back(new Shard());
+        shards_[s]->rng = this->rng_->fork();
+      }
+    }
+    ::markov::Metropolis<Model_T> blueprint;
+    blueprint.set_beta(cur_beta_);
+    blueprint.set_model(this->model_);
+
+    // Offsets of the family ids (unique across shards).
+    std::vector<size_t> family_offsets(shard_count_);
+    for (size_t s = 1; s < shard_count_; s++)
+    {
+      family_offsets[s] = family_offsets[s - 1] + shard_target_size(s - 1);
+    }
+
+    #pragma omp parallel for schedule(static, 1)
+    for (size_t s = 0; s < shard_count_; s++)
+    {
+      Shard& shard = *shards_[s];
+      size_t size = shard_target_size(s);
+      shard.population.clear();
+      shard.population.reserve(size);
+      for (size_t i = 0; i < size; i++)
+      {
+        shard.population.insert(blueprint);
+        auto& citizen = shard.population[i];
+        citizen.set_family(family_offsets[s] + i);
+        citizen->set_rng(shard.rng.get());
+        citizen->init();
+      }
+      shard.log_weight = std::log(static_cast<double>(size));
+    }
+    this->update_lowest_cost(shards_[0]->population[0]->cost(),
+                             shards_[0]->population[0]->state());
+  }
+
+  /////////////////////////////////////////////////////////////////////////////
+  /// Step in sharded mode: Shards are swept and resampled independently; a
+  /// global rebalance happens every `rebalance_interval` steps.
+  void make_sharded_step(uint64_t step)
+  {
+    utils::enable_overflow_divbyzero_exceptions();
+
+    assert(restart_base_step_ <= step);
+    double delta_beta = beta_.get_value(step + 1 - restart_base_step_) -
+                        beta_.get_value(step - restart_base_step_);
+    double scale_factor = this->model_->get_scale_factor();
+    if (scale_factor <= 0)
+    {
+      THROW(utils::InconsistentValueException,
+            "scale factor must be >=0, found ", scale_factor);
+    }
+
+    double cost_sum = 0;
+    double cost_squared_sum = 0;
+    size_t population_size = 0;
+    #pragma omp parallel for schedule(static, 1) \
+        reduction(+ : cost_sum, cost_squared_sum, population_size)
+    for (size_t s = 0; s < shards_.size(); s++)
+    {
+      Shard& shard = *shards_[s];
+      sweep_shard(shard);
+      for (double cost : shard.costs)
+      {
+        cost_sum += cost;
+        cost_squared_sum += cost * cost;
+      }
+      population_size += shard.costs.size();
+      if (delta_beta > 0)
+      {
+        resample_shard(shard, delta_beta * scale_factor);
+      }
+      for (size_t i = 0; i < shard.population.size(); i++)
+      {
+        shard.population[i]->set_beta(cur_beta_ + delta_beta);
+      }
+    }
+    cur_beta_ += delta_beta;
+
+    double Rd = static_cast<double>(population_size);
+    double avg = cost_sum / Rd;
+    this->observe(observed_.cost, avg);
+    this->observe(observed_.population, Rd);
+    if (delta_beta > 0) this->observe(observed_.delta_beta, delta_beta);
+
+    if ((step + 1 - restart_base_step_) % rebalance_interval_ == 0)
+    {
+      {
+        utils::ScopedPhase phase("resample");
+        rebalance_shards();
+      }
+
+      // Restart conditions (see make_step), checked at rebalances only.
+      std::map<size_t, size_t> families;
+      for (const auto& shard : shards_)
+      {
+        for (const auto& id_and_size : shard->population.get_families())
+        {
+          families[id_and_size.first] += id_and_size.second;
+        }
+      }
+      double rho_t = 0;
+      for (const auto& id_and_size : families)
+      {
+        double family_size = static_cast<double>(id_and_size.second);
+        rho_t += family_size * family_size;
+      }
+      rho_t /= Rd;
+      this->observe(observed_.families, static_cast<double>(families.size()));
+      this->observe(observed_.rho_t, rho_t);
+      double variance = cost_squared_sum / Rd - avg * avg;
+      if (Rd / rho_t < alpha_ || variance <= 0)
+      {
+        cur_beta_ = beta_start_;
+        restart_base_step_ = step;
+        if (utils::feature_enabled(utils::FEATURE_PA_EXP_REPOPULATION))
+        {
+          target_population_ *= 2;
+          LOG(INFO, "restarting; increased population -> ", target_population_);
+        }
+        init_shards();
+        observe::Observer::restart(step);
+        epoch_++;
+      }
+    }
+
+    utils::disable_overflow_divbyzero_exceptions();
+  }
+
+  /// Sweep all citizens of a shard, record their costs and report the lowest
+  /// cost found within the shard.
+  void sweep_shard(Shard& shard)
+  {
+    auto& population = shard.population;
+    shard.costs.resize(population.size());
+    size_t lowest = 0;
+    EvaluationCounter evaluation_counter;
+    for (size_t i = 0; i < population.size(); i++)
+    {
+      auto& citizen = population[i];
+      // Migrated citizens may still point to the generator of another shard.
+      citizen->set_rng(shard.rng.get());
+      if ((!this->time_limit_.has_value()) ||
+          (utils::get_wall_time() - this->start_time_) <
+              this->time_limit_.value())
+      {
+        citizen->make_sweeps(sweeps_per_replica_);
+      }
+      shard.costs[i] = citizen->cost();
+      evaluation_counter += citizen->get_evaluation_counter();
+      citizen->reset_evaluation_counter();
+      if (citizen->get_lowest_cost() < population[lowest]->get_lowest_cost())
+      {
+        lowest = i;
+      }
+    }
+    #pragma omp critical
+    {
+      this->update_lowest_cost(population[lowest]->get_lowest_cost(),
+                               population[lowest]->get_lowest_state());
+      this->evaluation_counter_ += evaluation_counter;
+    }
+  }
+
+  /// Resample a shard to its current size using the local Boltzmann weights
+  /// (see `resample`) and account for the shard's partition function ratio
+  /// in its `log_weight`.
+  void resample_shard(Shard& shard, double scaled_delta_beta)
+  {
+    size_t R = shard.costs.size();
+    double min_cost = *std::min_element(shard.costs.begin(), shard.costs.end());
+    shard.weights.resize(R);
+    double total_weight = 0;
+    for (size_t i = 0; i < R; i++)
+    {
+      shard.weights[i] =
+          exp(-scaled_delta_beta * (shard.costs[i] - min_cost));
+      total_weight += shard.weights[i];
+    }
+    // sum_i exp(-delta_beta * cost_i) = exp(-delta_beta * min_cost) * total
+    shard.log_weight += std::log(total_weight / static_cast<double>(R)) -
+                        scaled_delta_beta * min_cost;
+
+    size_t resampled_size = 0;
+    for (size_t i = 0; i < R; i++)
+    {
+      double relative_weight =
+          static_cast<double>(R) * shard.weights[i] / total_weight;
+      size_t int_weight = (size_t)floor(relative_weight);
+      shard.weights[i] = relative_weight - static_cast<double>(int_weight);
+      shard.population[i].set_count(int_weight);
+      resampled_size += int_weight;
+    }
+    if (resampled_size < R)
+    {
+      ::utils::systematic_selection(shard.weights, R - resampled_size,
+                                    shard.rng->uniform(), shard.selections);
+      for (size_t i = 0; i < R; i++)
+      {
+        if (shard.selections[i] > 0)
+        {
+          shard.population[i].spawn(shard.selections[i]);
+        }
+      }
+    }
+    shard.population.resample();
+  }
+
+  /////////////////////////////////////////////////////////////////////////////
+  /// Resample all citizens according to the weights of their shards and
+  /// migrate citizens from shards with a surplus to those with a deficit.
+  ///
+  /// Citizens of a shard with weight W and R citizens each represent W / R,
+  /// and the expected number of copies after rebalancing is proportional to
+  /// this. Copies are kept in their own shard where possible.
+  void rebalance_shards()
+  {
+    size_t S = shards_.size();
+    double max_log_weight = -std::numeric_limits<double>::infinity();
+    for (const auto& shard : shards_)
+    {
+      max_log_weight = std::max(max_log_weight, shard->log_weight);
+    }
+    std::vector<double> citizen_weight(S);
+    std::vector<size_t> offsets(S + 1, 0);
+    double total_weight = 0;
+    for (size_t s = 0; s < S; s++)
+    {
+      size_t size = shards_[s]->population.size();
+      double weight = exp(shards_[s]->log_weight - max_log_weight);
+      citizen_weight[s] = size > 0 ? weight / static_cast<double>(size) : 0;
+      total_weight += weight;
+      offsets[s + 1] = offsets[s] + size;
+    }
+
+    // Global residual resampling to `target_population_` citizens.
+    std::vector<double> residual_weights(offsets[S]);
+    size_t resampled_size = 0;
+    #pragma omp parallel for schedule(static, 1) reduction(+ : resampled_size)
+    for (size_t s = 0; s < S; s++)
+    {
+      auto& population = shards_[s]->population;
+      double relative_weight = static_cast<double>(target_population_) *
+                               citizen_weight[s] / total_weight;
+      size_t int_weight = (size_t)floor(relative_weight);
+      for (size_t i = 0; i < population.size(); i++)
+      {
+        population[i].set_count(int_weight);
+        residual_weights[offsets[s] + i] =
+            relative_weight - static_cast<double>(int_weight);
+      }
+      resampled_size += int_weight * population.size();
+    }
+    if (resampled_size < target_population_)
+    {
+      std::vector<size_t> selections;
+      ::utils::systematic_selection(residual_weights,
+                                    target_population_ - resampled_size,
+                                    this->rng_->uniform(), selections);
+      for (size_t s = 0; s < S; s++)
+      {
+        auto& population = shards_[s]->population;
+        for (size_t i = 0; i < population.size(); i++)
+        {
+          size_t selected = selections[offsets[s] + i];
+          if (selected > 0) population[i].spawn(selected);
+        }
+      }
+    }
+
+    // Find surplus copies (taken from the back of each shard) and assign
+    // them to the shards with a deficit.
+    struct Migration
+    {
+      size_t shard, position, count;
+    };
+    std::vector<Migration> surplus;
+    std::vector<size_t> deficit(S, 0);
+    for (size_t s = 0; s < S; s++)
+    {
+      auto& population = shards_[s]->population;
+      size_t count = 0;
+      for (size_t i = 0; i < population.size(); i++)
+      {
+        count += population[i].get_count();
+      }
+      size_t target = shard_target_size(s);
+      if (count < target)
+      {
+        deficit[s] = target - count;
+        continue;
+      }
+      for (size_t i = population.size(); i > 0 && count > target; i--)
+      {
+        auto& citizen = population[i - 1];
+        size_t moved = std::min(citizen.get_count(), count - target);
+        if (moved == 0) continue;
+        citizen.set_count(citizen.get_count() - moved);
+        surplus.push_back({s, i - 1, moved});
+        count -= moved;
+      }
+    }
+    std::vector<std::vector<Migration>> imports(S);
+    size_t next = 0;
+    for (size_t s = 0; s < S; s++)
+    {
+      while (deficit[s] > 0)
+      {
+        assert(next < surplus.size());
+        Migration& migration = surplus[next];
+        size_t moved = std::min(migration.count, deficit[s]);
+        imports[s].push_back({migration.shard, migration.position, moved});
+        migration.count -= moved;
+        deficit[s] -= moved;
+        if (migration.count == 0) next++;
+      }
+    }
+
+    // Copy the migrants into their new shard (by the thread owning it), then
+    // apply the counts. Sources are only resampled once all copies are made.
+    #pragma omp parallel for schedule(static, 1)
+    for (size_t s = 0; s < S; s++)
+    {
+      auto& population = shards_[s]->population;
+      for (const auto& migration : imports[s])
+      {
+        const auto& source =
+            shards_[migration.shard]->population[migration.position];
+        for (size_t k = 0; k < migration.count; k++)
+        {
+          population.insert(source.content());
+          population[population.size() - 1].set_family(source.get_family());
+        }
+      }
+    }
+    #pragma omp parallel for schedule(static, 1)
+    for (size_t s = 0; s < S; s++)
+    {
+      auto& shard = *shards_[s];
+      shard.population.resample();
+      // All citizens have equal weight again.
+      shard.log_weight = std::log(static_cast<double>(shard.population.size()));
+    }
+  }
+
+  /// Collect the citizens of all shards into `population_` (for rendering
+  /// solutions).
+  void gather_shards()
+  {
+    if (shards_.empty()) return;
+    size_t size = 0;
+    for (const auto& shard : shards_) size += shard->population.size();
+    population_.clear();
+    population_.reserve(size);
+    for (const auto& shard : shards_)
+    {
+      for (size_t i = 0; i < shard->population.size(); i++)
+      {
+        const auto& citizen = shard->population[i];
+        population_.insert(citizen.content());
+        population_[population_.size() - 1].set_family(citizen.get_family());
+      }
+    }
+    shards_.clear();
+  }
+
   bool is_linear_schedule() const
   {
     return this->resampling_strategy_ == "linear_schedule";
@@ -863,18 +1357,32 @@ class PopulationAnnealing : public SteppingSolver<Model_T>
   double friction_tensor_constant_;
   double initial_culling_fraction_;
   double constant_culling_fraction_;
+  size_t shard_count_;
+  size_t rebalance_interval_;
+  std::vector<std::unique_ptr<Shard>> shards_;
 
  private:
   std::vector<double> costs_before_;
   std::vector<double> costs_after_;
   double current_culling_fraction_;
 
+  // Number of citizens sharing a random number generator.
+  static constexpr size_t kCitizensPerChunk = 64;
+  // Random number generator of each chunk of citizens.
   std::vector<std::unique_ptr<::utils::RandomGenerator>> rngs_;
 
   double cur_beta_;
   size_t epoch_;
 
   uint64_t restart_base_step_;
+
+  // Observables recorded in each step (resolved in `configure()`).
+  struct Observed
+  {
+    ::observe::Observer::Handle epoch, cost, population, sigma, tau, zeta,
+        delta_beta, families, family_size, rho_t;
+  };
+  Observed observed_;
 };
 REGISTER_SOLVER(PopulationAnnealing);
 
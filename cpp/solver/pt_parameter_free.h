@@ -136,6 +136,16 @@ class PTParameterFree : public ParallelTempering<Model_T>,
     this->reset(left_over_time);
   }
 
+  bool resume_parameters(const std::vector<double>& parameters,
+                         double left_over_time) override
+  {
+    size_t sweeps = std::lround(parameters[0]);
+    this->step_limit_ = std::max(sweeps, (size_t)(2));
+    this->set_output_parameter("sweeps", this->step_limit_);
+    this->resume(left_over_time);
+    return true;
+  }
+
   double estimate_execution_cost() const override
   {
     size_t thread_count = this->get_thread_count();
@@ -143,6 +143,20 @@ class SAParameterFree : public SimulatedAnnealing<Model_T>,
     this->reset(left_over_time);
   }
 
+  bool resume_parameters(const std::vector<double>& parameters,
+                         double left_over_time) override
+  {
+    int sweeps = std::lround(parameters[0]);
+    this->step_limit_ = std::max(sweeps, 2);
+    // The schedule is kept (rather than stretched over the larger budget,
+    // which would reheat the replicas): steps past its stop continue at the
+    // final beta reached by the previous run.
+    this->set_output_parameter("sweeps", this->step_limit_);
+
+    this->resume(left_over_time);
+    return true;
+  }
+
   double estimate_execution_cost() const override
   {
     size_t thread_count = this->get_thread_count();
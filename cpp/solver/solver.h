@@ -7,15 +7,18 @@
 #include <set>
 #include <sstream>
 
+#include "utils/binary_solution.h"
 #include "utils/component.h"
 #include "utils/config.h"
 #include "utils/exception.h"
 #include "utils/log.h"
 #include "utils/optional.h"
 #include "utils/random_generator.h"
+#include "utils/structure_writer.h"
 #include "utils/qio_signal.h"
 #include "utils/timing.h"
 #include "matcher/matchers.h"
+#include "observe/cost_trace.h"
 #include "observe/observable.h"
 #include "observe/observer.h"
 #include "omp.h"
@@ -31,7 +34,12 @@ class Solver : public ::observe::Observer
 {
  public:
   /// Intanstiate an uninitialized Solver
-  Solver() : thread_count_(1), cost_milestones_("step", "cost") {}
+  Solver()
+      : thread_count_(1),
+        cost_milestones_("step", "cost"),
+        defer_configurations_(false)
+  {
+  }
   virtual ~Solver() {}
 
   /// Get the identifier of this solver.
@@ -48,6 +56,35 @@ class Solver : public ::observe::Observer
 
   /// Get the structured result description.
   virtual utils::Structure get_solutions() const = 0;
+
+  /// Let `get_solutions()` leave configurations as
+  /// `utils::StructureWriter::deferred()` placeholders (for solvers which
+  /// support it), to be written with `write_configuration()`.
+  void set_defer_configurations(bool value) { defer_configurations_ = value; }
+
+  /// Write the configuration of a deferred placeholder with `writer`.
+  virtual void write_configuration(size_t index,
+                                   utils::StructureWriter&) const
+  {
+    THROW(utils::NotImplementedException, get_identifier(),
+          " does not support writing deferred configuration ", index, ".");
+  }
+
+  /// Describe the variables of the model for binary solution output (see
+  /// `Model::get_binary_variables`); returns false if not supported.
+  virtual bool get_binary_variables(std::vector<int>&,
+                                    utils::SolutionEncoding&) const
+  {
+    return false;
+  }
+
+  /// Get the variable values of the configuration of a deferred placeholder
+  /// for binary solution output.
+  virtual void get_binary_values(size_t index, std::vector<int>&) const
+  {
+    THROW(utils::NotImplementedException, get_identifier(),
+          " does not support binary output of configuration ", index, ".");
+  }
   virtual utils::Structure get_model_properties() const
   {
     utils::Structure s;
@@ -138,6 +175,8 @@ class Solver : public ::observe::Observer
       }
     }
 
+    s["cost_trace"] = cost_trace_.render();
+
     s.set_extension("counters", evaluation_counter_);
     s.set_extension("solver", get_solver_properties());
     s.set_extension("model", model_properties);
@@ -235,6 +274,9 @@ class Solver : public ::observe::Observer
 
   void set_time_limit(double value) { time_limit_ = value; }
 
+  /// The current step (for solvers which proceed in steps).
+  virtual uint64_t get_current_step() const { return 0; }
+
  protected:
   /// Return the maximum number of threads this solver can use.
   ///
@@ -249,6 +291,9 @@ class Solver : public ::observe::Observer
   EvaluationCounter evaluation_counter_;
   int thread_count_;
   ::observe::Milestone cost_milestones_;
+  // Time-to-target trace (recorded when the lowest cost improves).
+  ::observe::CostTrace cost_trace_;
+  bool defer_configurations_;
 };
 
 }  // namespace solver
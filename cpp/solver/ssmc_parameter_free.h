@@ -229,6 +229,20 @@ class SSMCParameterFree : public SubstochasticMonteCarlo<Model_T>,
     parameters[0] = parameters[0] * 1.5;
   }
 
+  bool resume_parameters(const std::vector<double>& parameters,
+                         double left_over_time) override
+  {
+    this->step_limit_ =
+        std::max((uint64_t)std::floor(parameters[0]), (uint64_t)2);
+    // The schedules are kept (rather than stretched over the larger budget,
+    // which would reheat the population): steps past their stop continue at
+    // the final alpha and beta reached by the previous run.
+    this->set_output_parameter("step_limit", this->step_limit_);
+
+    this->resume(left_over_time);
+    return true;
+  }
+
   double estimate_execution_cost() const override
   {
     size_t thread_count = this->get_thread_count();
@@ -9,6 +9,7 @@
 
 #include "utils/component.h"
 #include "utils/config.h"
+#include "utils/instrumentation.h"
 #include "utils/log.h"
 #include "utils/optional.h"
 #include "utils/random_generator.h"
@@ -36,7 +37,10 @@ class SteppingSolver : public ModelSolver<Model_T>
  public:
   using Base_T = ModelSolver<Model_T>;
 
-  SteppingSolver() : step_(0), steps_accum_(0), seconds_accum_(0) {}
+  SteppingSolver()
+      : step_(0), steps_accum_(0), seconds_accum_(0), resumed_steps_(0)
+  {
+  }
   ~SteppingSolver() override {}
 
   /// Read the maximum number of steps from configuration.
@@ -78,8 +82,11 @@ class SteppingSolver : public ModelSolver<Model_T>
 
     rng_.reset(new utils::PCG(seed_));
     update_steps_per_tick_ = true;
+    step_observable_ = this->get_handle("step");
   }
 
+  uint64_t get_current_step() const override { return step_; }
+
   // Initialization must be implemented by derived classes.
   virtual void init() override = 0;
 
@@ -118,17 +125,20 @@ class SteppingSolver : public ModelSolver<Model_T>
     }
     using utils::get_wall_time;
     start_time_ = get_wall_time();
+    this->cost_trace_.start(start_time_);
 
     double time_before = get_wall_time(), time_after = time_before, time_diff;
     uint64_t next_steps_per_tick = steps_per_tick_;
     while (true)
     {
       // Perform (and time) the current number of steps scheduled per tick
+      // (recorded as one batch of the "steps" phase).
+      utils::ScopedPhase steps_phase("steps");
       for (uint64_t s = 0; s < next_steps_per_tick; s++)
       {
         {
           auto step_label = this->scoped_observable_label("step", step_);
-          this->observe("step", static_cast<double>(step_));
+          this->observe(step_observable_, static_cast<double>(step_));
           make_step(step_);
         }
         step_++;
@@ -138,7 +148,8 @@ class SteppingSolver : public ModelSolver<Model_T>
         {
 #if defined(qiotoolkit_PROFILING) || defined(_DEBUG)
           // ONLY logging this information in profiling build, because this may
-          // produce a lot of message on Qiotoolkit's log
+          // produce a lot of message on Qiotoolkit's log (release builds
+          // record the `cost_trace` in `update_lowest_cost()` instead).
           // NOTE: if the solver does not call `update_lowest_cost()` to avoid
           // copying the lowest state, then no milestones will be recorded.
           // and benchmarking time-to-solution WILL NOT WORK.
@@ -301,7 +312,7 @@ class SteppingSolver : public ModelSolver<Model_T>
 
   void update_accumulated_info()
   {
-    uint64_t steps = current_steps();
+    uint64_t steps = current_steps() - resumed_steps_;
     steps_accum_ += steps;
     double end_time = utils::get_wall_time();
     seconds_accum_ += (end_time - this->start_time_);
@@ -326,6 +337,19 @@ class SteppingSolver : public ModelSolver<Model_T>
     this->lowest_costs_.clear();
     this->lowest_states_.clear();
     this->lowest_cost_.reset();
+    resumed_steps_ = 0;
+  }
+
+  // Continue the last run from its current step and states (keeping its
+  // lowest cost) when `run()` is called again without `init()`.
+  void resume(double left_over_time)
+  {
+    LOG(INFO, "resume at step:", this->step_,
+        ", steps:", this->step_limit_.value());
+    this->time_limit_ = left_over_time;
+    this->lowest_costs_.clear();
+    this->lowest_states_.clear();
+    resumed_steps_ = current_steps();
   }
 
   bool handle_signals()
@@ -369,12 +393,15 @@ class SteppingSolver : public ModelSolver<Model_T>
   uint64_t step_;
   uint64_t steps_accum_;
   double seconds_accum_;
+  // steps (as in `current_steps()`) taken before the run was resumed
+  uint64_t resumed_steps_;
 
  private:
   std::string exit_reason = "";
   double tick_every_;
   uint64_t steps_per_tick_;
   bool update_steps_per_tick_;
+  ::observe::Observer::Handle step_observable_;
 };
 
 }  // namespace solver
@@ -112,15 +112,47 @@ class SubstochasticMonteCarlo : public SteppingSolver<Model_T>
 
   void update_population_statistics()
   {
-    max_cost_ = min_cost_ = population_[0]->cost();
-    for (size_t i = 0; i < population_.size(); i++)
+    double min_cost = population_[0]->cost();
+    double max_cost = min_cost;
+    // Index of the citizen with the lowest cost seen so far (only this one
+    // needs to be passed to update_lowest_cost).
+    size_t lowest = 0;
+    #pragma omp parallel
     {
-      const auto& citizen = population_[i];
-      min_cost_ = std::min(min_cost_, double(citizen->cost()));
-      max_cost_ = std::max(max_cost_, double(citizen->cost()));
-      this->update_lowest_cost(citizen->get_lowest_cost(),
-                               citizen->get_lowest_state());
+      // reduction min or max is not implemented yet in all compilers
+      double min_cost_local = min_cost;
+      double max_cost_local = max_cost;
+      size_t lowest_local = 0;
+      #pragma omp for nowait
+      for (size_t i = 0; i < population_.size(); i++)
+      {
+        const auto& citizen = population_[i];
+        min_cost_local = std::min(min_cost_local, double(citizen->cost()));
+        max_cost_local = std::max(max_cost_local, double(citizen->cost()));
+        if (citizen->get_lowest_cost() <
+            population_[lowest_local]->get_lowest_cost())
+        {
+          lowest_local = i;
+        }
+      }
+      #pragma omp critical
+      {
+        min_cost = std::min(min_cost, min_cost_local);
+        max_cost = std::max(max_cost, max_cost_local);
+        // Ties are resolved towards the first citizen (as in a serial loop).
+        auto lowest_cost = population_[lowest]->get_lowest_cost();
+        auto lowest_cost_local = population_[lowest_local]->get_lowest_cost();
+        if (lowest_cost_local < lowest_cost ||
+            (lowest_cost_local == lowest_cost && lowest_local < lowest))
+        {
+          lowest = lowest_local;
+        }
+      }
     }
+    min_cost_ = min_cost;
+    max_cost_ = max_cost;
+    this->update_lowest_cost(population_[lowest]->get_lowest_cost(),
+                             population_[lowest]->get_lowest_state());
   }
 
   void resample_population(double beta)
@@ -130,8 +162,10 @@ class SubstochasticMonteCarlo : public SteppingSolver<Model_T>
     if (cost_range > 0)
     {
       double total_weight = 0;
-      std::vector<double> weight(population_.size());
-      for (size_t i = 0; i < population_.size(); i++)
+      size_t n = population_.size();
+      std::vector<double> weight(n);
+      #pragma omp parallel for reduction(+ : total_weight)
+      for (size_t i = 0; i < n; i++)
       {
         const auto& citizen = population_[i];
         weight[i] = exp(beta * (max_cost_ - citizen->cost()) / cost_range);
@@ -139,25 +173,30 @@ class SubstochasticMonteCarlo : public SteppingSolver<Model_T>
       }
 
       size_t resampled_size = 0;
-      ::utils::RandomSelector selector;
-      for (size_t i = 0; i < population_.size(); i++)
+      #pragma omp parallel for reduction(+ : resampled_size)
+      for (size_t i = 0; i < n; i++)
       {
         auto& citizen = population_[i];
         double relative_weight =
             static_cast<double>(target_population_) * weight[i] / total_weight;
         size_t int_weight = (size_t)floor(relative_weight);
-        double residual_weight =
-            relative_weight - static_cast<double>(int_weight);
+        // The weights are re-used for the residuals.
+        weight[i] = relative_weight - static_cast<double>(int_weight);
         citizen.set_count(int_weight);
         resampled_size += int_weight;
-        selector.insert(i, residual_weight);
       }
       assert(resampled_size <= target_population_);
-      while (resampled_size < population_.size())
+      if (resampled_size < n)
       {
-        size_t citizen_id = selector.select_and_remove(this->rng_->uniform());
-        population_[citizen_id].spawn(1);
-        resampled_size++;
+        // Fill up with systematic selection over the residual weights.
+        std::vector<size_t> selections;
+        ::utils::systematic_selection(weight, n - resampled_size,
+                                      this->rng_->uniform(), selections);
+        #pragma omp parallel for
+        for (size_t i = 0; i < n; i++)
+        {
+          if (selections[i] > 0) population_[i].spawn(selections[i]);
+        }
       }
       population_.resample();
     }
@@ -75,6 +75,16 @@ class TabuParameterFree : public Tabu<Model_T>,
     this->reset(left_over_time);
   }
 
+  bool resume_parameters(const std::vector<double>& parameters,
+                         double left_over_time) override
+  {
+    int sweeps = std::lround(parameters[0]);
+    this->step_limit_ = std::max(sweeps, 2);
+    this->set_output_parameter("sweeps", this->step_limit_);
+    this->resume(left_over_time);
+    return true;
+  }
+
   double estimate_execution_cost() const override
   {
     size_t thread_count = this->get_thread_count();
@@ -0,0 +1,92 @@
+#include "solver/murex.h"
+
+#include <omp.h>
+
+#include <string>
+
+#include "utils/json.h"
+#include "utils/stream_handler_json.h"
+#include "utils/structure.h"
+#include "gtest/gtest.h"
+#include "model/poly.h"
+
+using ::model::Poly;
+using ::solver::Murex;
+
+namespace
+{
+const char kPolyInput[] = R"({
+  "cost_function": {
+    "type": "poly",
+    "version": "0.1",
+    "terms": [
+      {
+        "parameter": "x",
+        "constant": 1,
+        "terms": [
+          {"constant": -2, "ids": [0, 1]},
+          {"constant": -1, "ids": [1, 2]},
+          {"constant": 1, "ids": [2, 3]},
+          {"constant": -1, "ids": [3, 4]},
+          {"constant": 2, "ids": [4, 5]},
+          {"constant": -1, "ids": [5, 0]}
+        ],
+        "exponent": 2
+      },
+      {
+        "parameter": "y",
+        "constant": 1,
+        "terms": [
+          {"constant": 1, "ids": [0, 2]},
+          {"constant": -2, "ids": [1, 3]},
+          {"constant": -1, "ids": [2, 4]},
+          {"constant": 1, "ids": [3, 5]},
+          {"constant": -1, "ids": [4, 0]}
+        ],
+        "exponent": 2
+      }
+    ]
+  }
+})";
+
+// Run murex on `kPolyInput` with `threads` threads.
+utils::Structure run_murex(int threads)
+{
+  Poly poly;
+  utils::configure_with_configuration_from_json_string(kPolyInput, poly);
+  poly.init();
+  Murex<Poly> murex;
+  murex.set_model(&poly);
+  murex.configure(utils::json_from_string(
+      R"({"params": {"seed": 7, "step_limit": 200, )"
+      R"("temperature_set": [0.5, 1, 2, 4, 8], "threads": )" +
+      std::to_string(threads) + "}}"));
+  murex.init();
+  murex.run();
+  murex.finalize();
+  return murex.get_result()["solutions"];
+}
+}  // namespace
+
+TEST(Murex, FindsParetoFront)
+{
+  utils::Structure solutions = run_murex(1);
+  // One solution per node on the last (coldest) diagonal.
+  ASSERT_EQ(solutions.get_array_size(), 5u);
+  for (size_t i = 0; i < solutions.get_array_size(); i++)
+  {
+    EXPECT_GT(solutions[i]["states"].get_array_size(), 0u);
+  }
+}
+
+TEST(Murex, IndependentOfThreadCount)
+{
+  // Each node draws from its own random number generator, such that a fixed
+  // seed gives the same result with any number of threads.
+  int max_threads = omp_get_max_threads();
+  omp_set_num_threads(4);
+  std::string parallel = run_murex(4).to_string();
+  std::string sequential = run_murex(1).to_string();
+  omp_set_num_threads(max_threads);
+  EXPECT_EQ(sequential, parallel);
+}
@@ -136,6 +136,17 @@ TEST_F(ParallelTemperingTest, SimulatesToyModelWithLinearTemperatureSet)
 
   auto solver = result["benchmark"].get_extension("solver");
   EXPECT_EQ(solver["last_step"].get<uint64_t>(), 200);
+
+  // The time-to-target trace is recorded in all builds.
+  const auto& events = result["benchmark"]["cost_trace"]["events"];
+  ASSERT_GT(events.get_array_size(), 1u);
+  for (size_t i = 1; i < events.get_array_size(); i++)
+  {
+    EXPECT_LT(events[i]["cost"].get<double>(),
+              events[i - 1]["cost"].get<double>());
+    EXPECT_GE(events[i]["step"].get<uint64_t>(),
+              events[i - 1]["step"].get<uint64_t>());
+  }
   // NOTE: The following tests depend on internal implementation details and
   // are prone to change (their purpose is to highlight the output format).
   std::cout << solver["cost_milestones"].to_string() << std::endl;
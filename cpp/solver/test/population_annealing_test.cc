@@ -1,6 +1,8 @@
 
 #include "solver/population_annealing.h"
 
+#include <omp.h>
+
 #include <cmath>
 #include <set>
 #include <sstream>
@@ -210,6 +212,56 @@ TEST_F(PopulationAnnealingTest, GeometricScheduleDecreasing)
   EXPECT_THROW(configure(params_data), utils::ValueException);
 }
 
+TEST_F(PopulationAnnealingTest, SimulatesToyModelWithShards)
+{
+  auto result = run(R"({
+    "params": {
+      "seed": 42,
+      "step_limit": 200,
+      "population": 64,
+      "threads": 1,
+      "shards": 4,
+      "rebalance_interval": 5,
+      "number_of_solutions": 2
+    }
+  })");
+  EXPECT_LT(result["solutions"]["cost"].get<double>(), 1e-5);
+  EXPECT_LT(std::abs(result["solutions"]["configuration"].get<double>() -
+                     TestModel::kInitValue),
+            1e-5);
+  EXPECT_EQ(result["solutions"]["solutions"].get_array_size(), 2);
+  EXPECT_EQ(result["solutions"]["parameters"]["shards"].get<size_t>(), 4);
+}
+
+TEST_F(PopulationAnnealingTest, ShardsRequireSchedule)
+{
+  auto params_data = R"({
+    "params": {
+      "seed": 42,
+      "step_limit": 100,
+      "population": 64,
+      "threads": 1,
+      "shards": 4,
+      "resampling_strategy": "friction_tensor"
+    }
+  })";
+  EXPECT_THROW(configure(params_data), utils::InitialConfigException);
+}
+
+TEST_F(PopulationAnnealingTest, ShardsExceedPopulation)
+{
+  auto params_data = R"({
+    "params": {
+      "seed": 42,
+      "step_limit": 100,
+      "population": 2,
+      "threads": 1,
+      "shards": 4
+    }
+  })";
+  EXPECT_THROW(configure(params_data), utils::ValueException);
+}
+
 TEST_F(PopulationAnnealingTest, PopulationIsZero)
 {
   auto params_data = R"({
@@ -240,6 +292,42 @@ TEST_F(PopulationAnnealingTest, SimulatesInvalidMultipleSolutionValue)
   EXPECT_THROW(configure(params_data), utils::ValueException);
 }
 
+TEST(PopulationAnnealing, IndependentOfThreadCount)
+{
+  // Each chunk of citizens draws from its own random number generator, such
+  // that a fixed seed gives the same result with any number of threads.
+  int max_threads = omp_get_max_threads();
+  std::string results[2];
+  int thread_counts[2] = {1, 4};
+  for (int k = 0; k < 2; k++)
+  {
+    omp_set_num_threads(thread_counts[k]);
+    reset_TestModel_consts();
+    TestModel toy;
+    utils::configure_with_configuration_from_json_string(R"({
+      "cost_function": {
+        "version": "1.0",
+        "type": "toy"
+      }
+    })", toy);
+    toy.init();
+    PopulationAnnealing<TestModel> pa;
+    pa.set_model(&toy);
+    pa.configure(utils::json_from_string(
+        R"({"params": {"seed": 42, "step_limit": 50, "population": 300, )"
+        R"("number_of_solutions": 4, "threads": )" +
+        std::to_string(thread_counts[k]) + "}}"));
+    pa.init();
+    pa.run();
+    pa.finalize();
+    utils::Structure solutions = pa.get_result()["solutions"];
+    results[k] = solutions["solutions"].to_string();
+    EXPECT_EQ(solutions["solutions"].get_array_size(), 4);
+  }
+  omp_set_num_threads(max_threads);
+  EXPECT_EQ(results[0], results[1]);
+}
+
 TEST(PopulationAnnealing, PuboModel)
 {
   std::string input_file(utils::data_path("cpupubojobstest.json"));
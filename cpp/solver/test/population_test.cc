@@ -237,3 +237,88 @@ TEST(Population, OfMetropolis)
   //
   Population<Metropolis<TestModel>> metropolis_population;
 }
+
+TEST(Population, ResampleKeepsSurvivorsInPlace)
+{
+  Population<std::string> population;
+  population.reserve(4);
+  population.insert("a");
+  population.insert("b");
+  population.insert("c");
+  population.insert("d");
+  const std::string* a = &population[0].content();
+  const std::string* b = &population[1].content();
+  const std::string* c = &population[2].content();
+  const std::string* d = &population[3].content();
+  population[0].set_count(1);
+  population[1].set_count(0);
+  population[2].set_count(2);
+  population[3].set_count(1);
+  population.resample();
+  ASSERT_EQ(population.size(), 4);
+  // Survivors are not copied, the offspring of "c" re-uses the slot of "b".
+  EXPECT_EQ(&population[0].content(), a);
+  EXPECT_EQ(&population[1].content(), b);
+  EXPECT_EQ(*population[1], "c");
+  EXPECT_EQ(&population[2].content(), c);
+  EXPECT_EQ(&population[3].content(), d);
+}
+
+TEST(Population, ResampleDropsVacantSlots)
+{
+  Population<std::string> population;
+  population.insert("a");
+  population.insert("b");
+  population[0].set_count(2);
+  population[1].set_count(0);
+  // Growing appends vacant slots, which do not survive resampling.
+  population.resize(4);
+  population.resample();
+  ASSERT_EQ(population.size(), 2);
+  EXPECT_EQ(*population[0], "a");
+  EXPECT_EQ(*population[1], "a");
+}
+
+TEST(Population, GrowsBeyondReservedSize)
+{
+  Population<std::string> population;
+  population.reserve(2);
+  population.insert("a");
+  population.insert("b");
+  const std::string* a = &population[0].content();
+  population[0].set_count(40);
+  population[1].set_count(1);
+  population.resample();
+  ASSERT_EQ(population.size(), 41);
+  EXPECT_EQ(&population[39].content(), a);
+  for (size_t i = 0; i < 40; i++) EXPECT_EQ(*population[i], "a");
+  EXPECT_EQ(*population[40], "b");
+  population.clear();
+  population.clear_cache_pool();
+  population.insert("c");
+  EXPECT_EQ(*population[0], "c");
+}
+
+TEST(Population, ResampleLargePopulation)
+{
+  // Large enough for the offsets to be computed by a parallel scan.
+  const size_t size = 20000;
+  Population<std::string> population;
+  population.reserve(size);
+  std::vector<std::string> expected;
+  for (size_t i = 0; i < size; i++)
+  {
+    std::string content = std::to_string(i);
+    population.insert(content);
+    size_t count = (i * 7) % 4;  // 0, 3, 2, 1, ...
+    population[i].set_count(count);
+    for (size_t k = 0; k < count; k++) expected.push_back(content);
+  }
+  population.resample();
+  ASSERT_EQ(population.size(), expected.size());
+  for (size_t i = 0; i < population.size(); i++)
+  {
+    EXPECT_EQ(*population[i], expected[i]);
+    EXPECT_EQ(population[i].get_count(), 1);
+  }
+}
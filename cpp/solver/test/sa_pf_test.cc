@@ -150,6 +150,39 @@ TEST(SAParameterFree, IsingGroupedModel)
   EXPECT_EQ(-1, result["solutions"]["configuration"]["3"].get<int>());
 }
 
+TEST(SAParameterFree, IsingModelBatch)
+{
+  std::string input_file(utils::data_path("ising1.json"));
+  std::string param_file(utils::data_path("pfbatch.json"));
+  ParameterFreeLinearSearchSolver<model::IsingTermCached,
+                      SAParameterFree<model::IsingTermCached>>
+      sa_pf;
+  model::IsingTermCached model;
+  auto result =
+      run_solver<ParameterFreeLinearSearchSolver<model::IsingTermCached,
+                                     SAParameterFree<model::IsingTermCached>>>(
+          sa_pf, model, input_file, param_file);
+  EXPECT_NEAR(-10, result["solutions"]["cost"].get<double>(), 0.000001);
+  // The samples after the initial ones are evaluated in batches.
+  auto training = sa_pf.get_solver_properties()["training"];
+  EXPECT_GT(training["batch_samples"].get<uint64_t>(), 0u);
+}
+
+TEST(SAParameterFree, IsingModelHalving)
+{
+  std::string input_file(utils::data_path("ising1.json"));
+  std::string param_file(utils::data_path("pfhalving.json"));
+  ParameterFreeLinearSearchSolver<model::IsingTermCached,
+                      SAParameterFree<model::IsingTermCached>>
+      pa_pf;
+  model::IsingTermCached model;
+  auto result =
+      run_solver<ParameterFreeLinearSearchSolver<model::IsingTermCached,
+                                     SAParameterFree<model::IsingTermCached>>>(
+          pa_pf, model, input_file, param_file);
+  EXPECT_NEAR(-10, result["solutions"]["cost"].get<double>(), 0.000001);
+}
+
 #ifndef _DEBUG
 TEST(SAParameterFree, HonoringTimeout)
 {
@@ -1,5 +1,6 @@
 
 #include <cmath>
+#include <cstdio>
 #include <sstream>
 #include <string>
 
@@ -78,6 +79,69 @@ TEST(SSMCParameterFree, IsingModel)
   EXPECT_DOUBLE_EQ(-10, result["solutions"]["cost"].get<double>());
 }
 
+TEST(SSMCParameterFree, IsingModelBatch)
+{
+  std::string input_file(utils::data_path("ising1.json"));
+  std::string param_file(utils::data_path("pfbatch.json"));
+  ParameterFreeSolver<model::IsingTermCached,
+                      SSMCParameterFree<model::IsingTermCached>>
+      ssmc_pf;
+  model::IsingTermCached model;
+  auto result = run_solver<ParameterFreeSolver<
+      model::IsingTermCached, SSMCParameterFree<model::IsingTermCached>>>(
+      ssmc_pf, model, input_file, param_file);
+  EXPECT_DOUBLE_EQ(-10, result["solutions"]["cost"].get<double>());
+}
+
+TEST(SSMCParameterFree, IsingModelHalving)
+{
+  std::string input_file(utils::data_path("ising1.json"));
+  std::string param_file(utils::data_path("pfhalving.json"));
+  ParameterFreeSolver<model::IsingTermCached,
+                      SSMCParameterFree<model::IsingTermCached>>
+      ssmc_pf;
+  model::IsingTermCached model;
+  auto result = run_solver<ParameterFreeSolver<
+      model::IsingTermCached, SSMCParameterFree<model::IsingTermCached>>>(
+      ssmc_pf, model, input_file, param_file);
+  EXPECT_DOUBLE_EQ(-10, result["solutions"]["cost"].get<double>());
+}
+
+TEST(SSMCParameterFree, IsingModelTuningCache)
+{
+  std::string input_file(utils::data_path("ising1.json"));
+  std::string param_file(utils::data_path("pftuningcache.json"));
+  const char kCacheFile[] = "ssmc_pf_test.tuning_cache";
+  std::remove(kCacheFile);
+  typedef ParameterFreeSolver<model::IsingTermCached,
+                              SSMCParameterFree<model::IsingTermCached>>
+      Solver;
+  {
+    // The first run tunes the parameters and caches them.
+    Solver ssmc_pf;
+    model::IsingTermCached model;
+    auto result = run_solver<Solver>(ssmc_pf, model, input_file, param_file);
+    EXPECT_DOUBLE_EQ(-10, result["solutions"]["cost"].get<double>());
+    auto training = ssmc_pf.get_solver_properties()["training"];
+    EXPECT_EQ(training["cached_parameters"].get<uint64_t>(), 0u);
+    EXPECT_FALSE(training["tuning_skipped"].get<bool>());
+  }
+  {
+    // The same problem is solved with the cached parameters.
+    Solver ssmc_pf;
+    model::IsingTermCached model;
+    auto result = run_solver<Solver>(ssmc_pf, model, input_file, param_file);
+    EXPECT_DOUBLE_EQ(-10, result["solutions"]["cost"].get<double>());
+    auto training = ssmc_pf.get_solver_properties()["training"];
+    EXPECT_EQ(training["cached_parameters"].get<uint64_t>(), 1u);
+    EXPECT_TRUE(training["tuning_skipped"].get<bool>());
+  }
+  strategy::TuningCache cache;
+  cache.load(kCacheFile);
+  EXPECT_EQ(cache.get_entries().size(), 1u);
+  std::remove(kCacheFile);
+}
+
 TEST(SSMCParameterFree, PuboEmptyMixedModel)
 {
   std::string input_file(utils::data_path("puboemptymixed.json"));
@@ -11,6 +11,24 @@
 
 namespace strategy
 {
+bool BaseOpt::recommend_parameter_batch(
+    size_t count, std::vector<std::vector<double>>& batch)
+{
+  batch.clear();
+  std::vector<double> parameters;
+  while (batch.size() < count && recommend_parameter_values(parameters))
+  {
+    batch.push_back(parameters);
+  }
+  return !batch.empty();
+}
+
+void BaseOpt::add_prior_sample(std::vector<double>& parameters,
+                               double objective)
+{
+  add_new_sample(parameters, objective);
+}
+
 void BaseOpt::get_perf_metrics(utils::Structure& perf) const
 {
   perf["model_training_ms"] = model_time_ms_;
@@ -20,9 +20,17 @@ class BaseOpt : public utils::Component
   // Return next set of good parameters found by optimization process
   virtual bool recommend_parameter_values(
       std::vector<double>& parameters_new) = 0;
+  // Return up to `count` sets of parameters to be evaluated concurrently
+  // (before any of their objectives are fed back); false if none was found.
+  virtual bool recommend_parameter_batch(
+      size_t count, std::vector<std::vector<double>>& batch);
   // Feedback a new set of parameters and objective value to learning process
   virtual void add_new_sample(std::vector<double>& parameters,
                               double objective) = 0;
+  // Feedback a set of parameters which was not recommended (e.g., taken from
+  // the tuning cache) and its objective value
+  virtual void add_prior_sample(std::vector<double>& parameters,
+                                double objective);
   // Retrieve the performance telemetry related with the optimization search
   void get_perf_metrics(utils::Structure& perf) const;
 #ifdef qiotoolkit_PROFILING
@@ -23,6 +23,19 @@ using namespace optimal_learning;
 
 namespace strategy
 {
+BayesianOpt::BayesianOpt()
+    : sample_cur_(0),
+      new_sample_index_(0),
+      reserved_samples_(64),
+      retrain_interval_(8),
+      samples_since_training_(0),
+      model_outdated_(false),
+      thread_count_(omp_get_max_threads())
+{
+}
+
+BayesianOpt::~BayesianOpt() {}
+
 void BayesianOpt::init(size_t dimensions, uint32_t seed,
                        const GDParameters& model_parameters,
                        const GDParameters& search_parameters,
@@ -50,6 +63,9 @@ void BayesianOpt::init(size_t dimensions, uint32_t seed,
 
   // This is highly model related, other model shall have different settings.
   trained_parameters_.resize(dimensions_ + 2, 1.0);
+  gp_model_.reset();
+  samples_since_training_ = 0;
+  model_outdated_ = false;
 }
 
 void BayesianOpt::init(size_t dimensions, uint32_t seed,
@@ -139,8 +155,11 @@ void BayesianOpt::add_new_sample(std::vector<double>& parameters,
     {
       sample_points_[i + dimensions_ * new_sample_index_] = parameters[i];
     }
+    // the model can no longer be extended by appending samples
+    model_outdated_ = true;
   }
   new_sample_index_ = (new_sample_index_ + 1) % reserved_samples_;
+  samples_since_training_++;
 
 #ifdef qiotoolkit_PROFILING
   update_objective_profile(objective, parameters);
@@ -199,6 +218,46 @@ std::unique_ptr<GaussianProcess> create_model(
   return result;
 }
 
+bool BayesianOpt::update_model(std::vector<int>& derivatives)
+{
+  const int num_sampled = (int)sample_objectives_.size();
+  if (gp_model_ != nullptr && !model_outdated_)
+  {
+    const int num_modeled = gp_model_->num_sampled();
+    if (num_modeled == num_sampled)
+    {
+      return true;
+    }
+    // With unchanged hyperparameters, the rows of the new samples are
+    // appended to the cholesky factor of the covariance (O(n^2) per sample
+    // instead of O(n^3) for a new model).
+    const int num_new = num_sampled - num_modeled;
+    std::vector<double> new_values(num_new * (derivatives.size() + 1), 0.0);
+    for (int i = 0; i < num_new; i++)
+    {
+      new_values[i * (derivatives.size() + 1)] =
+          sample_objectives_[num_modeled + i];
+    }
+    try
+    {
+      gp_model_->AddPointsToGP(
+          sample_points_.data() + (size_t)num_modeled * dimensions_,
+          new_values.data(), num_new);
+      return true;
+    }
+    catch (SingularMatrixException& e)
+    {
+      LOG(WARN, "A SingularMatrixException is thrown, rebuilding the model");
+    }
+  }
+  gp_model_ =
+      create_model(model_training_.tolerance_, trained_parameters_,
+                   (int)dimensions_, sample_points_, sample_objectives_,
+                   derivatives, rng_);
+  model_outdated_ = false;
+  return gp_model_ != nullptr;
+}
+
 bool BayesianOpt::recommend_parameter_values(
     std::vector<double>& parameters_new)
 {
@@ -241,54 +300,57 @@ bool BayesianOpt::recommend_parameter_values(
 
   DomainType domain(domain_bounds.data(), dim);
 
-  using LogLikelihoodEvaluator = LogMarginalLikelihoodEvaluator;
+  int max_num_threads = thread_count_;
+  ThreadSchedule thread_schedule(max_num_threads, omp_sched_dynamic);
+  bool found_flag = false;
+  if (gp_model_ == nullptr || samples_since_training_ >= retrain_interval_)
+  {
+    using LogLikelihoodEvaluator = LogMarginalLikelihoodEvaluator;
 
-  // log likelihood evaluator object
-  LogLikelihoodEvaluator log_marginal_eval(
-      sample_points_.data(), sample_objectives_.data(),
-      derivatives_parameters.data(),
-      static_cast<int>(derivatives_parameters.size()), dim, num_sampled);
+    // log likelihood evaluator object
+    LogLikelihoodEvaluator log_marginal_eval(
+        sample_points_.data(), sample_objectives_.data(),
+        derivatives_parameters.data(),
+        static_cast<int>(derivatives_parameters.size()), dim, num_sampled);
 
-  GradientDescentParameters model_gd_parameters(
-      model_training_.num_multistarts_, model_training_.max_num_steps_,
-      model_training_.max_num_restarts_, model_training_.num_steps_averaged_,
-      model_training_.gamma_, model_training_.pre_mult_,
-      model_training_.max_relative_change_, model_training_.tolerance_);
+    GradientDescentParameters model_gd_parameters(
+        model_training_.num_multistarts_, model_training_.max_num_steps_,
+        model_training_.max_num_restarts_, model_training_.num_steps_averaged_,
+        model_training_.gamma_, model_training_.pre_mult_,
+        model_training_.max_relative_change_, model_training_.tolerance_);
 
-  assert(dimensions_ + 1 ==
-         (size_t)covariance_original.GetNumberOfHyperparameters());
-  int max_num_threads = omp_get_max_threads();
-  ThreadSchedule thread_schedule(max_num_threads, omp_sched_dynamic);
-  std::vector<double> noise_variance_parameter(1, 0.01);
+    assert(dimensions_ + 1 ==
+           (size_t)covariance_original.GetNumberOfHyperparameters());
+    std::vector<double> noise_variance_parameter(1, 0.01);
 
-  for (size_t i = 0; i < noise_variance_parameter.size(); i++)
-  {
-    domain_bounds_log10.push_back(ClosedInterval{-6, -1});
-  }
+    for (size_t i = 0; i < noise_variance_parameter.size(); i++)
+    {
+      domain_bounds_log10.push_back(ClosedInterval{-6, -1});
+    }
 
-  // We assume there is no noise
-  assert(noise_variance_parameter.size() == 1);
-  bool found_flag = false;
-  bool model_found = false;
-  MultistartGradientDescentHyperparameterOptimization<LogLikelihoodEvaluator>(
-      log_marginal_eval, covariance_original, noise_variance_parameter,
-      model_gd_parameters,
-      domain_bounds_log10.data(),  // need to be changed for log10 and adjust
-                                   // for hyper parameters.
-      thread_schedule, &model_found, &uniform_generator,
-      trained_parameters_.data());
-  if (!model_found)
-  {
-    return found_flag;
-  }
+    // We assume there is no noise
+    assert(noise_variance_parameter.size() == 1);
+    bool model_found = false;
+    MultistartGradientDescentHyperparameterOptimization<LogLikelihoodEvaluator>(
+        log_marginal_eval, covariance_original, noise_variance_parameter,
+        model_gd_parameters,
+        domain_bounds_log10.data(),  // need to be changed for log10 and adjust
+                                     // for hyper parameters.
+        thread_schedule, &model_found, &uniform_generator,
+        trained_parameters_.data());
+    if (!model_found)
+    {
+      return found_flag;
+    }
 
 #if defined(_DEBUG) || defined(qiotoolkit_PROFILING)
-  log_hyper_parameters();
+    log_hyper_parameters();
 #endif
-  auto gp_model =
-      create_model(model_training_.tolerance_, trained_parameters_, dim,
-                   sample_points_, sample_objectives_, derivatives, rng_);
-  if (gp_model.get() == nullptr)
+    // the covariance changed with the hyperparameters
+    gp_model_.reset();
+    samples_since_training_ = 0;
+  }
+  if (!update_model(derivatives))
   {
     return found_flag;
   }
@@ -325,7 +387,7 @@ bool BayesianOpt::recommend_parameter_values(
 
   int num_lhc_samples = num_to_sample;
   ComputeOptimalPointsToSample(
-      *gp_model, gd_params, domain, thread_schedule,
+      *gp_model_, gd_params, domain, thread_schedule,
       points_being_sampled.data(), num_to_sample, num_being_sampled,
       best_so_far_, search_training_.max_mc_steps_, lhc_search_only,
       num_lhc_samples, &found_flag, &uniform_generator, normal_rng_vec.data(),
@@ -349,6 +411,24 @@ bool BayesianOpt::recommend_parameter_values(
   return found_flag;
 }
 
+bool BayesianOpt::recommend_parameter_batch(
+    size_t count, std::vector<std::vector<double>>& batch)
+{
+  // Points left over from the previous search were chosen without the
+  // samples added since; sample the whole batch from a fresh q-EI search.
+  const int num_to_sample = search_training_.num_to_sample_;
+  search_training_.num_to_sample_ = (int)count;
+  next_winner_points_.resize(count * dimensions_);
+  sample_cur_ = search_training_.num_to_sample_;
+  bool found = BaseOpt::recommend_parameter_batch(count, batch);
+
+  // Later single recommendations search the configured number of points.
+  search_training_.num_to_sample_ = num_to_sample;
+  next_winner_points_.resize(num_to_sample * dimensions_);
+  sample_cur_ = num_to_sample;
+  return found;
+}
+
 void BayesianOpt::configure(const utils::Json& params, int thread_count)
 {
   using ::matcher::GreaterThan;
@@ -356,6 +436,7 @@ void BayesianOpt::configure(const utils::Json& params, int thread_count)
   // Please be careful to change the default values of training parameters.
   // They may affect the performance and correctness of parameter free
   // solvers.
+  this->thread_count_ = thread_count;
   this->model_training_.num_multistarts_ = thread_count;
   this->model_training_.max_num_steps_ = 100;
   this->model_training_.max_num_restarts_ = 12;
@@ -389,6 +470,11 @@ void BayesianOpt::configure(const utils::Json& params, int thread_count)
   this->param(params, strategy::kReservedSamples, this->reserved_samples_)
       .description("max number of samples reserved for training")
       .matches(GreaterThan<size_t>(10));
+  this->param(params, strategy::kRetrainInterval, this->retrain_interval_)
+      .description(
+          "number of samples after which the model hyperparameters are "
+          "retrained (the model is updated with the samples in between)")
+      .matches(GreaterThan<uint32_t>(0));
 }
 
 }  // namespace strategy
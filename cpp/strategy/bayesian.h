@@ -9,6 +9,11 @@
 #include "strategy/base_opt.h"
 #include "strategy/gd_parameters.h"
 
+namespace optimal_learning
+{
+class GaussianProcess;
+}  // namespace optimal_learning
+
 namespace strategy
 {
 ////////////////////////////////////////////////////////////////////////////////
@@ -17,12 +22,17 @@ namespace strategy
 /// https://github.com/wujian16/Cornell-MOE The paper "A Tutorial on Bayesian
 /// Optimization" is a good introduction of bayesian optimization
 ///
+/// The hyperparameters of the gaussian process are only retrained every
+/// `retrain_interval` samples; in between, the model is kept and the samples
+/// added since are inserted into its covariance factorization.
+///
 class BayesianOpt : public BaseOpt
 {
  public:
-  BayesianOpt() : sample_cur_(0), new_sample_index_(0), reserved_samples_(64){};
+  BayesianOpt();
   BayesianOpt(const BayesianOpt&) = delete;
   BayesianOpt& operator=(const BayesianOpt&) = delete;
+  ~BayesianOpt();
   // Load the Bayesian Optimization parameters
   void configure(const utils::Json& params, int thread_count);
   // Initialize the Bayesian Optimization Process
@@ -33,6 +43,10 @@ class BayesianOpt : public BaseOpt
             size_t reserved_samples = 128);
   // Return next set of good parameters found by bayesian optimization process
   bool recommend_parameter_values(std::vector<double>& parameters_new) override;
+  // Return `count` parameter sets which jointly maximize the expected
+  // improvement (q-EI), to be evaluated concurrently.
+  bool recommend_parameter_batch(
+      size_t count, std::vector<std::vector<double>>& batch) override;
   // Feedback a new set of parameters and objective value to learning process
   void add_new_sample(std::vector<double>& parameters,
                       double objective) override;
@@ -43,12 +57,20 @@ class BayesianOpt : public BaseOpt
   double get_sample(int indx, std::vector<double>& sample_point) const;
 
   uint32_t get_reserved_samples() { return reserved_samples_; }
+  // Hyper-parameters of the last model training
+  const std::vector<double>& get_hyper_parameters() const
+  {
+    return trained_parameters_;
+  }
 
  private:
   // copy out the best parameter values found
   void copyout_winner(std::vector<double>& parameters) const;
   // logging the hypyer parameters of bayesian optimization
   void log_hyper_parameters() const;
+  // Bring gp_model_ up to date with the samples (using trained_parameters_);
+  // returns false if no model could be built.
+  bool update_model(std::vector<int>& derivatives);
   // Vector of sample points (X)
   std::vector<double> sample_points_;
   // Target function's objective value corresponsed to  sample_points_
@@ -75,5 +97,15 @@ class BayesianOpt : public BaseOpt
   // Max number of samples (in unit of dimension) saved in sample_points_ for
   // model training
   size_t reserved_samples_;
+  // Gaussian process of the last search (with trained_parameters_)
+  std::unique_ptr<optimal_learning::GaussianProcess> gp_model_;
+  // Number of samples after which the hyperparameters are retrained
+  uint32_t retrain_interval_;
+  // Number of samples added since the hyperparameters were last trained
+  size_t samples_since_training_;
+  // Whether a sample of gp_model_ was replaced (rather than samples appended)
+  bool model_outdated_;
+  // Number of threads used by the searches
+  int thread_count_;
 };
 }  // namespace strategy
\ No newline at end of file
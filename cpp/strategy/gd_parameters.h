@@ -20,6 +20,14 @@ const char* const kNumToSample = "num_to_sample";
 const char* const kInitialSamples = "initial_samples";
 const char* const kNonImprovementLimit = "nonimprovement_limit";
 const char* const kReservedSamples = "reserved_samples";
+const char* const kRetrainInterval = "retrain_interval";
+const char* const kBatchSize = "batch_size";
+const char* const kSuccessiveHalving = "successive_halving";
+const char* const kHalvingConfigurations = "halving_configurations";
+const char* const kHalvingRate = "halving_rate";
+const char* const kTuningCache = "tuning_cache";
+const char* const kTuningCacheNeighbors = "tuning_cache_neighbors";
+const char* const kTuningCacheSkipDistance = "tuning_cache_skip_distance";
 class GDParameters : public utils::Component
 {
  public:
@@ -93,12 +93,38 @@ bool LinearSearchOpt::recommend_parameter_values(std::vector<double>& parameters
   return true;
 }
 
+bool LinearSearchOpt::recommend_parameter_batch(
+    size_t count, std::vector<std::vector<double>>& batch)
+{
+  batch.clear();
+  std::vector<double> parameters;
+  do
+  {
+    recommend_parameter_values(parameters);
+    batch.push_back(parameters);
+  } while (batch.size() < count &&
+           sample_cur_ + 1 < int(sample_points_.size()));
+  return true;
+}
+
 // Feedback a new set of parameters and objective value to learning process
 void LinearSearchOpt::add_new_sample(std::vector<double>& parameters,
                                    double objective)
 {
-  if (std::lround(parameters[0]) == sample_points_[sample_cur_])
-    sample_objectives_[sample_cur_] = objective;
+  // Samples of a batch are fed back after the whole batch was recommended,
+  // so look up the (unevaluated) sample point they belong to.
+  int index = sample_cur_;
+  for (int i = 0; i <= sample_cur_; i++)
+  {
+    if (std::lround(parameters[0]) == sample_points_[i] &&
+        sample_objectives_[i] == std::numeric_limits<double>::max())
+    {
+      index = i;
+      break;
+    }
+  }
+  if (std::lround(parameters[0]) == sample_points_[index])
+    sample_objectives_[index] = objective;
   else
     throw utils::NotImplementedException(
         "Search for parameters is not implemented.");
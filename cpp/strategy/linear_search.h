@@ -28,10 +28,18 @@ class LinearSearchOpt : public BaseOpt
   // Return next set of good parameters found by bayesian optimization process
   bool recommend_parameter_values(std::vector<double>& parameters_new);
 
+  // Return the next sample points of the current search interval (at most
+  // `count`); the interval is only refit once all of them were fed back.
+  bool recommend_parameter_batch(
+      size_t count, std::vector<std::vector<double>>& batch) override;
+
   // Feedback a new set of parameters and objective value to learning process
   void add_new_sample(std::vector<double>& parameters,
                                      double objective);
 
+  // Samples outside of the search interval are not used by the search.
+  void add_prior_sample(std::vector<double>&, double) override {}
+
   // Set initial sample points in the range of the search parameter
   void set_ranges(const std::vector<int>& intial_sample_points);
 
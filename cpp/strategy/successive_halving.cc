@@ -0,0 +1,189 @@
+
+#include "strategy/successive_halving.h"
+
+#include <assert.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <limits>
+
+#include "utils/config.h"
+#include "utils/log.h"
+#include "strategy/gd_parameters.h"
+
+namespace strategy
+{
+void SuccessiveHalvingOpt::configure(const utils::Json& params, int)
+{
+  using ::matcher::GreaterThan;
+  this->param(params, kHalvingConfigurations, configurations_)
+      .description("number of parameter sets started in each bracket")
+      .matches(GreaterThan<uint32_t>(0));
+  this->param(params, kHalvingRate, rate_)
+      .description(
+          "factor of the budget increase (and inverse of the fraction kept) "
+          "from one rung to the next")
+      .matches(GreaterThan<double>(1));
+}
+
+void SuccessiveHalvingOpt::init(size_t dimensions, uint32_t seed, size_t)
+{
+  dimensions_ = dimensions;
+  rng_.seed(seed);
+  trials_.clear();
+  trial_cur_ = 0;
+  rung_ = 0;
+  brackets_ = 0;
+  sample_count_ = 0;
+  best_parameters_.clear();
+}
+
+void SuccessiveHalvingOpt::set_ranges(
+    const std::vector<std::pair<double, double>>& ranges)
+{
+  ranges_ = ranges;
+}
+
+void SuccessiveHalvingOpt::set_ranges(
+    const std::vector<int>& initial_sample_points)
+{
+  // Only the budget is searched, up to the largest step limit of the solver.
+  ranges_ = {{(double)initial_sample_points[0],
+              (double)std::numeric_limits<int>::max()}};
+}
+
+void SuccessiveHalvingOpt::set_budget(std::vector<double>& parameters,
+                                      double budget) const
+{
+  parameters[0] = budget;
+  // parameters without range follow the budget
+  for (size_t i = std::max(ranges_.size(), (size_t)1); i < dimensions_; i++)
+  {
+    parameters[i] = budget;
+  }
+}
+
+void SuccessiveHalvingOpt::start_bracket()
+{
+  assert(!ranges_.empty());
+  trials_.clear();
+  trials_.reserve(configurations_);
+  for (uint32_t i = 0; i < configurations_; i++)
+  {
+    Trial trial;
+    if (i == 0 && !best_parameters_.empty())
+    {
+      // give the best parameters so far another chance with new restarts
+      trial.parameters = best_parameters_;
+    }
+    else
+    {
+      trial.parameters.resize(dimensions_);
+      for (size_t j = 1; j < std::min(ranges_.size(), dimensions_); j++)
+      {
+        trial.parameters[j] =
+            ranges_[j].first +
+            (ranges_[j].second - ranges_[j].first) * rng_.uniform();
+      }
+    }
+    set_budget(trial.parameters, ranges_[0].first);
+    trial.objective = std::numeric_limits<double>::max();
+    trial.sample = -1;
+    trials_.push_back(trial);
+  }
+  trial_cur_ = 0;
+  rung_ = 0;
+  brackets_++;
+  LOG(INFO, "Starting successive halving bracket ", brackets_, " with ",
+      configurations_, " configurations and budget ", ranges_[0].first);
+}
+
+void SuccessiveHalvingOpt::promote()
+{
+  double budget = trials_[0].parameters[0];
+  double max_budget = std::max(ranges_[0].second, ranges_[0].first);
+  if (trials_.size() == 1 && budget >= max_budget)
+  {
+    // the bracket is complete
+    trials_.clear();
+    return;
+  }
+  std::stable_sort(
+      trials_.begin(), trials_.end(),
+      [](const Trial& a, const Trial& b) { return a.objective < b.objective; });
+  size_t keep = (size_t)std::ceil((double)trials_.size() / rate_);
+  trials_.resize(std::max(keep, (size_t)1));
+  budget = std::min(budget * rate_, max_budget);
+  for (auto& trial : trials_)
+  {
+    set_budget(trial.parameters, budget);
+  }
+  trial_cur_ = 0;
+  rung_++;
+  LOG(INFO, "Promoted ", trials_.size(), " configurations to rung ", rung_,
+      " with budget ", budget);
+}
+
+bool SuccessiveHalvingOpt::recommend_parameter_values(
+    std::vector<double>& parameters_new)
+{
+  auto start_time = std::chrono::high_resolution_clock::now();
+  if (trials_.empty())
+  {
+    start_bracket();
+  }
+  parameters_new = trials_[trial_cur_].parameters;
+#if defined(_DEBUG) || defined(qiotoolkit_PROFILING)
+  log_parameters("Search parameters: ", parameters_new);
+#endif
+  auto end_time = std::chrono::high_resolution_clock::now();
+  int64_t ms_diff = std::chrono::duration_cast<std::chrono::milliseconds>(
+                        end_time - start_time)
+                        .count();
+  this->learning_time_ms_ += ms_diff;
+#ifdef qiotoolkit_PROFILING
+  update_profile(0, ms_diff);
+#endif
+  return true;
+}
+
+void SuccessiveHalvingOpt::add_new_sample(std::vector<double>& parameters,
+                                          double objective)
+{
+  assert(parameters.size() == dimensions_);
+  assert(trial_cur_ < trials_.size());
+  Trial& trial = trials_[trial_cur_];
+  trial.objective = objective;
+  trial.sample = sample_count_++;
+  if (best_parameters_.empty() || objective < best_objective_)
+  {
+    best_objective_ = objective;
+    best_parameters_ = parameters;
+  }
+  trial_cur_++;
+  if (trial_cur_ == trials_.size())
+  {
+    promote();
+  }
+#ifdef qiotoolkit_PROFILING
+  update_objective_profile(objective, parameters);
+#endif
+}
+
+int SuccessiveHalvingOpt::get_resumed_sample() const
+{
+  if (trials_.empty()) return -1;
+  return trials_[trial_cur_].sample;
+}
+
+void SuccessiveHalvingOpt::get_resumable_samples(std::vector<int>& samples) const
+{
+  samples.clear();
+  for (const auto& trial : trials_)
+  {
+    if (trial.sample >= 0) samples.push_back(trial.sample);
+  }
+}
+
+}  // namespace strategy
@@ -0,0 +1,104 @@
+
+#pragma once
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "utils/random_generator.h"
+#include "utils/structure.h"
+#include "strategy/base_opt.h"
+
+namespace strategy
+{
+////////////////////////////////////////////////////////////////////////////////
+/// Successive halving strategy searching implementation.
+///
+/// A bracket starts `halving_configurations` parameter sets (the best one
+/// found so far and random ones within the ranges) with the smallest step
+/// budget (parameters[0]). Once all of them were evaluated, the best
+/// 1/`halving_rate` are promoted to the next rung with `halving_rate` times
+/// the budget, until a single one is left which keeps growing its budget up
+/// to the upper end of its range; then a new bracket starts.
+///
+/// Promoted parameter sets continue the run of their previous rung (see
+/// `get_resumed_sample()`) rather than restarting it, so little time is
+/// spent on poor parameters.
+///
+/// With the sample points of a linear search as ranges, the budget is the
+/// only parameter (further dimensions follow it) and configurations differ
+/// by their random restarts only.
+class SuccessiveHalvingOpt : public BaseOpt
+{
+ public:
+  SuccessiveHalvingOpt()
+      : configurations_(9),
+        rate_(3),
+        trial_cur_(0),
+        rung_(0),
+        brackets_(0),
+        sample_count_(0),
+        best_objective_(0)
+  {
+  }
+  SuccessiveHalvingOpt(const SuccessiveHalvingOpt&) = delete;
+  SuccessiveHalvingOpt& operator=(const SuccessiveHalvingOpt&) = delete;
+  // Load the successive halving parameters
+  void configure(const utils::Json& params, int thread_count);
+  void init(size_t dimensions, uint32_t seed, size_t reserved_samples = 128);
+  // Return the next parameter set of the current rung
+  bool recommend_parameter_values(std::vector<double>& parameters_new) override;
+  // Feedback the objective of the last recommended parameter set
+  void add_new_sample(std::vector<double>& parameters,
+                      double objective) override;
+  // Set the parameter searching value ranges (parameters[0] is the budget)
+  void set_ranges(const std::vector<std::pair<double, double>>& ranges);
+  // Set the step budget from the initial sample points of a linear search
+  // (limited to the int range of the solvers' sweeps)
+  void set_ranges(const std::vector<int>& initial_sample_points);
+
+  // Sample (index in the order of `add_new_sample`) whose run the last
+  // recommended parameters continue, or -1 if they start a new run.
+  int get_resumed_sample() const;
+  // Samples whose runs may still be continued by later recommendations.
+  void get_resumable_samples(std::vector<int>& samples) const;
+  // Number of samples added so far (the index of the next one).
+  int get_sample_count() const { return sample_count_; }
+  // Number of parameter sets started in each bracket.
+  uint32_t get_configurations() const { return configurations_; }
+  size_t get_rung() const { return rung_; }
+  size_t get_bracket() const { return brackets_; }
+
+ private:
+  struct Trial
+  {
+    std::vector<double> parameters;
+    double objective;
+    // last sample evaluating these parameters (-1 if not run yet)
+    int sample;
+  };
+  // start a new bracket with the smallest budget
+  void start_bracket();
+  // keep the best trials of the current rung with a larger budget
+  void promote();
+  // set the step budget of `parameters`
+  void set_budget(std::vector<double>& parameters, double budget) const;
+
+  // Number of parameter sets started in each bracket
+  uint32_t configurations_;
+  // Fraction of trials dropped (and factor of budget increase) per rung
+  double rate_;
+  // Trials of the current rung
+  std::vector<Trial> trials_;
+  // Index of the trial to be evaluated next
+  size_t trial_cur_;
+  // Current rung (in the current bracket) and number of brackets started
+  size_t rung_;
+  size_t brackets_;
+  int sample_count_;
+  // Best parameters and objective found so far
+  std::vector<double> best_parameters_;
+  double best_objective_;
+  // Random number generator used to sample configurations
+  ::utils::Twister rng_;
+};
+}  // namespace strategy
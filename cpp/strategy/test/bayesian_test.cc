@@ -79,6 +79,67 @@ TEST(Bayesian, RangeTests)
   EXPECT_LT(0, s["total_training_ms"].get<int64_t>());
 }
 
+TEST(Bayesian, BatchTests)
+{
+  GDParameters model_parameters;
+  model_parameters.num_multistarts_ = omp_get_max_threads();
+  model_parameters.max_num_steps_ = 100;
+  model_parameters.max_num_restarts_ = 12;
+  model_parameters.num_steps_averaged_ = 4;
+  model_parameters.max_mc_steps_ = 100;
+  model_parameters.gamma_ = 1.01;
+  model_parameters.pre_mult_ = 1.0e-3;
+  model_parameters.max_relative_change_ = 1.0;
+  model_parameters.tolerance_ = 1.0e-6;
+  model_parameters.num_to_sample_ = 1;
+
+  GDParameters search_parameters;
+  search_parameters.num_multistarts_ = omp_get_max_threads();
+  search_parameters.max_num_steps_ = 100;
+  search_parameters.max_num_restarts_ = 12;
+  search_parameters.gamma_ = 0.7;
+  search_parameters.pre_mult_ = 1.0;
+  search_parameters.max_relative_change_ = 0.8;
+  search_parameters.tolerance_ = 1.0e-7;
+  search_parameters.num_steps_averaged_ = 4;
+  search_parameters.max_mc_steps_ = 100;
+  search_parameters.num_to_sample_ = 1;
+  BayesianOpt bayesian;
+  bayesian.init(2, 88, model_parameters, search_parameters);
+  std::vector<std::pair<double, double>> ranges = {{0.1, 20.}, {2., 2000.}};
+  bayesian.set_ranges(ranges);
+
+  std::vector<std::vector<double>> samples = {
+      {10., 100.}, {2., 200.}, {5., 6.}, {4., 5.}};
+  std::vector<double> objectives = {-9., -1., -1000., -600.};
+  for (size_t i = 0; i < samples.size(); i++)
+  {
+    bayesian.add_new_sample(samples[i], objectives[i]);
+  }
+
+  // The whole batch comes from one search, regardless of num_to_sample.
+  std::vector<std::vector<double>> batch;
+  ASSERT_TRUE(bayesian.recommend_parameter_batch(3, batch));
+  ASSERT_EQ(3u, batch.size());
+  for (auto& parameters : batch)
+  {
+    ASSERT_EQ(2u, parameters.size());
+    EXPECT_LE(parameters[0], ranges[0].second);
+    EXPECT_LE(ranges[0].first, parameters[0]);
+    EXPECT_LE(parameters[1], ranges[1].second);
+    EXPECT_LE(ranges[1].first, parameters[1]);
+    bayesian.add_new_sample(parameters, -100.);
+  }
+  EXPECT_EQ(7u, bayesian.num_of_saved_samples());
+
+  // Single recommendations are not affected by the batch size.
+  std::vector<double> parameters;
+  ASSERT_TRUE(bayesian.recommend_parameter_values(parameters));
+  ASSERT_EQ(2u, parameters.size());
+  bayesian.add_new_sample(parameters, -100.);
+  EXPECT_EQ(8u, bayesian.num_of_saved_samples());
+}
+
 TEST(Bayesian, SavedSamplesTests)
 {
   GDParameters model_parameters;
@@ -125,8 +186,120 @@ TEST(Bayesian, SavedSamplesTests)
   EXPECT_EQ(100., obj);
 }
 
+TEST(Bayesian, IncrementalModelTests)
+{
+  GDParameters model_parameters;
+  model_parameters.num_multistarts_ = omp_get_max_threads();
+  model_parameters.max_num_steps_ = 100;
+  model_parameters.max_num_restarts_ = 12;
+  model_parameters.num_steps_averaged_ = 4;
+  model_parameters.max_mc_steps_ = 100;
+  model_parameters.gamma_ = 1.01;
+  model_parameters.pre_mult_ = 1.0e-3;
+  model_parameters.max_relative_change_ = 1.0;
+  model_parameters.tolerance_ = 1.0e-6;
+  model_parameters.num_to_sample_ = 1;
+
+  GDParameters search_parameters;
+  search_parameters.num_multistarts_ = omp_get_max_threads();
+  search_parameters.max_num_steps_ = 100;
+  search_parameters.max_num_restarts_ = 12;
+  search_parameters.gamma_ = 0.7;
+  search_parameters.pre_mult_ = 1.0;
+  search_parameters.max_relative_change_ = 0.8;
+  search_parameters.tolerance_ = 1.0e-7;
+  search_parameters.num_steps_averaged_ = 4;
+  search_parameters.max_mc_steps_ = 100;
+  search_parameters.num_to_sample_ = 3;
+  BayesianOpt bayesian;
+  bayesian.init(2, 88, model_parameters, search_parameters);
+  std::vector<std::pair<double, double>> ranges = {{0.1, 20.}, {2., 2000.}};
+  bayesian.set_ranges(ranges);
+
+  std::vector<std::vector<double>> samples = {
+      {10., 100.}, {2., 200.}, {5., 6.}, {4., 5.}};
+  std::vector<double> objectives = {-9., -1., -1000., -600.};
+  for (size_t i = 0; i < samples.size(); i++)
+  {
+    bayesian.add_new_sample(samples[i], objectives[i]);
+  }
+
+  // The first search trains the hyperparameters, the following ones (within
+  // the retrain interval of 8 samples) extend the model by the new samples;
+  // the fourth search (after 9 new samples) retrains them.
+  std::vector<double> trained;
+  for (int search = 0; search < 4; search++)
+  {
+    for (int i = 0; i < search_parameters.num_to_sample_; i++)
+    {
+      std::vector<double> parameters;
+      ASSERT_TRUE(bayesian.recommend_parameter_values(parameters));
+      ASSERT_EQ(2u, parameters.size());
+      EXPECT_LE(parameters[0], ranges[0].second);
+      EXPECT_LE(ranges[0].first, parameters[0]);
+      EXPECT_LE(parameters[1], ranges[1].second);
+      EXPECT_LE(ranges[1].first, parameters[1]);
+      if (i == 0)
+      {
+        if (search == 0)
+        {
+          trained = bayesian.get_hyper_parameters();
+        }
+        else if (search < 3)
+        {
+          EXPECT_EQ(trained, bayesian.get_hyper_parameters());
+        }
+        else
+        {
+          EXPECT_NE(trained, bayesian.get_hyper_parameters());
+        }
+      }
+      bayesian.add_new_sample(parameters, -parameters[0] * parameters[1]);
+    }
+  }
+  EXPECT_EQ(16u, bayesian.num_of_saved_samples());
+}
+
 using namespace optimal_learning;
 
+TEST(GPP, AddPointsToGP)
+{
+  const int dim = 2;
+  const int num_sampled = 7;
+  std::vector<int> derivatives = {0, 1};
+  const int num_values = (int)derivatives.size() + 1;
+  std::vector<double> points;
+  std::vector<double> values(num_sampled * num_values, 0.0);
+  for (int i = 0; i < num_sampled; i++)
+  {
+    points.push_back(0.3 * i + 0.1);
+    points.push_back(std::sin(i));
+    values[i * num_values] = std::cos(i);
+  }
+  std::vector<double> noise_variance = {0.01, 0.02, 0.03};
+  std::vector<double> lengths = {0.8, 1.3};
+  SquareExponential covariance(dim, 1.5, lengths.data());
+  GaussianProcess full(covariance, points.data(), values.data(),
+                       noise_variance.data(), derivatives.data(),
+                       (int)derivatives.size(), dim, num_sampled);
+
+  // Extending the factorization gives the same model as building it anew.
+  GaussianProcess extended(covariance, points.data(), values.data(),
+                           noise_variance.data(), derivatives.data(),
+                           (int)derivatives.size(), dim, 4);
+  extended.AddPointsToGP(points.data() + 4 * dim, values.data() + 4 * num_values,
+                         1);
+  extended.AddPointsToGP(points.data() + 5 * dim, values.data() + 5 * num_values,
+                         2);
+  ASSERT_EQ(num_sampled, extended.num_sampled());
+  EXPECT_NEAR(full.get_mean(), extended.get_mean(), 1e-12);
+  ASSERT_EQ(full.get_K_inv_y().size(), extended.get_K_inv_y().size());
+  for (size_t i = 0; i < full.get_K_inv_y().size(); i++)
+  {
+    EXPECT_NEAR(full.get_K_inv_y()[i], extended.get_K_inv_y()[i], 1e-9);
+  }
+}
+
 namespace strategy
 {
 std::unique_ptr<GaussianProcess> create_model(
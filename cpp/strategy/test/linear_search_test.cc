@@ -2,6 +2,7 @@
 #include <cmath>
 #include <sstream>
 #include <string>
+#include "utils/exception.h"
 #include "gtest/gtest.h"
 #include "strategy/linear_search.h"
 
@@ -42,3 +43,35 @@ TEST(LinearSearchTest, FindMinimum)
   EXPECT_NEAR(best_param, target_val, 5);
   EXPECT_NEAR(min_obj, 0.0, 25);
 }
+
+TEST(LinearSearchTest, Batch)
+{
+  LinearSearchOpt opt;
+  opt.init(1, 333);
+  opt.set_ranges({10, 20, 30, 50});
+  Problem pr(60);
+
+  // Batches do not extend past the current search interval.
+  std::vector<std::vector<double>> batch;
+  ASSERT_TRUE(opt.recommend_parameter_batch(3, batch));
+  ASSERT_EQ(batch.size(), 3u);
+  EXPECT_EQ(batch[0][0], 10);
+  EXPECT_EQ(batch[2][0], 30);
+  for (auto it = batch.rbegin(); it != batch.rend(); it++)
+  {
+    opt.add_new_sample(*it, pr.objective(std::lround((*it)[0])));
+  }
+  ASSERT_TRUE(opt.recommend_parameter_batch(3, batch));
+  ASSERT_EQ(batch.size(), 1u);
+  EXPECT_EQ(batch[0][0], 50);
+  opt.add_new_sample(batch[0], pr.objective(50));
+
+  // The best sample point (50) was the last: the interval is stretched.
+  ASSERT_TRUE(opt.recommend_parameter_batch(8, batch));
+  ASSERT_EQ(batch.size(), 4u);
+  EXPECT_EQ(batch[0][0], 15);
+  EXPECT_EQ(batch[3][0], 75);
+
+  std::vector<double> unknown = {16};
+  EXPECT_THROW(opt.add_new_sample(unknown, 0), utils::NotImplementedException);
+}
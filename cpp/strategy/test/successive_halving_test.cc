@@ -0,0 +1,119 @@
+
+#include "strategy/successive_halving.h"
+
+#include <algorithm>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "utils/json.h"
+#include "gtest/gtest.h"
+
+using strategy::SuccessiveHalvingOpt;
+
+TEST(SuccessiveHalving, Rungs)
+{
+  SuccessiveHalvingOpt halving;
+  halving.configure(utils::json_from_string(
+                        "{\"halving_configurations\": 9, \"halving_rate\": 3}"),
+                    1);
+  halving.init(2, 88);
+  std::vector<std::pair<double, double>> ranges = {{10., 100.}, {0., 1.}};
+  halving.set_ranges(ranges);
+
+  // The first rung starts 9 runs with the smallest budget.
+  std::vector<std::vector<double>> rung;
+  for (int i = 0; i < 9; i++)
+  {
+    std::vector<double> parameters;
+    ASSERT_TRUE(halving.recommend_parameter_values(parameters));
+    ASSERT_EQ(parameters.size(), 2u);
+    EXPECT_EQ(parameters[0], 10.);
+    EXPECT_LE(0., parameters[1]);
+    EXPECT_LE(parameters[1], 1.);
+    EXPECT_EQ(halving.get_resumed_sample(), -1);
+    EXPECT_EQ(halving.get_sample_count(), i);
+    halving.add_new_sample(parameters, parameters[1]);
+    rung.push_back(parameters);
+  }
+  EXPECT_EQ(halving.get_rung(), 1u);
+
+  // The best third continues its runs with three times the budget.
+  std::vector<int> resumable;
+  halving.get_resumable_samples(resumable);
+  ASSERT_EQ(resumable.size(), 3u);
+  std::vector<int> best = {0, 1, 2, 3, 4, 5, 6, 7, 8};
+  std::sort(best.begin(), best.end(),
+            [&](int a, int b) { return rung[a][1] < rung[b][1]; });
+  for (int i = 0; i < 3; i++)
+  {
+    std::vector<double> parameters;
+    ASSERT_TRUE(halving.recommend_parameter_values(parameters));
+    EXPECT_EQ(parameters[0], 30.);
+    EXPECT_EQ(halving.get_resumed_sample(), best[i]);
+    EXPECT_EQ(parameters[1], rung[best[i]][1]);
+    halving.add_new_sample(parameters, parameters[1]);
+  }
+
+  // The budget of the last one is limited by the range.
+  std::vector<double> parameters;
+  ASSERT_TRUE(halving.recommend_parameter_values(parameters));
+  EXPECT_EQ(parameters[0], 90.);
+  EXPECT_EQ(halving.get_resumed_sample(), 9);
+  halving.add_new_sample(parameters, parameters[1]);
+  ASSERT_TRUE(halving.recommend_parameter_values(parameters));
+  EXPECT_EQ(parameters[0], 100.);
+  halving.add_new_sample(parameters, parameters[1]);
+  EXPECT_EQ(halving.get_bracket(), 1u);
+
+  // Then, a new bracket starts with the best parameters so far.
+  ASSERT_TRUE(halving.recommend_parameter_values(parameters));
+  EXPECT_EQ(halving.get_bracket(), 2u);
+  EXPECT_EQ(parameters[0], 10.);
+  EXPECT_EQ(parameters[1], rung[best[0]][1]);
+  EXPECT_EQ(halving.get_resumed_sample(), -1);
+  halving.get_resumable_samples(resumable);
+  EXPECT_TRUE(resumable.empty());
+}
+
+TEST(SuccessiveHalving, LinearRanges)
+{
+  SuccessiveHalvingOpt halving;
+  halving.init(2, 333);
+  halving.set_ranges(std::vector<int>{10, 20, 30, 50});
+
+  // Only the budget is searched (and the other parameter follows it).
+  std::vector<double> parameters;
+  for (int i = 0; i < 9; i++)
+  {
+    ASSERT_TRUE(halving.recommend_parameter_values(parameters));
+    EXPECT_EQ(parameters, std::vector<double>({10., 10.}));
+    halving.add_new_sample(parameters, -i);
+  }
+  for (int i = 0; i < 3; i++)
+  {
+    ASSERT_TRUE(halving.recommend_parameter_values(parameters));
+    EXPECT_EQ(parameters, std::vector<double>({30., 30.}));
+    EXPECT_EQ(halving.get_resumed_sample(), 8 - i);
+    halving.add_new_sample(parameters, -i);
+  }
+  // The last run keeps growing its budget up to the largest step limit.
+  for (double budget : {90., 270., 810.})
+  {
+    ASSERT_TRUE(halving.recommend_parameter_values(parameters));
+    EXPECT_EQ(parameters[0], budget);
+    halving.add_new_sample(parameters, -10);
+  }
+  const double max_budget = std::numeric_limits<int>::max();
+  while (halving.get_bracket() == 1u)
+  {
+    ASSERT_TRUE(halving.recommend_parameter_values(parameters));
+    ASSERT_LE(parameters[0], max_budget);
+    halving.add_new_sample(parameters, -10);
+    if (parameters[0] == max_budget) break;
+  }
+  EXPECT_EQ(parameters[0], max_budget);
+  ASSERT_TRUE(halving.recommend_parameter_values(parameters));
+  EXPECT_EQ(halving.get_bracket(), 2u);
+  EXPECT_EQ(parameters[0], 10.);
+}
@@ -0,0 +1,92 @@
+
+#include "strategy/tuning_cache.h"
+
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "utils/config.h"
+#include "utils/structure.h"
+#include "gtest/gtest.h"
+
+using strategy::TuningCache;
+using strategy::TuningEntry;
+
+namespace
+{
+TuningEntry make_entry(const std::string& solver, double feature,
+                       double parameter)
+{
+  TuningEntry entry;
+  entry.solver_ = solver;
+  entry.features_ = {feature, 1.};
+  entry.parameters_ = {parameter, 2 * parameter};
+  entry.execution_cost_ = parameter;
+  entry.cost_ = -feature;
+  return entry;
+}
+}  // namespace
+
+TEST(TuningCache, Features)
+{
+  utils::Structure properties;
+  EXPECT_TRUE(TuningCache::get_features(properties).empty());
+
+  utils::Structure& size = properties["graph"]["size"];
+  size["nodes"] = (uint64_t)10;
+  size["edges"] = (uint64_t)20;
+  size[utils::kMaxLocality] = (uint32_t)3;
+  size[utils::kAvgLocality] = 2.5;
+  size[utils::kTotalLocality] = (uint64_t)50;
+  size[utils::kMaxCouplingMagnitude] = 4.;
+  size[utils::kMinCouplingMagnitude] = 0.5;
+  std::vector<double> features = TuningCache::get_features(properties);
+  std::vector<double> expected = {10, 20, 3, 2.5, 5, 4, 0.5};
+  ASSERT_EQ(features.size(), expected.size());
+  for (size_t i = 0; i < expected.size(); i++)
+  {
+    EXPECT_DOUBLE_EQ(features[i], std::log1p(expected[i]));
+  }
+}
+
+TEST(TuningCache, StoreAndFindNearest)
+{
+  const char kCacheFile[] = "tuning_cache_test.tuning_cache";
+  std::remove(kCacheFile);
+  {
+    TuningCache cache;
+    cache.load(kCacheFile);
+    EXPECT_TRUE(cache.get_entries().empty());
+    cache.store(kCacheFile, make_entry("sa", 1., 10.));
+    cache.store(kCacheFile, make_entry("sa", 5., 50.));
+    cache.store(kCacheFile, make_entry("pt", 2., 20.));
+    cache.store(kCacheFile, make_entry("sa", 2.5, 25.));
+  }
+  {
+    // An entry truncated by an interrupted run is ignored.
+    std::ofstream out(kCacheFile, std::ios::app);
+    out << "{\"solver\": \"sa\", \"features\": [2,\n";
+  }
+
+  TuningCache cache;
+  cache.load(kCacheFile);
+  ASSERT_EQ(cache.get_entries().size(), 4u);
+  EXPECT_EQ(cache.get_entries()[1].parameters_,
+            std::vector<double>({50., 100.}));
+  EXPECT_EQ(cache.get_entries()[1].execution_cost_, 50.);
+
+  auto nearest = cache.find_nearest("sa", {2., 1.}, 2, 2);
+  ASSERT_EQ(nearest.size(), 2u);
+  EXPECT_DOUBLE_EQ(nearest[0].distance, 0.5);
+  EXPECT_EQ(nearest[0].entry->parameters_[0], 25.);
+  EXPECT_DOUBLE_EQ(nearest[1].distance, 1.);
+  EXPECT_EQ(nearest[1].entry->parameters_[0], 10.);
+
+  // Entries of other solvers or parameter dimensions do not match.
+  EXPECT_EQ(cache.find_nearest("pt", {2., 1.}, 2, 5).size(), 1u);
+  EXPECT_TRUE(cache.find_nearest("sa", {2., 1.}, 3, 5).empty());
+  EXPECT_TRUE(cache.find_nearest("tabu", {2., 1.}, 2, 5).empty());
+  std::remove(kCacheFile);
+}
@@ -0,0 +1,182 @@
+
+#include "strategy/tuning_cache.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+
+#include "utils/config.h"
+#include "utils/exception.h"
+#include "utils/log.h"
+#include "rapidjson/stringbuffer.h"
+#include "rapidjson/writer.h"
+
+namespace strategy
+{
+namespace
+{
+// Numeric value of `s` regardless of its integer or floating point type.
+double get_number(const utils::Structure& s)
+{
+  switch (s.get_type())
+  {
+    case utils::Structure::INT32:
+      return s.get<int32_t>();
+    case utils::Structure::UINT32:
+      return s.get<uint32_t>();
+    case utils::Structure::INT64:
+      return (double)s.get<int64_t>();
+    case utils::Structure::UINT64:
+      return (double)s.get<uint64_t>();
+    case utils::Structure::DOUBLE:
+      return s.get<double>();
+    default:
+      return 0;
+  }
+}
+}  // namespace
+
+void TuningEntry::configure(const utils::Json& json)
+{
+  this->param(json, "solver", solver_)
+      .description("identifier of the solver which tuned the parameters")
+      .required();
+  this->param(json, "features", features_)
+      .description("feature vector of the problem")
+      .required();
+  this->param(json, "parameters", parameters_)
+      .description("best parameters found")
+      .required();
+  this->param(json, "execution_cost", execution_cost_)
+      .description("estimated execution cost of the parameters");
+  this->param(json, "cost", cost_).description("lowest cost found");
+}
+
+std::string TuningEntry::to_string() const
+{
+  rapidjson::StringBuffer buffer;
+  rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+  auto write_array = [&](const char* key, const std::vector<double>& values) {
+    writer.Key(key);
+    writer.StartArray();
+    for (double value : values) writer.Double(value);
+    writer.EndArray();
+  };
+  writer.StartObject();
+  writer.Key("solver");
+  writer.String(solver_.c_str());
+  write_array("features", features_);
+  write_array("parameters", parameters_);
+  writer.Key("execution_cost");
+  writer.Double(execution_cost_);
+  writer.Key("cost");
+  writer.Double(cost_);
+  writer.EndObject();
+  return std::string(buffer.GetString());
+}
+
+void TuningCache::load(const std::string& file)
+{
+  entries_.clear();
+  std::ifstream in(file);
+  if (!in)
+  {
+    LOG(INFO, "Tuning cache ", file, " does not exist yet.");
+    return;
+  }
+  std::string line;
+  size_t line_number = 0;
+  while (std::getline(in, line))
+  {
+    line_number++;
+    if (line.empty()) continue;
+    try
+    {
+      TuningEntry entry;
+      entry.configure(utils::json_from_string(line));
+      entries_.push_back(entry);
+    }
+    catch (const utils::ConfigurationException& e)
+    {
+      // e.g., a line truncated by a run which was killed while writing
+      LOG(WARN, "Ignoring invalid entry on line ", line_number,
+          " of tuning cache ", file, ": ", e.what());
+    }
+  }
+  LOG(INFO, "Read ", entries_.size(), " entries from tuning cache ", file);
+}
+
+void TuningCache::store(const std::string& file, const TuningEntry& entry)
+{
+  // A single write per entry keeps concurrent runs from interleaving lines.
+  std::string line = entry.to_string() + "\n";
+  std::ofstream out(file, std::ios::app | std::ios::binary);
+  out.write(line.data(), (std::streamsize)line.size());
+  out.close();
+  if (!out)
+  {
+    THROW(utils::FileWriteException, "Unable to write tuning cache ", file,
+          ".");
+  }
+  entries_.push_back(entry);
+}
+
+std::vector<TuningCache::Neighbor> TuningCache::find_nearest(
+    const std::string& solver, const std::vector<double>& features,
+    size_t dimensions, size_t count) const
+{
+  std::vector<Neighbor> nearest;
+  for (const auto& entry : entries_)
+  {
+    if (entry.solver_ != solver || entry.parameters_.size() != dimensions ||
+        entry.features_.size() != features.size())
+    {
+      continue;
+    }
+    double distance = 0;
+    for (size_t i = 0; i < features.size(); i++)
+    {
+      double diff = entry.features_[i] - features[i];
+      distance += diff * diff;
+    }
+    nearest.push_back({std::sqrt(distance), &entry});
+  }
+  // among equally near entries, prefer the later (more recent) ones
+  std::reverse(nearest.begin(), nearest.end());
+  std::stable_sort(nearest.begin(), nearest.end(),
+                   [](const Neighbor& a, const Neighbor& b) {
+                     return a.distance < b.distance;
+                   });
+  if (nearest.size() > count) nearest.resize(count);
+  return nearest;
+}
+
+std::vector<double> TuningCache::get_features(
+    const utils::Structure& model_properties)
+{
+  std::vector<double> features;
+  if (!model_properties.has_key("graph") ||
+      !model_properties["graph"].has_key("size"))
+  {
+    return features;
+  }
+  const utils::Structure& size = model_properties["graph"]["size"];
+  auto feature = [&](const char* key) {
+    return size.has_key(key) ? get_number(size[key]) : 0.;
+  };
+  double nodes = feature("nodes");
+  double degree = nodes > 0 ? feature(utils::kTotalLocality) / nodes : 0;
+  // Log-scaled, such that problems differing by the same factor are equally
+  // far apart regardless of their size.
+  for (double value :
+       {nodes, feature("edges"), feature(utils::kMaxLocality),
+        feature(utils::kAvgLocality), degree,
+        feature(utils::kMaxCouplingMagnitude),
+        feature(utils::kMinCouplingMagnitude)})
+  {
+    features.push_back(std::log1p(std::abs(value)));
+  }
+  return features;
+}
+
+}  // namespace strategy
@@ -0,0 +1,71 @@
+
+#pragma once
+#include <string>
+#include <vector>
+
+#include "utils/component.h"
+#include "utils/json.h"
+#include "utils/structure.h"
+
+namespace strategy
+{
+////////////////////////////////////////////////////////////////////////////////
+/// Tuned parameters of a solver on one problem, together with the features
+/// of that problem (see `TuningCache::get_features()`).
+class TuningEntry : public utils::Component
+{
+ public:
+  TuningEntry() : execution_cost_(0), cost_(0) {}
+  void configure(const utils::Json& json) override;
+  // Single line json representation (with doubles in full precision, unlike
+  // the rendering of utils::Structure)
+  std::string to_string() const;
+
+  // Identifier of the parameter-free solver which tuned the parameters
+  std::string solver_;
+  // Feature vector of the problem
+  std::vector<double> features_;
+  // Best parameters found
+  std::vector<double> parameters_;
+  // Estimated execution cost of `parameters_`
+  double execution_cost_;
+  // Lowest cost found with `parameters_`
+  double cost_;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// On-disk cache of tuned parameters keyed by problem features.
+///
+/// The cache file holds one json `TuningEntry` per line, so that runs can
+/// append their results without rewriting it. Problems are compared by the
+/// euclidean distance of their (log-scaled) feature vectors: sizes, locality,
+/// degree and coupling magnitudes of the model graph.
+class TuningCache
+{
+ public:
+  struct Neighbor
+  {
+    double distance;
+    const TuningEntry* entry;
+  };
+
+  // Read the entries of `file` (a missing file is an empty cache)
+  void load(const std::string& file);
+  // Append `entry` to `file` (and to the entries read)
+  void store(const std::string& file, const TuningEntry& entry);
+  // Up to `count` entries of `solver` with `dimensions` parameters, nearest
+  // to `features` first.
+  std::vector<Neighbor> find_nearest(const std::string& solver,
+                                     const std::vector<double>& features,
+                                     size_t dimensions, size_t count) const;
+  // Feature vector of a model from its benchmark properties (empty if the
+  // model reports no graph properties).
+  static std::vector<double> get_features(
+      const utils::Structure& model_properties);
+
+  const std::vector<TuningEntry>& get_entries() const { return entries_; }
+
+ private:
+  std::vector<TuningEntry> entries_;
+};
+}  // namespace strategy
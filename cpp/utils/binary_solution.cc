@@ -0,0 +1,293 @@
+
+#include "utils/binary_solution.h"
+
+#include <cstring>
+
+#include "utils/exception.h"
+
+namespace utils
+{
+namespace
+{
+constexpr char kMagic[8] = {'Q', 'I', 'O', 'S', 'O', 'L', 'N', '\n'};
+constexpr uint32_t kByteOrderMark = 0x01020304;
+
+struct Header
+{
+  char magic[8];
+  uint32_t format_version;
+  uint32_t byte_order;
+  uint32_t encoding;
+  int32_t bit_values[2];
+  uint32_t reserved;
+  uint64_t variable_count;
+  uint64_t solution_count;
+  uint64_t metadata_size;
+  double cost;
+};
+
+static_assert(sizeof(Header) % 8 == 0, "header must keep sections aligned");
+
+size_t padded(size_t size) { return (size + 7) / 8 * 8; }
+
+bool is_valid(uint32_t encoding)
+{
+  return encoding >= SolutionEncoding::BITS &&
+         encoding <= SolutionEncoding::INT32;
+}
+
+// Size of one integer value (0 for BITS).
+size_t value_size(const SolutionEncoding& encoding)
+{
+  switch (encoding.type)
+  {
+    case SolutionEncoding::INT8:
+      return sizeof(int8_t);
+    case SolutionEncoding::INT16:
+      return sizeof(int16_t);
+    case SolutionEncoding::INT32:
+      return sizeof(int32_t);
+    default:
+      return 0;
+  }
+}
+
+// Size of the values of one solution (before padding).
+size_t values_size(const SolutionEncoding& encoding, size_t variable_count)
+{
+  return encoding.type == SolutionEncoding::BITS
+             ? (variable_count + 7) / 8
+             : variable_count * value_size(encoding);
+}
+}  // namespace
+
+BinarySolutionWriter::BinarySolutionWriter(std::ostream* out)
+    : out_(out), bytes_(0), variable_count_(0)
+{
+}
+
+size_t BinarySolutionWriter::file_size(size_t metadata_size,
+                                       size_t variable_count,
+                                       const SolutionEncoding& encoding,
+                                       size_t solution_count)
+{
+  return sizeof(Header) + padded(metadata_size) +
+         padded(variable_count * sizeof(int32_t)) +
+         solution_count *
+             padded(sizeof(double) + values_size(encoding, variable_count));
+}
+
+void BinarySolutionWriter::write(const void* data, size_t size)
+{
+  bytes_ += size;
+  if (out_ != nullptr && size > 0)
+  {
+    out_->write(static_cast<const char*>(data), (std::streamsize)size);
+  }
+}
+
+void BinarySolutionWriter::pad()
+{
+  static const char kPadding[8] = {0};
+  write(kPadding, padded(bytes_) - bytes_);
+}
+
+void BinarySolutionWriter::write_header(const std::string& metadata,
+                                        double cost,
+                                        const std::vector<int>& names,
+                                        const SolutionEncoding& encoding,
+                                        size_t solution_count)
+{
+  if (!is_valid(encoding.type))
+  {
+    THROW(utils::ValueException, "Unknown solution encoding ",
+          (uint32_t)encoding.type, ".");
+  }
+  encoding_ = encoding;
+  variable_count_ = names.size();
+
+  Header header;
+  std::memset(&header, 0, sizeof(Header));
+  std::memcpy(header.magic, kMagic, sizeof(kMagic));
+  header.format_version = kBinarySolutionFormatVersion;
+  header.byte_order = kByteOrderMark;
+  header.encoding = encoding.type;
+  header.bit_values[0] = encoding.bit_values[0];
+  header.bit_values[1] = encoding.bit_values[1];
+  header.variable_count = names.size();
+  header.solution_count = solution_count;
+  header.metadata_size = metadata.size();
+  header.cost = cost;
+  write(&header, sizeof(Header));
+  write(metadata.data(), metadata.size());
+  pad();
+  std::vector<int32_t> names32(names.begin(), names.end());
+  write(names32.data(), names32.size() * sizeof(int32_t));
+  pad();
+}
+
+void BinarySolutionWriter::write_solution(double cost,
+                                          const std::vector<int>& values)
+{
+  if (values.size() != variable_count_)
+  {
+    THROW(utils::ValueException, "Expected ", variable_count_,
+          " values in binary solution, got ", values.size(), ".");
+  }
+  buffer_.assign(values_size(encoding_, variable_count_), 0);
+  for (size_t i = 0; i < values.size(); i++)
+  {
+    int value = values[i];
+    if (encoding_.type == SolutionEncoding::BITS)
+    {
+      if (value == encoding_.bit_values[1])
+      {
+        buffer_[i / 8] |= (uint8_t)(1 << (i % 8));
+      }
+      else if (value != encoding_.bit_values[0])
+      {
+        THROW(utils::ValueException, "Value ", value,
+              " cannot be written as a bit (expected ",
+              encoding_.bit_values[0], " or ", encoding_.bit_values[1],
+              ").");
+      }
+    }
+    else if (encoding_.type == SolutionEncoding::INT8)
+    {
+      if (value < INT8_MIN || value > INT8_MAX)
+      {
+        THROW(utils::ValueException, "Value ", value,
+              " cannot be written as int8.");
+      }
+      buffer_[i] = (uint8_t)(int8_t)value;
+    }
+    else if (encoding_.type == SolutionEncoding::INT16)
+    {
+      if (value < INT16_MIN || value > INT16_MAX)
+      {
+        THROW(utils::ValueException, "Value ", value,
+              " cannot be written as int16.");
+      }
+      int16_t value16 = (int16_t)value;
+      std::memcpy(&buffer_[i * sizeof(int16_t)], &value16, sizeof(int16_t));
+    }
+    else
+    {
+      int32_t value32 = (int32_t)value;
+      std::memcpy(&buffer_[i * sizeof(int32_t)], &value32, sizeof(int32_t));
+    }
+  }
+  write(&cost, sizeof(double));
+  write(buffer_.data(), buffer_.size());
+  pad();
+}
+
+void BinarySolutionReader::open(const std::string& file_name)
+{
+  file_.open(file_name);
+  const char* data = file_.data();
+  size_t size = file_.size();
+  if (size < sizeof(Header) ||
+      std::memcmp(data, kMagic, sizeof(kMagic)) != 0)
+  {
+    THROW(utils::ParsingException, "File ", file_name,
+          " is not a binary solution file.");
+  }
+  Header header;
+  std::memcpy(&header, data, sizeof(Header));
+  if (header.format_version != kBinarySolutionFormatVersion)
+  {
+    THROW(utils::ParsingException,
+          "Unsupported binary solution format version ",
+          header.format_version, " in ", file_name, " (expected ",
+          kBinarySolutionFormatVersion, ").");
+  }
+  if (header.byte_order != kByteOrderMark)
+  {
+    THROW(utils::ParsingException, "Binary solution file ", file_name,
+          " was written with a different byte order.");
+  }
+  if (!is_valid(header.encoding))
+  {
+    THROW(utils::ParsingException, "Unknown encoding ", header.encoding,
+          " in binary solution file ", file_name, ".");
+  }
+  encoding_.type = (SolutionEncoding::Type)header.encoding;
+  encoding_.bit_values[0] = header.bit_values[0];
+  encoding_.bit_values[1] = header.bit_values[1];
+  cost_ = header.cost;
+  solution_count_ = header.solution_count;
+
+  size_t pos = sizeof(Header);
+  size_t remaining = size - pos;
+  if (header.metadata_size > remaining ||
+      header.variable_count > remaining / sizeof(int32_t))
+  {
+    THROW(utils::ParsingException, "Binary solution file ", file_name,
+          " is truncated or corrupt.");
+  }
+  metadata_.assign(data + pos, header.metadata_size);
+  pos += padded(header.metadata_size);
+  size_t names_size = padded(header.variable_count * sizeof(int32_t));
+  solution_size_ =
+      sizeof(double) + padded(values_size(encoding_, header.variable_count));
+  if (pos + names_size > size ||
+      header.solution_count > (size - pos - names_size) / solution_size_)
+  {
+    THROW(utils::ParsingException, "Binary solution file ", file_name,
+          " is truncated or corrupt.");
+  }
+  const int32_t* names = reinterpret_cast<const int32_t*>(data + pos);
+  names_.assign(names, names + header.variable_count);
+  solutions_ = data + pos + names_size;
+}
+
+const char* BinarySolutionReader::solution(size_t index) const
+{
+  if (index >= solution_count_)
+  {
+    THROW(utils::IndexOutOfRangeException, "Accessing solution ", index,
+          " of ", solution_count_, ".");
+  }
+  return solutions_ + index * solution_size_;
+}
+
+double BinarySolutionReader::solution_cost(size_t index) const
+{
+  double cost;
+  std::memcpy(&cost, solution(index), sizeof(double));
+  return cost;
+}
+
+std::vector<int> BinarySolutionReader::solution_values(size_t index) const
+{
+  const uint8_t* data =
+      reinterpret_cast<const uint8_t*>(solution(index) + sizeof(double));
+  std::vector<int> values(names_.size());
+  for (size_t i = 0; i < values.size(); i++)
+  {
+    if (encoding_.type == SolutionEncoding::BITS)
+    {
+      values[i] = encoding_.bit_values[(data[i / 8] >> (i % 8)) & 1];
+    }
+    else if (encoding_.type == SolutionEncoding::INT8)
+    {
+      values[i] = (int8_t)data[i];
+    }
+    else if (encoding_.type == SolutionEncoding::INT16)
+    {
+      int16_t value;
+      std::memcpy(&value, data + i * sizeof(int16_t), sizeof(int16_t));
+      values[i] = value;
+    }
+    else
+    {
+      int32_t value;
+      std::memcpy(&value, data + i * sizeof(int32_t), sizeof(int32_t));
+      values[i] = value;
+    }
+  }
+  return values;
+}
+
+}  // namespace utils
@@ -0,0 +1,136 @@
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "utils/mapped_file.h"
+
+namespace utils
+{
+/// File extension conventionally used for binary solution files.
+constexpr char kBinarySolutionExtension[] = ".qios";
+
+/// Current version of the binary solution format.
+constexpr uint32_t kBinarySolutionFormatVersion = 1;
+
+/// How the values of the variables are stored in a binary solution file.
+struct SolutionEncoding
+{
+  enum Type : uint32_t
+  {
+    BITS = 1,   // one bit per variable, representing one of `bit_values`
+    INT8 = 2,   // one signed byte per variable
+    INT16 = 3,  // one int16 per variable
+    INT32 = 4,  // one int32 per variable
+  };
+
+  Type type = INT8;
+  // The values represented by a 0 and a 1 bit (for BITS).
+  int32_t bit_values[2] = {0, 1};
+
+  /// The smallest integer encoding representing all values in [min, max].
+  static Type smallest_int(int64_t min, int64_t max)
+  {
+    if (min >= INT8_MIN && max <= INT8_MAX) return INT8;
+    if (min >= INT16_MIN && max <= INT16_MAX) return INT16;
+    return INT32;
+  }
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// Binary solution file
+///
+/// A compact alternative to the json response for large solutions, which
+/// stores
+///
+///   * a fixed-size header with the encoding, the number of variables and
+///     solutions and the lowest cost,
+///   * the metadata: the response in json form, without the configurations
+///     (i.e., the benchmark, solver parameters and the solution costs),
+///   * the input name of each variable (written once) and
+///   * for each solution its cost, followed by the value of each variable
+///     (in the order of the names), as bits (least significant first) or
+///     int8, int16 or int32 values.
+///
+/// All values are stored in native (little-endian) byte order and every
+/// section is 8-byte aligned.
+///
+class BinarySolutionWriter
+{
+ public:
+  /// Create a writer for `out` (or one only counting bytes if `out` is
+  /// nullptr).
+  explicit BinarySolutionWriter(std::ostream* out);
+
+  /// Write the header, metadata and variable names.
+  void write_header(const std::string& metadata, double cost,
+                    const std::vector<int>& names,
+                    const SolutionEncoding& encoding, size_t solution_count);
+
+  /// Write the next solution (with one value per variable).
+  ///
+  /// Throws a ValueException if a value cannot be represented in the
+  /// encoding.
+  void write_solution(double cost, const std::vector<int>& values);
+
+  /// Number of bytes written so far.
+  size_t bytes_written() const { return bytes_; }
+
+  /// Size of a file with `metadata_size` bytes of metadata and
+  /// `solution_count` solutions of `variable_count` variables (which does
+  /// not depend on their values).
+  static size_t file_size(size_t metadata_size, size_t variable_count,
+                          const SolutionEncoding& encoding,
+                          size_t solution_count);
+
+ private:
+  void write(const void* data, size_t size);
+  void pad();
+
+  std::ostream* out_;
+  size_t bytes_;
+  SolutionEncoding encoding_;
+  size_t variable_count_;
+  std::vector<uint8_t> buffer_;
+};
+
+/// Reads the files written by `BinarySolutionWriter`.
+class BinarySolutionReader
+{
+ public:
+  /// Map and validate `file_name`.
+  ///
+  /// Throws a ParsingException if the file is not a valid binary solution.
+  void open(const std::string& file_name);
+
+  const std::string& metadata() const { return metadata_; }
+  double cost() const { return cost_; }
+  const SolutionEncoding& encoding() const { return encoding_; }
+  const std::vector<int>& names() const { return names_; }
+  size_t solution_count() const { return solution_count_; }
+
+  /// Cost of solution `index`.
+  double solution_cost(size_t index) const;
+
+  /// Values of solution `index` (in the order of `names()`).
+  std::vector<int> solution_values(size_t index) const;
+
+ private:
+  const char* solution(size_t index) const;
+
+  MappedFile file_;
+  std::string metadata_;
+  double cost_;
+  SolutionEncoding encoding_;
+  std::vector<int> names_;
+  size_t solution_count_;
+  size_t solution_size_;
+  const char* solutions_;
+};
+
+}  // namespace utils
@@ -88,4 +88,27 @@ bool feature_enabled(int feature_id)
   return g_features.feature_enabled(feature_id);
 }
 
+ScopedFeatures::ScopedFeatures()
+{
+  for (int id = 0; id < Features::FEATURE_COUNT; id++)
+  {
+    if (g_features.feature_enabled(id)) enabled_.insert(id);
+  }
+}
+
+ScopedFeatures::~ScopedFeatures()
+{
+  for (int id = 0; id < Features::FEATURE_COUNT; id++)
+  {
+    if (enabled_.count(id) > 0)
+    {
+      g_features.set_enabled_feature(id);
+    }
+    else
+    {
+      g_features.set_disabled_feature(id);
+    }
+  }
+}
+
 }  // namespace utils
@@ -39,8 +39,11 @@ const char* const kAccumDependentVars = "accumulated_dependent_vars";
 const char* const kTotalLocality = "sum_coefficient_degrees_total";
 const char* const kMaxCouplingMagnitude = "max_coupling_magnitude";
 const char* const kMinCouplingMagnitude = "min_coupling_magnitude";
+const char* const kMergedTerms = "merged_terms";
+const char* const kCancelledTerms = "cancelled_terms";
 const char* const kPreprocessingMs = "preprocessing_time_ms";
 const char* const kPostprocessingMs = "postprocessing_time_ms";
+const char* const kPhases = "phases";
 
 const char* const kModel = "model";
 
@@ -56,8 +59,10 @@ enum Features
   FEATURE_PA_EXP_REPOPULATION = 2,
   // USE memory saving model
   FEATURE_USE_MEMORY_SAVING = 3,
+  // Record hardware counters for each phase (see utils/instrumentation.h)
+  FEATURE_PERF_COUNTERS = 4,
   // new feature much be added right before FEATURE_COUNT
-  FEATURE_COUNT = 4
+  FEATURE_COUNT = 5
 };
 void initialize_features();
 
@@ -66,4 +71,22 @@ void set_enabled_feature(const std::set<int>& features);
 bool feature_disabled(int feature_id);
 bool feature_enabled(int feature_id);
 
+/// Restores the features enabled at construction when leaving scope, such
+/// that features set by one run (in its parameters or by the memory saving
+/// retry of `app::Runner`) do not apply to the following runs.
+///
+/// NOTE: Features are process-wide; they must not be changed while other
+/// threads run.
+class ScopedFeatures
+{
+ public:
+  ScopedFeatures();
+  ~ScopedFeatures();
+  ScopedFeatures(const ScopedFeatures&) = delete;
+  ScopedFeatures& operator=(const ScopedFeatures&) = delete;
+
+ private:
+  std::set<int> enabled_;
+};
+
 }  // namespace utils
@@ -0,0 +1,367 @@
+
+#include "utils/dimacs_reader.h"
+
+#include <omp.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+#include <atomic>
+#include <climits>
+#include <cmath>
+
+#include "utils/dimacs.h"
+#include "utils/exception.h"
+#include "utils/mapped_file.h"
+
+namespace utils
+{
+namespace
+{
+inline bool is_space(char c)
+{
+  return c == ' ' || c == '\n' || c == '\r' || c == '\t' || c == '\v' ||
+         c == '\f';
+}
+
+inline void skip_space(const char* data, size_t end, size_t& pos)
+{
+  while (pos < end && is_space(data[pos])) pos++;
+}
+
+inline void skip_line(const char* data, size_t end, size_t& pos)
+{
+  while (pos < end && data[pos] != '\n' && data[pos] != '\r') pos++;
+}
+
+// Parse a decimal integer token ending in whitespace (or `end`).
+inline bool parse_int(const char* data, size_t end, size_t& pos, int& value)
+{
+  bool negative = data[pos] == '-';
+  size_t p = pos + negative;
+  size_t start = p;
+  int64_t result = 0;
+  while (p < end && (unsigned)(data[p] - '0') < 10)
+  {
+    result = result * 10 + (data[p] - '0');
+    if (result > INT_MAX) return false;
+    p++;
+  }
+  if (p == start || (p < end && !is_space(data[p]))) return false;
+  value = (int)(negative ? -result : result);
+  pos = p;
+  return true;
+}
+
+// Parse a floating point token ending in whitespace (or `end`).
+inline bool parse_double(const char* data, size_t end, size_t& pos,
+                         double& value)
+{
+  size_t p = pos;
+  while (p < end && !is_space(data[p])) p++;
+  size_t length = p - pos;
+  char buffer[64];
+  if (length == 0 || length >= sizeof(buffer)) return false;
+  // The mapped data is not null-terminated.
+  memcpy(buffer, data + pos, length);
+  buffer[length] = '\0';
+  char* parsed_end;
+  value = strtod(buffer, &parsed_end);
+  if (parsed_end != buffer + length) return false;
+  pos = p;
+  return true;
+}
+
+struct Chunk
+{
+  std::vector<double> weights;
+  std::vector<uint64_t> sizes;
+  std::vector<int> literals;
+  int max_name = 0;
+};
+
+// Parse the clauses in [begin, end), which must start and end at clause
+// boundaries. Returns false for anything that is not a well-formed clause on
+// its own line(s) (or a comment line).
+bool parse_chunk(const char* data, size_t begin, size_t end, bool weighted,
+                 Chunk& chunk)
+{
+  size_t pos = begin;
+  std::vector<int> names;
+  while (true)
+  {
+    skip_space(data, end, pos);
+    if (pos >= end) return true;
+    if (data[pos] == 'c')
+    {
+      skip_line(data, end, pos);
+      continue;
+    }
+    double weight = 1;
+    if (weighted)
+    {
+      if (!parse_double(data, end, pos, weight)) return false;
+      skip_space(data, end, pos);
+      if (pos >= end) return false;
+    }
+    size_t first = chunk.literals.size();
+    while (true)
+    {
+      int literal;
+      if (!parse_int(data, end, pos, literal)) return false;
+      if (literal == 0) break;
+      chunk.literals.push_back(literal);
+      skip_space(data, end, pos);
+      if (pos >= end) return false;
+    }
+    size_t size = chunk.literals.size() - first;
+    if (size == 0) return false;
+    // Repeated variables are rejected by utils::Dimacs (with a message).
+    names.clear();
+    for (size_t i = first; i < chunk.literals.size(); i++)
+    {
+      names.push_back(std::abs(chunk.literals[i]));
+    }
+    std::sort(names.begin(), names.end());
+    if (std::adjacent_find(names.begin(), names.end()) != names.end())
+    {
+      return false;
+    }
+    chunk.max_name = std::max(chunk.max_name, names.back());
+    chunk.weights.push_back(weight);
+    chunk.sizes.push_back(size);
+  }
+}
+
+// Parse the next whitespace-delimited token of the problem line.
+bool next_token(const char* data, size_t size, size_t& pos,
+                std::string& token)
+{
+  while (pos < size && (data[pos] == ' ' || data[pos] == '\t')) pos++;
+  size_t start = pos;
+  while (pos < size && !is_space(data[pos])) pos++;
+  token.assign(data + start, pos - start);
+  return !token.empty();
+}
+
+bool parse_positive(const std::string& token, uint32_t& value)
+{
+  size_t pos = 0;
+  int parsed;
+  if (!parse_int(token.data(), token.size(), pos, parsed) || parsed <= 0)
+  {
+    return false;
+  }
+  value = (uint32_t)parsed;
+  return true;
+}
+}  // namespace
+
+DimacsReader::DimacsReader() { clear(); }
+
+void DimacsReader::clear()
+{
+  nvar_ = 0;
+  ncl_ = 0;
+  type_ = "";
+  top_ = 0;
+  weights_.clear();
+  clause_offsets_.clear();
+  literals_.clear();
+  variables_.clear();
+}
+
+void DimacsReader::read_file(const std::string& filename)
+{
+  MappedFile file(filename);
+  read(file.data(), file.size());
+}
+
+size_t DimacsReader::parse_header(const char* data, size_t size)
+{
+  size_t pos = 0;
+  while (true)
+  {
+    skip_space(data, size, pos);
+    if (pos >= size) return size;
+    if (data[pos] == 'c')
+    {
+      skip_line(data, size, pos);
+    }
+    else if (data[pos] == 'p' && pos + 1 < size && data[pos + 1] == ' ')
+    {
+      break;
+    }
+    else
+    {
+      return size;
+    }
+  }
+  pos += 1;
+  std::string token;
+  if (!next_token(data, size, pos, type_) ||
+      (type_ != "cnf" && type_ != "wcnf") ||
+      !next_token(data, size, pos, token) || !parse_positive(token, nvar_) ||
+      !next_token(data, size, pos, token) || !parse_positive(token, ncl_))
+  {
+    return size;
+  }
+  top_ = 0;
+  if (type_ == "wcnf" && next_token(data, size, pos, token))
+  {
+    size_t token_pos = 0;
+    if (!parse_double(token.data(), token.size(), token_pos, top_))
+    {
+      return size;
+    }
+  }
+  if (next_token(data, size, pos, token)) return size;
+  return pos;
+}
+
+void DimacsReader::read(const char* data, size_t size)
+{
+  clear();
+  size_t begin = parse_header(data, size);
+  if (begin >= size)
+  {
+    read_with_dimacs(data, size);
+    return;
+  }
+
+  // Split the clauses into chunks at line boundaries; a clause spanning lines
+  // across a chunk boundary makes the chunk fail (and so do clauses that are
+  // invalid for any other reason).
+  size_t length = size - begin;
+  size_t n_chunks = 4 * (size_t)std::max(1, omp_get_max_threads());
+  if (length < n_chunks * 4096) n_chunks = 1;
+  std::vector<size_t> bounds(n_chunks + 1);
+  bounds[0] = begin;
+  bounds[n_chunks] = size;
+  for (size_t k = 1; k < n_chunks; k++)
+  {
+    size_t pos = std::max(bounds[k - 1], begin + k * (length / n_chunks));
+    while (pos < size && data[pos] != '\n') pos++;
+    bounds[k] = pos;
+  }
+
+  bool weighted = type_ == "wcnf";
+  std::vector<Chunk> chunks(n_chunks);
+  int failures = 0;
+  #pragma omp parallel for schedule(dynamic, 1) reduction(+ : failures)
+  for (size_t k = 0; k < n_chunks; k++)
+  {
+    if (!parse_chunk(data, bounds[k], bounds[k + 1], weighted, chunks[k]))
+    {
+      failures++;
+    }
+  }
+  if (failures > 0)
+  {
+    read_with_dimacs(data, size);
+    return;
+  }
+
+  // Concatenate the chunks.
+  std::vector<size_t> clause_starts(n_chunks + 1, 0);
+  std::vector<size_t> literal_starts(n_chunks + 1, 0);
+  int max_name = 0;
+  for (size_t k = 0; k < n_chunks; k++)
+  {
+    clause_starts[k + 1] = clause_starts[k] + chunks[k].weights.size();
+    literal_starts[k + 1] = literal_starts[k] + chunks[k].literals.size();
+    max_name = std::max(max_name, chunks[k].max_name);
+  }
+  weights_.resize(clause_starts[n_chunks]);
+  clause_offsets_.resize(clause_starts[n_chunks] + 1);
+  literals_.resize(literal_starts[n_chunks]);
+  clause_offsets_[0] = 0;
+  #pragma omp parallel for schedule(dynamic, 1)
+  for (size_t k = 0; k < n_chunks; k++)
+  {
+    Chunk& chunk = chunks[k];
+    std::copy(chunk.weights.begin(), chunk.weights.end(),
+              weights_.begin() + clause_starts[k]);
+    std::copy(chunk.literals.begin(), chunk.literals.end(),
+              literals_.begin() + literal_starts[k]);
+    uint64_t offset = literal_starts[k];
+    for (size_t i = 0; i < chunk.sizes.size(); i++)
+    {
+      offset += chunk.sizes[i];
+      clause_offsets_[clause_starts[k] + i + 1] = offset;
+    }
+    std::vector<double>().swap(chunk.weights);
+    std::vector<uint64_t>().swap(chunk.sizes);
+    std::vector<int>().swap(chunk.literals);
+  }
+
+  if (weights_.size() != ncl_)
+  {
+    THROW(utils::ValueException,
+          "Number of clauses parsed does not match: ", weights_.size(),
+          "!=", ncl_);
+  }
+
+  // Collect the variable names (with a bitmap if they are dense enough,
+  // otherwise by sorting).
+  if ((size_t)max_name <= 2 * literals_.size() + 1024)
+  {
+    std::vector<std::atomic<bool>> found(max_name + 1);
+    #pragma omp parallel for schedule(static)
+    for (size_t i = 0; i < literals_.size(); i++)
+    {
+      found[std::abs(literals_[i])].store(true, std::memory_order_relaxed);
+    }
+    for (int name = 1; name <= max_name; name++)
+    {
+      if (found[name].load(std::memory_order_relaxed))
+      {
+        variables_.push_back(name);
+      }
+    }
+  }
+  else
+  {
+    variables_.resize(literals_.size());
+    #pragma omp parallel for schedule(static)
+    for (size_t i = 0; i < literals_.size(); i++)
+    {
+      variables_[i] = std::abs(literals_[i]);
+    }
+    std::sort(variables_.begin(), variables_.end());
+    variables_.erase(std::unique(variables_.begin(), variables_.end()),
+                     variables_.end());
+    variables_.shrink_to_fit();
+  }
+  if (variables_.size() != nvar_)
+  {
+    THROW(utils::ValueException,
+          "Number of variables found does not match: ", variables_.size(),
+          "!=", nvar_);
+  }
+}
+
+void DimacsReader::read_with_dimacs(const char* data, size_t size)
+{
+  clear();
+  Dimacs dimacs;
+  dimacs.read(std::string(data, size));
+  type_ = dimacs.get_type();
+  top_ = dimacs.get_top();
+  nvar_ = dimacs.get_nvar();
+  ncl_ = dimacs.get_ncl();
+  variables_ = dimacs.get_variables();
+  const auto& clauses = dimacs.get_clauses();
+  weights_.reserve(clauses.size());
+  clause_offsets_.reserve(clauses.size() + 1);
+  clause_offsets_.push_back(0);
+  for (const auto& clause : clauses)
+  {
+    weights_.push_back(clause.weight);
+    literals_.insert(literals_.end(), clause.variables.begin(),
+                     clause.variables.end());
+    clause_offsets_.push_back(literals_.size());
+  }
+}
+
+}  // namespace utils
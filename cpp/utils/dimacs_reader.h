@@ -0,0 +1,85 @@
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+namespace utils
+{
+/// Streaming reader for the DIMACS (cnf / wcnf) format
+///
+/// Unlike `utils::Dimacs`, this maps the input file and parses the clauses
+/// (on all threads, in chunks aligned to line boundaries) directly into flat
+/// arrays instead of `Dimacs::Clause` objects:
+///
+///   * `get_weights()[i]` is the weight of clause `i`,
+///   * `get_literals()[get_clause_offsets()[i]...get_clause_offsets()[i+1]]`
+///     are its (possibly negated) variables.
+///
+/// Inputs the fast path does not handle (e.g., clauses spanning multiple
+/// lines) and malformed inputs are handed to `utils::Dimacs`, which produces
+/// the same result (or the same error message).
+class DimacsReader
+{
+ public:
+  DimacsReader();
+
+  /// Map `filename` and parse its contents.
+  void read_file(const std::string& filename);
+
+  /// Parse `size` bytes of dimacs content at `data`.
+  void read(const char* data, size_t size);
+
+  /// Get the type of the parsed problem ('cnf' or 'wcnf').
+  std::string get_type() const { return type_; }
+
+  /// Get the number of variables in the problem.
+  size_t get_nvar() const { return variables_.size(); }
+
+  /// Get the number of clauses in the problem.
+  size_t get_ncl() const { return weights_.size(); }
+
+  /// Get the value specified as top in the input (0 if not specified).
+  double get_top() const { return top_; }
+
+  /// Get the sorted list of (positive) variable names found in the clauses.
+  const std::vector<int>& get_variables() const { return variables_; }
+
+  /// Get the weight of each clause.
+  const std::vector<double>& get_weights() const { return weights_; }
+
+  /// Get the offset of each clause's literals in `get_literals()` (with an
+  /// additional entry for the end of the last clause).
+  const std::vector<uint64_t>& get_clause_offsets() const
+  {
+    return clause_offsets_;
+  }
+
+  /// Get the literals of all clauses.
+  const std::vector<int>& get_literals() const { return literals_; }
+
+  /// Return the reader to its initial state.
+  void clear();
+
+ private:
+  /// Parse the problem line (and leading comments); returns the position of
+  /// the first clause or `size` if the header is not in the expected form.
+  size_t parse_header(const char* data, size_t size);
+
+  /// Parse using `utils::Dimacs` and convert its result.
+  void read_with_dimacs(const char* data, size_t size);
+
+  uint32_t nvar_;  // the number of variables specified in the input
+  uint32_t ncl_;   // the number of clauses specified in the input
+  std::string type_;
+  double top_;
+  std::vector<double> weights_;
+  std::vector<uint64_t> clause_offsets_;
+  std::vector<int> literals_;
+  std::vector<int> variables_;
+};
+
+}  // namespace utils
@@ -0,0 +1,299 @@
+
+#include "utils/instrumentation.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "utils/config.h"
+#include "utils/log.h"
+#include "utils/timing.h"
+
+#ifdef __linux__
+#include <dirent.h>
+#include <errno.h>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace utils
+{
+struct Phase
+{
+  Phase(const char* name_, Phase* parent_)
+      : name(name_),
+        parent(parent_),
+        count(0),
+        wall_time(0),
+        cpu_time(0),
+        has_counters(false),
+        counters()
+  {
+  }
+
+  std::string name;
+  Phase* parent;
+  std::vector<std::unique_ptr<Phase>> children;
+  uint64_t count;
+  double wall_time;
+  double cpu_time;
+  bool has_counters;
+  uint64_t counters[PERF_COUNTER_COUNT];
+};
+
+namespace
+{
+const char* const kPerfCounterNames[PERF_COUNTER_COUNT] = {
+    "cycles", "instructions", "llc_misses", "branch_misses"};
+
+// Hardware counters of the process, opened (on first use) for each of its
+// threads and inherited by the threads created later (e.g., by OpenMP).
+class PerfCounters
+{
+ public:
+  PerfCounters() : available_() {}
+
+  ~PerfCounters()
+  {
+#ifdef __linux__
+    for (const auto& group : groups_)
+    {
+      for (int fd : group.fds) close(fd);
+    }
+#endif
+  }
+
+  // Whether any counter is available.
+  bool available()
+  {
+    std::call_once(opened_, [this] { open(); });
+    return !groups_.empty();
+  }
+
+  bool available(int counter) const { return available_[counter]; }
+
+  // Current totals of all threads (0 for unavailable counters).
+  void read(uint64_t values[PERF_COUNTER_COUNT]) const
+  {
+    for (int i = 0; i < PERF_COUNTER_COUNT; i++) values[i] = 0;
+#ifdef __linux__
+    for (const auto& group : groups_)
+    {
+      // PERF_FORMAT_GROUP: the number of counters followed by their values
+      // in the order in which they were added to the group (including
+      // those of the inherited threads).
+      uint64_t buffer[1 + PERF_COUNTER_COUNT];
+      if (::read(group.fds[0], buffer, sizeof(buffer)) <= 0) continue;
+      for (size_t k = 0; k < buffer[0] && k < group.members.size(); k++)
+      {
+        values[group.members[k]] += buffer[1 + k];
+      }
+    }
+#endif
+  }
+
+ private:
+  struct Group
+  {
+    std::vector<int> fds;
+    std::vector<int> members;
+  };
+
+  void open()
+  {
+#ifdef __linux__
+    // Threads created before the counters (e.g., an OpenMP thread pool) are
+    // counted by their own group, later ones inherit the counters of the
+    // thread creating them.
+    std::vector<pid_t> threads;
+    DIR* tasks = opendir("/proc/self/task");
+    if (tasks != nullptr)
+    {
+      while (struct dirent* entry = readdir(tasks))
+      {
+        if (entry->d_name[0] != '.') threads.push_back(atoi(entry->d_name));
+      }
+      closedir(tasks);
+    }
+    if (threads.empty()) threads.push_back(0);
+    int error = 0;
+    for (pid_t thread : threads)
+    {
+      Group group = open_group(thread, error);
+      if (!group.fds.empty()) groups_.push_back(group);
+    }
+    if (groups_.empty())
+    {
+      LOG(WARN, "Hardware counters are unavailable (perf_event_open: ",
+          strerror(error), ").");
+    }
+#else
+    LOG(WARN, "Hardware counters are only supported on Linux.");
+#endif
+  }
+
+#ifdef __linux__
+  Group open_group(pid_t thread, int& error)
+  {
+    // PERF_COUNT_HW_CACHE_MISSES usually counts last level cache misses.
+    const uint64_t kEvents[PERF_COUNTER_COUNT] = {
+        PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+        PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES};
+    Group group;
+    for (int i = 0; i < PERF_COUNTER_COUNT; i++)
+    {
+      struct perf_event_attr attr;
+      memset(&attr, 0, sizeof(attr));
+      attr.size = sizeof(attr);
+      attr.type = PERF_TYPE_HARDWARE;
+      attr.config = kEvents[i];
+      attr.disabled = group.fds.empty() ? 1 : 0;
+      attr.inherit = 1;
+      attr.exclude_kernel = 1;
+      attr.exclude_hv = 1;
+      attr.read_format = PERF_FORMAT_GROUP;
+      int leader = group.fds.empty() ? -1 : group.fds[0];
+      int fd = (int)syscall(__NR_perf_event_open, &attr, thread, -1, leader, 0);
+      if (fd < 0)
+      {
+        error = errno;
+        continue;
+      }
+      group.fds.push_back(fd);
+      group.members.push_back(i);
+      available_[i] = true;
+    }
+    if (!group.fds.empty())
+    {
+      ioctl(group.fds[0], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+      ioctl(group.fds[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    }
+    return group;
+  }
+#endif
+
+  std::once_flag opened_;
+  bool available_[PERF_COUNTER_COUNT];
+  std::vector<Group> groups_;
+};
+
+PerfCounters& process_counters()
+{
+  static PerfCounters counters;
+  return counters;
+}
+
+// Phases of one thread.
+struct Profile
+{
+  Profile() : root("", nullptr), current(&root), paused(0) {}
+
+  Phase root;
+  Phase* current;
+  // Number of `ScopedPhasesPaused` in scope
+  int paused;
+};
+
+thread_local Profile t_profile;
+
+Structure render(const Phase& phase, const PerfCounters& perf)
+{
+  Structure s(Structure::OBJECT);
+  for (const auto& child : phase.children)
+  {
+    Structure& rendered = s[child->name];
+    rendered["count"] = child->count;
+    rendered["wall_ms"] = 1000 * child->wall_time;
+    rendered["cpu_ms"] = 1000 * child->cpu_time;
+    if (child->has_counters)
+    {
+      for (int i = 0; i < PERF_COUNTER_COUNT; i++)
+      {
+        if (perf.available(i))
+        {
+          rendered[kPerfCounterNames[i]] = child->counters[i];
+        }
+      }
+    }
+    if (!child->children.empty())
+    {
+      rendered["phases"] = render(*child, perf);
+    }
+  }
+  return s;
+}
+}  // namespace
+
+ScopedPhase::ScopedPhase(const char* name) : phase_(nullptr), counting_(false)
+{
+  Profile& profile = t_profile;
+  if (profile.paused > 0) return;
+  Phase* parent = profile.current;
+  for (const auto& child : parent->children)
+  {
+    if (child->name == name)
+    {
+      phase_ = child.get();
+      break;
+    }
+  }
+  if (phase_ == nullptr)
+  {
+    parent->children.emplace_back(new Phase(name, parent));
+    phase_ = parent->children.back().get();
+  }
+  profile.current = phase_;
+
+  PerfCounters& perf = process_counters();
+  counting_ =
+      feature_enabled(Features::FEATURE_PERF_COUNTERS) && perf.available();
+  if (counting_) perf.read(start_counters_);
+  start_cpu_time_ = get_cpu_time();
+  start_wall_time_ = get_wall_time();
+}
+
+ScopedPhase::~ScopedPhase()
+{
+  if (phase_ == nullptr) return;
+  phase_->wall_time += get_wall_time() - start_wall_time_;
+  phase_->cpu_time += get_cpu_time() - start_cpu_time_;
+  phase_->count++;
+  Profile& profile = t_profile;
+  if (counting_)
+  {
+    uint64_t counters[PERF_COUNTER_COUNT];
+    process_counters().read(counters);
+    for (int i = 0; i < PERF_COUNTER_COUNT; i++)
+    {
+      phase_->counters[i] += counters[i] - start_counters_[i];
+    }
+    phase_->has_counters = true;
+  }
+  profile.current = phase_->parent;
+}
+
+ScopedPhasesPaused::ScopedPhasesPaused() { t_profile.paused++; }
+
+ScopedPhasesPaused::~ScopedPhasesPaused() { t_profile.paused--; }
+
+void reset_phases()
+{
+  Profile& profile = t_profile;
+  // Open phases still refer to the current tree.
+  if (profile.current != &profile.root) return;
+  profile.root.children.clear();
+}
+
+Structure render_phases()
+{
+  Profile& profile = t_profile;
+  return render(profile.root, process_counters());
+}
+
+}  // namespace utils
@@ -0,0 +1,90 @@
+
+#pragma once
+
+#include <stdint.h>
+
+#include "utils/structure.h"
+
+namespace utils
+{
+/// Hardware counters recorded for each phase when the
+/// `FEATURE_PERF_COUNTERS` feature is enabled (Linux only).
+enum PerfCounter
+{
+  PERF_CYCLES = 0,
+  PERF_INSTRUCTIONS = 1,
+  PERF_LLC_MISSES = 2,
+  PERF_BRANCH_MISSES = 3,
+  PERF_COUNTER_COUNT = 4
+};
+
+struct Phase;
+
+////////////////////////////////////////////////////////////////////////////////
+/// Scoped phase
+///
+/// Measures the wall time, cpu time and (optionally) hardware counters spent
+/// in a phase of the run until the object leaves scope:
+///
+///   ```cpp
+///   {
+///     utils::ScopedPhase phase("model_init");
+///     model->init();
+///   }
+///   ```
+///
+/// Phases opened while another phase is open are recorded as its children;
+/// repeated phases of the same name (e.g., each batch of steps) are
+/// accumulated. The phases are recorded per thread (such that concurrent
+/// runs do not mix) and should only be opened outside of parallel regions;
+/// code which may open phases (e.g., a solver run) is wrapped in
+/// `ScopedPhasesPaused` when it runs inside one.
+///
+/// NOTE: The cpu time and the hardware counters are those of the process
+/// (all threads, including concurrent runs).
+///
+class ScopedPhase
+{
+ public:
+  explicit ScopedPhase(const char* name);
+  ~ScopedPhase();
+  ScopedPhase(const ScopedPhase&) = delete;
+  ScopedPhase& operator=(const ScopedPhase&) = delete;
+
+ private:
+  Phase* phase_;
+  bool counting_;
+  double start_wall_time_;
+  double start_cpu_time_;
+  uint64_t start_counters_[PERF_COUNTER_COUNT];
+};
+
+/// Phases opened by the calling thread while this object is in scope are not
+/// recorded (they are accounted to the enclosing phase).
+class ScopedPhasesPaused
+{
+ public:
+  ScopedPhasesPaused();
+  ~ScopedPhasesPaused();
+  ScopedPhasesPaused(const ScopedPhasesPaused&) = delete;
+  ScopedPhasesPaused& operator=(const ScopedPhasesPaused&) = delete;
+};
+
+/// Discard the phases recorded by the calling thread (this has no effect
+/// while a phase is open).
+void reset_phases();
+
+/// Render the phases recorded by the calling thread:
+///
+///   {
+///     "model_init": {"count": 1, "cpu_ms": 2.1, "wall_ms": 2.0,
+///                    "phases": {"normalize_edges": {...}}},
+///     "steps": {"count": 12, "cpu_ms": ..., "wall_ms": ...,
+///               "cycles": ..., "instructions": ..., "llc_misses": ...,
+///               "branch_misses": ...},
+///     ...
+///   }
+///
+Structure render_phases();
+
+}  // namespace utils
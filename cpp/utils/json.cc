@@ -4,6 +4,7 @@
 #include <cstdio>
 
 #include "utils/exception.h"
+#include "utils/instrumentation.h"
 #include "utils/operating_system.h"
 #include "rapidjson/error/en.h"
 #include "rapidjson/stringbuffer.h"
@@ -32,6 +33,7 @@ JsonDocument json_from_string(const char* buffer)
 
 void memory_check_using_file_size(const std::string& filename, double mult)
 {
+  ScopedPhase phase("memory_check");
   size_t available_memory = utils::get_available_memory();
   bool file_size_found = false;
   size_t file_size = utils::get_file_size(filename, file_size_found);
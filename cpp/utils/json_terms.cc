@@ -0,0 +1,340 @@
+
+#include "utils/json_terms.h"
+
+#include <omp.h>
+#include <string.h>
+
+#include <algorithm>
+#include <climits>
+
+#include "rapidjson/memorystream.h"
+#include "rapidjson/reader.h"
+
+namespace utils
+{
+namespace
+{
+inline bool is_space(char c)
+{
+  return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+}
+
+inline void skip_space(const char* data, size_t end, size_t& pos)
+{
+  while (pos < end && is_space(data[pos])) pos++;
+}
+
+// Advance `pos` past the string starting at `pos` (which must be '"').
+bool skip_string(const char* data, size_t end, size_t& pos)
+{
+  for (pos++; pos < end; pos++)
+  {
+    if (data[pos] == '\\')
+    {
+      pos++;
+    }
+    else if (data[pos] == '"')
+    {
+      pos++;
+      return true;
+    }
+  }
+  return false;
+}
+
+// Advance `pos` past the value starting at `pos`.
+bool skip_value(const char* data, size_t end, size_t& pos)
+{
+  if (pos >= end) return false;
+  char c = data[pos];
+  if (c == '"') return skip_string(data, end, pos);
+  if (c != '{' && c != '[')
+  {
+    // Number or literal.
+    while (pos < end && data[pos] != ',' && data[pos] != '}' &&
+           data[pos] != ']' && !is_space(data[pos]))
+    {
+      pos++;
+    }
+    return true;
+  }
+  size_t depth = 0;
+  while (pos < end)
+  {
+    c = data[pos];
+    if (c == '"')
+    {
+      if (!skip_string(data, end, pos)) return false;
+      continue;
+    }
+    if (c == '{' || c == '[')
+    {
+      depth++;
+    }
+    else if (c == '}' || c == ']')
+    {
+      if (--depth == 0)
+      {
+        pos++;
+        return true;
+      }
+    }
+    pos++;
+  }
+  return false;
+}
+
+bool parse_int(const char* data, size_t end, size_t& pos, int& value)
+{
+  bool negative = false;
+  if (pos < end && data[pos] == '-')
+  {
+    negative = true;
+    pos++;
+  }
+  size_t start = pos;
+  long long result = 0;
+  while (pos < end && data[pos] >= '0' && data[pos] <= '9')
+  {
+    result = result * 10 + (data[pos] - '0');
+    if (result > (long long)INT_MAX + 1) return false;
+    pos++;
+  }
+  if (pos == start) return false;
+  if (negative) result = -result;
+  if (result > INT_MAX || result < INT_MIN) return false;
+  value = (int)result;
+  return true;
+}
+
+// Receives the single number read by `parse_double`.
+struct NumberHandler
+    : public rapidjson::BaseReaderHandler<rapidjson::UTF8<>, NumberHandler>
+{
+  double value = 0;
+  bool Default() { return false; }
+  bool Int(int i) { return set(i); }
+  bool Uint(unsigned u) { return set(u); }
+  bool Int64(int64_t i) { return set((double)i); }
+  bool Uint64(uint64_t u) { return set((double)u); }
+  bool Double(double d) { return set(d); }
+  bool set(double d)
+  {
+    value = d;
+    return true;
+  }
+};
+
+bool parse_double(const char* data, size_t end, size_t& pos, double& value)
+{
+  // Only accept JSON number characters; the number itself is converted by
+  // rapidjson (unlike strtod, this does not depend on the locale and yields
+  // the same value as the streaming parser).
+  size_t stop = pos;
+  while (stop < end && ((data[stop] >= '0' && data[stop] <= '9') ||
+                        data[stop] == '-' || data[stop] == '+' ||
+                        data[stop] == '.' || data[stop] == 'e' ||
+                        data[stop] == 'E'))
+  {
+    stop++;
+  }
+  if (stop == pos || stop >= end) return false;
+  rapidjson::MemoryStream number(data + pos, stop - pos);
+  rapidjson::Reader reader;
+  NumberHandler handler;
+  if (reader.Parse<rapidjson::kParseStopWhenDoneFlag>(number, handler)
+          .IsError() ||
+      number.Tell() != stop - pos)
+  {
+    return false;
+  }
+  value = handler.value;
+  pos = stop;
+  return true;
+}
+
+bool parse_term(const char* data, size_t end, size_t& pos, JsonTerm& term)
+{
+  // data[pos] == '{'
+  pos++;
+  bool has_c = false, has_ids = false;
+  term.ids.clear();
+  while (true)
+  {
+    skip_space(data, end, pos);
+    if (pos >= end || data[pos] != '"') return false;
+    size_t key_begin = ++pos;
+    while (pos < end && data[pos] != '"' && data[pos] != '\\') pos++;
+    if (pos >= end || data[pos] != '"') return false;
+    size_t key_length = pos - key_begin;
+    pos++;
+    skip_space(data, end, pos);
+    if (pos >= end || data[pos] != ':') return false;
+    pos++;
+    skip_space(data, end, pos);
+    if (key_length == 1 && data[key_begin] == 'c' && !has_c)
+    {
+      if (!parse_double(data, end, pos, term.c)) return false;
+      has_c = true;
+    }
+    else if (key_length == 3 && strncmp(data + key_begin, "ids", 3) == 0 &&
+             !has_ids)
+    {
+      if (pos >= end || data[pos] != '[') return false;
+      pos++;
+      skip_space(data, end, pos);
+      if (pos < end && data[pos] == ']')
+      {
+        pos++;
+      }
+      else
+      {
+        while (true)
+        {
+          int id;
+          if (!parse_int(data, end, pos, id)) return false;
+          term.ids.push_back(id);
+          skip_space(data, end, pos);
+          if (pos >= end) return false;
+          if (data[pos] == ']')
+          {
+            pos++;
+            break;
+          }
+          if (data[pos] != ',') return false;
+          pos++;
+          skip_space(data, end, pos);
+        }
+      }
+      has_ids = true;
+    }
+    else
+    {
+      return false;
+    }
+    skip_space(data, end, pos);
+    if (pos >= end) return false;
+    if (data[pos] == '}')
+    {
+      pos++;
+      return has_c && has_ids;
+    }
+    if (data[pos] != ',') return false;
+    pos++;
+  }
+}
+
+// Parse the terms in [begin, end); `begin` is the start of a term (or the
+// closing bracket of the array, if `last`).
+bool parse_chunk(const char* data, size_t begin, size_t end, size_t array_end,
+                 bool last, std::vector<JsonTerm>& terms)
+{
+  size_t pos = begin;
+  JsonTerm term;
+  while (pos < end)
+  {
+    if (data[pos] != '{') return false;
+    if (!parse_term(data, array_end, pos, term)) return false;
+    terms.push_back(term);
+    skip_space(data, array_end, pos);
+    if (pos < array_end && data[pos] == ',')
+    {
+      pos++;
+      skip_space(data, array_end, pos);
+      if (pos >= array_end || data[pos] != '{') return false;
+    }
+    else if (!(last && pos == array_end))
+    {
+      return false;
+    }
+  }
+  return pos == end;
+}
+}  // namespace
+
+bool find_json_member(const char* data, size_t size,
+                      const std::vector<std::string>& path, JsonSpan& span)
+{
+  size_t pos = 0;
+  for (const auto& key : path)
+  {
+    skip_space(data, size, pos);
+    if (pos >= size || data[pos] != '{') return false;
+    pos++;
+    bool found = false;
+    while (!found)
+    {
+      skip_space(data, size, pos);
+      if (pos >= size || data[pos] != '"') return false;
+      size_t key_begin = pos + 1;
+      if (!skip_string(data, size, pos)) return false;
+      size_t key_length = pos - 1 - key_begin;
+      skip_space(data, size, pos);
+      if (pos >= size || data[pos] != ':') return false;
+      pos++;
+      skip_space(data, size, pos);
+      if (key_length == key.size() &&
+          memcmp(data + key_begin, key.data(), key_length) == 0)
+      {
+        found = true;
+        break;
+      }
+      if (!skip_value(data, size, pos)) return false;
+      skip_space(data, size, pos);
+      if (pos >= size || data[pos] != ',') return false;
+      pos++;
+    }
+  }
+  span.begin = pos;
+  if (!skip_value(data, size, pos)) return false;
+  span.end = pos;
+  return true;
+}
+
+bool parse_json_terms(const char* data, const JsonSpan& span,
+                      std::vector<std::vector<JsonTerm>>& chunks)
+{
+  chunks.clear();
+  if (span.end - span.begin < 2 || data[span.begin] != '[' ||
+      data[span.end - 1] != ']')
+  {
+    return false;
+  }
+  size_t first = span.begin + 1;
+  size_t array_end = span.end - 1;  // position of the closing bracket
+  skip_space(data, array_end, first);
+
+  // Split at term boundaries: terms cannot contain '{' in the supported form,
+  // so the next '{' after any position starts a term. (If the input is not in
+  // that form, parse_chunk fails.)
+  size_t n_chunks = 4 * (size_t)omp_get_max_threads();
+  size_t length = array_end - first;
+  if (length < n_chunks * 64) n_chunks = 1;
+  std::vector<size_t> bounds(n_chunks + 1);
+  bounds[0] = first;
+  bounds[n_chunks] = array_end;
+  for (size_t k = 1; k < n_chunks; k++)
+  {
+    size_t pos = std::max(bounds[k - 1], first + k * (length / n_chunks));
+    const void* next = memchr(data + pos, '{', array_end - pos);
+    bounds[k] = next == nullptr
+                    ? array_end
+                    : (size_t)(static_cast<const char*>(next) - data);
+  }
+
+  chunks.resize(n_chunks);
+  int failures = 0;
+  #pragma omp parallel for schedule(dynamic, 1) reduction(+ : failures)
+  for (size_t k = 0; k < n_chunks; k++)
+  {
+    bool last = bounds[k + 1] == array_end;
+    if (!parse_chunk(data, bounds[k], bounds[k + 1], array_end, last,
+                     chunks[k]))
+    {
+      failures++;
+    }
+  }
+  return failures == 0;
+}
+
+}  // namespace utils
@@ -0,0 +1,43 @@
+
+#pragma once
+
+#include <stddef.h>
+
+#include <string>
+#include <vector>
+
+namespace utils
+{
+/// Byte range `[begin, end)` of a value within a JSON document.
+struct JsonSpan
+{
+  size_t begin;
+  size_t end;
+};
+
+/// Locate the value at `path` (a sequence of object keys) in a JSON document.
+///
+/// This is a structural scan (strings and nesting only; values are not
+/// decoded or validated), which is much faster than parsing the document.
+/// Returns false if the path does not exist or the document is malformed.
+bool find_json_member(const char* data, size_t size,
+                      const std::vector<std::string>& path, JsonSpan& span);
+
+/// A term as found in a `terms` array: `{"c": <number>, "ids": [<int>...]}`.
+struct JsonTerm
+{
+  double c;
+  std::vector<int> ids;
+};
+
+/// Parse the `terms` array spanning `span` using all threads.
+///
+/// The array is split into chunks at term boundaries which are parsed
+/// concurrently. Only the strict `{"c": ..., "ids": [...]}` form is
+/// supported; returns false if anything else is encountered (the caller is
+/// expected to fall back to the streaming parser, which also produces the
+/// appropriate error messages).
+bool parse_json_terms(const char* data, const JsonSpan& span,
+                      std::vector<std::vector<JsonTerm>>& chunks);
+
+}  // namespace utils
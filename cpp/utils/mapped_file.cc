@@ -0,0 +1,139 @@
+
+#include "utils/mapped_file.h"
+
+#include "utils/exception.h"
+
+#ifdef _WIN32
+// clang-format off
+#include <windows.h>
+// clang-format on
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace utils
+{
+// Used to map empty files (which cannot be mmap'ed) to a valid address.
+static const char kEmptyContent[1] = {0};
+
+MappedFile::MappedFile()
+    : data_(nullptr),
+      size_(0)
+#ifdef _WIN32
+      ,
+      file_handle_(nullptr),
+      mapping_handle_(nullptr)
+#endif
+{
+}
+
+MappedFile::MappedFile(const std::string& file_name) : MappedFile()
+{
+  open(file_name);
+}
+
+MappedFile::~MappedFile() { close(); }
+
+#ifdef _WIN32
+
+void MappedFile::open(const std::string& file_name)
+{
+  close();
+  HANDLE file = CreateFileA(file_name.c_str(), GENERIC_READ, FILE_SHARE_READ,
+                            nullptr, OPEN_EXISTING,
+                            FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+  if (file == INVALID_HANDLE_VALUE)
+  {
+    throw FileReadException("Unable to open file " + file_name + ".");
+  }
+  LARGE_INTEGER file_size;
+  GetFileSizeEx(file, &file_size);
+  size_ = static_cast<size_t>(file_size.QuadPart);
+  file_handle_ = file;
+  if (size_ == 0)
+  {
+    data_ = kEmptyContent;
+    return;
+  }
+  HANDLE mapping =
+      CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  void* view = mapping == nullptr
+                   ? nullptr
+                   : MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+  if (view == nullptr)
+  {
+    if (mapping != nullptr) CloseHandle(mapping);
+    CloseHandle(file);
+    file_handle_ = nullptr;
+    size_ = 0;
+    throw FileReadException("Unable to map file " + file_name + ".");
+  }
+  mapping_handle_ = mapping;
+  data_ = static_cast<const char*>(view);
+}
+
+void MappedFile::close()
+{
+  if (data_ != nullptr && data_ != kEmptyContent)
+  {
+    UnmapViewOfFile(data_);
+  }
+  if (mapping_handle_ != nullptr) CloseHandle(mapping_handle_);
+  if (file_handle_ != nullptr) CloseHandle(file_handle_);
+  mapping_handle_ = nullptr;
+  file_handle_ = nullptr;
+  data_ = nullptr;
+  size_ = 0;
+}
+
+#else
+
+void MappedFile::open(const std::string& file_name)
+{
+  close();
+  int fd = ::open(file_name.c_str(), O_RDONLY);
+  if (fd < 0)
+  {
+    throw FileReadException("Unable to open file " + file_name + ".");
+  }
+  struct stat st_buf;
+  if (fstat(fd, &st_buf) != 0)
+  {
+    ::close(fd);
+    throw FileReadException("Unable to read size of file " + file_name + ".");
+  }
+  size_t size = static_cast<size_t>(st_buf.st_size);
+  if (size == 0)
+  {
+    ::close(fd);
+    data_ = kEmptyContent;
+    return;
+  }
+  void* mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  // The mapping keeps its own reference to the file.
+  ::close(fd);
+  if (mapping == MAP_FAILED)
+  {
+    throw FileReadException("Unable to map file " + file_name + ".");
+  }
+  madvise(mapping, size, MADV_WILLNEED);
+  data_ = static_cast<const char*>(mapping);
+  size_ = size;
+}
+
+void MappedFile::close()
+{
+  if (data_ != nullptr && data_ != kEmptyContent)
+  {
+    munmap(const_cast<char*>(data_), size_);
+  }
+  data_ = nullptr;
+  size_ = 0;
+}
+
+#endif
+
+}  // namespace utils
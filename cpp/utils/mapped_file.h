@@ -0,0 +1,55 @@
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+namespace utils
+{
+////////////////////////////////////////////////////////////////////////////////
+/// Read-only memory mapping of a file.
+///
+/// The content of the file is accessible through `data()` for as long as the
+/// MappedFile is alive (or until `close()` is called). Pages are loaded
+/// lazily by the operating system, so opening even a very large file is
+/// cheap.
+///
+///   MappedFile file("problem.qiob");
+///   const char* begin = file.data();
+///   size_t size = file.size();
+///
+class MappedFile
+{
+ public:
+  MappedFile();
+  explicit MappedFile(const std::string& file_name);
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+  ~MappedFile();
+
+  /// Map `file_name` (closing any previously mapped file).
+  ///
+  /// Throws a FileReadException if the file cannot be opened or mapped.
+  void open(const std::string& file_name);
+
+  /// Unmap the file (if any).
+  void close();
+
+  bool is_open() const { return data_ != nullptr; }
+
+  /// Beginning of the mapped content.
+  const char* data() const { return data_; }
+
+  /// Size of the mapped content in bytes.
+  size_t size() const { return size_; }
+
+ private:
+  const char* data_;
+  size_t size_;
+#ifdef _WIN32
+  void* file_handle_;
+  void* mapping_handle_;
+#endif
+};
+
+}  // namespace utils
@@ -141,23 +141,30 @@ std::string get_compiler()
 
 utils::Structure get_build_properties()
 {
-  utils::Structure s;
-  s["branch"] = get_git_branch();
-  s["commit_hash"] = get_git_commit_hash();
-  s["compiler"] = get_compiler();
-  s["build_type"] = get_cmake_build_type();
-  s["qiotoolkit_version"] = get_qiotoolkit_version();
-  return s;
+  // Constant for the process: computed once (e.g., for batches of runs).
+  static const utils::Structure properties = [] {
+    utils::Structure s;
+    s["branch"] = get_git_branch();
+    s["commit_hash"] = get_git_commit_hash();
+    s["compiler"] = get_compiler();
+    s["build_type"] = get_cmake_build_type();
+    s["qiotoolkit_version"] = get_qiotoolkit_version();
+    return s;
+  }();
+  return properties;
 }
 
 utils::Structure get_invocation_properties()
 {
-  utils::Structure s;
-  s["host"] = get_hostname();
-  s["user"] = get_username();
-  s["datetime"] = get_startup_datetime();
-  s["directory"] = get_current_directory();
-  return s;
+  static const utils::Structure properties = [] {
+    utils::Structure s;
+    s["host"] = get_hostname();
+    s["user"] = get_username();
+    s["datetime"] = get_startup_datetime();
+    s["directory"] = get_current_directory();
+    return s;
+  }();
+  return properties;
 }
 
 }  // namespace utils
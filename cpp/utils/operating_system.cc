@@ -3,7 +3,12 @@
 
 #include <fenv.h>
 
+#include <algorithm>
 #include <sstream>
+
+#ifdef __unix__
+#include <dirent.h>
+#endif
 // include OS specific functions
 
 namespace utils
@@ -60,6 +65,27 @@ bool isFolder(std::string input_problem)
     return false;  // file or dir does not exist
 }
 
+std::vector<std::string> list_files(const std::string& folder)
+{
+  std::vector<std::string> files;
+  DIR* dir = opendir(folder.c_str());
+  if (dir == nullptr) return files;
+  while (struct dirent* entry = readdir(dir))
+  {
+    std::string name = entry->d_name;
+    if (name.empty() || name[0] == '.') continue;
+    std::string path = folder + path_separator() + name;
+    struct stat st_buf;
+    if (stat(path.c_str(), &st_buf) == 0 && S_ISREG(st_buf.st_mode))
+    {
+      files.push_back(path);
+    }
+  }
+  closedir(dir);
+  std::sort(files.begin(), files.end());
+  return files;
+}
+
 #endif
 
 #ifdef _WIN32
@@ -122,6 +148,27 @@ bool isFolder(std::string input_problem)
     return false;  // file or dir does not exist
 }
 
+std::vector<std::string> list_files(const std::string& folder)
+{
+  std::vector<std::string> files;
+  WIN32_FIND_DATAA entry;
+  HANDLE handle = FindFirstFileA((folder + "\\*").c_str(), &entry);
+  if (handle == INVALID_HANDLE_VALUE) return files;
+  do
+  {
+    std::string name = entry.cFileName;
+    if (name.empty() || name[0] == '.' ||
+        (entry.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY))
+    {
+      continue;
+    }
+    files.push_back(folder + path_separator() + name);
+  } while (FindNextFileA(handle, &entry));
+  FindClose(handle);
+  std::sort(files.begin(), files.end());
+  return files;
+}
+
 #endif
 
 size_t get_file_size(const std::string& filename, bool& success)
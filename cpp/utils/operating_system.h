@@ -2,6 +2,7 @@
 #pragma once
 
 #include <string>
+#include <vector>
 
 namespace utils
 {
@@ -54,4 +55,7 @@ char path_separator();
 /// Used to differentiate protobuf inputs that come in a folder
 bool isFolder(std::string problem_input);
 
+/// Paths of the (non-hidden) files in `folder`, sorted by name.
+std::vector<std::string> list_files(const std::string& folder);
+
 }  // namespace utils
@@ -0,0 +1,215 @@
+
+#include "utils/packed_state_set.h"
+
+#include <assert.h>
+
+#include <algorithm>
+#include <cstring>
+
+namespace utils
+{
+namespace
+{
+// Finalizer of splitmix64, used to mix the words of a state into its hash.
+uint64_t mix(uint64_t x)
+{
+  x ^= x >> 30;
+  x *= 0xbf58476d1ce4e5b9ULL;
+  x ^= x >> 27;
+  x *= 0x94d049bb133111ebULL;
+  x ^= x >> 31;
+  return x;
+}
+
+// Size of the table for `slots` states (keeping the load factor <= 1/2).
+size_t table_size_for(size_t slots)
+{
+  size_t table_size = 1;
+  while (table_size < 2 * slots) table_size <<= 1;
+  return table_size;
+}
+}  // namespace
+
+constexpr size_t PackedStateSet::kEmpty;
+constexpr size_t PackedStateSet::kInitialStates;
+
+PackedStateSet::PackedStateSet()
+{
+  init(0, 0, kRejectNew);
+}
+
+void PackedStateSet::init(size_t n_bits, size_t capacity, Eviction eviction)
+{
+  n_bits_ = n_bits;
+  words_per_state_ = (n_bits + 63) / 64;
+  capacity_ = capacity;
+  eviction_ = eviction;
+  size_t slots = std::min(capacity_, kInitialStates);
+  words_.assign(slots * words_per_state_, 0);
+  hashes_.assign(slots, 0);
+  packed_.assign(words_per_state_, 0);
+  size_t table_size = table_size_for(slots);
+  table_.assign(table_size, kEmpty);
+  table_mask_ = table_size - 1;
+  clear();
+}
+
+void PackedStateSet::clear()
+{
+  std::fill(table_.begin(), table_.end(), kEmpty);
+  head_ = 0;
+  size_ = 0;
+  dropped_ = 0;
+}
+
+void PackedStateSet::grow()
+{
+  size_t slots = std::min(std::max(2 * hashes_.size(), (size_t)1), capacity_);
+  words_.resize(slots * words_per_state_, 0);
+  hashes_.resize(slots, 0);
+  if (table_.size() < table_size_for(slots)) rehash(table_size_for(slots));
+}
+
+void PackedStateSet::rehash(size_t table_size)
+{
+  // Only called while growing, when the slots in use are [0, size_).
+  assert(head_ == 0);
+  table_.assign(table_size, kEmpty);
+  table_mask_ = table_size - 1;
+  for (size_t slot = 0; slot < size_; slot++)
+  {
+    size_t position = hashes_[slot] & table_mask_;
+    while (table_[position] != kEmpty) position = (position + 1) & table_mask_;
+    table_[position] = slot;
+  }
+}
+
+void PackedStateSet::pack(const std::vector<bool>& state) const
+{
+  assert(state.size() == n_bits_);
+  std::fill(packed_.begin(), packed_.end(), 0);
+  for (size_t i = 0; i < n_bits_; i++)
+  {
+    if (state[i]) packed_[i >> 6] |= 1ULL << (i & 63);
+  }
+}
+
+uint64_t PackedStateSet::hash_packed() const
+{
+  uint64_t hash = mix(n_bits_);
+  for (size_t w = 0; w < words_per_state_; w++)
+  {
+    hash = mix(hash ^ packed_[w]);
+  }
+  return hash;
+}
+
+bool PackedStateSet::matches(size_t slot, uint64_t hash) const
+{
+  return hashes_[slot] == hash &&
+         std::memcmp(slot_words(slot), packed_.data(),
+                     words_per_state_ * sizeof(uint64_t)) == 0;
+}
+
+size_t PackedStateSet::find(uint64_t hash) const
+{
+  size_t position = hash & table_mask_;
+  while (table_[position] != kEmpty && !matches(table_[position], hash))
+  {
+    position = (position + 1) & table_mask_;
+  }
+  return position;
+}
+
+void PackedStateSet::erase_slot(size_t slot)
+{
+  size_t position = hashes_[slot] & table_mask_;
+  while (table_[position] != slot) position = (position + 1) & table_mask_;
+  // Backward-shift deletion: move subsequent entries of the probe sequence
+  // into the hole if their ideal position does not lie after it.
+  size_t hole = position;
+  for (size_t next = (hole + 1) & table_mask_; table_[next] != kEmpty;
+       next = (next + 1) & table_mask_)
+  {
+    size_t ideal = hashes_[table_[next]] & table_mask_;
+    if (((next - ideal) & table_mask_) >= ((next - hole) & table_mask_))
+    {
+      table_[hole] = table_[next];
+      hole = next;
+    }
+  }
+  table_[hole] = kEmpty;
+}
+
+bool PackedStateSet::insert(const std::vector<bool>& state)
+{
+  if (capacity_ == 0)
+  {
+    dropped_++;
+    return false;
+  }
+  pack(state);
+  uint64_t hash = hash_packed();
+  size_t position = find(hash);
+  if (table_[position] != kEmpty) return false;
+
+  size_t slot;
+  if (size_ < capacity_)
+  {
+    if (size_ == hashes_.size())
+    {
+      grow();
+      position = find(hash);
+    }
+    slot = (head_ + size_) % capacity_;
+    size_++;
+  }
+  else if (eviction_ == kEvictOldest)
+  {
+    slot = head_;
+    head_ = (head_ + 1) % capacity_;
+    erase_slot(slot);
+    dropped_++;
+    // The deletion may have shifted entries into the probe sequence.
+    position = find(hash);
+  }
+  else
+  {
+    dropped_++;
+    return false;
+  }
+  std::memcpy(&words_[slot * words_per_state_], packed_.data(),
+              words_per_state_ * sizeof(uint64_t));
+  hashes_[slot] = hash;
+  table_[position] = slot;
+  return true;
+}
+
+bool PackedStateSet::contains(const std::vector<bool>& state) const
+{
+  if (capacity_ == 0) return false;
+  pack(state);
+  return table_[find(hash_packed())] != kEmpty;
+}
+
+std::vector<bool> PackedStateSet::get(size_t i) const
+{
+  assert(i < size_);
+  const uint64_t* words = slot_words((head_ + i) % capacity_);
+  std::vector<bool> state(n_bits_);
+  for (size_t k = 0; k < n_bits_; k++)
+  {
+    state[k] = (words[k >> 6] >> (k & 63)) & 1;
+  }
+  return state;
+}
+
+size_t PackedStateSet::memory_estimate(size_t n_bits, size_t capacity)
+{
+  size_t slots = std::min(capacity, kInitialStates);
+  return sizeof(PackedStateSet) +
+         (slots + 1) * ((n_bits + 63) / 64) * sizeof(uint64_t) +
+         slots * sizeof(uint64_t) + table_size_for(slots) * sizeof(size_t);
+}
+
+}  // namespace utils
@@ -0,0 +1,108 @@
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace utils
+{
+////////////////////////////////////////////////////////////////////////////////
+/// PackedStateSet is a bounded set of binary states of fixed length.
+///
+/// States are stored as packed bits (64 per word) in one contiguous buffer and
+/// looked up by a 64-bit hash in an open-addressing table, which avoids the
+/// per-state allocation and lexicographic comparisons of a
+/// `std::set<std::vector<bool>>`.
+///
+/// At most `capacity` states are kept. Once full, new states are either
+/// rejected (`kRejectNew`, keeping the states found first) or replace the
+/// oldest state in the set (`kEvictOldest`). Storage is allocated as states
+/// are added (doubling up to `capacity`), so a large capacity costs nothing
+/// until it is used.
+///
+///   PackedStateSet set;
+///   set.init(3, 2, PackedStateSet::kRejectNew);
+///   set.insert({true, false, true});   // -> true
+///   set.insert({true, false, true});   // -> false (already present)
+///   set.get(0);                        // -> {true, false, true}
+///
+class PackedStateSet
+{
+ public:
+  enum Eviction
+  {
+    kRejectNew,
+    kEvictOldest
+  };
+
+  PackedStateSet();
+
+  /// Prepare the set for states of `n_bits` bits, keeping at most `capacity`
+  /// of them. Removes all states.
+  void init(size_t n_bits, size_t capacity, Eviction eviction);
+
+  /// Remove all states (the number of dropped states is also reset).
+  void clear();
+
+  /// Insert `state` if not present. Returns whether it was added.
+  bool insert(const std::vector<bool>& state);
+
+  /// Whether `state` is present in the set.
+  bool contains(const std::vector<bool>& state) const;
+
+  /// Number of states in the set.
+  size_t size() const { return size_; }
+
+  /// Return the `i`-th state, in insertion order (oldest first).
+  std::vector<bool> get(size_t i) const;
+
+  /// Number of states which were not kept due to the capacity limit (either
+  /// rejected or evicted) since the last `clear()`.
+  uint64_t dropped() const { return dropped_; }
+
+  /// Estimate of the memory initially needed for a set with these
+  /// parameters (before it grows with the states inserted).
+  static size_t memory_estimate(size_t n_bits, size_t capacity);
+
+ private:
+  static constexpr size_t kEmpty = static_cast<size_t>(-1);
+  // Number of state slots allocated by `init`.
+  static constexpr size_t kInitialStates = 1;
+
+  // Double the allocated slots (up to capacity_).
+  void grow();
+  // Rebuild table_ with `table_size` positions.
+  void rehash(size_t table_size);
+
+  void pack(const std::vector<bool>& state) const;
+  uint64_t hash_packed() const;
+  // Position in table_ holding the slot which matches packed_ (or the empty
+  // position where it would be inserted).
+  size_t find(uint64_t hash) const;
+  bool matches(size_t slot, uint64_t hash) const;
+  void erase_slot(size_t slot);
+  const uint64_t* slot_words(size_t slot) const
+  {
+    return &words_[slot * words_per_state_];
+  }
+
+  size_t n_bits_;
+  size_t words_per_state_;
+  size_t capacity_;
+  Eviction eviction_;
+  // Ring buffer of packed states: `size_` slots starting at `head_`. It
+  // only wraps around once all `capacity_` slots are allocated.
+  std::vector<uint64_t> words_;
+  std::vector<uint64_t> hashes_;
+  size_t head_;
+  size_t size_;
+  // Open-addressing (linear probing) table of slot indices.
+  std::vector<size_t> table_;
+  size_t table_mask_;
+  uint64_t dropped_;
+  // Scratch buffer for packing the state being looked up.
+  mutable std::vector<uint64_t> packed_;
+};
+
+}  // namespace utils
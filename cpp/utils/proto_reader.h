@@ -33,27 +33,8 @@ class ProtoReader
     QuantumUtil::Problem problem;
     std::fstream file_handler;
 
-    // extract foldername from the path
-    std::string folder_name;
-    unsigned found = folder_path.find_last_of("/\\");
-    if (found)
-    {
-      folder_name = folder_path.substr(found + 1);
-    }
-    else
-    {
-      // The folder is in the working directory
-      folder_name = folder_path;
-    }
-
     handler_proxy.StartObject();  // Start the problem dir read
-    // Proto files are constructed internally and we control the naming
-    // The naming schema is problemname_pb for folder and
-    // problemname_pb_<filecount>.pb for individual messages problenname is
-    // specified while constructing a problem on the client
-    // Eg:: OptimizationProblem_pb\OptimzationProblem_pb_0.pb
-    std::string file_name = folder_path + "/" + folder_name + "_" +
-                            std::to_string(file_count) + ".pb";
+    std::string file_name = ShardFileName(folder_path, file_count);
     file_handler.open(file_name, std::ios::in | std::ios::binary);
 
     do
@@ -72,60 +53,14 @@ class ProtoReader
         if (file_count == 0)  // Read the first file with the version, type and
                               // start of terms array
         {
-          handler_proxy.StartObject();  // Start the cost function
-          handler_proxy.Key("cost_function");
-
-          QuantumUtil::Problem_ProblemType type = cost_function.type();
-          if (model_type.find(type) == model_type.end())
-          {
-            THROW(
-                utils::ValueException,
-                "Expected type to be ising, pubo, maxsat or softspin. Invalid "
-                "problem type specified. ");
-          }
-
-          std::string version = cost_function.version();
-          if (type == QuantumUtil::Problem_ProblemType_SOFTSPIN)
-          {
-            if (version != "0.1" && !version.empty())
-            {
-              THROW(utils::ValueException,
-                    "Expected version to be 0.1 for soft spin. Provided: ",
-                    version);
-            }
-          }
-          else if (version != "1.0" && version != "1.1" && !version.empty())
-          {
-            THROW(utils::ValueException,
-                  "Expected version to be 1.0 or 1.1. Provided: ", version);
-          }
-
-          if (type == QuantumUtil::Problem_ProblemType_ISING ||
-              type == QuantumUtil::Problem_ProblemType_PUBO)
-          {
-            if (cost_function.terms_size() == 0)
-            {
-              THROW(utils::ValueException,
-                    "Problem terms cannot be 0. Please "
-                    "add problem terms");
-            }
-          }
-
-          handler_proxy.StartObject();  // Start the version, type, terms and
-                                        // (optionally init config)
-          handler_proxy.Key("type");
-          handler_proxy.String(model_type[type]);
-          handler_proxy.Key("version");
-          handler_proxy.String(version);
-          handler_proxy.Key("terms");
-          handler_proxy.StartArray();  // Start the terms array
+          ParseHeader(cost_function, cost_function.terms_size(),
+                      handler_proxy);
         }
         Parse(terms, handler_proxy, term_count);
         problem.Clear();
         file_count++;
         file_handler.close();
-        file_name = folder_path + "/" + folder_name + "_" +
-                    std::to_string(file_count) + ".pb";
+        file_name = ShardFileName(folder_path, file_count);
         file_handler.open(file_name, std::ios::in | std::ios::binary);
       }
       else
@@ -137,6 +72,138 @@ class ProtoReader
     } while (file_handler);
 
     file_handler.close();
+    return ParseFooter(term_count, file_count, handler_proxy);
+  }
+
+  // Parse all shards of the problem concurrently (one shard per thread)
+  // directly into per-shard edge vectors. The cost function of the first
+  // shard (without its terms) is returned in `header` and its number of terms
+  // in `header_term_count`.
+  template <typename Edge>
+  void ParseShards(const std::string& folder_path,
+                   std::vector<std::vector<Edge>>& shards,
+                   QuantumUtil::Problem_CostFunction& header,
+                   size_t& header_term_count)
+  {
+    // Shards are numbered consecutively; the first missing file ends the
+    // problem (but there must be at least one).
+    std::vector<std::string> file_names;
+    while (true)
+    {
+      std::string file_name = ShardFileName(folder_path, file_names.size());
+      std::ifstream file_handler(file_name, std::ios::in | std::ios::binary);
+      if (!file_handler)
+      {
+        if (file_names.empty())
+        {
+          THROW(utils::FileReadException, "Could not open file: ", file_name);
+        }
+        break;
+      }
+      file_names.push_back(file_name);
+    }
+
+    shards.clear();
+    shards.resize(file_names.size());
+    utils::OmpCatch omp_catch;
+    #pragma omp parallel for schedule(dynamic, 1)
+    for (size_t k = 0; k < file_names.size(); k++)
+    {
+      omp_catch.run([&, k]() {
+        QuantumUtil::Problem problem;
+        std::ifstream file_handler(file_names[k],
+                                   std::ios::in | std::ios::binary);
+        if (file_handler.fail())
+        {
+          THROW(utils::FileReadException, "Could not open file: ",
+                file_names[k]);
+        }
+        problem.ParseFromIstream(&file_handler);
+        if (!problem.has_cost_function())
+        {
+          throw ConfigurationException(
+              "Invalid problem message. No cost function found",
+              utils::Error::MissingInput);
+        }
+        QuantumUtil::Problem_CostFunction* cost_function =
+            problem.mutable_cost_function();
+        std::vector<Edge>& edges = shards[k];
+        edges.reserve(cost_function->terms_size());
+        std::vector<int> ids;
+        for (const auto& term : cost_function->terms())
+        {
+          ids.assign(term.ids().begin(), term.ids().end());
+          edges.emplace_back(term.c(), ids);
+        }
+        if (k == 0)
+        {
+          header_term_count = cost_function->terms_size();
+          cost_function->clear_terms();
+          header.Swap(cost_function);
+        }
+      });
+    }
+    omp_catch.rethrow();
+  }
+
+  // Replay the first shard's type and version, and open the terms array.
+  template <typename StreamHandler>
+  void ParseHeader(const QuantumUtil::Problem_CostFunction& cost_function,
+                   size_t term_count,
+                   utils::PROTOHandlerProxy<StreamHandler>& handler_proxy)
+  {
+    handler_proxy.StartObject();  // Start the cost function
+    handler_proxy.Key("cost_function");
+
+    QuantumUtil::Problem_ProblemType type = cost_function.type();
+    if (model_type.find(type) == model_type.end())
+    {
+      THROW(utils::ValueException,
+            "Expected type to be ising, pubo, maxsat or softspin. Invalid "
+            "problem type specified. ");
+    }
+
+    std::string version = cost_function.version();
+    if (type == QuantumUtil::Problem_ProblemType_SOFTSPIN)
+    {
+      if (version != "0.1" && !version.empty())
+      {
+        THROW(utils::ValueException,
+              "Expected version to be 0.1 for soft spin. Provided: ", version);
+      }
+    }
+    else if (version != "1.0" && version != "1.1" && !version.empty())
+    {
+      THROW(utils::ValueException,
+            "Expected version to be 1.0 or 1.1. Provided: ", version);
+    }
+
+    if (type == QuantumUtil::Problem_ProblemType_ISING ||
+        type == QuantumUtil::Problem_ProblemType_PUBO)
+    {
+      if (term_count == 0)
+      {
+        THROW(utils::ValueException,
+              "Problem terms cannot be 0. Please "
+              "add problem terms");
+      }
+    }
+
+    handler_proxy.StartObject();  // Start the version, type, terms and
+                                  // (optionally init config)
+    handler_proxy.Key("type");
+    handler_proxy.String(model_type[type]);
+    handler_proxy.Key("version");
+    handler_proxy.String(version);
+    handler_proxy.Key("terms");
+    handler_proxy.StartArray();  // Start the terms array
+  }
+
+  // Close the terms array and the objects opened by `ParseHeader`.
+  template <typename StreamHandler>
+  bool ParseFooter(unsigned term_count, unsigned file_count,
+                   utils::PROTOHandlerProxy<StreamHandler>& handler_proxy)
+  {
     handler_proxy.EndArray(term_count);  // End terms array;
     handler_proxy.EndObject(
         4);  // End reading terms, version and type and init config
@@ -146,6 +213,30 @@ class ProtoReader
     return handler_proxy.complete();
   }
 
+  // Proto files are constructed internally and we control the naming
+  // The naming schema is problemname_pb for folder and
+  // problemname_pb_<filecount>.pb for individual messages problenname is
+  // specified while constructing a problem on the client
+  // Eg:: OptimizationProblem_pb\OptimzationProblem_pb_0.pb
+  static std::string ShardFileName(const std::string& folder_path,
+                                   size_t index)
+  {
+    // extract foldername from the path
+    std::string folder_name;
+    unsigned found = folder_path.find_last_of("/\\");
+    if (found)
+    {
+      folder_name = folder_path.substr(found + 1);
+    }
+    else
+    {
+      // The folder is in the working directory
+      folder_name = folder_path;
+    }
+    return folder_path + "/" + folder_name + "_" + std::to_string(index) +
+           ".pb";
+  }
+
   // Parsing a vector of Terms. Akin to a Graph
   template <typename StreamHandler>
   bool Parse(const google::protobuf::RepeatedPtrField<
@@ -209,6 +300,54 @@ void configure_from_proto_folder(const std::string& folder_name, Type& val)
   val = std::move(handler_proxy.get_value());
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Stream configure a graph configuration from PROTO folder, parsing the
+/// shards concurrently.
+///
+/// Each shard is parsed on its own thread directly into edges (without
+/// replaying the terms through the stream handler); the type and version
+/// from the first shard go through the stream handler as usual.
+/// 'Type' needs `Get_Edges` and `EdgeType_T` (see graph::GraphConfiguration).
+///
+template <typename Type, typename Handler = typename Type::StreamHandler>
+void configure_graph_from_proto_folder(const std::string& folder_name,
+                                       Type& val)
+{
+  using Edge = typename Type::EdgeType_T;
+  std::vector<std::vector<Edge>> shards;
+  QuantumUtil::Problem_CostFunction header;
+  size_t header_term_count = 0;
+  utils::ProtoReader reader;
+  reader.ParseShards(folder_name, shards, header, header_term_count);
+
+  utils::PROTOHandlerProxy<Handler> handler_proxy;
+  handler_proxy.StartObject();  // Start the problem dir read
+  reader.ParseHeader(header, header_term_count, handler_proxy);
+  if (!reader.ParseFooter(0, shards.size(), handler_proxy))
+  {
+    if (!handler_proxy.complete())
+    {
+      throw ConfigurationException(handler_proxy.error_message(),
+                                   handler_proxy.error_code());
+    }
+  }
+  val = std::move(handler_proxy.get_value());
+
+  std::vector<size_t> offsets(shards.size() + 1, 0);
+  for (size_t k = 0; k < shards.size(); k++)
+  {
+    offsets[k + 1] = offsets[k] + shards[k].size();
+  }
+  std::vector<Edge>& edges = Type::Get_Edges::get(val);
+  edges.resize(offsets.back());
+  #pragma omp parallel for schedule(dynamic, 1)
+  for (size_t k = 0; k < shards.size(); k++)
+  {
+    std::move(shards[k].begin(), shards[k].end(), edges.begin() + offsets[k]);
+    std::vector<Edge>().swap(shards[k]);
+  }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Stream configure from proto folder.
 /// Intermidiate configuration object is created and used.
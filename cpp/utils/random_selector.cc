@@ -3,9 +3,11 @@
 
 #include <algorithm>
 #include <cassert>
+#include <cmath>
 #include <iostream>
 
 #include "utils/exception.h"
+#include "utils/scan.h"
 
 namespace utils
 {
@@ -124,4 +126,41 @@ size_t RandomSelector::select_and_remove(double uniform)
   return id;
 }
 
+void systematic_selection(const std::vector<double>& weights, size_t count,
+                          double uniform, std::vector<size_t>& selections)
+{
+  assert(uniform >= 0);
+  assert(uniform < 1);
+
+  size_t n = weights.size();
+  selections.assign(n, 0);
+  if (count == 0) return;
+  if (n == 0) throw IndexOutOfRangeException("No weights to select from.");
+
+  std::vector<double> cumulative(weights);
+  double total_weight = exclusive_scan(cumulative);
+  if (total_weight <= 0)
+  {
+    // Degenerate case (all weights 0): select equiprobably.
+    for (size_t i = 0; i < n; i++) cumulative[i] = static_cast<double>(i);
+    total_weight = static_cast<double>(n);
+  }
+  double spacing = total_weight / static_cast<double>(count);
+
+  // Number of points (uniform + k) * spacing strictly below the cumulative
+  // weight `c`; clamped to `count` to guard against rounding in the division.
+  auto points_below = [&](double c) {
+    double points = std::ceil(c / spacing - uniform);
+    return std::min(count, static_cast<size_t>(std::max(0.0, points)));
+  };
+
+  #pragma omp parallel for
+  for (size_t i = 0; i < n; i++)
+  {
+    size_t lower = points_below(cumulative[i]);
+    size_t upper = (i + 1 < n) ? points_below(cumulative[i + 1]) : count;
+    selections[i] = upper - lower;
+  }
+}
+
 }  // namespace utils
@@ -1,6 +1,7 @@
 
 #pragma once
 
+#include <stddef.h>
 #include <stdint.h>
 
 #include <vector>
@@ -46,4 +47,17 @@ class RandomSelector
   double total_weight_;
 };
 
+// Systematic resampling: Distribute `count` selections among the entries of
+// `weights` proportionally to their weight, using a single `uniform` \in [0,1)
+// as the offset of `count` equally spaced points on the cumulative weight.
+// `selections[i]` is set to the number of times entry `i` is selected (they
+// sum to `count`). With all weights < total_weight / count (such as residual
+// weights < 1 which sum to `count`), each entry is selected at most once and
+// with probability `count * weight[i] / total_weight`.
+//
+// Unlike repeated calls to RandomSelector::select_and_remove, this needs only
+// a prefix sum over the weights, which is computed in parallel.
+void systematic_selection(const std::vector<double>& weights, size_t count,
+                          double uniform, std::vector<size_t>& selections);
+
 }  // namespace utils
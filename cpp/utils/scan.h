@@ -0,0 +1,71 @@
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "omp.h"
+
+namespace utils
+{
+// Below this size the scan is done serially (the cost of forking threads
+// outweighs the work).
+constexpr size_t kParallelScanThreshold = 4096;
+
+////////////////////////////////////////////////////////////////////////////////
+/// Replace `values` with their exclusive prefix sum and return the total.
+///
+/// The input is split into one contiguous chunk per thread; each thread sums
+/// its chunk, the chunk totals are accumulated serially and each thread then
+/// writes the prefix sums for its chunk, starting from the offset of its
+/// chunk.
+///
+///   std::vector<size_t> counts = {2, 0, 3, 1};
+///   size_t total = exclusive_scan(counts);
+///   // counts == {0, 2, 2, 5}, total == 6
+///
+template <class T>
+T exclusive_scan(std::vector<T>& values)
+{
+  size_t n = values.size();
+  if (n < kParallelScanThreshold || omp_get_max_threads() == 1)
+  {
+    T sum = 0;
+    for (size_t i = 0; i < n; i++)
+    {
+      T value = values[i];
+      values[i] = sum;
+      sum += value;
+    }
+    return sum;
+  }
+
+  std::vector<T> offsets(static_cast<size_t>(omp_get_max_threads()) + 1, 0);
+  size_t thread_count = 1;
+  #pragma omp parallel
+  {
+    size_t nt = static_cast<size_t>(omp_get_num_threads());
+    size_t t = static_cast<size_t>(omp_get_thread_num());
+    size_t begin = n * t / nt;
+    size_t end = n * (t + 1) / nt;
+    T sum = 0;
+    for (size_t i = begin; i < end; i++) sum += values[i];
+    offsets[t + 1] = sum;
+    #pragma omp barrier
+    #pragma omp single
+    {
+      thread_count = nt;
+      for (size_t k = 1; k <= nt; k++) offsets[k] += offsets[k - 1];
+    }
+    sum = offsets[t];
+    for (size_t i = begin; i < end; i++)
+    {
+      T value = values[i];
+      values[i] = sum;
+      sum += value;
+    }
+  }
+  return offsets[thread_count];
+}
+
+}  // namespace utils
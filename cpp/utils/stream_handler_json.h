@@ -2,8 +2,12 @@
 #pragma once
 
 #include <string>
+#include <vector>
 
+#include "utils/config.h"
 #include "utils/exception.h"
+#include "utils/json_terms.h"
+#include "utils/mapped_file.h"
 #include "utils/stream_handler.h"
 #include "rapidjson/filereadstream.h"
 #include "rapidjson/reader.h"
@@ -148,6 +152,60 @@ void configure_from_json_file(const std::string& file_name, Type& val)
   val = std::move(handler_proxy.get_value());
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Sream configure a graph configuration from JSON file, parsing the
+/// `cost_function.terms` array on all threads.
+///
+/// The file is mapped and the terms array is parsed in chunks concurrently;
+/// the rest of the document goes through the regular stream handler. If the
+/// terms are not in the plain `{"c": ..., "ids": [...]}` form, this falls
+/// back to `configure_from_json_file` (which reports any errors).
+/// 'Type' needs `Get_Edges` and `EdgeType_T` (see graph::GraphConfiguration).
+///
+template <typename Type, typename Handler = typename Type::StreamHandler>
+void configure_graph_from_json_file(const std::string& file_name, Type& val)
+{
+  std::vector<std::vector<JsonTerm>> chunks;
+  std::string remainder;
+  {
+    MappedFile file;
+    file.open(file_name);
+    JsonSpan span;
+    if (!find_json_member(file.data(), file.size(),
+                          {kCostFunction, Type::Get_Edges::get_key()}, span) ||
+        !parse_json_terms(file.data(), span, chunks))
+    {
+      chunks.clear();
+      file.close();
+      configure_from_json_file<Type, Handler>(file_name, val);
+      return;
+    }
+    remainder.reserve(file.size() - (span.end - span.begin) + 2);
+    remainder.append(file.data(), span.begin);
+    remainder.append("[]");
+    remainder.append(file.data() + span.end, file.size() - span.end);
+  }
+  configure_from_json_string<Type, Handler>(remainder, val);
+
+  std::vector<size_t> offsets(chunks.size() + 1, 0);
+  for (size_t k = 0; k < chunks.size(); k++)
+  {
+    offsets[k + 1] = offsets[k] + chunks[k].size();
+  }
+  auto& edges = Type::Get_Edges::get(val);
+  edges.resize(offsets.back());
+  #pragma omp parallel for schedule(dynamic, 1)
+  for (size_t k = 0; k < chunks.size(); k++)
+  {
+    for (size_t i = 0; i < chunks[k].size(); i++)
+    {
+      edges[offsets[k] + i] =
+          typename Type::EdgeType_T(chunks[k][i].c, chunks[k][i].ids);
+    }
+    std::vector<JsonTerm>().swap(chunks[k]);
+  }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Sream configure from JSON string.
 /// Intermidiate configuration object is created and used.
@@ -1,15 +1,20 @@
 
 #include "utils/structure.h"
 
-#include <math.h>
+#include <sstream>
 
-#include <iomanip>
+#include "utils/structure_writer.h"
 
 namespace utils
 {
 std::string Structure::to_string(bool pretty) const
 {
-  return to_string(pretty, 0);
+  std::stringstream out;
+  {
+    StructureWriter writer(&out, pretty);
+    writer.write(*this);
+  }
+  return out.str();
 }
 
 void Structure::remove(const std::string& key)
@@ -21,180 +26,6 @@ void Structure::remove(const std::string& key)
   object_->erase(key);
 }
 
-// The following is a poor man's backport of std::quoted
-// for compilers before C++14
-#if __cplusplus < 201402L || defined(__clang__)
-}  // namespace utils
-
-namespace std
-{
-string quoted(const string& s)
-{
-  string quoted = "\"";
-  size_t i = 0, j = 0;
-  while (i < s.size())
-  {
-    j = s.find_first_of("\\\"", i);
-    if (j == std::string::npos) break;
-    quoted += s.substr(i, j - i) + "\\" + s[j];
-    i = j + 1;
-  }
-  quoted += s.substr(i, s.size() - i) + "\"";
-  return quoted;
-}
-
-}  // namespace std
-
-namespace utils
-{
-#endif
-
-bool is_digits(std::string s)
-{
-  if (s.empty()) return false;
-  auto first_non_digit =
-      std::find_if(s.begin(), s.end(), [](char c) { return !std::isdigit(c); });
-  return first_non_digit == s.end();
-}
-
-std::string Structure::to_string(bool pretty, int level) const
-{
-  std::string indent((size_t)(2 * level), ' ');
-  std::stringstream out;
-  bool simple = is_simple();
-  switch (type_)
-  {
-    case UNKNOWN_TYPE:
-      out << "?";
-      break;
-    case BOOL:
-      out << (bool_ ? "true" : "false");
-      break;
-    case INT32:
-      out << int32_;
-      break;
-    case UINT32:
-      out << uint32_;
-      break;
-    case INT64:
-      out << int64_;
-      break;
-    case UINT64:
-      out << uint64_;
-      break;
-    case DOUBLE:
-      out << (isnan(double_) ? "nan" : std::to_string(double_));
-      break;
-    case STRING:
-      if (string_ != nullptr)
-      {
-        out << std::quoted(*string_);
-      }
-      else
-      {
-        out << std::quoted(std::string());
-      }
-      break;
-    case ARRAY:
-      if (array_ == nullptr)
-      {
-        out << "[]";
-        break;
-      }
-      if (simple || !pretty)
-      {
-        out << "[";
-        for (size_t i = 0; i < array_->size(); i++)
-        {
-          out << (*array_)[i].to_string(false, level + 1);
-          if (i < array_->size() - 1) out << ",";
-        }
-        out << "]";
-      }
-      else
-      {
-        out << "[\n";
-        for (size_t i = 0; i < array_->size(); i++)
-        {
-          out << indent << "  " << (*array_)[i].to_string(pretty, level + 1);
-          if (i < array_->size() - 1) out << ",";
-          out << "\n";
-        }
-        out << indent << "]";
-      }
-      break;
-    case OBJECT:
-    {
-      // objects members need to be printed in a specific order
-      // 1) for objects with numeric keys represented as strings,
-      //    they should be ordered numerically
-      // 2) customers expect a specific order of elements in some
-      //    situations. The only known occurrence of this is currently
-      //    that "version" needs to be the leading element, so we
-      //    print it first.
-      if (object_ == nullptr)
-      {
-        out << "{}";
-        break;
-      }
-      using Iterator = decltype(object_->begin());
-      std::vector<Iterator> items;
-      items.reserve(object_->size());
-      Iterator it = object_->find("version");
-      if (it != object_->end()) items.push_back(it);
-      bool all_numeric = true;
-      for (auto it = object_->begin(); it != object_->end(); it++)
-      {
-        if (all_numeric) all_numeric = is_digits(it->first);
-        if (it->first != "version") items.push_back(it);
-      }
-      if (all_numeric)
-      {
-        // Sort strings representing numeric keys numerically.
-        // NOTE: this deliberatly does not cover negative numbers
-        // (or floats) at this point. This type of information
-        // really should not be stored in keys.
-        std::sort(items.begin(), items.end(),
-                  [](const Iterator& a, const Iterator& b) -> bool {
-                    if (a->first.size() != b->first.size())
-                      return a->first.size() < b->first.size();
-                    return a->first < b->first;
-                  });
-      }
-
-      if (simple || !pretty)
-      {
-        out << "{";
-        size_t i = 0;
-        for (const auto& item : items)
-        {
-          out << std::quoted(item->first) << ": "
-              << item->second.to_string(false, level + 1);
-          if (i < object_->size() - 1) out << ", ";
-          i++;
-        }
-        out << "}";
-      }
-      else
-      {
-        out << "{\n";
-        size_t i = 0;
-        for (const auto& item : items)
-        {
-          out << indent << "  " << std::quoted(item->first) << ": "
-              << item->second.to_string(pretty, level + 1);
-          if (i < object_->size() - 1) out << ",";
-          out << "\n";
-          i++;
-        }
-        out << indent << "}";
-      }
-      break;
-    }
-  }
-  return out.str();
-}
-
 void Structure::deep_copy(const Structure& other)
 {
   assert(this != (&other));
@@ -500,7 +500,8 @@ class Structure
   Type type_;
 
   static std::string type2string(Type type);
-  std::string to_string(bool pretty, int level) const;
+
+  friend class StructureWriter;
 
  private:
   // Doing deep copy value from other to this
@@ -0,0 +1,385 @@
+
+#include "utils/structure_writer.h"
+
+#include <math.h>
+#include <string.h>
+
+#include <algorithm>
+#include <numeric>
+
+namespace utils
+{
+namespace
+{
+// Key of the (only) member of a deferred placeholder.
+const char kDeferredKey[] = "$deferred";
+
+// Output is collected in a buffer of (about) this size before it is
+// written to the stream.
+const size_t kBufferSize = 1 << 16;
+
+bool is_digits(const std::string& s)
+{
+  if (s.empty()) return false;
+  return std::all_of(s.begin(), s.end(),
+                     [](char c) { return c >= '0' && c <= '9'; });
+}
+
+// Write the decimal representation of `value` ending at `end`; returns the
+// position of the first character.
+char* format_int(int64_t value, char* end)
+{
+  uint64_t magnitude = value < 0 ? 0 - (uint64_t)value : (uint64_t)value;
+  char* p = end;
+  do
+  {
+    *--p = (char)('0' + magnitude % 10);
+    magnitude /= 10;
+  } while (magnitude > 0);
+  if (value < 0) *--p = '-';
+  return p;
+}
+
+// Number of characters `format_int` writes for `value`.
+size_t int_size(int64_t value)
+{
+  uint64_t magnitude = value < 0 ? 0 - (uint64_t)value : (uint64_t)value;
+  size_t size = value < 0 ? 2 : 1;
+  while (magnitude >= 10)
+  {
+    magnitude /= 10;
+    size++;
+  }
+  return size;
+}
+}  // namespace
+
+StructureWriter::StructureWriter(std::ostream* out, bool pretty)
+    : out_(out), pretty_(pretty), level_(0), bytes_(0)
+{
+}
+
+StructureWriter::~StructureWriter() { flush(); }
+
+Structure StructureWriter::deferred(size_t index)
+{
+  Structure placeholder(Structure::OBJECT);
+  placeholder[kDeferredKey] = (uint64_t)index;
+  return placeholder;
+}
+
+bool StructureWriter::is_deferred(const Structure& structure, size_t& index)
+{
+  if (structure.type_ != Structure::OBJECT || structure.object_ == nullptr ||
+      structure.object_->size() != 1)
+  {
+    return false;
+  }
+  const auto& member = *structure.object_->begin();
+  if (member.first != kDeferredKey ||
+      member.second.type_ != Structure::UINT64)
+  {
+    return false;
+  }
+  index = (size_t)member.second.uint64_;
+  return true;
+}
+
+void StructureWriter::flush()
+{
+  if (out_ != nullptr && !buffer_.empty())
+  {
+    out_->write(buffer_.data(), (std::streamsize)buffer_.size());
+  }
+  buffer_.clear();
+}
+
+void StructureWriter::emit(const char* data, size_t size)
+{
+  bytes_ += size;
+  if (out_ == nullptr) return;
+  buffer_.append(data, size);
+  if (buffer_.size() >= kBufferSize) flush();
+}
+
+void StructureWriter::write_int(int64_t value)
+{
+  if (out_ == nullptr)
+  {
+    bytes_ += int_size(value);
+    return;
+  }
+  char digits[24];
+  char* end = digits + sizeof(digits);
+  char* begin = format_int(value, end);
+  emit(begin, (size_t)(end - begin));
+}
+
+void StructureWriter::write_indent(int level)
+{
+  static const std::string spaces(64, ' ');
+  size_t count = (size_t)(2 * level);
+  while (count > 0)
+  {
+    size_t n = std::min(count, spaces.size());
+    emit(spaces.data(), n);
+    count -= n;
+  }
+}
+
+void StructureWriter::write_string(const std::string& value)
+{
+  // Same escaping as std::quoted.
+  emit('"');
+  size_t begin = 0;
+  for (size_t i = 0; i < value.size(); i++)
+  {
+    if (value[i] == '"' || value[i] == '\\')
+    {
+      emit(value.data() + begin, i - begin);
+      emit('\\');
+      begin = i;
+    }
+  }
+  emit(value.data() + begin, value.size() - begin);
+  emit('"');
+}
+
+void StructureWriter::write(const Structure& structure)
+{
+  write(structure, pretty_, level_);
+  flush();
+}
+
+void StructureWriter::write(const Structure& structure, bool pretty, int level)
+{
+  size_t index;
+  if (deferred_handler_ && is_deferred(structure, index))
+  {
+    bool pretty_outer = pretty_;
+    int level_outer = level_;
+    pretty_ = pretty;
+    level_ = level;
+    deferred_handler_(index, *this);
+    pretty_ = pretty_outer;
+    level_ = level_outer;
+    return;
+  }
+
+  bool simple = structure.is_simple();
+  switch (structure.type_)
+  {
+    case Structure::UNKNOWN_TYPE:
+      emit('?');
+      break;
+    case Structure::BOOL:
+      emit(structure.bool_ ? "true" : "false");
+      break;
+    case Structure::INT32:
+      write_int(structure.int32_);
+      break;
+    case Structure::UINT32:
+      write_int(structure.uint32_);
+      break;
+    case Structure::INT64:
+      write_int(structure.int64_);
+      break;
+    case Structure::UINT64:
+      emit(std::to_string(structure.uint64_));
+      break;
+    case Structure::DOUBLE:
+      emit(isnan(structure.double_) ? "nan"
+                                    : std::to_string(structure.double_));
+      break;
+    case Structure::STRING:
+      write_string(structure.string_ != nullptr ? *structure.string_
+                                                : std::string());
+      break;
+    case Structure::ARRAY:
+    {
+      if (structure.array_ == nullptr)
+      {
+        emit("[]");
+        break;
+      }
+      const auto& array = *structure.array_;
+      if (simple || !pretty)
+      {
+        emit('[');
+        for (size_t i = 0; i < array.size(); i++)
+        {
+          write(array[i], false, level + 1);
+          if (i < array.size() - 1) emit(',');
+        }
+        emit(']');
+      }
+      else
+      {
+        emit("[\n");
+        for (size_t i = 0; i < array.size(); i++)
+        {
+          write_indent(level + 1);
+          write(array[i], pretty, level + 1);
+          if (i < array.size() - 1) emit(',');
+          emit('\n');
+        }
+        write_indent(level);
+        emit(']');
+      }
+      break;
+    }
+    case Structure::OBJECT:
+    {
+      // objects members need to be printed in a specific order
+      // 1) for objects with numeric keys represented as strings,
+      //    they should be ordered numerically
+      // 2) customers expect a specific order of elements in some
+      //    situations. The only known occurrence of this is currently
+      //    that "version" needs to be the leading element, so we
+      //    print it first.
+      if (structure.object_ == nullptr)
+      {
+        emit("{}");
+        break;
+      }
+      const auto& object = *structure.object_;
+      using Iterator = decltype(object.begin());
+      std::vector<Iterator> items;
+      items.reserve(object.size());
+      Iterator it = object.find("version");
+      if (it != object.end()) items.push_back(it);
+      bool all_numeric = true;
+      for (auto it = object.begin(); it != object.end(); it++)
+      {
+        if (all_numeric) all_numeric = is_digits(it->first);
+        if (it->first != "version") items.push_back(it);
+      }
+      if (all_numeric)
+      {
+        // Sort strings representing numeric keys numerically.
+        // NOTE: this deliberatly does not cover negative numbers
+        // (or floats) at this point. This type of information
+        // really should not be stored in keys.
+        std::sort(items.begin(), items.end(),
+                  [](const Iterator& a, const Iterator& b) -> bool {
+                    if (a->first.size() != b->first.size())
+                      return a->first.size() < b->first.size();
+                    return a->first < b->first;
+                  });
+      }
+
+      if (simple || !pretty)
+      {
+        emit('{');
+        for (size_t i = 0; i < items.size(); i++)
+        {
+          write_string(items[i]->first);
+          emit(": ");
+          write(items[i]->second, false, level + 1);
+          if (i < object.size() - 1) emit(", ");
+        }
+        emit('}');
+      }
+      else
+      {
+        emit("{\n");
+        for (size_t i = 0; i < items.size(); i++)
+        {
+          write_indent(level + 1);
+          write_string(items[i]->first);
+          emit(": ");
+          write(items[i]->second, pretty, level + 1);
+          if (i < object.size() - 1) emit(',');
+          emit('\n');
+        }
+        write_indent(level);
+        emit('}');
+      }
+      break;
+    }
+  }
+}
+
+void StructureWriter::write_int_members(const std::vector<int>& names,
+                                        const std::vector<int>& values,
+                                        const std::string& prefix,
+                                        const char* separator)
+{
+  // Use the member order of the equivalent Structure: numeric if all names
+  // are non-negative, otherwise that of the (string) keys.
+  std::vector<size_t> order(names.size());
+  std::iota(order.begin(), order.end(), 0);
+  bool all_numeric = std::all_of(names.begin(), names.end(),
+                                 [](int name) { return name >= 0; });
+  if (all_numeric)
+  {
+    std::sort(order.begin(), order.end(),
+              [&](size_t a, size_t b) { return names[a] < names[b]; });
+  }
+  else
+  {
+    std::sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+      return std::to_string(names[a]) < std::to_string(names[b]);
+    });
+  }
+
+  char line[64];
+  char* end = line + sizeof(line);
+  for (size_t i = 0; i < order.size(); i++)
+  {
+    // Format `"name": value` right-to-left into `line`.
+    char* p = format_int(values[order[i]], end);
+    *--p = ' ';
+    *--p = ':';
+    *--p = '"';
+    p = format_int(names[order[i]], p);
+    *--p = '"';
+    emit(prefix);
+    emit(p, (size_t)(end - p));
+    if (i < order.size() - 1) emit(separator);
+  }
+}
+
+void StructureWriter::write_int_object(const std::vector<int>& names,
+                                       const std::vector<int>& values)
+{
+  assert(names.size() == values.size());
+  if (names.empty())
+  {
+    emit("{}");
+    flush();
+    return;
+  }
+
+  // An object with more than three members is not "simple" and, if
+  // pretty, written with one member per line.
+  bool multiline = pretty_ && names.size() > 3;
+  std::string prefix = multiline ? std::string(2 * (level_ + 1), ' ') : "";
+  const char* separator = multiline ? ",\n" : ", ";
+  emit(multiline ? "{\n" : "{");
+  if (out_ == nullptr)
+  {
+    // Only counting: the size of the members does not depend on their order
+    // (and the values need not be formatted).
+    size_t size = 0;
+    for (size_t i = 0; i < names.size(); i++)
+    {
+      size += int_size(names[i]) + int_size(values[i]);
+    }
+    bytes_ += size + names.size() * (prefix.size() + strlen("\"\": ")) +
+              (names.size() - 1) * strlen(separator);
+  }
+  else
+  {
+    write_int_members(names, values, prefix, separator);
+  }
+  if (multiline)
+  {
+    emit('\n');
+    write_indent(level_);
+  }
+  emit('}');
+  flush();
+}
+
+}  // namespace utils
@@ -0,0 +1,90 @@
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <functional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "utils/structure.h"
+
+namespace utils
+{
+////////////////////////////////////////////////////////////////////////////////
+/// StructureWriter
+///
+/// Writes a `Structure` as json to a stream, in the same form as
+/// `Structure::to_string()` but without building the string of each nested
+/// value first.
+///
+/// Values which are expensive to render (such as the configurations of large
+/// solutions) can be left in the structure as `deferred(index)` placeholders;
+/// the writer calls the deferred handler to write them in place (with
+/// `write` or `write_int_object`). Without an output stream, the writer only
+/// counts the bytes it would write.
+///
+class StructureWriter
+{
+ public:
+  using DeferredHandler =
+      std::function<void(size_t index, StructureWriter& writer)>;
+
+  /// Create a writer for `out` (or one only counting bytes if `out` is
+  /// nullptr).
+  explicit StructureWriter(std::ostream* out, bool pretty = true);
+  ~StructureWriter();
+
+  /// Set the function writing the values of `deferred()` placeholders.
+  void set_deferred_handler(DeferredHandler handler)
+  {
+    deferred_handler_ = handler;
+  }
+
+  /// Write `structure` at the current position.
+  void write(const Structure& structure);
+
+  /// Write an object mapping `names[i]` to `values[i]` at the current
+  /// position, as a Structure OBJECT with `std::to_string(names[i])` keys
+  /// would be written.
+  void write_int_object(const std::vector<int>& names,
+                        const std::vector<int>& values);
+
+  /// Number of bytes written so far.
+  size_t bytes_written() const { return bytes_; }
+
+  /// Write any buffered output to the stream.
+  void flush();
+
+  /// Create a placeholder for the deferred value `index`.
+  static Structure deferred(size_t index);
+
+  /// Return whether `structure` is a placeholder created by `deferred()` (and
+  /// set `index` accordingly).
+  static bool is_deferred(const Structure& structure, size_t& index);
+
+ private:
+  void write(const Structure& structure, bool pretty, int level);
+  void write_string(const std::string& value);
+  void write_int(int64_t value);
+  void write_int_members(const std::vector<int>& names,
+                         const std::vector<int>& values,
+                         const std::string& prefix, const char* separator);
+  void write_indent(int level);
+  void emit(const char* data, size_t size);
+  void emit(const std::string& value) { emit(value.data(), value.size()); }
+  void emit(char c) { emit(&c, 1); }
+
+  std::ostream* out_;
+  // Formatting of the value being written (which changes while a deferred
+  // value is written).
+  bool pretty_;
+  int level_;
+  size_t bytes_;
+  std::string buffer_;
+  DeferredHandler deferred_handler_;
+};
+
+}  // namespace utils
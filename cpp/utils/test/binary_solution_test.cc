@@ -0,0 +1,161 @@
+
+#include "utils/binary_solution.h"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <string>
+
+#include "utils/exception.h"
+#include "gtest/gtest.h"
+
+using utils::BinarySolutionReader;
+using utils::BinarySolutionWriter;
+using utils::SolutionEncoding;
+
+namespace
+{
+const char kFileName[] = "binary_solution_test.qios";
+
+// Write `solutions` (with cost i for solution i) to kFileName and return
+// the number of bytes written.
+size_t write_file(const SolutionEncoding& encoding,
+                  const std::vector<int>& names,
+                  const std::vector<std::vector<int>>& solutions)
+{
+  std::ofstream out(kFileName, std::ios::binary);
+  BinarySolutionWriter writer(&out);
+  writer.write_header("{\"cost\": -1.5}", -1.5, names, encoding,
+                      solutions.size());
+  for (size_t i = 0; i < solutions.size(); i++)
+  {
+    writer.write_solution((double)i, solutions[i]);
+  }
+  return writer.bytes_written();
+}
+}  // namespace
+
+TEST(BinarySolution, Bits)
+{
+  SolutionEncoding encoding;
+  encoding.type = SolutionEncoding::BITS;
+  encoding.bit_values[0] = 1;
+  encoding.bit_values[1] = -1;
+  std::vector<int> names = {7, 3, 12, 0, 1, 2, 4, 5, 6, 8, 9};
+  std::vector<std::vector<int>> solutions = {
+      {1, -1, 1, 1, -1, -1, 1, 1, 1, -1, -1},
+      {-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+  };
+  size_t bytes = write_file(encoding, names, solutions);
+
+  BinarySolutionReader reader;
+  reader.open(kFileName);
+  EXPECT_EQ(reader.metadata(), "{\"cost\": -1.5}");
+  EXPECT_EQ(reader.cost(), -1.5);
+  EXPECT_EQ(reader.encoding().type, SolutionEncoding::BITS);
+  EXPECT_EQ(reader.names(), names);
+  ASSERT_EQ(reader.solution_count(), 2u);
+  for (size_t i = 0; i < solutions.size(); i++)
+  {
+    EXPECT_EQ(reader.solution_cost(i), (double)i);
+    EXPECT_EQ(reader.solution_values(i), solutions[i]);
+  }
+  EXPECT_THROW(reader.solution_values(2), utils::IndexOutOfRangeException);
+
+  // Counting without a stream gives the size of the file.
+  BinarySolutionWriter counter(nullptr);
+  counter.write_header("{\"cost\": -1.5}", -1.5, names, encoding, 2);
+  counter.write_solution(0, solutions[0]);
+  counter.write_solution(1, solutions[1]);
+  EXPECT_EQ(counter.bytes_written(), bytes);
+  EXPECT_EQ(bytes % 8, 0u);
+  // ... as does the size of the metadata.
+  EXPECT_EQ(BinarySolutionWriter::file_size(strlen("{\"cost\": -1.5}"),
+                                            names.size(), encoding, 2),
+            bytes);
+  std::remove(kFileName);
+}
+
+TEST(BinarySolution, Int8)
+{
+  SolutionEncoding encoding;
+  std::vector<int> names = {-4, 2, 100};
+  std::vector<std::vector<int>> solutions = {{0, 127, -128}, {3, 2, 1}};
+  write_file(encoding, names, solutions);
+
+  BinarySolutionReader reader;
+  reader.open(kFileName);
+  EXPECT_EQ(reader.encoding().type, SolutionEncoding::INT8);
+  EXPECT_EQ(reader.names(), names);
+  ASSERT_EQ(reader.solution_count(), 2u);
+  EXPECT_EQ(reader.solution_values(0), solutions[0]);
+  EXPECT_EQ(reader.solution_values(1), solutions[1]);
+  std::remove(kFileName);
+}
+
+TEST(BinarySolution, WiderInts)
+{
+  EXPECT_EQ(SolutionEncoding::smallest_int(0, 127), SolutionEncoding::INT8);
+  EXPECT_EQ(SolutionEncoding::smallest_int(0, 128), SolutionEncoding::INT16);
+  EXPECT_EQ(SolutionEncoding::smallest_int(-32769, 0),
+            SolutionEncoding::INT32);
+  std::vector<int> names = {5, 6, 7};
+  for (auto type : {SolutionEncoding::INT16, SolutionEncoding::INT32})
+  {
+    SolutionEncoding encoding;
+    encoding.type = type;
+    std::vector<std::vector<int>> solutions = {{0, 32767, -32768},
+                                               {300, 2, -1}};
+    if (type == SolutionEncoding::INT32) solutions[1][0] = 100000;
+    size_t bytes = write_file(encoding, names, solutions);
+    EXPECT_EQ(BinarySolutionWriter::file_size(strlen("{\"cost\": -1.5}"),
+                                              names.size(), encoding, 2),
+              bytes);
+
+    BinarySolutionReader reader;
+    reader.open(kFileName);
+    EXPECT_EQ(reader.encoding().type, type);
+    ASSERT_EQ(reader.solution_count(), 2u);
+    EXPECT_EQ(reader.solution_values(0), solutions[0]);
+    EXPECT_EQ(reader.solution_values(1), solutions[1]);
+    std::remove(kFileName);
+  }
+}
+
+TEST(BinarySolution, InvalidValues)
+{
+  SolutionEncoding bits;
+  bits.type = SolutionEncoding::BITS;
+  BinarySolutionWriter writer(nullptr);
+  writer.write_header("", 0, {1, 2}, bits, 1);
+  EXPECT_THROW(writer.write_solution(0, {0, 2}), utils::ValueException);
+  EXPECT_THROW(writer.write_solution(0, {0}), utils::ValueException);
+
+  BinarySolutionWriter int8_writer(nullptr);
+  int8_writer.write_header("", 0, {1}, SolutionEncoding(), 1);
+  EXPECT_THROW(int8_writer.write_solution(0, {128}), utils::ValueException);
+
+  SolutionEncoding int16;
+  int16.type = SolutionEncoding::INT16;
+  BinarySolutionWriter int16_writer(nullptr);
+  int16_writer.write_header("", 0, {1}, int16, 1);
+  EXPECT_THROW(int16_writer.write_solution(0, {32768}), utils::ValueException);
+}
+
+TEST(BinarySolution, Truncated)
+{
+  write_file(SolutionEncoding(), {1, 2, 3}, {{1, 2, 3}});
+  std::string content;
+  {
+    std::ifstream in(kFileName, std::ios::binary);
+    content.assign(std::istreambuf_iterator<char>(in),
+                   std::istreambuf_iterator<char>());
+  }
+  {
+    std::ofstream out(kFileName, std::ios::binary);
+    out << content.substr(0, content.size() - 8);
+  }
+  BinarySolutionReader reader;
+  EXPECT_THROW(reader.open(kFileName), utils::ParsingException);
+  std::remove(kFileName);
+}
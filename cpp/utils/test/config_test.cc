@@ -43,4 +43,19 @@ TEST(Config, UseMemSavingFalse)
       utils::feature_disabled(utils::Features::FEATURE_USE_MEMORY_SAVING));
   EXPECT_FALSE(
       utils::feature_enabled(utils::Features::FEATURE_USE_MEMORY_SAVING));
-}
\ No newline at end of file
+}
+
+TEST(Config, ScopedFeatures)
+{
+  utils::initialize_features();
+  {
+    utils::ScopedFeatures features;
+    utils::set_enabled_feature({utils::Features::FEATURE_USE_MEMORY_SAVING});
+    utils::set_disabled_feature({utils::Features::FEATURE_COMPACT_TERMS});
+    EXPECT_TRUE(
+        utils::feature_enabled(utils::Features::FEATURE_USE_MEMORY_SAVING));
+  }
+  EXPECT_FALSE(
+      utils::feature_enabled(utils::Features::FEATURE_USE_MEMORY_SAVING));
+  EXPECT_TRUE(utils::feature_enabled(utils::Features::FEATURE_COMPACT_TERMS));
+}
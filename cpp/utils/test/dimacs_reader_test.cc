@@ -0,0 +1,183 @@
+
+#include "utils/dimacs_reader.h"
+
+#include <cstdio>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <string>
+
+#include "utils/dimacs.h"
+#include "utils/exception.h"
+#include "gtest/gtest.h"
+
+using utils::Dimacs;
+using utils::DimacsReader;
+
+namespace
+{
+void read(DimacsReader& reader, const std::string& input)
+{
+  reader.read(input.data(), input.size());
+}
+
+// Check that `reader` holds the same problem as `dimacs`.
+void expect_same(const DimacsReader& reader, const Dimacs& dimacs)
+{
+  EXPECT_EQ(reader.get_type(), dimacs.get_type());
+  EXPECT_EQ(reader.get_nvar(), dimacs.get_nvar());
+  EXPECT_EQ(reader.get_ncl(), dimacs.get_ncl());
+  EXPECT_EQ(reader.get_top(), dimacs.get_top());
+  EXPECT_EQ(reader.get_variables(), dimacs.get_variables());
+  const auto& clauses = dimacs.get_clauses();
+  ASSERT_EQ(reader.get_weights().size(), clauses.size());
+  ASSERT_EQ(reader.get_clause_offsets().size(), clauses.size() + 1);
+  for (size_t i = 0; i < clauses.size(); i++)
+  {
+    EXPECT_EQ(reader.get_weights()[i], clauses[i].weight);
+    std::vector<int> literals(
+        reader.get_literals().begin() + reader.get_clause_offsets()[i],
+        reader.get_literals().begin() + reader.get_clause_offsets()[i + 1]);
+    EXPECT_EQ(literals, clauses[i].variables);
+  }
+}
+
+std::string error_message(const std::string& input, bool use_reader)
+{
+  try
+  {
+    if (use_reader)
+    {
+      DimacsReader reader;
+      read(reader, input);
+    }
+    else
+    {
+      Dimacs dimacs;
+      dimacs.read(input);
+    }
+  }
+  catch (const std::exception& e)
+  {
+    return e.what();
+  }
+  return "";
+}
+}  // namespace
+
+TEST(DimacsReader, Unweighted)
+{
+  DimacsReader reader;
+  read(reader, R"(c
+c Unweighted Max-SAT
+c
+p cnf 2 3
+-1 0
+1 2 0
+c a comment between clauses
+-2 0
+)");
+  EXPECT_EQ(reader.get_type(), "cnf");
+  EXPECT_EQ(reader.get_nvar(), 2u);
+  EXPECT_EQ(reader.get_ncl(), 3u);
+  EXPECT_EQ(reader.get_variables(), std::vector<int>({1, 2}));
+  EXPECT_EQ(reader.get_weights(), std::vector<double>({1, 1, 1}));
+  EXPECT_EQ(reader.get_clause_offsets(), std::vector<uint64_t>({0, 1, 3, 4}));
+  EXPECT_EQ(reader.get_literals(), std::vector<int>({-1, 1, 2, -2}));
+  EXPECT_EQ(reader.get_top(), 0);
+}
+
+TEST(DimacsReader, Weighted)
+{
+  DimacsReader reader;
+  read(reader, R"(c
+p wcnf 3 3 10
+1.5 -1 0
+4 1 3 0
+2e1 -3 0
+)");
+  EXPECT_EQ(reader.get_type(), "wcnf");
+  EXPECT_EQ(reader.get_nvar(), 2u);
+  EXPECT_EQ(reader.get_variables(), std::vector<int>({1, 3}));
+  EXPECT_EQ(reader.get_weights(), std::vector<double>({1.5, 4, 20}));
+  EXPECT_EQ(reader.get_literals(), std::vector<int>({-1, 1, 3, -3}));
+  EXPECT_EQ(reader.get_top(), 10);
+}
+
+TEST(DimacsReader, MultiLineClauses)
+{
+  std::string input(R"(p cnf 3 2
+1 -2
+  3 0 -1
+2 0
+)");
+  DimacsReader reader;
+  read(reader, input);
+  Dimacs dimacs;
+  dimacs.read(input);
+  expect_same(reader, dimacs);
+}
+
+TEST(DimacsReader, MatchesDimacs)
+{
+  // Large enough to be split into several chunks.
+  std::mt19937 rng(17);
+  const int nvar = 5000;
+  const int ncl = 40000;
+  std::vector<bool> used(nvar + 1);
+  std::stringstream clauses;
+  for (int i = 0; i < ncl; i++)
+  {
+    clauses << (1 + rng() % 100);
+    int start = 1 + rng() % (nvar - 10);
+    int n = 1 + rng() % 5;
+    for (int j = 0; j < n; j++)
+    {
+      int name = start + 2 * j;
+      used[name] = true;
+      clauses << " " << ((rng() % 2) ? -name : name);
+    }
+    clauses << " 0\n";
+    if (i % 1000 == 0) clauses << "c checkpoint " << i << "\n";
+  }
+  int nused = 0;
+  for (bool u : used) nused += u;
+  std::string input = "c generated\np wcnf " + std::to_string(nused) + " " +
+                      std::to_string(ncl) + "\n" + clauses.str();
+
+  DimacsReader reader;
+  read(reader, input);
+  Dimacs dimacs;
+  dimacs.read(input);
+  expect_same(reader, dimacs);
+
+  std::string filename = "dimacs_reader_test.wcnf";
+  {
+    std::ofstream out(filename, std::ios::binary);
+    out << input;
+  }
+  DimacsReader from_file;
+  from_file.read_file(filename);
+  std::remove(filename.c_str());
+  expect_same(from_file, dimacs);
+}
+
+TEST(DimacsReader, SameErrors)
+{
+  for (std::string input : {
+           "p cnf 2 2\n1 2 0\n",            // too few clauses
+           "p cnf 3 1\n1 2 0\n",            // too few variables
+           "p cnf 2 1\n1 1 0\n",            // repeated variable
+           "p cnf 2 1\n1 -1 0\n",           // positive and negative
+           "p cnf 2 2\n1 0\n0\n",           // empty clause
+           "p cnf 2 1\n1 x 0\n",            // not a number
+           "p cnf 2 1\n1 2 0\np cnf 2 1\n",  // multiple problem lines
+           "p foo 2 1\n1 2 0\n",            // unknown type
+           "1 2 0\n",                       // missing problem line
+       })
+  {
+    std::string expected = error_message(input, false);
+    EXPECT_NE(expected, "") << input;
+    EXPECT_EQ(error_message(input, true), expected) << input;
+  }
+}
@@ -0,0 +1,95 @@
+
+#include "utils/instrumentation.h"
+
+#include <omp.h>
+
+#include <string>
+
+#include "utils/config.h"
+#include "gtest/gtest.h"
+
+using utils::ScopedPhase;
+using utils::Structure;
+
+TEST(Instrumentation, NestedPhases)
+{
+  utils::reset_phases();
+  {
+    ScopedPhase parse("parse");
+  }
+  for (int i = 0; i < 3; i++)
+  {
+    ScopedPhase steps("steps");
+    ScopedPhase exchange("exchange");
+  }
+  Structure phases = utils::render_phases();
+  EXPECT_EQ(phases["parse"]["count"].get<uint64_t>(), 1u);
+  EXPECT_FALSE(phases["parse"].has_key("phases"));
+  EXPECT_EQ(phases["steps"]["count"].get<uint64_t>(), 3u);
+  EXPECT_GE(phases["steps"]["wall_ms"].get<double>(), 0);
+  const Structure& exchange = phases["steps"]["phases"]["exchange"];
+  EXPECT_EQ(exchange["count"].get<uint64_t>(), 3u);
+  EXPECT_LE(exchange["wall_ms"].get<double>(),
+            phases["steps"]["wall_ms"].get<double>());
+  EXPECT_FALSE(phases["steps"].has_key("cycles"));
+
+  // Resetting while a phase is open keeps the phases.
+  {
+    ScopedPhase open("open");
+    utils::reset_phases();
+  }
+  EXPECT_TRUE(utils::render_phases().has_key("steps"));
+  utils::reset_phases();
+  EXPECT_EQ(utils::render_phases().to_string(false), "{}");
+}
+
+TEST(Instrumentation, PerThread)
+{
+  utils::reset_phases();
+  #pragma omp parallel num_threads(2)
+  {
+    ScopedPhase phase(omp_get_thread_num() == 0 ? "main" : "worker");
+  }
+  Structure phases = utils::render_phases();
+  EXPECT_TRUE(phases.has_key("main"));
+  EXPECT_FALSE(phases.has_key("worker"));
+}
+
+TEST(Instrumentation, Paused)
+{
+  utils::reset_phases();
+  {
+    ScopedPhase steps("steps");
+    utils::ScopedPhasesPaused paused;
+    ScopedPhase worker("worker_steps");
+  }
+  {
+    ScopedPhase after("after");
+  }
+  Structure phases = utils::render_phases();
+  EXPECT_EQ(phases["steps"]["count"].get<uint64_t>(), 1u);
+  EXPECT_FALSE(phases["steps"].has_key("phases"));
+  EXPECT_FALSE(phases.has_key("worker_steps"));
+  EXPECT_TRUE(phases.has_key("after"));
+}
+
+TEST(Instrumentation, PerfCounters)
+{
+  utils::reset_phases();
+  utils::set_enabled_feature({utils::Features::FEATURE_PERF_COUNTERS});
+  {
+    ScopedPhase phase("counted");
+    volatile double x = 0;
+    for (int i = 0; i < 100000; i++) x = x + i;
+  }
+  utils::set_disabled_feature({utils::Features::FEATURE_PERF_COUNTERS});
+  // The counters may not be permitted (e.g., in containers); if they are,
+  // work was done.
+  Structure phases = utils::render_phases();
+  const Structure& counted = phases["counted"];
+  if (counted.has_key("instructions"))
+  {
+    EXPECT_GT(counted["instructions"].get<uint64_t>(), 100000u);
+  }
+  EXPECT_EQ(counted["count"].get<uint64_t>(), 1u);
+}
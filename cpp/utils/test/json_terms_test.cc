@@ -0,0 +1,123 @@
+
+#include "utils/json_terms.h"
+
+#include <locale.h>
+
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+using utils::JsonSpan;
+using utils::JsonTerm;
+
+namespace
+{
+std::vector<JsonTerm> parse(const std::string& json, bool& ok)
+{
+  JsonSpan span;
+  std::vector<std::vector<JsonTerm>> chunks;
+  ok = utils::find_json_member(json.data(), json.size(),
+                               {"cost_function", "terms"}, span) &&
+       utils::parse_json_terms(json.data(), span, chunks);
+  std::vector<JsonTerm> terms;
+  for (const auto& chunk : chunks)
+  {
+    terms.insert(terms.end(), chunk.begin(), chunk.end());
+  }
+  return terms;
+}
+}  // namespace
+
+TEST(JsonTerms, FindsMember)
+{
+  std::string json =
+      R"({"a": {"terms": 1}, "cost_function": {"type": "i\"{[", )"
+      R"("x": [{"terms": []}], "terms": [{"c": 1, "ids": [0]}] }})";
+  JsonSpan span;
+  ASSERT_TRUE(utils::find_json_member(json.data(), json.size(),
+                                      {"cost_function", "terms"}, span));
+  EXPECT_EQ(json.substr(span.begin, span.end - span.begin),
+            R"([{"c": 1, "ids": [0]}])");
+  EXPECT_FALSE(utils::find_json_member(json.data(), json.size(),
+                                       {"cost_function", "nodes"}, span));
+}
+
+TEST(JsonTerms, ParsesTermsInChunks)
+{
+  std::string json = R"({"cost_function": {"terms": [)";
+  for (int i = 0; i < 10000; i++)
+  {
+    if (i > 0) json += ",\n  ";
+    json += (i % 2) ? R"({"ids": [)" + std::to_string(i) + ", " +
+                          std::to_string(-i) + R"(], "c": -)" +
+                          std::to_string(i) + ".5e-1}"
+                    : R"({ "c" : )" + std::to_string(i) + R"(, "ids":[]})";
+  }
+  json += R"(], "type": "pubo"}})";
+  bool ok;
+  auto terms = parse(json, ok);
+  ASSERT_TRUE(ok);
+  ASSERT_EQ(terms.size(), 10000u);
+  for (int i = 0; i < 10000; i++)
+  {
+    if (i % 2)
+    {
+      EXPECT_DOUBLE_EQ(terms[i].c, -(i + 0.5) / 10);
+      EXPECT_EQ(terms[i].ids, std::vector<int>({i, -i}));
+    }
+    else
+    {
+      EXPECT_EQ(terms[i].c, i);
+      EXPECT_TRUE(terms[i].ids.empty());
+    }
+  }
+}
+
+TEST(JsonTerms, IgnoresLocale)
+{
+  // A locale with ',' as decimal separator must not affect the parsing.
+  std::string previous = setlocale(LC_NUMERIC, nullptr);
+  bool found = false;
+  for (const char* name : {"de_DE.UTF-8", "de_DE.utf8", "fr_FR.UTF-8",
+                           "fr_FR.utf8", "de_DE", "fr_FR"})
+  {
+    if (setlocale(LC_NUMERIC, name) != nullptr)
+    {
+      found = true;
+      break;
+    }
+  }
+  if (!found) GTEST_SKIP() << "no locale with a decimal comma available";
+  bool ok;
+  auto terms =
+      parse(R"({"cost_function": {"terms": [{"c": 1.5, "ids": [0]}]}})", ok);
+  setlocale(LC_NUMERIC, previous.c_str());
+  ASSERT_TRUE(ok);
+  ASSERT_EQ(terms.size(), 1u);
+  EXPECT_EQ(terms[0].c, 1.5);
+}
+
+TEST(JsonTerms, ParsesEmptyArray)
+{
+  bool ok;
+  auto terms = parse(R"({"cost_function": {"terms": [ ]}})", ok);
+  EXPECT_TRUE(ok);
+  EXPECT_TRUE(terms.empty());
+}
+
+TEST(JsonTerms, RejectsUnsupportedTerms)
+{
+  bool ok;
+  for (std::string terms :
+       {R"([{"c": 1}])", R"([{"ids": [1]}])", R"([{"c": 1, "ids": [1], "x": 2}])",
+        R"([{"c": "1", "ids": [1]}])", R"([{"c": 1, "ids": [1.5]}])",
+        R"([{"c": 1, "ids": [3000000000]}])", R"([{"c": 1, "ids": [1]},])",
+        R"([{"c": 1, "ids": [1]} {"c": 1, "ids": [1]}])",
+        R"([{"c": 0x1, "ids": [1]}])", R"([{"c": 01, "ids": [1]}])",
+        R"([{"c": +1, "ids": [1]}])", R"([{"c": 1e, "ids": [1]}])", R"([{"c": 1, "c": 2, "ids": [1]}])"})
+  {
+    parse(R"({"cost_function": {"terms": )" + terms + "}}", ok);
+    EXPECT_FALSE(ok) << terms;
+  }
+}
@@ -0,0 +1,47 @@
+
+#include "utils/mapped_file.h"
+
+#include <cstdio>
+#include <string>
+
+#include "utils/exception.h"
+#include "utils/file.h"
+#include "gtest/gtest.h"
+
+using utils::MappedFile;
+
+TEST(MappedFile, MapsContent)
+{
+  std::string file_name = "mapped_file_test.bin";
+  std::string content("mapped\0content", 14);
+  utils::write_file(file_name, content);
+  {
+    MappedFile file(file_name);
+    EXPECT_TRUE(file.is_open());
+    EXPECT_EQ(file.size(), content.size());
+    EXPECT_EQ(std::string(file.data(), file.size()), content);
+    file.close();
+    EXPECT_FALSE(file.is_open());
+    EXPECT_EQ(file.size(), 0);
+  }
+  std::remove(file_name.c_str());
+}
+
+TEST(MappedFile, MapsEmptyFile)
+{
+  std::string file_name = "mapped_file_test_empty.bin";
+  utils::write_file(file_name, "");
+  MappedFile file(file_name);
+  EXPECT_TRUE(file.is_open());
+  EXPECT_EQ(file.size(), 0);
+  file.close();
+  std::remove(file_name.c_str());
+}
+
+TEST(MappedFile, ThrowsOnMissingFile)
+{
+  MappedFile file;
+  EXPECT_THROW(file.open("mapped_file_test_missing.bin"),
+               utils::FileReadException);
+  EXPECT_FALSE(file.is_open());
+}
@@ -0,0 +1,103 @@
+
+#include "utils/packed_state_set.h"
+
+#include <set>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+using utils::PackedStateSet;
+
+namespace
+{
+std::vector<bool> make_state(size_t n, uint64_t value)
+{
+  std::vector<bool> state(n);
+  for (size_t i = 0; i < n; i++) state[i] = (value >> (i % 64)) & 1;
+  return state;
+}
+}  // namespace
+
+TEST(PackedStateSet, InsertsUniqueStates)
+{
+  PackedStateSet set;
+  set.init(3, 4, PackedStateSet::kRejectNew);
+  EXPECT_TRUE(set.insert({true, false, true}));
+  EXPECT_FALSE(set.insert({true, false, true}));
+  EXPECT_TRUE(set.insert({false, false, false}));
+  EXPECT_EQ(set.size(), 2);
+  EXPECT_EQ(set.get(0), std::vector<bool>({true, false, true}));
+  EXPECT_EQ(set.get(1), std::vector<bool>({false, false, false}));
+  EXPECT_TRUE(set.contains({false, false, false}));
+  EXPECT_FALSE(set.contains({false, true, false}));
+  set.clear();
+  EXPECT_EQ(set.size(), 0);
+  EXPECT_FALSE(set.contains({true, false, true}));
+}
+
+TEST(PackedStateSet, RejectsNewWhenFull)
+{
+  PackedStateSet set;
+  set.init(130, 8, PackedStateSet::kRejectNew);
+  for (uint64_t v = 0; v < 20; v++) set.insert(make_state(130, v));
+  EXPECT_EQ(set.size(), 8);
+  EXPECT_EQ(set.dropped(), 12);
+  for (uint64_t v = 0; v < 8; v++)
+  {
+    EXPECT_EQ(set.get(v), make_state(130, v));
+  }
+  EXPECT_FALSE(set.contains(make_state(130, 8)));
+}
+
+TEST(PackedStateSet, EvictsOldestWhenFull)
+{
+  PackedStateSet set;
+  set.init(70, 5, PackedStateSet::kEvictOldest);
+  for (uint64_t v = 0; v < 1000; v++)
+  {
+    EXPECT_TRUE(set.insert(make_state(70, v * 7919)));
+    // The latest states are all present, evicted ones are not.
+    for (uint64_t w = (v < 5 ? 0 : v - 4); w <= v; w++)
+    {
+      EXPECT_TRUE(set.contains(make_state(70, w * 7919)));
+    }
+    if (v >= 5)
+    {
+      EXPECT_FALSE(set.contains(make_state(70, (v - 5) * 7919)));
+    }
+  }
+  EXPECT_EQ(set.size(), 5);
+  EXPECT_EQ(set.dropped(), 995);
+  EXPECT_EQ(set.get(0), make_state(70, 995 * 7919));
+  EXPECT_EQ(set.get(4), make_state(70, 999 * 7919));
+}
+
+TEST(PackedStateSet, ZeroCapacity)
+{
+  PackedStateSet set;
+  set.init(4, 0, PackedStateSet::kEvictOldest);
+  EXPECT_FALSE(set.insert({true, true, false, false}));
+  EXPECT_EQ(set.size(), 0);
+  EXPECT_EQ(set.dropped(), 1);
+}
+
+TEST(PackedStateSet, GrowsUpToCapacity)
+{
+  // A large capacity is only allocated as states are added.
+  EXPECT_LT(PackedStateSet::memory_estimate(1 << 20, 1024),
+            PackedStateSet::memory_estimate(1 << 20, 1) * 2);
+  PackedStateSet set;
+  set.init(100, 1000, PackedStateSet::kEvictOldest);
+  for (uint64_t v = 0; v < 1500; v++)
+  {
+    EXPECT_TRUE(set.insert(make_state(100, v * 31)));
+  }
+  EXPECT_EQ(set.size(), 1000);
+  EXPECT_EQ(set.dropped(), 500);
+  for (uint64_t v = 0; v < 1500; v++)
+  {
+    EXPECT_EQ(set.contains(make_state(100, v * 31)), v >= 500);
+  }
+  EXPECT_EQ(set.get(0), make_state(100, 500 * 31));
+  EXPECT_EQ(set.get(999), make_state(100, 1499 * 31));
+}
@@ -292,3 +292,32 @@ TEST(RandomSelector, RemoveAll)
   EXPECT_EQ(selector.select_and_remove(0.5), 2);
   EXPECT_EQ(selector.select_and_remove(0.5), 1);
 }
+
+TEST(SystematicSelection, ResidualWeights)
+{
+  // Residual weights summing to 2: each is selected at most once.
+  std::vector<double> weights = {0.5, 0.25, 0.75, 0.5};
+  std::vector<size_t> selections;
+  utils::systematic_selection(weights, 2, 0.0, selections);
+  EXPECT_EQ(selections, std::vector<size_t>({1, 0, 1, 0}));
+  utils::systematic_selection(weights, 2, 0.6, selections);
+  EXPECT_EQ(selections, std::vector<size_t>({0, 1, 0, 1}));
+}
+
+TEST(SystematicSelection, SumsToCount)
+{
+  std::vector<double> weights(10000);
+  for (size_t i = 0; i < weights.size(); i++) weights[i] = (i % 7) / 7.0;
+  std::vector<size_t> selections;
+  for (double uniform : {0.0, 0.3, 0.999})
+  {
+    utils::systematic_selection(weights, 1234, uniform, selections);
+    size_t total = 0;
+    for (size_t i = 0; i < selections.size(); i++)
+    {
+      if (weights[i] == 0) EXPECT_EQ(selections[i], 0);
+      total += selections[i];
+    }
+    EXPECT_EQ(total, 1234);
+  }
+}
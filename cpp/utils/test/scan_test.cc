@@ -0,0 +1,37 @@
+
+#include "utils/scan.h"
+
+#include <vector>
+
+#include "gtest/gtest.h"
+
+using utils::exclusive_scan;
+
+TEST(Scan, Empty)
+{
+  std::vector<size_t> values;
+  EXPECT_EQ(exclusive_scan(values), 0);
+  EXPECT_TRUE(values.empty());
+}
+
+TEST(Scan, Small)
+{
+  std::vector<size_t> values = {2, 0, 3, 1};
+  EXPECT_EQ(exclusive_scan(values), 6);
+  EXPECT_EQ(values, std::vector<size_t>({0, 2, 2, 5}));
+}
+
+TEST(Scan, Large)
+{
+  std::vector<size_t> values(100000);
+  for (size_t i = 0; i < values.size(); i++) values[i] = i % 3;
+  std::vector<size_t> expected(values.size());
+  size_t sum = 0;
+  for (size_t i = 0; i < values.size(); i++)
+  {
+    expected[i] = sum;
+    sum += values[i];
+  }
+  EXPECT_EQ(exclusive_scan(values), sum);
+  EXPECT_EQ(values, expected);
+}
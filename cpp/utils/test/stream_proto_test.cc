@@ -116,4 +116,52 @@ TEST(Stream, FileFailureTest)
       utils::FileReadException,
       "Could not open file: " +
       utils::data_path("err_input_problem_pb/err_input_problem_pb_0.pb"));
-}
\ No newline at end of file
+}
+struct ShardEdge
+{
+  ShardEdge(double c, const std::vector<int>& nodes) : c(c), nodes(nodes) {}
+  double c;
+  std::vector<int> nodes;
+};
+
+TEST(Stream, ProtoShardsTest)
+{
+  utils::ProtoReader reader;
+  std::string input_folder = utils::data_path("input_problem_pb");
+  std::vector<QuantumUtil::Problem*> problem_msgs;
+  create_test_proto_msgs(problem_msgs);
+  write_to_protobuf_folder(input_folder, problem_msgs);
+
+  std::vector<std::vector<ShardEdge>> shards;
+  QuantumUtil::Problem_CostFunction header;
+  size_t header_term_count = 0;
+  reader.ParseShards(input_folder, shards, header, header_term_count);
+  ASSERT_EQ(shards.size(), 4u);
+  for (size_t k = 0; k < shards.size(); k++)
+  {
+    ASSERT_EQ(shards[k].size(), k + 1);
+    for (size_t i = 0; i < shards[k].size(); i++)
+    {
+      EXPECT_EQ(shards[k][i].c, i + 2.5);
+      EXPECT_EQ(shards[k][i].nodes, std::vector<int>({int(i), int(i + 1)}));
+    }
+  }
+  EXPECT_EQ(header.version(), "1.0");
+  EXPECT_EQ(header.type(), QuantumUtil::Problem_ProblemType_ISING);
+  EXPECT_EQ(header.terms_size(), 0);
+  EXPECT_EQ(header_term_count, 1u);
+}
+
+TEST(Stream, ProtoShardsFileFailureTest)
+{
+  utils::ProtoReader reader;
+  std::vector<std::vector<ShardEdge>> shards;
+  QuantumUtil::Problem_CostFunction header;
+  size_t header_term_count = 0;
+  EXPECT_THROW_MESSAGE(
+      reader.ParseShards(utils::data_path("err_input_problem_pb"), shards,
+                         header, header_term_count),
+      utils::FileReadException,
+      "Could not open file: " +
+      utils::data_path("err_input_problem_pb/err_input_problem_pb_0.pb"));
+}
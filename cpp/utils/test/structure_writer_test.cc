@@ -0,0 +1,116 @@
+
+#include "utils/structure_writer.h"
+
+#include <sstream>
+
+#include "gtest/gtest.h"
+
+using utils::Structure;
+using utils::StructureWriter;
+
+namespace
+{
+std::string write(const Structure& s, bool pretty = true)
+{
+  std::stringstream out;
+  StructureWriter writer(&out, pretty);
+  writer.write(s);
+  EXPECT_EQ(writer.bytes_written(), out.str().size());
+  return out.str();
+}
+
+Structure int_object(const std::vector<int>& names,
+                     const std::vector<int>& values)
+{
+  Structure s(Structure::OBJECT);
+  for (size_t i = 0; i < names.size(); i++)
+  {
+    s[std::to_string(names[i])] = values[i];
+  }
+  return s;
+}
+}  // namespace
+
+TEST(StructureWriter, MatchesToString)
+{
+  Structure s;
+  s["version"] = "1.0";
+  s["cost"] = -3.5;
+  s["name"] = "say \"hi\"";
+  s["list"] = std::vector<int>({1, 2, 3});
+  s["nested"]["10"] = true;
+  s["nested"]["9"] = 8u;
+  s["nested"]["100"] = (int64_t)-1;
+  s["nested"]["11"] = Structure();
+  for (int i = 0; i < 12; i++) s["long"].push_back(s["nested"]);
+  EXPECT_EQ(write(s), s.to_string());
+  EXPECT_EQ(write(s, false), s.to_string(false));
+}
+
+TEST(StructureWriter, IntObject)
+{
+  for (const auto& names : std::vector<std::vector<int>>(
+           {{}, {3}, {10, 2, 1}, {10, 2, 1, 33, 0}, {-1, 2, 10, -20, 3},
+            {123456, 7, -1000000000, 99, 100}}))
+  {
+    std::vector<int> values;
+    for (int name : names) values.push_back(name % 2 ? -1 : 1);
+    for (bool pretty : {true, false})
+    {
+      Structure s;
+      s["configuration"] = Structure(Structure::OBJECT);
+      s["cost"] = 1.0;
+      s["configuration"] = StructureWriter::deferred(0);
+
+      auto handler = [&](size_t index, StructureWriter& w) {
+        EXPECT_EQ(index, 0u);
+        w.write_int_object(names, values);
+      };
+      std::stringstream out;
+      StructureWriter writer(&out, pretty);
+      writer.set_deferred_handler(handler);
+      writer.write(s);
+      // The counting writer adds up the sizes without formatting.
+      StructureWriter counter(nullptr, pretty);
+      counter.set_deferred_handler(handler);
+      counter.write(s);
+
+      s["configuration"] = int_object(names, values);
+      EXPECT_EQ(out.str(), s.to_string(pretty));
+      EXPECT_EQ(writer.bytes_written(), out.str().size());
+      EXPECT_EQ(counter.bytes_written(), out.str().size());
+    }
+  }
+}
+
+TEST(StructureWriter, Deferred)
+{
+  Structure s;
+  s["solutions"].push_back(StructureWriter::deferred(1));
+  s["solutions"].push_back(StructureWriter::deferred(0));
+  size_t index = 0;
+  EXPECT_TRUE(StructureWriter::is_deferred(s["solutions"][0], index));
+  EXPECT_EQ(index, 1u);
+  EXPECT_FALSE(StructureWriter::is_deferred(s, index));
+
+  auto handler = [](size_t index, StructureWriter& writer) {
+    Structure value;
+    value["index"] = (int)index;
+    writer.write(value);
+  };
+  std::stringstream out;
+  StructureWriter writer(&out);
+  writer.set_deferred_handler(handler);
+  writer.write(s);
+
+  Structure expected;
+  expected["solutions"][0]["index"] = 1;
+  expected["solutions"][1]["index"] = 0;
+  EXPECT_EQ(out.str(), expected.to_string());
+
+  // Without a stream, only the bytes are counted.
+  StructureWriter counter(nullptr);
+  counter.set_deferred_handler(handler);
+  counter.write(s);
+  EXPECT_EQ(counter.bytes_written(), out.str().size());
+}
@@ -2,6 +2,7 @@
 #include "utils/utils.h"
 
 #include <cmath>
+#include <string>
 
 #include "gtest/gtest.h"
 
@@ -49,3 +50,20 @@ TEST(Utils, GetCombinedHash)
   EXPECT_NE(utils::get_combined_hash(1, 2), utils::get_combined_hash(-1, -2));
   EXPECT_NE(utils::get_combined_hash(0, 0), utils::get_combined_hash(0, 1));
 }
+
+TEST(Utils, HashBytes)
+{
+  std::string small = "qiotoolkit";
+  EXPECT_EQ(utils::hash_bytes(small.data(), small.size()),
+            utils::hash_bytes(small.data(), small.size()));
+  EXPECT_NE(utils::hash_bytes(small.data(), small.size()),
+            utils::hash_bytes(small.data(), small.size() - 1));
+  EXPECT_NE(utils::hash_bytes("", 0), utils::hash_bytes("\0", 1));
+
+  // Multiple chunks (hashed concurrently).
+  std::string large(5 << 20, 'x');
+  uint64_t hash = utils::hash_bytes(large.data(), large.size());
+  EXPECT_EQ(hash, utils::hash_bytes(large.data(), large.size()));
+  large[3 << 20] = 'y';
+  EXPECT_NE(hash, utils::hash_bytes(large.data(), large.size()));
+}
@@ -3,6 +3,9 @@
 
 #include <math.h>
 
+#include <string.h>
+
+#include <algorithm>
 #include <limits>
 
 namespace utils
@@ -100,4 +103,50 @@ double least_diff_method(std::multiset<double>& bbstree_A,
   return min;
 }
 
-}  // namespace utils
\ No newline at end of file
+namespace
+{
+// Finalizer of splitmix64.
+uint64_t mix64(uint64_t x)
+{
+  x ^= x >> 30;
+  x *= 0xbf58476d1ce4e5b9ULL;
+  x ^= x >> 27;
+  x *= 0x94d049bb133111ebULL;
+  x ^= x >> 31;
+  return x;
+}
+
+uint64_t hash_chunk(const char* data, size_t size, uint64_t seed)
+{
+  uint64_t hash = mix64(seed ^ size);
+  size_t i = 0;
+  for (; i + 8 <= size; i += 8)
+  {
+    uint64_t word;
+    memcpy(&word, data + i, 8);
+    hash = mix64(hash ^ word) + 0x9e3779b97f4a7c15ULL;
+  }
+  uint64_t tail = 0;
+  memcpy(&tail, data + i, size - i);
+  return mix64(hash ^ tail);
+}
+}  // namespace
+
+uint64_t hash_bytes(const char* data, size_t size)
+{
+  const size_t chunk_size = 1 << 20;
+  size_t n_chunks = (size + chunk_size - 1) / chunk_size;
+  if (n_chunks <= 1) return hash_chunk(data, size, 0);
+  std::vector<uint64_t> chunk_hashes(n_chunks);
+  #pragma omp parallel for
+  for (size_t c = 0; c < n_chunks; c++)
+  {
+    size_t begin = c * chunk_size;
+    size_t length = std::min(chunk_size, size - begin);
+    chunk_hashes[c] = hash_chunk(data + begin, length, c);
+  }
+  return hash_chunk(reinterpret_cast<const char*>(chunk_hashes.data()),
+                    n_chunks * sizeof(uint64_t), size);
+}
+
+}  // namespace utils
@@ -1,5 +1,8 @@
 
 #pragma once
+#include <stddef.h>
+#include <stdint.h>
+
 #include <set>
 #include <vector>
 namespace utils
@@ -48,4 +51,10 @@ inline size_t get_combined_hash(const  T1& v1, const T2& v2, const T3& v3)
   return seed;
 }
 
+/// 64-bit hash of a block of memory (e.g., the content of a file).
+///
+/// Large blocks are hashed in chunks concurrently; the result does not depend
+/// on the number of threads.
+uint64_t hash_bytes(const char* data, size_t size);
+
 }  // namespace utils
\ No newline at end of file